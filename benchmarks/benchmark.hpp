@@ -0,0 +1,95 @@
+#pragma once
+#include <NTTLib.hpp>
+#include <NTTArgParser.hpp>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace NTT_NS
+{
+    using BenchmarkOperation = std::function<void()>;
+
+    /**
+     * One measured operation of the benchmark executable. The operation is repeated until the
+     *      minimum time is reached, the result is reported per operation and per unit (the
+     *      tokens of a parse, the arguments of a registration, ...).
+     */
+    struct BenchmarkCase
+    {
+        String name;
+        std::vector<std::pair<String, u64>> parameters;
+
+        /**
+         * The name of the unit which is processed by the operation, `token` for the parses.
+         */
+        String unit;
+        u64 unitsPerOperation;
+
+        /**
+         * Builds the inputs (parser, command line) and returns the measured operation, the inputs
+         *      are only alive while the case runs so that the cases do not share their memory.
+         */
+        std::function<BenchmarkOperation()> prepare;
+    };
+
+    /**
+     * Owns the storage of a generated command line and exposes it as `argc`/`argv`.
+     */
+    class CommandLine
+    {
+    public:
+        CommandLine();
+
+        void push(const std::string &token);
+
+        inline u32 argc() const { return static_cast<u32>(m_tokens.size()); }
+
+        /**
+         * Valid until the next `push`.
+         */
+        char **argv();
+
+        /**
+         * @return The number of tokens without the program name.
+         */
+        inline u64 tokenCount() const { return m_tokens.size() - 1; }
+
+    private:
+        std::vector<std::string> m_tokens;
+        std::vector<char *> m_argv;
+    };
+
+    /**
+     * @return The number of heap allocations since the start of the process, counted by the
+     *      replaced global `operator new`.
+     */
+    u64 allocationCount();
+
+    /**
+     * @return The number of bytes requested by the heap allocations since the start of the
+     *      process (the released memory is not subtracted).
+     */
+    u64 allocatedBytes();
+
+    /**
+     * @return The peak resident set size of the process in bytes, `0` if it is not available.
+     */
+    u64 peakResidentBytes();
+
+    /**
+     * Keeps the result of an operation alive so that the compiler cannot remove it.
+     */
+    void consume(u64 value);
+
+    /**
+     * Sets a variable of the process environment.
+     */
+    void setEnvironment(const char *name, const char *value);
+
+    void registerParserBenchmarks(std::vector<BenchmarkCase> &cases);
+    void registerConversionBenchmarks(std::vector<BenchmarkCase> &cases);
+    void registerConfigBenchmarks(std::vector<BenchmarkCase> &cases);
+    void registerStreamBenchmarks(std::vector<BenchmarkCase> &cases);
+    void registerCompletionBenchmarks(std::vector<BenchmarkCase> &cases);
+} // namespace NTT_NS
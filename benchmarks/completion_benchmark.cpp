@@ -0,0 +1,90 @@
+#include "benchmark.hpp"
+#include <cstdio>
+#include <memory>
+
+namespace NTT_NS
+{
+    static std::vector<String> optionKeys(u32 index)
+    {
+        return {String(("--option-" + std::to_string(index)).c_str())};
+    }
+
+    /**
+     * The parser of a large tool, every option is a key of its own.
+     */
+    static void defineOptions(ArgParser &parser, u32 optionCount)
+    {
+        for (u32 i = 0; i < optionCount; i++)
+        {
+            parser.addArgument<i32>(optionKeys(i), "The option");
+        }
+    }
+
+    /**
+     * The completion index of the options written into a file, removed with the last operation
+     *      which uses it.
+     */
+    struct CompletionFixture
+    {
+        std::string path;
+
+        ~CompletionFixture()
+        {
+            std::remove(path.c_str());
+        }
+    };
+
+    void registerCompletionBenchmarks(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 optionCounts[] = {1000, 10000};
+
+        for (u32 optionCount : optionCounts)
+        {
+            // What a completion pays on every key press without the index: the whole parser is
+            //      built before the keys can be listed.
+            cases.push_back(BenchmarkCase{
+                "complete/build_parser",
+                {{"options", optionCount}},
+                "query",
+                1,
+                [optionCount]() -> BenchmarkOperation
+                {
+                    return [optionCount]()
+                    {
+                        ArgParser parser("Benchmark parser");
+                        defineOptions(parser, optionCount);
+                        consume(parser.isParsed());
+                    };
+                }});
+
+            // The whole query of `--complete`: the index is mapped, searched and released.
+            cases.push_back(BenchmarkCase{
+                "complete/index",
+                {{"options", optionCount}},
+                "query",
+                1,
+                [optionCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<CompletionFixture> fixture = std::make_shared<CompletionFixture>();
+                    fixture->path = "ntt_benchmark_completion_" + std::to_string(optionCount) + ".bin";
+
+                    ArgParser parser("Benchmark parser");
+                    defineOptions(parser, optionCount);
+                    parser.writeCompletionIndex(String(fixture->path.c_str()));
+
+                    const std::string prefix = "--option-" + std::to_string(optionCount / 10);
+                    std::shared_ptr<std::vector<ArgCompletionCandidate>> candidates =
+                        std::make_shared<std::vector<ArgCompletionCandidate>>();
+                    return [fixture, prefix, candidates]()
+                    {
+                        ArgCompletionIndex index;
+                        index.open(String(fixture->path.c_str()));
+                        index.complete(ArgStringView(prefix.c_str(), static_cast<u32>(prefix.length())),
+                                       ArgStringView(),
+                                       *candidates);
+                        consume(candidates->size());
+                    };
+                }});
+        }
+    }
+} // namespace NTT_NS
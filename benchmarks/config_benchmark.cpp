@@ -0,0 +1,140 @@
+#include "benchmark.hpp"
+#include <cstdio>
+#include <memory>
+#include <nlohmann/json.hpp>
+
+namespace NTT_NS
+{
+    static std::string settingName(u32 index)
+    {
+        return "setting-" + std::to_string(index);
+    }
+
+    /**
+     * Writes a config file of about `targetBytes` bytes, the matched settings are spread between
+     *      unrelated sections so that most of the file is skipped.
+     */
+    static void writeConfigFile(const std::string &path, u32 settingCount, u64 targetBytes)
+    {
+        FILE *file = fopen(path.c_str(), "wb");
+        const std::string padding(200, 'x');
+        const u64 sectionCount = targetBytes / (padding.size() + 60);
+
+        fprintf(file, "{\n");
+        u32 setting = 0;
+        for (u64 i = 0; i < sectionCount; i++)
+        {
+            fprintf(file, "  \"section-%llu\": {\"description\": \"%s\", \"values\": [1, 2, 3]},\n",
+                    static_cast<unsigned long long>(i), padding.c_str());
+            while (setting < settingCount && setting * sectionCount / settingCount <= i)
+            {
+                fprintf(file, "  \"%s\": %u,\n", settingName(setting).c_str(), setting);
+                setting++;
+            }
+        }
+        fprintf(file, "  \"last\": null\n}\n");
+        fclose(file);
+    }
+
+    static std::string readWholeFile(const std::string &path)
+    {
+        std::string content;
+        FILE *file = fopen(path.c_str(), "rb");
+        char buffer[65536];
+        u64 count = 0;
+        while ((count = fread(buffer, 1, sizeof(buffer), file)) != 0)
+        {
+            content.append(buffer, count);
+        }
+        fclose(file);
+        return content;
+    }
+
+    /**
+     * The generated file, removed with the last operation which uses it.
+     */
+    struct ConfigFixture
+    {
+        std::string path;
+        ArgParser parser{"Benchmark parser"};
+        std::vector<ArgHandle<i32>> settings;
+        CommandLine commandLine;
+
+        ~ConfigFixture()
+        {
+            std::remove(path.c_str());
+        }
+    };
+
+    static std::shared_ptr<ConfigFixture> createConfigFixture(u32 settingCount, u64 fileBytes)
+    {
+        std::shared_ptr<ConfigFixture> fixture = std::make_shared<ConfigFixture>();
+        fixture->path = "ntt_benchmark_config_" + std::to_string(fileBytes) + ".json";
+        writeConfigFile(fixture->path, settingCount, fileBytes);
+
+        for (u32 i = 0; i < settingCount; i++)
+        {
+            fixture->settings.push_back(fixture->parser.addArgument<i32>({String(("--" + settingName(i)).c_str())}));
+        }
+        return fixture;
+    }
+
+    void registerConfigBenchmarks(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 settingCount = 1000;
+        const u64 fileSizes[] = {1 << 20, 8 << 20};
+
+        for (u64 fileBytes : fileSizes)
+        {
+            // Streams the file into the config layer, parses and reads every setting.
+            cases.push_back(BenchmarkCase{
+                "config/stream",
+                {{"settings", settingCount}, {"file_bytes", fileBytes}},
+                "setting",
+                settingCount,
+                [fileBytes]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<ConfigFixture> fixture = createConfigFixture(settingCount, fileBytes);
+                    const String path = fixture->path.c_str();
+                    return [fixture, path]()
+                    {
+                        fixture->parser.parseConfig(path);
+                        fixture->parser.parse(fixture->commandLine.argc(), fixture->commandLine.argv());
+
+                        u64 checksum = 0;
+                        for (const ArgHandle<i32> &setting : fixture->settings)
+                        {
+                            checksum += static_cast<u64>(setting.get());
+                        }
+                        consume(checksum);
+                    };
+                }});
+
+            // Reads the whole file, builds the nlohmann/json document and looks every setting up.
+            cases.push_back(BenchmarkCase{
+                "config/dom",
+                {{"settings", settingCount}, {"file_bytes", fileBytes}},
+                "setting",
+                settingCount,
+                [fileBytes]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<ConfigFixture> fixture = createConfigFixture(settingCount, fileBytes);
+                    return [fixture]()
+                    {
+                        const nlohmann::json document = nlohmann::json::parse(readWholeFile(fixture->path));
+
+                        u64 checksum = 0;
+                        for (u32 i = 0; i < settingCount; i++)
+                        {
+                            nlohmann::json::const_iterator member = document.find(settingName(i));
+                            if (member != document.end())
+                            {
+                                checksum += member->get<u64>();
+                            }
+                        }
+                        consume(checksum);
+                    };
+                }});
+        }
+    }
+} // namespace NTT_NS
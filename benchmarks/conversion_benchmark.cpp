@@ -0,0 +1,75 @@
+#include "benchmark.hpp"
+#include <conversion.hpp>
+#include <cstring>
+#include <memory>
+
+namespace NTT_NS
+{
+    /**
+     * The tokens of one conversion case, each operation converts all of them.
+     */
+    struct ConversionInputs
+    {
+        std::vector<std::string> tokens;
+    };
+
+    template <typename T>
+    static BenchmarkCase conversionCase(const char *name,
+                                        bool (*convert)(const char *, const char *, T &),
+                                        const std::vector<std::string> &tokens)
+    {
+        std::shared_ptr<ConversionInputs> inputs = std::make_shared<ConversionInputs>();
+        inputs->tokens = tokens;
+
+        return BenchmarkCase{
+            name,
+            {{"tokens", tokens.size()}},
+            "token",
+            tokens.size(),
+            [inputs, convert]() -> BenchmarkOperation
+            {
+                return [inputs, convert]()
+                {
+                    u64 converted = 0;
+                    for (const std::string &token : inputs->tokens)
+                    {
+                        T value = T();
+                        converted += convert(token.data(), token.data() + token.length(), value) ? 1 : 0;
+                        converted += static_cast<u64>(value != T());
+                    }
+                    consume(converted);
+                };
+            }};
+    }
+
+    void registerConversionBenchmarks(std::vector<BenchmarkCase> &cases)
+    {
+        cases.push_back(conversionCase<i32>(
+            "conversion/i32_valid",
+            parseI32,
+            {"0", "7", "42", "-3", "+17", "1024", "65535", "-123456", "987654321", "31415926"}));
+        cases.push_back(conversionCase<i32>(
+            "conversion/i32_invalid",
+            parseI32,
+            {"", "-", "abc", "12abc", " 12", "1.5", "0x1F", "--5", "1e3", "true"}));
+        cases.push_back(conversionCase<i32>(
+            "conversion/i32_boundary",
+            parseI32,
+            {"2147483647", "-2147483648", "2147483648", "-2147483649", "+2147483647",
+             "0000000000002147483647", "99999999999999999999999", "-0", "+0", "1"}));
+
+        cases.push_back(conversionCase<f32>(
+            "conversion/f32_valid",
+            parseF32,
+            {"9.5", "2.12", "-0.25", "1e3", "-1.5e2", ".5", "1.", "3.14159", "6.02e23", "1000000"}));
+        cases.push_back(conversionCase<f32>(
+            "conversion/f32_invalid",
+            parseF32,
+            {"", "+", ".", "abc", "1.5f", "1e", "1e+", "1.2.3", "infinite", "2,5"}));
+        cases.push_back(conversionCase<f32>(
+            "conversion/f32_boundary",
+            parseF32,
+            {"3.4028234e38", "3.4028235e38", "3.40282356e38", "3.5e38", "1e39", "-1e400",
+             "1.17549435e-38", "1e-45", "1e-400", "inf", "-infinity", "nan"}));
+    }
+} // namespace NTT_NS
@@ -0,0 +1,290 @@
+#include "benchmark.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <new>
+
+#ifdef NTT_PLATFORM_UNIX
+#include <sys/resource.h>
+#else
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace
+{
+    std::atomic<unsigned long long> s_allocationCount{0};
+    std::atomic<unsigned long long> s_allocatedBytes{0};
+    std::atomic<unsigned long long> s_sink{0};
+
+    void *countedAllocate(std::size_t size)
+    {
+        s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+        s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        void *pointer = std::malloc(size == 0 ? 1 : size);
+        if (pointer == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return pointer;
+    }
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    return countedAllocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return countedAllocate(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace NTT_NS
+{
+    CommandLine::CommandLine()
+    {
+        m_tokens.push_back("benchmark");
+    }
+
+    void CommandLine::push(const std::string &token)
+    {
+        m_tokens.push_back(token);
+    }
+
+    char **CommandLine::argv()
+    {
+        m_argv.clear();
+        for (std::string &token : m_tokens)
+        {
+            m_argv.push_back(&token[0]);
+        }
+        return m_argv.data();
+    }
+
+    u64 allocationCount()
+    {
+        return s_allocationCount.load(std::memory_order_relaxed);
+    }
+
+    u64 allocatedBytes()
+    {
+        return s_allocatedBytes.load(std::memory_order_relaxed);
+    }
+
+    u64 peakResidentBytes()
+    {
+#ifdef NTT_PLATFORM_UNIX
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+#ifdef __APPLE__
+        return static_cast<u64>(usage.ru_maxrss);
+#else
+        return static_cast<u64>(usage.ru_maxrss) * 1024;
+#endif
+#else
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return 0;
+        }
+        return static_cast<u64>(counters.PeakWorkingSetSize);
+#endif
+    }
+
+    void consume(u64 value)
+    {
+        s_sink.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void setEnvironment(const char *name, const char *value)
+    {
+#ifdef NTT_PLATFORM_UNIX
+        setenv(name, value, 1);
+#else
+        _putenv_s(name, value);
+#endif
+    }
+
+    /**
+     * The measurement of one case, the operation is repeated (doubling the count) until the
+     *      loop takes at least the minimum time.
+     */
+    struct BenchmarkResult
+    {
+        u64 iterations;
+        f64 nanosecondsPerOperation;
+        f64 allocationsPerOperation;
+        f64 allocatedBytesPerOperation;
+        u64 peakResidentBytes;
+    };
+
+    static BenchmarkResult runCase(const BenchmarkCase &benchmarkCase, f64 minimumNanoseconds)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const BenchmarkOperation operation = benchmarkCase.prepare();
+
+        // The first call warms up the buffers which are reused by the following calls.
+        operation();
+
+        u64 iterations = 1;
+        while (true)
+        {
+            const u64 allocationsBefore = allocationCount();
+            const u64 bytesBefore = allocatedBytes();
+            const Clock::time_point start = Clock::now();
+            for (u64 i = 0; i < iterations; i++)
+            {
+                operation();
+            }
+            const f64 elapsed = std::chrono::duration<f64, std::nano>(Clock::now() - start).count();
+            const u64 allocations = allocationCount() - allocationsBefore;
+            const u64 bytes = allocatedBytes() - bytesBefore;
+
+            if (elapsed >= minimumNanoseconds)
+            {
+                return BenchmarkResult{
+                    iterations,
+                    elapsed / iterations,
+                    static_cast<f64>(allocations) / iterations,
+                    static_cast<f64>(bytes) / iterations,
+                    peakResidentBytes()};
+            }
+
+            iterations *= 2;
+        }
+    }
+
+    static void writeResult(FILE *output, const BenchmarkCase &benchmarkCase, const BenchmarkResult &result, bool last)
+    {
+        fprintf(output, "    {\"name\": \"%s\", \"parameters\": {", benchmarkCase.name.c_str());
+        for (u32 i = 0; i < benchmarkCase.parameters.size(); i++)
+        {
+            fprintf(output, "%s\"%s\": %llu",
+                    i == 0 ? "" : ", ",
+                    benchmarkCase.parameters[i].first.c_str(),
+                    static_cast<unsigned long long>(benchmarkCase.parameters[i].second));
+        }
+        fprintf(output,
+                "}, \"iterations\": %llu, \"ns_per_op\": %.1f, \"unit\": \"%s\", \"units_per_op\": %llu, "
+                "\"ns_per_unit\": %.3f, \"allocations_per_op\": %.2f, \"allocated_bytes_per_op\": %.0f, "
+                "\"peak_rss_bytes\": %llu}%s\n",
+                static_cast<unsigned long long>(result.iterations),
+                result.nanosecondsPerOperation,
+                benchmarkCase.unit.c_str(),
+                static_cast<unsigned long long>(benchmarkCase.unitsPerOperation),
+                result.nanosecondsPerOperation / benchmarkCase.unitsPerOperation,
+                result.allocationsPerOperation,
+                result.allocatedBytesPerOperation,
+                static_cast<unsigned long long>(result.peakResidentBytes),
+                last ? "" : ",");
+        fflush(output);
+    }
+} // namespace NTT_NS
+
+using namespace NTT_NS;
+
+int main(int argc, char **argv)
+{
+    String outputPath;
+    String filter;
+    i32 minimumMilliseconds = 0;
+
+    ArgParser parser("Measures the parser and prints the results as JSON");
+    parser.addArgument<String>({"-o", "--output"}, &outputPath, "The JSON file, the standard output by default");
+    parser.addArgument<String>({"-f", "--filter"}, &filter, "Only runs the cases whose name contains the filter");
+    parser.addArgument<i32>({"-t", "--min-time"}, &minimumMilliseconds, "The minimum time of each case in ms", false, 200);
+
+    try
+    {
+        parser.parse(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    std::vector<BenchmarkCase> cases;
+    registerParserBenchmarks(cases);
+    registerConversionBenchmarks(cases);
+    registerConfigBenchmarks(cases);
+    registerStreamBenchmarks(cases);
+    registerCompletionBenchmarks(cases);
+
+    std::vector<const BenchmarkCase *> selectedCases;
+    for (const BenchmarkCase &benchmarkCase : cases)
+    {
+        if (std::string(benchmarkCase.name.c_str()).find(filter.c_str()) != std::string::npos)
+        {
+            selectedCases.push_back(&benchmarkCase);
+        }
+    }
+
+    FILE *output = stdout;
+    if (outputPath.length() != 0)
+    {
+        output = fopen(outputPath.c_str(), "w");
+        if (output == nullptr)
+        {
+            fprintf(stderr, "The output file %s cannot be opened\n", outputPath.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    fprintf(output, "{\n  \"benchmarks\": [\n");
+    for (u32 i = 0; i < selectedCases.size(); i++)
+    {
+        const BenchmarkResult result = runCase(*selectedCases[i], minimumMilliseconds * 1e6);
+        writeResult(output, *selectedCases[i], result, i + 1 == selectedCases.size());
+    }
+    fprintf(output, "  ],\n  \"peak_rss_bytes\": %llu\n}\n",
+            static_cast<unsigned long long>(peakResidentBytes()));
+
+    if (output != stdout)
+    {
+        fclose(output);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1303 @@
+#include "benchmark.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace NTT_NS
+{
+    /**
+     * The value types which are measured, the bool flags take one token and the others two.
+     */
+    enum BenchmarkValueType
+    {
+        BENCHMARK_STRING,
+        BENCHMARK_I32,
+        BENCHMARK_F32,
+        BENCHMARK_BOOL,
+    };
+
+    static const char *valueTypeName(BenchmarkValueType type)
+    {
+        switch (type)
+        {
+        case BENCHMARK_STRING:
+            return "string";
+        case BENCHMARK_I32:
+            return "i32";
+        case BENCHMARK_F32:
+            return "f32";
+        case BENCHMARK_BOOL:
+            return "bool";
+        default:
+            return "unknown";
+        }
+    }
+
+    static std::string argumentKey(u32 index, u32 alias = 0)
+    {
+        return alias == 0
+                   ? "--arg-" + std::to_string(index)
+                   : "--arg-" + std::to_string(index) + "-" + std::to_string(alias);
+    }
+
+    static std::vector<String> argumentKeys(u32 index, u32 aliasCount)
+    {
+        std::vector<String> keys;
+        for (u32 alias = 0; alias < aliasCount; alias++)
+        {
+            keys.push_back(String(argumentKey(index, alias)));
+        }
+        return keys;
+    }
+
+    static void addTypedArgument(ArgParser &parser, BenchmarkValueType type, const std::vector<String> &keys)
+    {
+        switch (type)
+        {
+        case BENCHMARK_STRING:
+            parser.addArgument<String>(keys, "The string argument", false, "default");
+            break;
+        case BENCHMARK_I32:
+            parser.addArgument<i32>(keys, "The i32 argument", false, 1);
+            break;
+        case BENCHMARK_F32:
+            parser.addArgument<f32>(keys, "The f32 argument", false, 1.0f);
+            break;
+        case BENCHMARK_BOOL:
+            parser.addArgument<bool>(keys, "The bool argument");
+            break;
+        default:
+            break;
+        }
+    }
+
+    static void pushTypedValue(CommandLine &commandLine, BenchmarkValueType type, u32 index)
+    {
+        switch (type)
+        {
+        case BENCHMARK_STRING:
+            commandLine.push("value-" + std::to_string(index));
+            break;
+        case BENCHMARK_I32:
+            commandLine.push(std::to_string(index));
+            break;
+        case BENCHMARK_F32:
+            commandLine.push(std::to_string(index) + ".5");
+            break;
+        case BENCHMARK_BOOL:
+        default:
+            break;
+        }
+    }
+
+    /**
+     * A parser and a command line which are kept alive by the operation of a case.
+     */
+    struct ParseFixture
+    {
+        ArgParser parser{"Benchmark parser"};
+        CommandLine commandLine;
+    };
+
+    static std::shared_ptr<ParseFixture> createFixture(
+        BenchmarkValueType type,
+        u32 argumentCount,
+        u32 aliasCount)
+    {
+        std::shared_ptr<ParseFixture> fixture = std::make_shared<ParseFixture>();
+        for (u32 i = 0; i < argumentCount; i++)
+        {
+            addTypedArgument(fixture->parser, type, argumentKeys(i, aliasCount));
+        }
+
+        // Every argument is given once through its last alias.
+        for (u32 i = 0; i < argumentCount; i++)
+        {
+            fixture->commandLine.push(argumentKey(i, aliasCount - 1));
+            pushTypedValue(fixture->commandLine, type, i);
+        }
+        return fixture;
+    }
+
+    static u64 tokensPerArgument(BenchmarkValueType type)
+    {
+        return type == BENCHMARK_BOOL ? 1 : 2;
+    }
+
+    static BenchmarkCase parseCase(
+        const String &name,
+        std::vector<std::pair<String, u64>> parameters,
+        u64 tokenCount,
+        std::function<std::shared_ptr<ParseFixture>()> createInputs)
+    {
+        return BenchmarkCase{
+            name,
+            parameters,
+            "token",
+            tokenCount,
+            [createInputs]() -> BenchmarkOperation
+            {
+                std::shared_ptr<ParseFixture> fixture = createInputs();
+                const u32 argc = fixture->commandLine.argc();
+                char **argv = fixture->commandLine.argv();
+                return [fixture, argc, argv]()
+                {
+                    fixture->parser.parse(argc, argv);
+                    consume(fixture->parser.isParsed());
+                };
+            }};
+    }
+
+    static const BenchmarkValueType s_valueTypes[] = {
+        BENCHMARK_STRING,
+        BENCHMARK_I32,
+        BENCHMARK_F32,
+        BENCHMARK_BOOL,
+    };
+
+    static const u32 s_argumentCounts[] = {10, 100, 1000, 10000};
+
+    static void registerArgumentCountCases(std::vector<BenchmarkCase> &cases)
+    {
+        for (BenchmarkValueType type : s_valueTypes)
+        {
+            for (u32 argumentCount : s_argumentCounts)
+            {
+                cases.push_back(parseCase(
+                    format("parse/{}", String(valueTypeName(type))),
+                    {{"arguments", argumentCount}},
+                    argumentCount * tokensPerArgument(type),
+                    [type, argumentCount]()
+                    { return createFixture(type, argumentCount, 1); }));
+            }
+        }
+    }
+
+    /**
+     * The numeric parses with the lazy conversion, nothing is read so that the parse only records
+     *      the tokens (compare with `parse/i32` and `parse/f32`).
+     */
+    static void registerLazyConversionCases(std::vector<BenchmarkCase> &cases)
+    {
+        const BenchmarkValueType lazyTypes[] = {BENCHMARK_I32, BENCHMARK_F32};
+
+        for (BenchmarkValueType type : lazyTypes)
+        {
+            for (u32 argumentCount : s_argumentCounts)
+            {
+                cases.push_back(parseCase(
+                    format("parse_lazy/{}", String(valueTypeName(type))),
+                    {{"arguments", argumentCount}},
+                    argumentCount * tokensPerArgument(type),
+                    [type, argumentCount]()
+                    {
+                        std::shared_ptr<ParseFixture> fixture = createFixture(type, argumentCount, 1);
+                        fixture->parser.setLazyConversion(true);
+                        return fixture;
+                    }));
+            }
+        }
+    }
+
+    static void registerTokenCountCases(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 tokenCounts[] = {10, 1000, 100000, 1000000};
+
+        for (u32 tokenCount : tokenCounts)
+        {
+            // The same keys are repeated, the last value of each argument is kept.
+            cases.push_back(parseCase(
+                "parse/repeated_keys",
+                {{"tokens", tokenCount}},
+                tokenCount,
+                [tokenCount]()
+                {
+                    const u32 argumentCount = 10;
+                    std::shared_ptr<ParseFixture> fixture = std::make_shared<ParseFixture>();
+                    for (u32 i = 0; i < argumentCount; i++)
+                    {
+                        addTypedArgument(fixture->parser, BENCHMARK_I32, argumentKeys(i, 1));
+                    }
+                    for (u32 i = 0; i < tokenCount / 2; i++)
+                    {
+                        fixture->commandLine.push(argumentKey(i % argumentCount));
+                        fixture->commandLine.push(std::to_string(i));
+                    }
+                    return fixture;
+                }));
+
+            // One list argument takes every value.
+            cases.push_back(parseCase(
+                "parse/i32_list",
+                {{"tokens", tokenCount}},
+                tokenCount,
+                [tokenCount]()
+                {
+                    std::shared_ptr<ParseFixture> fixture = std::make_shared<ParseFixture>();
+                    fixture->parser.addArgument<std::vector<i32>>({"--values"}).setNargs(NARGS_ONE_OR_MORE);
+                    fixture->commandLine.push("--values");
+                    for (u32 i = 1; i < tokenCount; i++)
+                    {
+                        fixture->commandLine.push(std::to_string(i));
+                    }
+                    return fixture;
+                }));
+
+            cases.push_back(parseCase(
+                "parse/string_list",
+                {{"tokens", tokenCount}},
+                tokenCount,
+                [tokenCount]()
+                {
+                    std::shared_ptr<ParseFixture> fixture = std::make_shared<ParseFixture>();
+                    fixture->parser.addArgument<std::vector<String>>({"--values"}).setNargs(NARGS_ONE_OR_MORE);
+                    fixture->commandLine.push("--values");
+                    for (u32 i = 1; i < tokenCount; i++)
+                    {
+                        fixture->commandLine.push("value-" + std::to_string(i));
+                    }
+                    return fixture;
+                }));
+        }
+    }
+
+    static void registerAliasCountCases(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 argumentCount = 100;
+        const u32 aliasCounts[] = {1, 4, 16};
+
+        for (u32 aliasCount : aliasCounts)
+        {
+            cases.push_back(parseCase(
+                "parse/aliases",
+                {{"arguments", argumentCount}, {"aliases", aliasCount}},
+                argumentCount * tokensPerArgument(BENCHMARK_I32),
+                [aliasCount]()
+                { return createFixture(BENCHMARK_I32, argumentCount, aliasCount); }));
+        }
+    }
+
+    /**
+     * Reads every argument of the parsed fixture by its key.
+     */
+    template <typename T>
+    static BenchmarkOperation getArgumentOperation(BenchmarkValueType type, u32 argumentCount)
+    {
+        std::shared_ptr<ParseFixture> fixture = createFixture(type, argumentCount, 1);
+        fixture->parser.parse(fixture->commandLine.argc(), fixture->commandLine.argv());
+
+        std::shared_ptr<std::vector<String>> keys = std::make_shared<std::vector<String>>();
+        for (u32 i = 0; i < argumentCount; i++)
+        {
+            keys->push_back(String(argumentKey(i)));
+        }
+
+        return [fixture, keys]()
+        {
+            u64 checksum = 0;
+            for (const String &key : *keys)
+            {
+                const T value = fixture->parser.getArgument<T>(key);
+                checksum += reinterpret_cast<const u8 *>(&value)[0];
+            }
+            consume(checksum);
+        };
+    }
+
+    static void registerGetArgumentCases(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 argumentCount = 1000;
+
+        for (BenchmarkValueType type : s_valueTypes)
+        {
+            cases.push_back(BenchmarkCase{
+                format("getArgument/{}", String(valueTypeName(type))),
+                {{"arguments", argumentCount}},
+                "lookup",
+                argumentCount,
+                [type]()
+                {
+                    switch (type)
+                    {
+                    case BENCHMARK_STRING:
+                        return getArgumentOperation<String>(type, argumentCount);
+                    case BENCHMARK_I32:
+                        return getArgumentOperation<i32>(type, argumentCount);
+                    case BENCHMARK_F32:
+                        return getArgumentOperation<f32>(type, argumentCount);
+                    case BENCHMARK_BOOL:
+                    default:
+                        return getArgumentOperation<bool>(type, argumentCount);
+                    }
+                }});
+        }
+
+        // The handles skip the key lookup and the type check.
+        cases.push_back(BenchmarkCase{
+            "handle/i32",
+            {{"arguments", argumentCount}},
+            "lookup",
+            argumentCount,
+            []() -> BenchmarkOperation
+            {
+                std::shared_ptr<ParseFixture> fixture = std::make_shared<ParseFixture>();
+                std::shared_ptr<std::vector<ArgHandle<i32>>> handles =
+                    std::make_shared<std::vector<ArgHandle<i32>>>();
+                for (u32 i = 0; i < argumentCount; i++)
+                {
+                    handles->push_back(fixture->parser.addArgument<i32>({String(argumentKey(i))}));
+                }
+
+                return [fixture, handles]()
+                {
+                    u64 checksum = 0;
+                    for (const ArgHandle<i32> &handle : *handles)
+                    {
+                        checksum += static_cast<u64>(handle.get());
+                    }
+                    consume(checksum);
+                };
+            }});
+    }
+
+    static void registerResetCases(std::vector<BenchmarkCase> &cases)
+    {
+        for (u32 argumentCount : s_argumentCounts)
+        {
+            cases.push_back(BenchmarkCase{
+                "reset",
+                {{"arguments", argumentCount}},
+                "argument",
+                argumentCount,
+                [argumentCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<ParseFixture> fixture = createFixture(BENCHMARK_STRING, argumentCount, 1);
+                    return [fixture]()
+                    {
+                        fixture->parser.reset();
+                        consume(fixture->parser.isParsed());
+                    };
+                }});
+        }
+    }
+
+    static void registerAddArgumentCases(std::vector<BenchmarkCase> &cases)
+    {
+        for (BenchmarkValueType type : s_valueTypes)
+        {
+            for (u32 argumentCount : s_argumentCounts)
+            {
+                cases.push_back(BenchmarkCase{
+                    format("addArgument/{}", String(valueTypeName(type))),
+                    {{"arguments", argumentCount}},
+                    "argument",
+                    argumentCount,
+                    [type, argumentCount]() -> BenchmarkOperation
+                    {
+                        std::shared_ptr<std::vector<std::vector<String>>> keys =
+                            std::make_shared<std::vector<std::vector<String>>>();
+                        for (u32 i = 0; i < argumentCount; i++)
+                        {
+                            keys->push_back(argumentKeys(i, 1));
+                        }
+
+                        return [type, keys]()
+                        {
+                            ArgParser parser("Benchmark parser");
+                            for (const std::vector<String> &triggerKeys : *keys)
+                            {
+                                addTypedArgument(parser, type, triggerKeys);
+                            }
+                            consume(parser.isParsed());
+                        };
+                    }});
+            }
+        }
+    }
+
+    static std::string environmentName(u32 index)
+    {
+        return "NTT_BENCHMARK_ENV_" + std::to_string(index);
+    }
+
+    /**
+     * The parse of an empty command line whose arguments all declare an environment variable,
+     *      one of ten is set, against the `getenv` call per argument which it replaces.
+     */
+    static void registerEnvironmentCases(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 argumentCounts[] = {10, 100, 1000};
+
+        for (u32 argumentCount : argumentCounts)
+        {
+            for (u32 i = 0; i < argumentCount; i += 10)
+            {
+                setEnvironment(environmentName(i).c_str(), std::to_string(i).c_str());
+            }
+
+            cases.push_back(parseCase(
+                "parse/environment",
+                {{"arguments", argumentCount}},
+                argumentCount,
+                [argumentCount]()
+                {
+                    std::shared_ptr<ParseFixture> fixture = std::make_shared<ParseFixture>();
+                    for (u32 i = 0; i < argumentCount; i++)
+                    {
+                        fixture->parser.addArgument<i32>(argumentKeys(i, 1))
+                            .setEnvironmentVariable(environmentName(i).c_str());
+                    }
+                    return fixture;
+                }));
+
+            cases.push_back(BenchmarkCase{
+                "environment/getenv",
+                {{"arguments", argumentCount}},
+                "argument",
+                argumentCount,
+                [argumentCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<std::vector<std::string>> names = std::make_shared<std::vector<std::string>>();
+                    for (u32 i = 0; i < argumentCount; i++)
+                    {
+                        names->push_back(environmentName(i));
+                    }
+                    return [names]()
+                    {
+                        u64 checksum = 0;
+                        for (const std::string &name : *names)
+                        {
+                            const char *value = getenv(name.c_str());
+                            checksum += value == nullptr ? 0 : static_cast<u64>(atoi(value));
+                        }
+                        consume(checksum);
+                    };
+                }});
+        }
+    }
+
+    /**
+     * The help of a large parser: the first layout after a change (`setNargs` invalidates the
+     *      text) and the `--help` request which reuses the laid out text.
+     */
+    static void registerHelpCases(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 optionCounts[] = {100, 5000};
+
+        for (u32 optionCount : optionCounts)
+        {
+            cases.push_back(BenchmarkCase{
+                "help/layout",
+                {{"arguments", optionCount}},
+                "argument",
+                optionCount,
+                [optionCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<ParseFixture> fixture = createFixture(BENCHMARK_I32, optionCount - 1, 2);
+                    const ArgHandle<std::vector<i32>> list = fixture->parser.addArgument<std::vector<i32>>({"--values"}, "The values");
+                    return [fixture, list]()
+                    {
+                        list.setNargs(NARGS_ONE);
+                        consume(fixture->parser.getHelp().length());
+                    };
+                }});
+
+            cases.push_back(BenchmarkCase{
+                "help/request",
+                {{"arguments", optionCount}},
+                "argument",
+                optionCount,
+                [optionCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<ParseFixture> fixture = createFixture(BENCHMARK_I32, optionCount, 2);
+                    fixture->commandLine = CommandLine();
+                    fixture->commandLine.push("--help");
+                    const u32 argc = fixture->commandLine.argc();
+                    char **argv = fixture->commandLine.argv();
+                    return [fixture, argc, argv]()
+                    {
+                        const ArgStatus status = fixture->parser.tryParse(argc, argv);
+                        consume(status.code() + fixture->parser.getHelp().length());
+                    };
+                }});
+        }
+    }
+
+    /**
+     * A launcher which parses half `String` and half `i32` arguments and the worker which reads
+     *      every value through its handles, either by parsing the same command line again or by
+     *      attaching to the serialized result.
+     */
+    struct HandoffFixture
+    {
+        ArgParser parser{"Benchmark parser"};
+        std::vector<ArgHandle<String>> strings;
+        std::vector<ArgHandle<i32>> numbers;
+        CommandLine commandLine;
+        std::vector<u8> blob;
+    };
+
+    static std::shared_ptr<HandoffFixture> createHandoffFixture(u32 argumentCount)
+    {
+        std::shared_ptr<HandoffFixture> fixture = std::make_shared<HandoffFixture>();
+        for (u32 i = 0; i < argumentCount; i++)
+        {
+            if (i % 2 == 0)
+            {
+                fixture->strings.push_back(fixture->parser.addArgument<String>(argumentKeys(i, 1)));
+                fixture->commandLine.push(argumentKey(i));
+                pushTypedValue(fixture->commandLine, BENCHMARK_STRING, i);
+            }
+            else
+            {
+                fixture->numbers.push_back(fixture->parser.addArgument<i32>(argumentKeys(i, 1)));
+                fixture->commandLine.push(argumentKey(i));
+                pushTypedValue(fixture->commandLine, BENCHMARK_I32, i);
+            }
+        }
+        fixture->parser.parse(fixture->commandLine.argc(), fixture->commandLine.argv());
+        fixture->blob = fixture->parser.serialize();
+        return fixture;
+    }
+
+    static void registerHandoffCases(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 argumentCounts[] = {10, 1000, 10000};
+
+        for (u32 argumentCount : argumentCounts)
+        {
+            cases.push_back(BenchmarkCase{
+                "handoff/serialize",
+                {{"arguments", argumentCount}},
+                "argument",
+                argumentCount,
+                [argumentCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<HandoffFixture> fixture = createHandoffFixture(argumentCount);
+                    return [fixture]()
+                    {
+                        const ArgStatus status = fixture->parser.trySerialize(fixture->blob);
+                        consume(status.code() + fixture->blob.size());
+                    };
+                }});
+
+            cases.push_back(BenchmarkCase{
+                "handoff/parse",
+                {{"arguments", argumentCount}},
+                "argument",
+                argumentCount,
+                [argumentCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<HandoffFixture> fixture = createHandoffFixture(argumentCount);
+                    return [fixture]()
+                    {
+                        fixture->parser.parse(fixture->commandLine.argc(), fixture->commandLine.argv());
+
+                        u64 checksum = 0;
+                        for (const ArgHandle<String> &handle : fixture->strings)
+                        {
+                            checksum += handle.get().length();
+                        }
+                        for (const ArgHandle<i32> &handle : fixture->numbers)
+                        {
+                            checksum += static_cast<u64>(handle.get());
+                        }
+                        consume(checksum);
+                    };
+                }});
+
+            cases.push_back(BenchmarkCase{
+                "handoff/attach",
+                {{"arguments", argumentCount}},
+                "argument",
+                argumentCount,
+                [argumentCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<HandoffFixture> fixture = createHandoffFixture(argumentCount);
+                    std::shared_ptr<ArgSnapshot> snapshot = std::make_shared<ArgSnapshot>();
+                    return [fixture, snapshot]()
+                    {
+                        fixture->parser.tryAttach(fixture->blob.data(), fixture->blob.size(), *snapshot);
+
+                        u64 checksum = 0;
+                        for (const ArgHandle<String> &handle : fixture->strings)
+                        {
+                            checksum += snapshot->get(handle).length();
+                        }
+                        for (const ArgHandle<i32> &handle : fixture->numbers)
+                        {
+                            checksum += static_cast<u64>(snapshot->get(handle));
+                        }
+                        consume(checksum);
+                    };
+                }});
+        }
+    }
+
+    /**
+     * The startup of a CLI with many subcommands which runs one of them: the parser is created,
+     *      every subcommand is declared and the command line is parsed. With the builders only
+     *      the selected subcommand defines its options, the eager case defines every option of
+     *      every subcommand beforehand like a CLI without subcommand support.
+     */
+    struct SubcommandTable
+    {
+        std::vector<String> names;
+        std::vector<std::vector<std::vector<String>>> optionKeys;
+        CommandLine commandLine;
+    };
+
+    static std::shared_ptr<SubcommandTable> createSubcommandTable(u32 subcommandCount, u32 optionCount)
+    {
+        std::shared_ptr<SubcommandTable> table = std::make_shared<SubcommandTable>();
+        for (u32 i = 0; i < subcommandCount; i++)
+        {
+            table->names.push_back(String("command-" + std::to_string(i)));
+            table->optionKeys.emplace_back();
+            for (u32 option = 0; option < optionCount; option++)
+            {
+                table->optionKeys.back().push_back(argumentKeys(option, 2));
+            }
+        }
+
+        table->commandLine.push(table->names[subcommandCount / 2]);
+        for (u32 option = 0; option < optionCount; option += 4)
+        {
+            table->commandLine.push(argumentKey(option));
+            pushTypedValue(table->commandLine, BENCHMARK_I32, option);
+        }
+        return table;
+    }
+
+    static void defineSubcommandOptions(ArgParser &parser, const std::vector<std::vector<String>> &keys)
+    {
+        for (const std::vector<String> &triggerKeys : keys)
+        {
+            parser.addArgument<i32>(triggerKeys, "The option of the subcommand", false, 1);
+        }
+    }
+
+    static void registerSubcommandCases(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 subcommandCount = 150;
+        const u32 optionCount = 20;
+
+        cases.push_back(BenchmarkCase{
+            "subcommand/builder",
+            {{"subcommands", subcommandCount}, {"options", optionCount}},
+            "startup",
+            1,
+            []() -> BenchmarkOperation
+            {
+                std::shared_ptr<SubcommandTable> table = createSubcommandTable(subcommandCount, optionCount);
+                return [table]()
+                {
+                    ArgParser parser("Benchmark parser");
+                    for (u32 i = 0; i < subcommandCount; i++)
+                    {
+                        const std::vector<std::vector<String>> *keys = &table->optionKeys[i];
+                        parser.addSubcommand(table->names[i], "The subcommand", [keys](ArgParser &subcommand)
+                                             { defineSubcommandOptions(subcommand, *keys); });
+                    }
+                    parser.parse(table->commandLine.argc(), table->commandLine.argv());
+                    consume(parser.getSubcommand()->isParsed());
+                };
+            }});
+
+        cases.push_back(BenchmarkCase{
+            "subcommand/eager",
+            {{"subcommands", subcommandCount}, {"options", optionCount}},
+            "startup",
+            1,
+            []() -> BenchmarkOperation
+            {
+                std::shared_ptr<SubcommandTable> table = createSubcommandTable(subcommandCount, optionCount);
+                return [table]()
+                {
+                    std::vector<Scope<ArgParser>> parsers;
+                    for (u32 i = 0; i < subcommandCount; i++)
+                    {
+                        parsers.push_back(CreateScope<ArgParser>("The subcommand"));
+                        defineSubcommandOptions(*parsers.back(), table->optionKeys[i]);
+                    }
+
+                    // The selected parser receives the command line without the subcommand name.
+                    ArgParser &selected = *parsers[subcommandCount / 2];
+                    selected.parse(table->commandLine.argc() - 1, table->commandLine.argv() + 1);
+                    consume(selected.isParsed());
+                };
+            }});
+    }
+
+    /**
+     * The arguments of a small tool, declared once as constant data and once through
+     *      `addArgument` for the comparison.
+     */
+    static constexpr ArgStaticArgument kStaticArguments[] = {
+        staticArgument<String>({"-i", "--input"}, "The input", true),
+        staticArgument<String>({"-o", "--output"}, "The output", false, "out.bin"),
+        staticArgument<String>({"--format"}, "The format", false, "binary"),
+        staticArgument<String>({"--log"}, "The log file"),
+        staticArgument<i32>({"-j", "--jobs"}, "The jobs", false, 1),
+        staticArgument<i32>({"--level"}, "The level", false, 3),
+        staticArgument<i32>({"--retry"}, "The retries", false, 2),
+        staticArgument<i32>({"--timeout"}, "The timeout", false, 30),
+        staticArgument<f32>({"-s", "--scale"}, "The scale", false, 1.0f),
+        staticArgument<f32>({"--ratio"}, "The ratio", false, 0.5f),
+        staticArgument<f32>({"--gamma"}, "The gamma", false, 2.2f),
+        staticArgument<f32>({"--threshold"}, "The threshold", false, 0.1f),
+        staticArgument<bool>({"-v", "--verbose"}, "The verbose mode"),
+        staticArgument<bool>({"-q", "--quiet"}, "The quiet mode"),
+        staticArgument<bool>({"--dry-run"}, "The dry run"),
+        staticArgument<bool>({"--force"}, "The force mode"),
+    };
+    static constexpr u32 kStaticArgumentCount = sizeof(kStaticArguments) / sizeof(kStaticArguments[0]);
+    static constexpr ArgStaticSchema<kStaticArgumentCount> kStaticSchema(kStaticArguments);
+
+    static void defineRuntimeArguments(ArgParser &parser)
+    {
+        for (const ArgStaticArgument &argument : kStaticArguments)
+        {
+            std::vector<String> keys;
+            for (u32 key = 0; key < argument.keys.count; key++)
+            {
+                keys.push_back(String(argument.keys.keys[key]));
+            }
+
+            switch (argument.type)
+            {
+            case ArgStaticType::ARG_STATIC_STRING:
+                parser.addArgument<String>(keys, argument.description, argument.isRequired, argument.defaultValue.stringValue.data);
+                break;
+            case ArgStaticType::ARG_STATIC_I32:
+                parser.addArgument<i32>(keys, argument.description, argument.isRequired, argument.defaultValue.i32Value);
+                break;
+            case ArgStaticType::ARG_STATIC_F32:
+                parser.addArgument<f32>(keys, argument.description, argument.isRequired, argument.defaultValue.f32Value);
+                break;
+            case ArgStaticType::ARG_STATIC_BOOL:
+            default:
+                parser.addArgument<bool>(keys, argument.description, argument.isRequired, argument.defaultValue.boolValue);
+                break;
+            }
+        }
+    }
+
+    /**
+     * A whole start of a small tool (definitions and parse), the static schema against the
+     *      definitions built by `addArgument`.
+     */
+    static void registerStaticSchemaCases(std::vector<BenchmarkCase> &cases)
+    {
+        std::shared_ptr<CommandLine> commandLine = std::make_shared<CommandLine>();
+        for (const char *token : {"-i", "in.bin", "--jobs", "8", "--scale", "0.75", "--verbose", "--format", "text"})
+        {
+            commandLine->push(token);
+        }
+
+        cases.push_back(BenchmarkCase{
+            "startup/static",
+            {{"arguments", kStaticArgumentCount}},
+            "startup",
+            1,
+            [commandLine]() -> BenchmarkOperation
+            {
+                return [commandLine]()
+                {
+                    ArgStaticResult<kStaticArgumentCount> result;
+                    kStaticSchema.parse(commandLine->argc(), commandLine->argv(), result);
+                    consume(result.isParsed());
+                };
+            }});
+
+        cases.push_back(BenchmarkCase{
+            "startup/runtime",
+            {{"arguments", kStaticArgumentCount}},
+            "startup",
+            1,
+            [commandLine]() -> BenchmarkOperation
+            {
+                return [commandLine]()
+                {
+                    ArgParser parser("Benchmark parser");
+                    defineRuntimeArguments(parser);
+                    parser.parse(commandLine->argc(), commandLine->argv());
+                    consume(parser.isParsed());
+                };
+            }});
+    }
+
+    /**
+     * Long keys made of three words like the options of a large tool (`--enable-cache-size`), the
+     *      keys share their prefixes as the real ones do. The index picks the words so that no key
+     *      is repeated (up to 40^3 keys).
+     */
+    static std::string wordKey(u32 index)
+    {
+        static const char *const words[] = {
+            "enable", "disable", "cache", "size", "limit", "thread", "count", "output",
+            "input", "format", "level", "debug", "trace", "memory", "pool", "buffer",
+            "timeout", "retry", "delay", "window", "width", "height", "color", "depth",
+            "path", "prefix", "suffix", "mode", "policy", "strategy", "verbose", "quiet",
+            "batch", "queue", "worker", "socket", "port", "host", "index", "shard"};
+        const u32 wordCount = sizeof(words) / sizeof(words[0]);
+
+        return std::string("--") + words[index % wordCount] +
+               "-" + words[(index / wordCount) % wordCount] +
+               "-" + words[(index / wordCount / wordCount) % wordCount];
+    }
+
+    /**
+     * Edit distance of two keys with the two row algorithm, the baseline of the suggestions.
+     */
+    static u32 editDistance(const std::string &first, const std::string &second, std::vector<u32> &rows)
+    {
+        const u32 width = static_cast<u32>(second.length()) + 1;
+        rows.resize(width * 2);
+        u32 *previous = rows.data();
+        u32 *current = rows.data() + width;
+        for (u32 j = 0; j < width; j++)
+        {
+            previous[j] = j;
+        }
+        for (u32 i = 1; i <= first.length(); i++)
+        {
+            current[0] = i;
+            for (u32 j = 1; j < width; j++)
+            {
+                const u32 replaced = previous[j - 1] + (first[i - 1] == second[j - 1] ? 0 : 1);
+                current[j] = std::min(replaced, std::min(previous[j], current[j - 1]) + 1);
+            }
+            std::swap(previous, current);
+        }
+        return previous[width - 1];
+    }
+
+    /**
+     * The suggestions of a mistyped key: the trie search against the distance to every key, and
+     *      the exact and abbreviated parses with the prefix matching.
+     */
+    static void registerKeyTrieCases(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 keyCount = 20000;
+
+        struct SuggestionFixture
+        {
+            ArgParser parser{"Benchmark parser"};
+            CommandLine commandLine;
+            std::vector<std::string> keys;
+            std::string typo;
+            ArgStatus status;
+        };
+
+        std::function<std::shared_ptr<SuggestionFixture>()> createInputs = []()
+        {
+            std::shared_ptr<SuggestionFixture> fixture = std::make_shared<SuggestionFixture>();
+            for (u32 i = 0; i < keyCount; i++)
+            {
+                fixture->keys.push_back(wordKey(i));
+                fixture->parser.addArgument<i32>({String(fixture->keys.back())}, "The i32 argument", false, 1);
+            }
+
+            // Two swapped characters in the middle of an existing key.
+            fixture->typo = fixture->keys[keyCount / 2];
+            std::swap(fixture->typo[3], fixture->typo[4]);
+            fixture->commandLine.push(fixture->typo);
+            fixture->commandLine.push("1");
+            fixture->status = fixture->parser.tryParse(fixture->commandLine.argc(), fixture->commandLine.argv());
+            return fixture;
+        };
+
+        cases.push_back(BenchmarkCase{
+            "suggestion/trie",
+            {{"keys", keyCount}},
+            "message",
+            1,
+            [createInputs]() -> BenchmarkOperation
+            {
+                std::shared_ptr<SuggestionFixture> fixture = createInputs();
+                return [fixture]()
+                {
+                    consume(fixture->parser.getErrorMessage(fixture->status).length());
+                };
+            }});
+
+        cases.push_back(BenchmarkCase{
+            "suggestion/linear",
+            {{"keys", keyCount}},
+            "message",
+            1,
+            [createInputs]() -> BenchmarkOperation
+            {
+                std::shared_ptr<SuggestionFixture> fixture = createInputs();
+                return [fixture]()
+                {
+                    std::vector<u32> rows;
+                    u32 closest = 0xFFFFFFFFu;
+                    u64 closestKey = 0;
+                    for (u64 i = 0; i < fixture->keys.size(); i++)
+                    {
+                        const u32 distance = editDistance(fixture->typo, fixture->keys[i], rows);
+                        if (distance < closest)
+                        {
+                            closest = distance;
+                            closestKey = i;
+                        }
+                    }
+                    consume(closestKey + closest);
+                };
+            }});
+
+        const u32 argumentCount = 1000;
+        for (u32 abbreviated = 0; abbreviated < 2; abbreviated++)
+        {
+            cases.push_back(BenchmarkCase{
+                abbreviated != 0 ? "prefix/abbreviated" : "prefix/exact",
+                {{"arguments", argumentCount}},
+                "token",
+                argumentCount * 2,
+                [abbreviated]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<ParseFixture> fixture = std::make_shared<ParseFixture>();
+                    fixture->parser.setPrefixMatching(true);
+                    for (u32 i = 0; i < argumentCount; i++)
+                    {
+                        const std::string key = wordKey(i);
+                        fixture->parser.addArgument<i32>({String(key)}, "The i32 argument", false, 1);
+
+                        // No word of the key is the prefix of another one.
+                        fixture->commandLine.push(abbreviated != 0 ? key.substr(0, key.length() - 1) : key);
+                        fixture->commandLine.push(std::to_string(i));
+                    }
+                    const u32 argc = fixture->commandLine.argc();
+                    char **argv = fixture->commandLine.argv();
+                    return [fixture, argc, argv]()
+                    {
+                        fixture->parser.parse(argc, argv);
+                        consume(fixture->parser.isParsed());
+                    };
+                }});
+        }
+    }
+
+    /**
+     * A live result of `i32` arguments, reloaded by a background thread while the operation reads
+     *      when `isReloading` is set. The mutex guarded `shared_ptr` is the baseline of the views.
+     */
+    struct LiveFixture
+    {
+        ArgParser parser{"Benchmark parser"};
+        CommandLine commandLine;
+        std::vector<ArgHandle<i32>> handles;
+        std::shared_ptr<const ArgSchema> schema;
+        Scope<ArgLiveResult> live;
+
+        std::mutex mutex;
+        std::shared_ptr<const ArgParseResult> locked;
+
+        std::atomic<bool> isReloading{false};
+        std::thread reloader;
+
+        ~LiveFixture()
+        {
+            isReloading = false;
+            if (reloader.joinable())
+            {
+                reloader.join();
+            }
+        }
+    };
+
+    static std::shared_ptr<LiveFixture> createLiveFixture(u32 argumentCount, bool isReloading)
+    {
+        std::shared_ptr<LiveFixture> fixture = std::make_shared<LiveFixture>();
+        for (u32 i = 0; i < argumentCount; i++)
+        {
+            fixture->handles.push_back(fixture->parser.addArgument<i32>({String(argumentKey(i))}));
+            fixture->commandLine.push(argumentKey(i));
+            pushTypedValue(fixture->commandLine, BENCHMARK_I32, i);
+        }
+        fixture->schema = fixture->parser.freeze();
+        fixture->live = CreateScope<ArgLiveResult>(fixture->schema);
+        fixture->live->reload(fixture->commandLine.argc(), fixture->commandLine.argv());
+        fixture->locked = std::make_shared<const ArgParseResult>(
+            fixture->schema->parse(fixture->commandLine.argc(), fixture->commandLine.argv()));
+
+        if (isReloading)
+        {
+            fixture->isReloading = true;
+            LiveFixture *reloaded = fixture.get();
+            const u32 argc = fixture->commandLine.argc();
+            char **argv = fixture->commandLine.argv();
+            fixture->reloader = std::thread(
+                [reloaded, argc, argv]()
+                {
+                    while (reloaded->isReloading.load())
+                    {
+                        reloaded->live->tryReload(argc, argv);
+
+                        std::shared_ptr<const ArgParseResult> result =
+                            std::make_shared<const ArgParseResult>(reloaded->schema->parse(argc, argv));
+                        std::lock_guard<std::mutex> lock(reloaded->mutex);
+                        reloaded->locked = std::move(result);
+                    }
+                });
+        }
+        return fixture;
+    }
+
+    /**
+     * The readers of a reloaded configuration: a view of the live result against a copy of the
+     *      `shared_ptr` under a mutex, with and without a concurrent reload.
+     */
+    static void registerLiveResultCases(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 argumentCount = 10;
+
+        for (u32 isReloading = 0; isReloading <= 1; isReloading++)
+        {
+            cases.push_back(BenchmarkCase{
+                "live/view",
+                {{"arguments", argumentCount}, {"reloading", isReloading}},
+                "read",
+                1,
+                [isReloading]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<LiveFixture> fixture = createLiveFixture(argumentCount, isReloading != 0);
+                    return [fixture]()
+                    {
+                        ArgLiveView view = fixture->live->read();
+                        u64 checksum = 0;
+                        for (const ArgHandle<i32> &handle : fixture->handles)
+                        {
+                            checksum += static_cast<u64>(view.get(handle));
+                        }
+                        consume(checksum);
+                    };
+                }});
+
+            cases.push_back(BenchmarkCase{
+                "live/mutex",
+                {{"arguments", argumentCount}, {"reloading", isReloading}},
+                "read",
+                1,
+                [isReloading]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<LiveFixture> fixture = createLiveFixture(argumentCount, isReloading != 0);
+                    return [fixture]()
+                    {
+                        std::shared_ptr<const ArgParseResult> result;
+                        {
+                            std::lock_guard<std::mutex> lock(fixture->mutex);
+                            result = fixture->locked;
+                        }
+                        u64 checksum = 0;
+                        for (const ArgHandle<i32> &handle : fixture->handles)
+                        {
+                            checksum += static_cast<u64>(result->get(handle));
+                        }
+                        consume(checksum);
+                    };
+                }});
+        }
+
+        cases.push_back(BenchmarkCase{
+            "live/reload",
+            {{"arguments", argumentCount}},
+            "reload",
+            1,
+            []() -> BenchmarkOperation
+            {
+                std::shared_ptr<LiveFixture> fixture = createLiveFixture(argumentCount, false);
+                return [fixture]()
+                {
+                    const ArgStatus status = fixture->live->tryReload(fixture->commandLine.argc(),
+                                                                      fixture->commandLine.argv());
+                    consume(status.code());
+                };
+            }});
+    }
+
+    /**
+     * The rejected command lines, the throwing API against the status API.
+     */
+    static void registerFailureCases(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 argumentCount = 100;
+        const u32 failedToken = argumentCount;
+
+        // The unknown key is in the middle of the command line.
+        std::function<std::shared_ptr<ParseFixture>()> createInputs = []()
+        {
+            std::shared_ptr<ParseFixture> fixture = std::make_shared<ParseFixture>();
+            for (u32 i = 0; i < argumentCount; i++)
+            {
+                addTypedArgument(fixture->parser, BENCHMARK_I32, argumentKeys(i, 1));
+            }
+            for (u32 i = 0; i < argumentCount; i++)
+            {
+                fixture->commandLine.push(i == argumentCount / 2 ? "--unknown" : argumentKey(i));
+                fixture->commandLine.push(std::to_string(i));
+            }
+            return fixture;
+        };
+
+        cases.push_back(BenchmarkCase{
+            "parse/failure_throwing",
+            {{"arguments", argumentCount}},
+            "token",
+            failedToken,
+            [createInputs]() -> BenchmarkOperation
+            {
+                std::shared_ptr<ParseFixture> fixture = createInputs();
+                return [fixture]()
+                {
+                    try
+                    {
+                        fixture->parser.parse(fixture->commandLine.argc(), fixture->commandLine.argv());
+                    }
+                    catch (const std::exception &e)
+                    {
+                        consume(e.what()[0]);
+                    }
+                };
+            }});
+
+        cases.push_back(BenchmarkCase{
+            "parse/failure_try",
+            {{"arguments", argumentCount}},
+            "token",
+            failedToken,
+            [createInputs]() -> BenchmarkOperation
+            {
+                std::shared_ptr<ParseFixture> fixture = createInputs();
+                const u32 argc = fixture->commandLine.argc();
+                char **argv = fixture->commandLine.argv();
+                return [fixture, argc, argv]()
+                {
+                    consume(fixture->parser.tryParse(argc, argv).code());
+                };
+            }});
+
+        const u32 lookupCount = 100;
+        std::function<std::shared_ptr<ParseFixture>()> createParser = []()
+        {
+            std::shared_ptr<ParseFixture> fixture = std::make_shared<ParseFixture>();
+            for (u32 i = 0; i < argumentCount; i++)
+            {
+                addTypedArgument(fixture->parser, BENCHMARK_I32, argumentKeys(i, 1));
+            }
+            return fixture;
+        };
+
+        cases.push_back(BenchmarkCase{
+            "getArgument/failure_throwing",
+            {{"arguments", argumentCount}},
+            "lookup",
+            lookupCount,
+            [createParser]() -> BenchmarkOperation
+            {
+                std::shared_ptr<ParseFixture> fixture = createParser();
+                const String key = "--unknown";
+                return [fixture, key]()
+                {
+                    for (u32 i = 0; i < lookupCount; i++)
+                    {
+                        try
+                        {
+                            consume(static_cast<u64>(fixture->parser.getArgument<i32>(key)));
+                        }
+                        catch (const std::exception &e)
+                        {
+                            consume(e.what()[0]);
+                        }
+                    }
+                };
+            }});
+
+        cases.push_back(BenchmarkCase{
+            "getArgument/failure_try",
+            {{"arguments", argumentCount}},
+            "lookup",
+            lookupCount,
+            [createParser]() -> BenchmarkOperation
+            {
+                std::shared_ptr<ParseFixture> fixture = createParser();
+                const String key = "--unknown";
+                return [fixture, key]()
+                {
+                    u64 checksum = 0;
+                    for (u32 i = 0; i < lookupCount; i++)
+                    {
+                        i32 value = 0;
+                        checksum += fixture->parser.tryGetArgument<i32>(key, value).code();
+                    }
+                    consume(checksum);
+                };
+            }});
+    }
+
+    /**
+     * A long list checked by a regex validator, on the parsing thread against the worker
+     *      threads. The checks only scale with the cores of the machine.
+     */
+    static void registerValidationCases(std::vector<BenchmarkCase> &cases)
+    {
+        const u32 valueCount = 10000;
+        const u32 threadCounts[] = {1, 4};
+
+        for (u32 threadCount : threadCounts)
+        {
+            cases.push_back(BenchmarkCase{
+                "parse/validated_list",
+                {{"values", valueCount}, {"threads", threadCount}},
+                "token",
+                valueCount + 1,
+                [threadCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<ParseFixture> fixture = std::make_shared<ParseFixture>();
+                    fixture->parser.setValidationThreads(threadCount);
+                    fixture->parser.addArgument<std::vector<String>>({"--inputs"}, "The inputs")
+                        .setNargs(NARGS_ONE_OR_MORE)
+                        .addValidator(ArgValidator::regex("data/[a-z]+_[0-9]+\\.(txt|csv)"));
+
+                    fixture->commandLine.push("--inputs");
+                    for (u32 i = 0; i < valueCount; i++)
+                    {
+                        fixture->commandLine.push("data/input_" + std::to_string(i) + ".txt");
+                    }
+
+                    const u32 argc = fixture->commandLine.argc();
+                    char **argv = fixture->commandLine.argv();
+                    return [fixture, argc, argv]()
+                    {
+                        consume(fixture->parser.tryParse(argc, argv).code());
+                    };
+                }});
+        }
+    }
+
+    void registerParserBenchmarks(std::vector<BenchmarkCase> &cases)
+    {
+        registerArgumentCountCases(cases);
+        registerLazyConversionCases(cases);
+        registerTokenCountCases(cases);
+        registerAliasCountCases(cases);
+        registerGetArgumentCases(cases);
+        registerResetCases(cases);
+        registerAddArgumentCases(cases);
+        registerHelpCases(cases);
+        registerEnvironmentCases(cases);
+        registerHandoffCases(cases);
+        registerSubcommandCases(cases);
+        registerKeyTrieCases(cases);
+        registerStaticSchemaCases(cases);
+        registerLiveResultCases(cases);
+        registerFailureCases(cases);
+        registerValidationCases(cases);
+    }
+} // namespace NTT_NS
@@ -0,0 +1,206 @@
+#include "benchmark.hpp"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#ifdef NTT_PLATFORM_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace NTT_NS
+{
+    static i32 openForReading(const std::string &path)
+    {
+#ifdef NTT_PLATFORM_UNIX
+        return ::open(path.c_str(), O_RDONLY);
+#else
+        return _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#endif
+    }
+
+    static void closeDescriptor(i32 fileDescriptor)
+    {
+#ifdef NTT_PLATFORM_UNIX
+        ::close(fileDescriptor);
+#else
+        _close(fileDescriptor);
+#endif
+    }
+
+    static i64 readDescriptor(i32 fileDescriptor, char *buffer, u32 capacity)
+    {
+#ifdef NTT_PLATFORM_UNIX
+        return ::read(fileDescriptor, buffer, capacity);
+#else
+        return _read(fileDescriptor, buffer, capacity);
+#endif
+    }
+
+    /**
+     * A NUL delimited file of `--col <n>` pairs (the output of a generator piped into the tool),
+     *      removed with the last operation which uses it.
+     */
+    struct StreamFixture
+    {
+        std::string path;
+        ArgParser parser{"Benchmark parser"};
+
+        ~StreamFixture()
+        {
+            std::remove(path.c_str());
+        }
+    };
+
+    static std::shared_ptr<StreamFixture> createStreamFixture(u64 tokenCount)
+    {
+        std::shared_ptr<StreamFixture> fixture = std::make_shared<StreamFixture>();
+        fixture->path = "ntt_benchmark_stream_" + std::to_string(tokenCount) + ".bin";
+        fixture->parser.addArgument<i32>({"-c", "--col"}, "The column");
+
+        FILE *file = fopen(fixture->path.c_str(), "wb");
+        for (u64 i = 0; i < tokenCount / 2; i++)
+        {
+            fprintf(file, "--col%c%llu%c", '\0', static_cast<unsigned long long>(i), '\0');
+        }
+        fclose(file);
+        return fixture;
+    }
+
+    /**
+     * A NUL delimited file of input paths which are all visited by a repeated positional argument.
+     */
+    struct PositionalFixture : StreamFixture
+    {
+        u64 visitedBytes = 0;
+    };
+
+    static std::shared_ptr<PositionalFixture> createPositionalFixture(u64 tokenCount)
+    {
+        std::shared_ptr<PositionalFixture> fixture = std::make_shared<PositionalFixture>();
+        fixture->path = "ntt_benchmark_positional_" + std::to_string(tokenCount) + ".bin";
+        PositionalFixture *state = fixture.get();
+        fixture->parser.addPositional<String>("inputs", [state](u32, ArgStringView path)
+                                              { state->visitedBytes += path.length(); },
+                                              "The inputs", true, true);
+
+        FILE *file = fopen(fixture->path.c_str(), "wb");
+        for (u64 i = 0; i < tokenCount; i++)
+        {
+            fprintf(file, "data/input_%llu.txt%c", static_cast<unsigned long long>(i), '\0');
+        }
+        fclose(file);
+        return fixture;
+    }
+
+    void registerStreamBenchmarks(std::vector<BenchmarkCase> &cases)
+    {
+        const u64 tokenCounts[] = {100000, 1000000};
+
+        for (u64 tokenCount : tokenCounts)
+        {
+            // The baseline: every byte is read and every delimiter is found, nothing is parsed.
+            cases.push_back(BenchmarkCase{
+                "stream/read",
+                {{"tokens", tokenCount}},
+                "token",
+                tokenCount,
+                [tokenCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<StreamFixture> fixture = createStreamFixture(tokenCount);
+                    std::shared_ptr<std::vector<char>> buffer =
+                        std::make_shared<std::vector<char>>(NTT_ARG_TOKEN_SOURCE_BUFFER_SIZE);
+                    return [fixture, buffer]()
+                    {
+                        const i32 fileDescriptor = openForReading(fixture->path);
+                        u64 delimiters = 0;
+                        i64 count = 0;
+                        while ((count = readDescriptor(fileDescriptor, buffer->data(), static_cast<u32>(buffer->size()))) > 0)
+                        {
+                            const char *position = buffer->data();
+                            const char *end = position + count;
+                            while ((position = static_cast<const char *>(memchr(position, '\0', end - position))) != nullptr)
+                            {
+                                delimiters++;
+                                position++;
+                            }
+                        }
+                        closeDescriptor(fileDescriptor);
+                        consume(delimiters);
+                    };
+                }});
+
+            cases.push_back(BenchmarkCase{
+                "stream/parse",
+                {{"tokens", tokenCount}},
+                "token",
+                tokenCount,
+                [tokenCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<StreamFixture> fixture = createStreamFixture(tokenCount);
+                    return [fixture]()
+                    {
+                        const i32 fileDescriptor = openForReading(fixture->path);
+                        ArgTokenSource source(fileDescriptor);
+                        const ArgStatus status = fixture->parser.tryParseStream(source);
+                        closeDescriptor(fileDescriptor);
+                        consume(status.code() + static_cast<u64>(fixture->parser.getArgument<i32>("--col")));
+                    };
+                }});
+
+            // Every token is a positional value which is visited without being stored.
+            cases.push_back(BenchmarkCase{
+                "stream/positional",
+                {{"tokens", tokenCount}},
+                "token",
+                tokenCount,
+                [tokenCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<PositionalFixture> fixture = createPositionalFixture(tokenCount);
+                    return [fixture]()
+                    {
+                        const i32 fileDescriptor = openForReading(fixture->path);
+                        ArgTokenSource source(fileDescriptor);
+                        const ArgStatus status = fixture->parser.tryParseStream(source);
+                        closeDescriptor(fileDescriptor);
+                        consume(status.code() + fixture->visitedBytes);
+                    };
+                }});
+
+            // The whole input is read into an argument vector first, its memory grows with the input.
+            cases.push_back(BenchmarkCase{
+                "stream/argv",
+                {{"tokens", tokenCount}},
+                "token",
+                tokenCount,
+                [tokenCount]() -> BenchmarkOperation
+                {
+                    std::shared_ptr<StreamFixture> fixture = createStreamFixture(tokenCount);
+                    return [fixture]()
+                    {
+                        std::vector<char> content;
+                        char buffer[NTT_ARG_TOKEN_SOURCE_BUFFER_SIZE];
+                        const i32 fileDescriptor = openForReading(fixture->path);
+                        i64 count = 0;
+                        while ((count = readDescriptor(fileDescriptor, buffer, sizeof(buffer))) > 0)
+                        {
+                            content.insert(content.end(), buffer, buffer + count);
+                        }
+                        closeDescriptor(fileDescriptor);
+
+                        std::vector<char *> argv(1, const_cast<char *>("program"));
+                        for (u64 start = 0; start < content.size(); start += strlen(content.data() + start) + 1)
+                        {
+                            argv.push_back(content.data() + start);
+                        }
+
+                        const ArgStatus status = fixture->parser.tryParse(static_cast<u32>(argv.size()), argv.data());
+                        consume(status.code() + static_cast<u64>(fixture->parser.getArgument<i32>("--col")));
+                    };
+                }});
+        }
+    }
+} // namespace NTT_NS
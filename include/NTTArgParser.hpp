@@ -1,3 +1,11 @@
 #pragma once
 
-#include "parser.hpp"
\ No newline at end of file
+#include "parser.hpp"
+#include "schema.hpp"
+#include "instrumentation.hpp"
+#include "live_result.hpp"
+#include "token_source.hpp"
+#include "validator.hpp"
+#include "completion.hpp"
+#include "snapshot.hpp"
+#include "static_schema.hpp"
@@ -0,0 +1,2052 @@
+#include "argument_data.hpp"
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+#include "memory.hpp"
+#include "conversion.hpp"
+#include "response_file.hpp"
+#include "help.hpp"
+#include "token_source.hpp"
+
+#ifdef NTT_PLATFORM_UNIX
+#include <unistd.h>
+extern char **environ;
+#else
+#include <stdlib.h>
+#endif
+
+namespace NTT_NS
+{
+    /**
+     * override for printing method of with the argument value.
+     */
+    template <>
+    String format(const String &formatMsg, const ArgumentValue &value)
+    {
+        const String data = format("<int={}, float={}, bool={}>",
+                                   value.i32Value,
+                                   value.f32Value,
+                                   value.boolValue);
+        return format(formatMsg, data);
+    }
+
+    /**
+     * override for printing method of with the argument type.
+     */
+    template <>
+    String format(const String &formatMsg, const ArgParserType &value)
+    {
+        String typeStr = NTT_STRING_EMPTY;
+        switch (value)
+        {
+        case ArgParserType::STRING:
+            typeStr = "STRING";
+            break;
+        case ArgParserType::I32:
+            typeStr = "I32";
+            break;
+        case ArgParserType::F32:
+            typeStr = "F32";
+            break;
+        case ArgParserType::BOOL:
+            typeStr = "BOOL";
+            break;
+        case ArgParserType::STRING_LIST:
+            typeStr = "STRING_LIST";
+            break;
+        case ArgParserType::I32_LIST:
+            typeStr = "I32_LIST";
+            break;
+        case ArgParserType::F32_LIST:
+            typeStr = "F32_LIST";
+            break;
+        case ArgParserType::BOOL_LIST:
+            typeStr = "BOOL_LIST";
+            break;
+        default:
+            typeStr = "UNKNOWN";
+            break;
+        }
+
+        return format(formatMsg, typeStr);
+    }
+
+    void KeyIndex::insert(const char *key, StringRef keyRef, u32 index)
+    {
+        if ((count + 1) * 2 > slots.size())
+        {
+            grow();
+        }
+
+        place(Slot{keyRef.offset, keyRef.length, hashKey(key, keyRef.length), index});
+        count++;
+    }
+
+    void KeyIndex::place(const Slot &slot)
+    {
+        const u32 mask = static_cast<u32>(slots.size()) - 1;
+        u32 slotIndex = slot.hash & mask;
+        while (slots[slotIndex].index != NTT_ARGUMENT_KEY_INDEX_EMPTY_SLOT)
+        {
+            slotIndex = (slotIndex + 1) & mask;
+        }
+        slots[slotIndex] = slot;
+    }
+
+    void KeyIndex::grow()
+    {
+        std::vector<Slot> oldSlots;
+        oldSlots.swap(slots);
+
+        const size_t capacity = oldSlots.empty()
+                                    ? NTT_ARGUMENT_KEY_INDEX_MIN_CAPACITY
+                                    : oldSlots.size() * 2;
+        slots.assign(capacity, Slot{0, 0, 0, NTT_ARGUMENT_KEY_INDEX_EMPTY_SLOT});
+
+        for (const Slot &slot : oldSlots)
+        {
+            if (slot.index != NTT_ARGUMENT_KEY_INDEX_EMPTY_SLOT)
+            {
+                place(slot);
+            }
+        }
+    }
+
+    StringRef SchemaData::intern(const char *data, u32 length)
+    {
+        StringRef ref{static_cast<u32>(stringPool.size()), length};
+        stringPool.insert(stringPool.end(), data, data + length);
+        stringPool.push_back('\0');
+        return ref;
+    }
+
+    void SchemaData::checkKeys(const std::vector<String> &triggerKeys) const
+    {
+        for (u32 i = 0; i < triggerKeys.size(); i++)
+        {
+            bool duplicated = searchByKey(triggerKeys[i]) != NTT_ARGUMENT_INVALID_INDEX;
+            for (u32 j = 0; j < i && !duplicated; j++)
+            {
+                duplicated = triggerKeys[j] == triggerKeys[i];
+            }
+
+            if (duplicated || searchSubcommand(triggerKeys[i].c_str(), triggerKeys[i].length()) != NTT_ARGUMENT_INVALID_INDEX)
+            {
+                throw std::invalid_argument(
+                    format("The key {} is already defined", triggerKeys[i]).c_str());
+            }
+        }
+    }
+
+    template <>
+    ListRange SchemaData::internListDefault<String>(const std::vector<String> &defaultValue)
+    {
+        ListRange range{static_cast<u32>(listDefaultStrings.size()), static_cast<u32>(defaultValue.size())};
+        for (const String &value : defaultValue)
+        {
+            listDefaultStrings.push_back(intern(value.c_str(), value.length()));
+        }
+        return range;
+    }
+
+    template <>
+    ListRange SchemaData::internListDefault<i32>(const std::vector<i32> &defaultValue)
+    {
+        ListRange range{static_cast<u32>(listDefaultI32s.size()), static_cast<u32>(defaultValue.size())};
+        listDefaultI32s.insert(listDefaultI32s.end(), defaultValue.begin(), defaultValue.end());
+        return range;
+    }
+
+    template <>
+    ListRange SchemaData::internListDefault<f32>(const std::vector<f32> &defaultValue)
+    {
+        ListRange range{static_cast<u32>(listDefaultF32s.size()), static_cast<u32>(defaultValue.size())};
+        listDefaultF32s.insert(listDefaultF32s.end(), defaultValue.begin(), defaultValue.end());
+        return range;
+    }
+
+    template <>
+    ListRange SchemaData::internListDefault<bool>(const std::vector<bool> &defaultValue)
+    {
+        ListRange range{static_cast<u32>(listDefaultBools.size()), static_cast<u32>(defaultValue.size())};
+        listDefaultBools.insert(listDefaultBools.end(), defaultValue.begin(), defaultValue.end());
+        return range;
+    }
+
+    void SchemaData::setNargs(u32 index, ArgNargs nargs)
+    {
+        if (!isList(index))
+        {
+            throw std::invalid_argument(format("The argument {} is not a list", triggerKeysOf(index)).c_str());
+        }
+
+        u8 argumentFlags = flags[index] & ~(ARGUMENT_FLAG_MULTIPLE_VALUES | ARGUMENT_FLAG_OPTIONAL_VALUE);
+        switch (nargs)
+        {
+        case ArgNargs::NARGS_ONE:
+            break;
+        case ArgNargs::NARGS_ONE_OR_MORE:
+            argumentFlags |= ARGUMENT_FLAG_MULTIPLE_VALUES;
+            break;
+        case ArgNargs::NARGS_ZERO_OR_MORE:
+            argumentFlags |= ARGUMENT_FLAG_MULTIPLE_VALUES | ARGUMENT_FLAG_OPTIONAL_VALUE;
+            break;
+        default:
+            throw std::invalid_argument("The nargs is not supported");
+        }
+        flags[index] = argumentFlags;
+    }
+
+    void SchemaData::setEnvironmentName(u32 index, const String &name)
+    {
+        if (isList(index))
+        {
+            throw std::invalid_argument(
+                format("The list argument {} cannot be read from an environment variable", triggerKeysOf(index)).c_str());
+        }
+
+        if (infos[index].environmentName.length != 0)
+        {
+            throw std::invalid_argument(
+                format("The argument {} already reads an environment variable", triggerKeysOf(index)).c_str());
+        }
+
+        if (name.length() == 0)
+        {
+            throw std::invalid_argument("The environment variable name is empty");
+        }
+
+        if (environmentIndex.find(stringPool.data(), name.c_str(), name.length()) != NTT_ARGUMENT_INVALID_INDEX)
+        {
+            throw std::invalid_argument(format("The environment variable {} is already used", name).c_str());
+        }
+
+        const StringRef nameRef = intern(name.c_str(), name.length());
+        infos[index].environmentName = nameRef;
+        environmentIndex.insert(name.c_str(), nameRef, index);
+    }
+
+    u32 SchemaData::addSubcommand(const String &name, const String &description)
+    {
+        if (name.length() == 0 || name[0] == '-')
+        {
+            throw std::invalid_argument(format("The subcommand name {} is not valid", name).c_str());
+        }
+
+        if (searchSubcommand(name.c_str(), name.length()) != NTT_ARGUMENT_INVALID_INDEX ||
+            searchByKey(name) != NTT_ARGUMENT_INVALID_INDEX)
+        {
+            throw std::invalid_argument(format("The subcommand {} is already defined", name).c_str());
+        }
+
+        const u32 index = static_cast<u32>(subcommands.size());
+        const StringRef nameRef = intern(name.c_str(), name.length());
+        subcommands.push_back(SubcommandInfo{nameRef, intern(description.c_str(), description.length())});
+        subcommandIndex.insert(name.c_str(), nameRef, index);
+        return index;
+    }
+
+    u32 SchemaData::registerArgument(
+        const std::vector<String> &triggerKeys,
+        const String &description,
+        ArgParserType type,
+        bool isRequired,
+        const ArgumentValue &defaultValue,
+        const String &defaultString,
+        void *destination)
+    {
+        checkKeys(triggerKeys);
+
+        const u32 index = count();
+
+        ArgumentInfo info;
+        info.firstKey = static_cast<u32>(keys.size());
+        info.keyCount = static_cast<u32>(triggerKeys.size());
+        for (const String &triggerKey : triggerKeys)
+        {
+            const StringRef keyRef = intern(triggerKey.c_str(), triggerKey.length());
+            keys.push_back(keyRef);
+            keyIndex.insert(triggerKey.c_str(), keyRef, index);
+            keyTrie.insert(triggerKey.c_str(), triggerKey.length(), index);
+        }
+        info.description = intern(description.c_str(), description.length());
+        info.defaultString = intern(defaultString.c_str(), defaultString.length());
+        info.environmentName = StringRef{0, 0};
+        info.destination = destination;
+
+        u8 argumentFlags = 0;
+        if (isRequired)
+        {
+            argumentFlags |= ARGUMENT_FLAG_REQUIRED;
+            requiredArgumentIndexes.push_back(index);
+        }
+        if (destination != nullptr)
+        {
+            argumentFlags |= ARGUMENT_FLAG_BOUND;
+            boundArgumentIndexes.push_back(index);
+        }
+        if (type == ArgParserType::STRING)
+        {
+            stringArgumentIndexes.push_back(index);
+        }
+        if (type >= ArgParserType::STRING_LIST)
+        {
+            listArgumentIndexes.push_back(index);
+        }
+
+        types.push_back(type);
+        flags.push_back(argumentFlags);
+        infos.push_back(info);
+        defaultValues.push_back(defaultValue);
+
+        return index;
+    }
+
+    u32 SchemaData::registerPositional(
+        const String &name,
+        const String &description,
+        ArgParserType type,
+        bool isRequired,
+        bool isRepeated,
+        const PositionalCallback &visit)
+    {
+        if (name.length() == 0 || name.c_str()[0] == '-')
+        {
+            throw std::invalid_argument(format("The positional argument {} must be named without a leading -", name).c_str());
+        }
+
+        for (const PositionalInfo &positional : positionals)
+        {
+            if (viewAt(keys[infos[positional.argument].firstKey]) == name.c_str())
+            {
+                throw std::invalid_argument(format("The positional argument {} is already defined", name).c_str());
+            }
+        }
+
+        if (!positionals.empty())
+        {
+            const u32 previous = positionals.back().argument;
+            if ((flags[previous] & ARGUMENT_FLAG_MULTIPLE_VALUES) != 0)
+            {
+                throw std::invalid_argument(format("The positional argument {} cannot follow a repeated one", name).c_str());
+            }
+            if (isRequired && (flags[previous] & ARGUMENT_FLAG_REQUIRED) == 0)
+            {
+                throw std::invalid_argument(format("The required positional argument {} cannot follow an optional one", name).c_str());
+            }
+        }
+
+        const u32 index = count();
+
+        // The name is kept as the only key for the messages and the help, it is never looked up.
+        ArgumentInfo info;
+        info.firstKey = static_cast<u32>(keys.size());
+        info.keyCount = 1;
+        keys.push_back(intern(name.c_str(), name.length()));
+        info.description = intern(description.c_str(), description.length());
+        info.defaultString = intern("", 0);
+        info.environmentName = StringRef{0, 0};
+        info.destination = nullptr;
+
+        u8 argumentFlags = ARGUMENT_FLAG_POSITIONAL;
+        if (isRequired)
+        {
+            argumentFlags |= ARGUMENT_FLAG_REQUIRED;
+            requiredArgumentIndexes.push_back(index);
+        }
+        if (isRepeated)
+        {
+            argumentFlags |= ARGUMENT_FLAG_MULTIPLE_VALUES;
+        }
+
+        // The values are only handed to the visitor, the slot always reads as an empty value (the
+        //      view of a `STRING` slot is rebuilt with the others when the pool moves).
+        ArgumentValue emptyValue;
+        if (type == ArgParserType::STRING)
+        {
+            stringArgumentIndexes.push_back(index);
+        }
+        if (type >= ArgParserType::STRING_LIST)
+        {
+            emptyValue.listValue = ListRange{0, 0};
+        }
+
+        types.push_back(type);
+        flags.push_back(argumentFlags);
+        infos.push_back(info);
+        defaultValues.push_back(emptyValue);
+        positionals.push_back(PositionalInfo{index, visit});
+
+        return index;
+    }
+
+    i64 SchemaData::searchByPrefix(const char *prefix, u32 length) const
+    {
+        const u32 argument = keyTrie.resolvePrefix(prefix, length);
+        if (argument == NTT_KEY_TRIE_NO_ARGUMENT)
+        {
+            return NTT_ARGUMENT_INVALID_INDEX;
+        }
+        if (argument == NTT_KEY_TRIE_AMBIGUOUS)
+        {
+            return NTT_ARGUMENT_AMBIGUOUS_INDEX;
+        }
+        return argument;
+    }
+
+    std::vector<String> SchemaData::triggerKeysOf(u32 index) const
+    {
+        const ArgumentInfo &info = infos[index];
+        std::vector<String> triggerKeys;
+        triggerKeys.reserve(info.keyCount);
+        for (u32 i = 0; i < info.keyCount; i++)
+        {
+            triggerKeys.push_back(viewAt(keys[info.firstKey + i]).toString());
+        }
+        return triggerKeys;
+    }
+
+    ArgStatus SchemaData::findTypedArgument(const String &key, ArgParserType type, const char *typeName, u32 &index) const
+    {
+        const ArgStringView keyView(key.c_str(), key.length());
+        const i64 foundIndex = searchByKey(key);
+        if (foundIndex == NTT_ARGUMENT_INVALID_INDEX)
+        {
+            return ArgStatus(ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND, NTT_ARG_NO_INDEX, NTT_ARG_NO_INDEX, keyView);
+        }
+
+        if (types[foundIndex] != type)
+        {
+            return ArgStatus(ArgErrorCode::ARG_ERROR_TYPE_MISMATCH,
+                             NTT_ARG_NO_INDEX,
+                             static_cast<u32>(foundIndex),
+                             keyView,
+                             typeName);
+        }
+
+        index = static_cast<u32>(foundIndex);
+        return ArgStatus();
+    }
+
+    static String joinKeys(const std::vector<String> &keys)
+    {
+        std::string joined;
+        for (const String &key : keys)
+        {
+            if (!joined.empty())
+            {
+                joined.append(", ");
+            }
+            joined.append(key.c_str(), key.length());
+        }
+        return String(joined);
+    }
+
+    /**
+     * The closest keys to a missing key, the allowed distance grows with the length of the key
+     *      so that a short key is never matched with an unrelated one.
+     */
+    static String suggestionsOf(const SchemaData &schema, const ArgStringView &key)
+    {
+        const u32 maxDistance = std::min<u32>(NTT_ARGUMENT_SUGGESTION_MAX_DISTANCE, key.length() / 3);
+        if (maxDistance == 0)
+        {
+            return NTT_STRING_EMPTY;
+        }
+
+        std::vector<KeySuggestion> suggestions;
+        schema.keyTrie.suggest(key.data(), key.length(), maxDistance, NTT_ARGUMENT_SUGGESTION_LIMIT, suggestions);
+        if (suggestions.empty())
+        {
+            return NTT_STRING_EMPTY;
+        }
+
+        std::vector<String> keys;
+        for (const KeySuggestion &suggestion : suggestions)
+        {
+            keys.push_back(suggestion.key);
+        }
+        return format(", did you mean {}?", joinKeys(keys));
+    }
+
+    String formatStatus(const SchemaData &schema, const ArgStatus &status)
+    {
+        switch (status.code())
+        {
+        case ArgErrorCode::ARG_ERROR_NONE:
+            return NTT_STRING_EMPTY;
+        case ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND:
+            return format("The key {} is not found{}",
+                          status.subject().toString(),
+                          suggestionsOf(schema, status.subject()));
+        case ArgErrorCode::ARG_ERROR_MISSING_VALUE:
+            return format("The {} argument {} is not followed by a value",
+                          String(status.typeName()),
+                          schema.triggerKeysOf(status.argumentIndex()));
+        case ArgErrorCode::ARG_ERROR_INVALID_VALUE:
+            return format("The value {} of the argument {} is not a valid {}",
+                          status.subject().toString(),
+                          schema.triggerKeysOf(status.argumentIndex()),
+                          String(status.typeName()));
+        case ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED:
+            return format("The required argument {} is not provided",
+                          schema.triggerKeysOf(status.argumentIndex()));
+        case ArgErrorCode::ARG_ERROR_TYPE_MISMATCH:
+            return format("The key {} is not a {}",
+                          schema.triggerKeysOf(status.argumentIndex()),
+                          String(status.typeName()));
+        case ArgErrorCode::ARG_ERROR_RESPONSE_FILE_NOT_OPENED:
+            return format("The response file {} cannot be opened", status.subject().toString());
+        case ArgErrorCode::ARG_ERROR_RESPONSE_FILE_UNTERMINATED_QUOTE:
+            return format("The response file {} contains an unterminated quote", status.subject().toString());
+        case ArgErrorCode::ARG_ERROR_NOT_PARSED:
+            return "The result is not parsed by any schema";
+        case ArgErrorCode::ARG_ERROR_HELP_REQUESTED:
+            return "The help is requested";
+        case ArgErrorCode::ARG_ERROR_CONFIG_FILE_NOT_OPENED:
+            return format("The config file {} cannot be opened", status.subject().toString());
+        case ArgErrorCode::ARG_ERROR_CONFIG_FILE_INVALID:
+            return format("The config file {} is not valid at line {}", status.subject().toString(), status.tokenIndex());
+        case ArgErrorCode::ARG_ERROR_SNAPSHOT_INVALID:
+            return "The serialized result is not valid";
+        case ArgErrorCode::ARG_ERROR_SNAPSHOT_SCHEMA_MISMATCH:
+            return "The serialized result does not match the arguments of the parser";
+        case ArgErrorCode::ARG_ERROR_AMBIGUOUS_KEY:
+        {
+            std::vector<String> candidates;
+            schema.keyTrie.collectPrefixed(status.subject().data(),
+                                           status.subject().length(),
+                                           NTT_ARGUMENT_AMBIGUOUS_CANDIDATE_LIMIT,
+                                           candidates);
+            return format("The key {} is ambiguous, it matches {}",
+                          status.subject().toString(),
+                          joinKeys(candidates));
+        }
+        case ArgErrorCode::ARG_ERROR_STREAM_READ_FAILED:
+            return format("The token source cannot be read at the token {}", status.tokenIndex());
+        case ArgErrorCode::ARG_ERROR_STREAM_TOKEN_TOO_LONG:
+            return format("The token {} is longer than the buffer of the token source", status.tokenIndex());
+        case ArgErrorCode::ARG_ERROR_UNEXPECTED_POSITIONAL:
+            return format("The positional value {} is not expected", status.subject().toString());
+        case ArgErrorCode::ARG_ERROR_VALIDATION_FAILED:
+            return format("The value {} of the argument {} is not {}",
+                          status.subject().toString(),
+                          schema.triggerKeysOf(status.argumentIndex()),
+                          String(status.typeName()));
+        default:
+            return "Unknown error";
+        }
+    }
+
+    /**
+     * The values read from a response file are views into its mapping and the values of the
+     *      config layer are views into the schema, they are never copied.
+     */
+    static bool pointsIntoStableStorage(const SchemaData &schema, const ResultData &result, const char *data)
+    {
+        if (!schema.configChars.empty() &&
+            data >= schema.configChars.data() && data <= schema.configChars.data() + schema.configChars.size())
+        {
+            return true;
+        }
+
+        for (const std::shared_ptr<MappedFile> &file : result.mappedFiles)
+        {
+            if (data >= file->data() && data <= file->data() + file->size())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * The storage size of the element type of the list argument inside the result.
+     */
+    static u32 listStorageSize(const ResultData &result, ArgParserType type)
+    {
+        switch (type)
+        {
+        case ArgParserType::STRING_LIST:
+            return static_cast<u32>(result.stringItems.size());
+        case ArgParserType::I32_LIST:
+            return static_cast<u32>(result.i32Items.size());
+        case ArgParserType::F32_LIST:
+            return static_cast<u32>(result.f32Items.size());
+        case ArgParserType::BOOL_LIST:
+            return static_cast<u32>(result.boolItems.size());
+        case ArgParserType::STRING:
+        case ArgParserType::I32:
+        case ArgParserType::F32:
+        case ArgParserType::BOOL:
+        default:
+            return 0;
+        }
+    }
+
+    /**
+     * Copies the default values of the list argument into its range of the result, the range
+     *      must already be laid out with the count of the default values.
+     */
+    static void writeListDefault(const SchemaData &schema, ResultData &result, u32 index)
+    {
+        const ListRange &defaultRange = schema.defaultValues[index].listValue;
+        const u32 offset = result.values[index].listValue.offset;
+
+        switch (schema.types[index])
+        {
+        case ArgParserType::STRING_LIST:
+            for (u32 i = 0; i < defaultRange.count; i++)
+            {
+                result.stringItems[offset + i] = schema.viewAt(schema.listDefaultStrings[defaultRange.offset + i]);
+            }
+            break;
+        case ArgParserType::I32_LIST:
+            std::copy_n(schema.listDefaultI32s.begin() + defaultRange.offset, defaultRange.count,
+                        result.i32Items.begin() + offset);
+            break;
+        case ArgParserType::F32_LIST:
+            std::copy_n(schema.listDefaultF32s.begin() + defaultRange.offset, defaultRange.count,
+                        result.f32Items.begin() + offset);
+            break;
+        case ArgParserType::BOOL_LIST:
+            std::copy_n(schema.listDefaultBools.begin() + defaultRange.offset, defaultRange.count,
+                        result.boolItems.begin() + offset);
+            break;
+        case ArgParserType::STRING:
+        case ArgParserType::I32:
+        case ArgParserType::F32:
+        case ArgParserType::BOOL:
+        default:
+            break;
+        }
+    }
+
+    /**
+     * Copies the values of the list argument into its bound `std::vector`.
+     */
+    static void writeListBinding(const SchemaData &schema, const ResultData &result, u32 index)
+    {
+        const ListRange &range = result.values[index].listValue;
+
+        switch (schema.types[index])
+        {
+        case ArgParserType::STRING_LIST:
+        {
+            std::vector<String> &destination = schema.boundSlot<std::vector<String>>(index);
+            destination.clear();
+            destination.reserve(range.count);
+            for (u32 i = 0; i < range.count; i++)
+            {
+                destination.push_back(result.stringItems[range.offset + i].toString());
+            }
+            break;
+        }
+        case ArgParserType::I32_LIST:
+            schema.boundSlot<std::vector<i32>>(index).assign(
+                result.i32Items.begin() + range.offset,
+                result.i32Items.begin() + range.offset + range.count);
+            break;
+        case ArgParserType::F32_LIST:
+            schema.boundSlot<std::vector<f32>>(index).assign(
+                result.f32Items.begin() + range.offset,
+                result.f32Items.begin() + range.offset + range.count);
+            break;
+        case ArgParserType::BOOL_LIST:
+            schema.boundSlot<std::vector<bool>>(index).assign(
+                result.boolItems.begin() + range.offset,
+                result.boolItems.begin() + range.offset + range.count);
+            break;
+        case ArgParserType::STRING:
+        case ArgParserType::I32:
+        case ArgParserType::F32:
+        case ArgParserType::BOOL:
+        default:
+            break;
+        }
+    }
+
+    /**
+     * Applies the conversion policy when the value cannot be converted, in lenient mode the
+     *      numeric prefix of the value is kept (`12abc` gives `12`, see `parseI32Prefix`) or, if
+     *      there is none, the default value is used (`0` for a list element), in strict mode the
+     *      value is rejected.
+     *
+     * @retval true if the value is rejected.
+     */
+    static inline bool rejectsInvalidValue(const SchemaData &schema)
+    {
+        return schema.conversionPolicy == ArgConversionPolicy::STRICT_CONVERSION;
+    }
+
+    /**
+     * Counts the conversion (see `ArgParseCounters::conversions`) and passes its outcome through.
+     */
+    static inline bool countConversion(ResultData &result, bool converted)
+    {
+        NTT_ARG_INSTRUMENT(result.counters.conversions++;
+                           result.counters.conversionFailures += converted ? 0 : 1;)
+        (void)result;
+        return converted;
+    }
+
+    static inline ArgStatus invalidValue(u32 tokenIndex, u32 index, const ArgToken &value, const char *typeName)
+    {
+        return ArgStatus(ArgErrorCode::ARG_ERROR_INVALID_VALUE, tokenIndex + 1, index, value.view(), typeName);
+    }
+
+    /**
+     * The values of the config lists are not in the command line, they have no token index.
+     */
+    static inline ArgStatus invalidListItem(const ResultData &result, const ListItem &item, const ArgToken &value, const char *typeName)
+    {
+        if (item.token >= result.configTokenStart)
+        {
+            return ArgStatus(ArgErrorCode::ARG_ERROR_INVALID_VALUE, NTT_ARG_NO_INDEX, item.argument, value.view(), typeName);
+        }
+        return invalidValue(item.token, item.argument, value, typeName);
+    }
+
+    /**
+     * Lays out and converts the values of every list argument (a counting sort of `listItems` by
+     *      argument), so that the storage of each element type is sized exactly once and the
+     *      values of each argument are contiguous. The arguments which are not provided receive
+     *      their default values.
+     */
+    static ArgStatus buildLists(const SchemaData &schema, ResultData &result, bool applyBindings)
+    {
+        if (schema.listArgumentIndexes.empty())
+        {
+            return ArgStatus();
+        }
+        NTT_ARG_INSTRUMENT(ArgPhaseTimer timer(result.counters.conversionNanoseconds));
+
+        for (u32 index : schema.listArgumentIndexes)
+        {
+            result.values[index].listValue = ListRange{
+                0,
+                result.isProvided(index) ? 0 : schema.defaultValues[index].listValue.count};
+        }
+        for (const ListItem &item : result.listItems)
+        {
+            result.values[item.argument].listValue.count++;
+        }
+
+        u32 totals[NTT_ARGUMENT_LIST_KIND_COUNT] = {0, 0, 0, 0};
+        for (u32 index : schema.listArgumentIndexes)
+        {
+            ListRange &range = result.values[index].listValue;
+            u32 &total = totals[schema.types[index] - ArgParserType::STRING_LIST];
+            range.offset = total;
+            total += range.count;
+        }
+
+        result.stringItems.resize(totals[ArgParserType::STRING_LIST - ArgParserType::STRING_LIST]);
+        result.i32Items.resize(totals[ArgParserType::I32_LIST - ArgParserType::STRING_LIST]);
+        result.f32Items.resize(totals[ArgParserType::F32_LIST - ArgParserType::STRING_LIST]);
+        result.boolItems.resize(totals[ArgParserType::BOOL_LIST - ArgParserType::STRING_LIST]);
+
+        // The ranges of the provided arguments are refilled from the start, their count is used
+        //      as the write cursor.
+        for (u32 index : schema.listArgumentIndexes)
+        {
+            if (result.isProvided(index))
+            {
+                result.values[index].listValue.count = 0;
+            }
+            else
+            {
+                writeListDefault(schema, result, index);
+            }
+        }
+
+        const std::vector<ArgToken> &tokens = result.tokens;
+        u64 charCount = 0;
+        if (!schema.zeroCopyStrings)
+        {
+            for (const ListItem &item : result.listItems)
+            {
+                const ArgToken &token = tokens[item.token];
+                if (schema.types[item.argument] == ArgParserType::STRING_LIST &&
+                    (token.flags & ARG_TOKEN_FLAG_STABLE) == 0)
+                {
+                    charCount += token.length;
+                }
+            }
+        }
+        result.listChars.resize(charCount);
+        char *chars = result.listChars.data();
+
+        for (const ListItem &item : result.listItems)
+        {
+            const ArgToken &token = tokens[item.token];
+            ListRange &range = result.values[item.argument].listValue;
+            const u32 position = range.offset + range.count++;
+
+            switch (schema.types[item.argument])
+            {
+            case ArgParserType::STRING_LIST:
+                if (schema.zeroCopyStrings || (token.flags & ARG_TOKEN_FLAG_STABLE) != 0)
+                {
+                    result.stringItems[position] = token.view();
+                }
+                else
+                {
+                    memcpy(chars, token.data, token.length);
+                    result.stringItems[position] = ArgStringView(chars, token.length);
+                    chars += token.length;
+                }
+                break;
+            case ArgParserType::I32_LIST:
+                if (!countConversion(result, parseI32(token.data, token.data + token.length, result.i32Items[position])))
+                {
+                    if (rejectsInvalidValue(schema))
+                    {
+                        return invalidListItem(result, item, token, "i32");
+                    }
+                    if (!parseI32Prefix(token.data, token.data + token.length, result.i32Items[position]))
+                    {
+                        result.i32Items[position] = 0;
+                    }
+                }
+                break;
+            case ArgParserType::F32_LIST:
+                if (!countConversion(result, parseF32(token.data, token.data + token.length, result.f32Items[position])))
+                {
+                    if (rejectsInvalidValue(schema))
+                    {
+                        return invalidListItem(result, item, token, "f32");
+                    }
+                    if (!parseF32Prefix(token.data, token.data + token.length, result.f32Items[position]))
+                    {
+                        result.f32Items[position] = 0.0f;
+                    }
+                }
+                break;
+            case ArgParserType::BOOL_LIST:
+                if (!token.equals("true", 4) && !token.equals("false", 5) && rejectsInvalidValue(schema))
+                {
+                    return invalidListItem(result, item, token, "bool");
+                }
+                result.boolItems[position] = token.equals("true", 4);
+                break;
+            case ArgParserType::STRING:
+            case ArgParserType::I32:
+            case ArgParserType::F32:
+            case ArgParserType::BOOL:
+            default:
+                break;
+            }
+        }
+
+        if (!applyBindings)
+        {
+            return ArgStatus();
+        }
+
+        for (u32 index : schema.boundArgumentIndexes)
+        {
+            if (schema.isList(index))
+            {
+                writeListBinding(schema, result, index);
+            }
+        }
+        return ArgStatus();
+    }
+
+    void syncResult(const SchemaData &schema, ResultData &result, const char *oldPool)
+    {
+        const u32 oldCount = static_cast<u32>(result.values.size());
+        const String *oldOwnedStrings = result.ownedStrings.data();
+
+        result.values.insert(
+            result.values.end(),
+            schema.defaultValues.begin() + oldCount,
+            schema.defaultValues.end());
+        result.ownedStrings.resize(schema.count());
+        result.f32Texts.resize(schema.count());
+        result.providedBits.resize(
+            (schema.count() + NTT_ARGUMENT_PROVIDED_WORD_BITS - 1) / NTT_ARGUMENT_PROVIDED_WORD_BITS,
+            0);
+        result.pendingBits.resize(result.providedBits.size());
+
+        // The views of the previous arguments only need to be rebuilt if their storage is moved.
+        const bool relocated = oldPool != schema.stringPool.data() ||
+                               oldOwnedStrings != result.ownedStrings.data();
+
+        for (u32 index : schema.stringArgumentIndexes)
+        {
+            if (index < oldCount && !relocated)
+            {
+                continue;
+            }
+
+            if (!result.isProvided(index))
+            {
+                result.values[index].stringValue = schema.viewAt(schema.infos[index].defaultString);
+            }
+            else if (!schema.zeroCopyStrings &&
+                     !pointsIntoStableStorage(schema, result, result.values[index].stringValue.data()))
+            {
+                const String &owned = result.ownedStrings[index];
+                result.values[index].stringValue = ArgStringView(owned.c_str(), owned.length());
+            }
+        }
+
+        // The new list arguments are appended after the current values, the default `STRING`
+        //      values of the previous ones point into the pool.
+        for (u32 index : schema.listArgumentIndexes)
+        {
+            if (index >= oldCount)
+            {
+                ListRange &range = result.values[index].listValue;
+                range.offset = listStorageSize(result, schema.types[index]);
+                switch (schema.types[index])
+                {
+                case ArgParserType::STRING_LIST:
+                    result.stringItems.resize(range.offset + range.count);
+                    break;
+                case ArgParserType::I32_LIST:
+                    result.i32Items.resize(range.offset + range.count);
+                    break;
+                case ArgParserType::F32_LIST:
+                    result.f32Items.resize(range.offset + range.count);
+                    break;
+                case ArgParserType::BOOL_LIST:
+                    result.boolItems.resize(range.offset + range.count);
+                    break;
+                case ArgParserType::STRING:
+                case ArgParserType::I32:
+                case ArgParserType::F32:
+                case ArgParserType::BOOL:
+                default:
+                    break;
+                }
+                writeListDefault(schema, result, index);
+            }
+            else if (relocated &&
+                     schema.types[index] == ArgParserType::STRING_LIST &&
+                     !result.isProvided(index))
+            {
+                writeListDefault(schema, result, index);
+            }
+        }
+    }
+
+    void resetResult(const SchemaData &schema, ResultData &result, bool applyBindings)
+    {
+        if (result.values.size() != schema.count())
+        {
+            result.values.clear();
+            result.ownedStrings.clear();
+            result.providedBits.clear();
+            result.pendingBits.clear();
+            result.f32Texts.clear();
+            syncResult(schema, result, schema.stringPool.data());
+        }
+
+        std::copy(schema.defaultValues.begin(), schema.defaultValues.end(), result.values.begin());
+        std::fill(result.providedBits.begin(), result.providedBits.end(), 0);
+        std::fill(result.pendingBits.begin(), result.pendingBits.end(), AtomicBitWord());
+        result.mappedFiles.clear();
+        result.listItems.clear();
+        result.subcommand = NTT_ARG_NO_INDEX;
+
+        for (u32 index : schema.stringArgumentIndexes)
+        {
+            result.values[index].stringValue = schema.viewAt(schema.infos[index].defaultString);
+        }
+
+        buildLists(schema, result, applyBindings);
+
+        if (!applyBindings)
+        {
+            return;
+        }
+
+        for (u32 index : schema.boundArgumentIndexes)
+        {
+            const ArgumentValue &defaultValue = schema.defaultValues[index];
+            switch (schema.types[index])
+            {
+            case ArgParserType::STRING:
+                schema.boundSlot<String>(index) = schema.viewAt(schema.infos[index].defaultString).toString();
+                break;
+            case ArgParserType::I32:
+                schema.boundSlot<i32>(index) = defaultValue.i32Value;
+                break;
+            case ArgParserType::F32:
+                schema.boundSlot<f32>(index) = defaultValue.f32Value;
+                break;
+            case ArgParserType::BOOL:
+                schema.boundSlot<bool>(index) = defaultValue.boolValue;
+                break;
+            case ArgParserType::STRING_LIST:
+            case ArgParserType::I32_LIST:
+            case ArgParserType::F32_LIST:
+            case ArgParserType::BOOL_LIST:
+            default:
+                // The bound lists are written by `buildLists`.
+                break;
+            }
+        }
+    }
+
+    /**
+     * Writes the parsed values either into the result or into the bound storages.
+     */
+    class ArgumentWriter
+    {
+    public:
+        ArgumentWriter(const SchemaData &schema, ResultData &result, bool applyBindings)
+            : m_schema(schema),
+              m_result(result),
+              m_applyBindings(applyBindings),
+              m_lazyConversion(applyBindings && schema.lazyConversion)
+        {
+        }
+
+        inline void storeString(u32 index, const ArgToken &value)
+        {
+            if (isBound(index))
+            {
+                m_schema.boundSlot<String>(index) = value.view().toString();
+            }
+            else if ((m_schema.zeroCopyStrings && (value.flags & ARG_TOKEN_FLAG_TRANSIENT) == 0) ||
+                     (value.flags & ARG_TOKEN_FLAG_STABLE) != 0)
+            {
+                m_result.values[index].stringValue = value.view();
+            }
+            else
+            {
+                String &owned = m_result.ownedStrings[index];
+                owned = value.view().toString();
+                m_result.values[index].stringValue = ArgStringView(owned.c_str(), owned.length());
+            }
+            m_result.markProvided(index);
+        }
+
+        /**
+         * @retval false if the value is rejected by the conversion policy, nothing is stored.
+         */
+        inline bool storeI32(u32 index, const ArgToken &value)
+        {
+            if (storeRaw(index, value))
+            {
+                return true;
+            }
+
+            NTT_ARG_INSTRUMENT(ArgPhaseTimer timer(m_result.counters.conversionNanoseconds));
+            i32 converted = 0;
+            if (!countConversion(m_result, parseI32(value.data, value.data + value.length, converted)))
+            {
+                if (rejectsInvalidValue(m_schema))
+                {
+                    return false;
+                }
+                if (!parseI32Prefix(value.data, value.data + value.length, converted))
+                {
+                    converted = m_schema.defaultValues[index].i32Value;
+                }
+            }
+
+            if (isBound(index))
+            {
+                m_schema.boundSlot<i32>(index) = converted;
+            }
+            else
+            {
+                m_result.values[index].i32Value = converted;
+            }
+            m_result.markProvided(index);
+            return true;
+        }
+
+        /**
+         * @retval false if the value is rejected by the conversion policy, nothing is stored.
+         */
+        inline bool storeF32(u32 index, const ArgToken &value)
+        {
+            if ((m_schema.flags[index] & ARGUMENT_FLAG_VALIDATED) != 0)
+            {
+                m_result.f32Texts[index].assign(value.data, value.length);
+            }
+
+            if (storeRaw(index, value))
+            {
+                return true;
+            }
+
+            NTT_ARG_INSTRUMENT(ArgPhaseTimer timer(m_result.counters.conversionNanoseconds));
+            f32 converted = 0.0f;
+            if (!countConversion(m_result, parseF32(value.data, value.data + value.length, converted)))
+            {
+                if (rejectsInvalidValue(m_schema))
+                {
+                    return false;
+                }
+                if (!parseF32Prefix(value.data, value.data + value.length, converted))
+                {
+                    converted = m_schema.defaultValues[index].f32Value;
+                }
+            }
+
+            if (isBound(index))
+            {
+                m_schema.boundSlot<f32>(index) = converted;
+            }
+            else
+            {
+                m_result.values[index].f32Value = converted;
+            }
+            m_result.markProvided(index);
+            return true;
+        }
+
+        inline void storeBool(u32 index, bool value)
+        {
+            if (isBound(index))
+            {
+                m_schema.boundSlot<bool>(index) = value;
+            }
+            else
+            {
+                m_result.values[index].boolValue = value;
+            }
+            m_result.markProvided(index);
+        }
+
+    private:
+        inline bool isBound(u32 index) const
+        {
+            return m_applyBindings && m_schema.isBound(index);
+        }
+
+        /**
+         * Only keeps the token in lazy mode (the bound storages are always converted).
+         *
+         * @retval true if the value is stored as a raw token.
+         */
+        inline bool storeRaw(u32 index, const ArgToken &value)
+        {
+            if (!m_lazyConversion || m_schema.isBound(index) || (value.flags & ARG_TOKEN_FLAG_TRANSIENT) != 0)
+            {
+                return false;
+            }
+
+            m_result.values[index].stringValue = value.view();
+            m_result.markPending(index);
+            m_result.markProvided(index);
+            return true;
+        }
+
+    private:
+        const SchemaData &m_schema;
+        ResultData &m_result;
+        bool m_applyBindings;
+        bool m_lazyConversion;
+    };
+
+    /**
+     * Converts and caches the raw token of a lazily parsed argument.
+     */
+    ArgStatus resolvePending(const SchemaData &schema, ResultData &result, u32 index)
+    {
+        if (!result.isPending(index))
+        {
+            return ArgStatus();
+        }
+
+        NTT_ARG_INSTRUMENT(ArgPhaseTimer timer(result.counters.conversionNanoseconds));
+        const ArgStringView raw = result.values[index].stringValue;
+        const char *end = raw.data() + raw.length();
+
+        switch (schema.types[index])
+        {
+        case ArgParserType::I32:
+        {
+            i32 converted = 0;
+            if (!countConversion(result, parseI32(raw.data(), end, converted)))
+            {
+                if (rejectsInvalidValue(schema))
+                {
+                    return ArgStatus(ArgErrorCode::ARG_ERROR_INVALID_VALUE, NTT_ARG_NO_INDEX, index, raw, "i32");
+                }
+                if (!parseI32Prefix(raw.data(), end, converted))
+                {
+                    converted = schema.defaultValues[index].i32Value;
+                }
+            }
+            result.values[index].i32Value = converted;
+            break;
+        }
+        case ArgParserType::F32:
+        {
+            f32 converted = 0.0f;
+            if (!countConversion(result, parseF32(raw.data(), end, converted)))
+            {
+                if (rejectsInvalidValue(schema))
+                {
+                    return ArgStatus(ArgErrorCode::ARG_ERROR_INVALID_VALUE, NTT_ARG_NO_INDEX, index, raw, "f32");
+                }
+                if (!parseF32Prefix(raw.data(), end, converted))
+                {
+                    converted = schema.defaultValues[index].f32Value;
+                }
+            }
+            result.values[index].f32Value = converted;
+            break;
+        }
+        case ArgParserType::STRING:
+        case ArgParserType::BOOL:
+        case ArgParserType::STRING_LIST:
+        case ArgParserType::I32_LIST:
+        case ArgParserType::F32_LIST:
+        case ArgParserType::BOOL_LIST:
+        default:
+            break;
+        }
+
+        result.clearPending(index);
+        return ArgStatus();
+    }
+
+    ArgStatus resolveAllPending(const SchemaData &schema, ResultData &result)
+    {
+        for (u32 word = 0; word < result.pendingBits.size(); word++)
+        {
+            // Only the set bits are visited, the arguments which are not pending cost nothing.
+            u64 bits = result.pendingBits[word].bits.load(std::memory_order_relaxed);
+            while (bits != 0)
+            {
+                u32 bit = 0;
+                while (((bits >> bit) & 1u) == 0)
+                {
+                    bit++;
+                }
+                bits &= bits - 1;
+
+                const ArgStatus status = resolvePending(schema, result, word * NTT_ARGUMENT_PROVIDED_WORD_BITS + bit);
+                if (!status.ok())
+                {
+                    return status;
+                }
+            }
+        }
+        return ArgStatus();
+    }
+
+    /**
+     * Collects the tokens of the command line (without the program name) into the reused buffer
+     *      of the result, the `@file` tokens are replaced by the content of the response file.
+     */
+    static ArgStatus collectTokens(const SchemaData &schema, ResultData &result, u32 argc, char **argv)
+    {
+        std::vector<ArgToken> &tokens = result.tokens;
+        tokens.clear();
+
+        for (u32 i = 1; i < argc; i++)
+        {
+            const char *arg = argv[i];
+            const u32 length = static_cast<u32>(strlen(arg));
+            if (!schema.responseFiles || arg[0] != '@')
+            {
+                tokens.push_back(ArgToken{arg, length, 0});
+                continue;
+            }
+
+            const ArgStringView path(arg + 1, length - 1);
+            const u32 tokenIndex = static_cast<u32>(tokens.size()) + 1;
+
+            std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+            if (!file->open(arg + 1))
+            {
+                return ArgStatus(ArgErrorCode::ARG_ERROR_RESPONSE_FILE_NOT_OPENED, tokenIndex, NTT_ARG_NO_INDEX, path);
+            }
+
+            if (!tokenizeResponseFile(file->data(), file->size(), ARG_TOKEN_FLAG_STABLE, tokens))
+            {
+                return ArgStatus(ArgErrorCode::ARG_ERROR_RESPONSE_FILE_UNTERMINATED_QUOTE, tokenIndex, NTT_ARG_NO_INDEX, path);
+            }
+
+            result.mappedFiles.push_back(std::move(file));
+        }
+
+        return ArgStatus();
+    }
+
+    static inline char **currentEnvironment()
+    {
+#ifdef NTT_PLATFORM_UNIX
+        return environ;
+#else
+        return _environ;
+#endif
+    }
+
+    /**
+     * Stores a value which does not come from the command line (environment, config file) into
+     *      a scalar argument. The value goes through the same conversions as the command line
+     *      values, the boolean accepts `true`/`1` and `false`/`0`. The failure has no token index.
+     */
+    static ArgStatus storeSourceValue(const SchemaData &schema, u32 index, const ArgToken &value, ArgumentWriter &writer)
+    {
+        switch (schema.types[index])
+        {
+        case ArgParserType::STRING:
+            writer.storeString(index, value);
+            break;
+        case ArgParserType::I32:
+            if (!writer.storeI32(index, value))
+            {
+                return ArgStatus(ArgErrorCode::ARG_ERROR_INVALID_VALUE, NTT_ARG_NO_INDEX, index, value.view(), "i32");
+            }
+            break;
+        case ArgParserType::F32:
+            if (!writer.storeF32(index, value))
+            {
+                return ArgStatus(ArgErrorCode::ARG_ERROR_INVALID_VALUE, NTT_ARG_NO_INDEX, index, value.view(), "f32");
+            }
+            break;
+        case ArgParserType::BOOL:
+            if (value.equals("true", 4) || value.equals("1", 1))
+            {
+                writer.storeBool(index, true);
+            }
+            else if (value.equals("false", 5) || value.equals("0", 1))
+            {
+                writer.storeBool(index, false);
+            }
+            else if (rejectsInvalidValue(schema))
+            {
+                return ArgStatus(ArgErrorCode::ARG_ERROR_INVALID_VALUE, NTT_ARG_NO_INDEX, index, value.view(), "bool");
+            }
+            else
+            {
+                writer.storeBool(index, schema.defaultValues[index].boolValue);
+            }
+            break;
+        case ArgParserType::STRING_LIST:
+        case ArgParserType::I32_LIST:
+        case ArgParserType::F32_LIST:
+        case ArgParserType::BOOL_LIST:
+        default:
+            break;
+        }
+        return ArgStatus();
+    }
+
+    /**
+     * Fills the arguments which are not given by the command line from their environment
+     *      variables. The environment is scanned once, each `NAME=value` entry is looked up in the
+     *      hashed set of the declared names (the lists cannot declare a variable).
+     */
+    static ArgStatus readEnvironment(const SchemaData &schema, ResultData &result, ArgumentWriter &writer)
+    {
+        char **environment = currentEnvironment();
+        if (environment == nullptr)
+        {
+            return ArgStatus();
+        }
+
+        for (char **entry = environment; *entry != nullptr; entry++)
+        {
+            const char *variable = *entry;
+            const char *separator = strchr(variable, '=');
+            if (separator == nullptr)
+            {
+                continue;
+            }
+
+            const i64 found = schema.environmentIndex.find(
+                schema.stringPool.data(), variable, static_cast<u32>(separator - variable));
+            if (found == NTT_ARGUMENT_INVALID_INDEX || result.isProvided(static_cast<u32>(found)))
+            {
+                continue;
+            }
+
+            // `setenv` may free the entry, the value is copied (or converted) like a streamed token.
+            const ArgToken value{separator + 1, static_cast<u32>(strlen(separator + 1)), ARG_TOKEN_FLAG_TRANSIENT};
+            const ArgStatus status = storeSourceValue(schema, static_cast<u32>(found), value, writer);
+            if (!status.ok())
+            {
+                return status;
+            }
+        }
+
+        return ArgStatus();
+    }
+
+    /**
+     * Applies the config layer to the arguments which are not given by the command line or the
+     *      environment. The values are views into the schema, the list values are appended to
+     *      the tokens so that they are laid out with the command line values.
+     */
+    static ArgStatus applyConfig(const SchemaData &schema, ResultData &result, ArgumentWriter &writer)
+    {
+        result.configSkipBits.assign(result.providedBits.begin(), result.providedBits.end());
+
+        for (const ConfigEntry &entry : schema.configEntries)
+        {
+            const u32 index = entry.argument;
+            if ((result.configSkipBits[index / NTT_ARGUMENT_PROVIDED_WORD_BITS] >>
+                 (index % NTT_ARGUMENT_PROVIDED_WORD_BITS)) &
+                1u)
+            {
+                continue;
+            }
+
+            if (entry.offset == NTT_ARG_NO_INDEX)
+            {
+                result.markProvided(index);
+                continue;
+            }
+
+            const ArgToken value{schema.configChars.data() + entry.offset, entry.length, ARG_TOKEN_FLAG_STABLE};
+            if (schema.isList(index))
+            {
+                result.tokens.push_back(value);
+                result.listItems.push_back(ListItem{index, static_cast<u32>(result.tokens.size() - 1)});
+                result.markProvided(index);
+                continue;
+            }
+
+            const ArgStatus status = storeSourceValue(schema, index, value, writer);
+            if (!status.ok())
+            {
+                return status;
+            }
+        }
+
+        return ArgStatus();
+    }
+
+    /**
+     * The values of a multiple values list run until a key, a subcommand or (with the prefix
+     *      matching) a token which is the prefix of a key.
+     */
+    static inline bool endsListValues(const SchemaData &schema, const ArgToken &token)
+    {
+        return schema.searchByKey(token.data, token.length) != NTT_ARGUMENT_INVALID_INDEX ||
+               (!schema.positionals.empty() && token.equals("--", 2)) ||
+               (!schema.subcommands.empty() &&
+                schema.searchSubcommand(token.data, token.length) != NTT_ARGUMENT_INVALID_INDEX) ||
+               (schema.matchesByPrefix(token.data, token.length) &&
+                schema.searchByPrefix(token.data, token.length) != NTT_ARGUMENT_INVALID_INDEX);
+    }
+
+    static inline ArgStatus missingValue(u32 tokenIndex, u32 index, const ArgToken &key, const char *typeName)
+    {
+        return ArgStatus(ArgErrorCode::ARG_ERROR_MISSING_VALUE, tokenIndex + 1, index, key.view(), typeName);
+    }
+
+    static inline i64 lookupKey(const SchemaData &schema, ResultData &result, const ArgToken &token)
+    {
+#ifdef NTT_ARG_INSTRUMENTATION
+        result.counters.keyLookups++;
+        return schema.searchByKey(token.data, token.length, result.counters.keyComparisons);
+#else
+        (void)result;
+        return schema.searchByKey(token.data, token.length);
+#endif
+    }
+
+    /**
+     * Where the next positional token of a parse goes.
+     */
+    struct PositionalCursor
+    {
+        /**
+         * The index inside `SchemaData::positionals` and the number of values which it has
+         *      already received.
+         */
+        u32 positional = 0;
+        u32 valueCount = 0;
+
+        /**
+         * Set by the `--` token, every following token is positional.
+         */
+        bool isOptionsEnded = false;
+    };
+
+    /**
+     * @retval true if the token which is not a key goes to the positional arguments: it does not
+     *      start with `-` (a lone `-` does, it usually means the standard input). The other
+     *      tokens (`-5` as well) are only positional after `--`.
+     */
+    static inline bool isPositionalToken(const SchemaData &schema, const ArgToken &token)
+    {
+        return !schema.positionals.empty() && (token.length < 2 || token.data[0] != '-');
+    }
+
+    /**
+     * Converts the token and passes it to the visitor of the current positional argument, the
+     *      value is not stored anywhere.
+     *
+     * @param tokenIndex The index of the token for the failures.
+     */
+    static ArgStatus visitPositional(
+        const SchemaData &schema,
+        ResultData &result,
+        PositionalCursor &cursor,
+        const ArgToken &token,
+        u32 tokenIndex)
+    {
+        if (cursor.positional >= schema.positionals.size())
+        {
+            return ArgStatus(ArgErrorCode::ARG_ERROR_UNEXPECTED_POSITIONAL, tokenIndex, NTT_ARG_NO_INDEX, token.view());
+        }
+
+        const PositionalInfo &positional = schema.positionals[cursor.positional];
+        const u32 index = positional.argument;
+        ArgumentValue value;
+        bool converted = true;
+        const char *typeName = "";
+
+        NTT_ARG_INSTRUMENT(ArgPhaseTimer timer(result.counters.conversionNanoseconds));
+        switch (schema.types[index])
+        {
+        case ArgParserType::STRING:
+            value.stringValue = token.view();
+            break;
+        case ArgParserType::I32:
+            typeName = "i32";
+            converted = countConversion(result, parseI32(token.data, token.data + token.length, value.i32Value));
+            break;
+        case ArgParserType::F32:
+            typeName = "f32";
+            converted = countConversion(result, parseF32(token.data, token.data + token.length, value.f32Value));
+            break;
+        case ArgParserType::BOOL:
+            typeName = "bool";
+            value.boolValue = token.equals("true", 4);
+            converted = value.boolValue || token.equals("false", 5);
+            break;
+        case ArgParserType::STRING_LIST:
+        case ArgParserType::I32_LIST:
+        case ArgParserType::F32_LIST:
+        case ArgParserType::BOOL_LIST:
+        default:
+            throw std::invalid_argument("The type is not supported");
+        }
+        NTT_ARG_INSTRUMENT(timer.stop());
+
+        if (!converted)
+        {
+            if (rejectsInvalidValue(schema))
+            {
+                return ArgStatus(ArgErrorCode::ARG_ERROR_INVALID_VALUE, tokenIndex, index, token.view(), typeName);
+            }
+            value = schema.defaultValues[index];
+            if (schema.types[index] == ArgParserType::I32)
+            {
+                parseI32Prefix(token.data, token.data + token.length, value.i32Value);
+            }
+            else if (schema.types[index] == ArgParserType::F32)
+            {
+                parseF32Prefix(token.data, token.data + token.length, value.f32Value);
+            }
+        }
+
+        positional.visit(cursor.valueCount, value);
+        result.markProvided(index);
+
+        cursor.valueCount++;
+        if ((schema.flags[index] & ARGUMENT_FLAG_MULTIPLE_VALUES) == 0)
+        {
+            cursor.positional++;
+            cursor.valueCount = 0;
+        }
+        return ArgStatus();
+    }
+
+    /**
+     * The environment variables, the config layer, the lists, the required arguments and the
+     *      validators, once the tokens are parsed.
+     *
+     * @param isStreamed If `true` the list tokens are not the tokens of the command line, their
+     *      invalid values have no token index.
+     */
+    static ArgStatus finishTokens(
+        const SchemaData &schema,
+        ResultData &result,
+        ArgumentWriter &writer,
+        bool applyBindings,
+        bool isStreamed)
+    {
+        ArgStatus status;
+        NTT_ARG_INSTRUMENT(ArgPhaseTimer sourceTimer(result.counters.sourceNanoseconds,
+                                                     &result.counters.conversionNanoseconds);)
+        if (schema.environmentIndex.count != 0)
+        {
+            status = readEnvironment(schema, result, writer);
+            if (!status.ok())
+            {
+                return status;
+            }
+        }
+
+        result.configTokenStart = isStreamed ? 0 : static_cast<u32>(result.tokens.size());
+        if (!schema.configEntries.empty())
+        {
+            status = applyConfig(schema, result, writer);
+            if (!status.ok())
+            {
+                return status;
+            }
+        }
+
+        NTT_ARG_INSTRUMENT(sourceTimer.stop());
+
+        status = buildLists(schema, result, applyBindings);
+        if (!status.ok())
+        {
+            return status;
+        }
+
+        NTT_ARG_INSTRUMENT(ArgPhaseTimer requiredTimer(result.counters.requiredCheckNanoseconds));
+        for (u32 index : schema.requiredArgumentIndexes)
+        {
+            if (!result.isProvided(index))
+            {
+                return ArgStatus(ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED, NTT_ARG_NO_INDEX, index);
+            }
+        }
+        NTT_ARG_INSTRUMENT(requiredTimer.stop());
+
+        if (schema.validators.empty())
+        {
+            return ArgStatus();
+        }
+
+        NTT_ARG_INSTRUMENT(ArgPhaseTimer validationTimer(result.counters.validationNanoseconds));
+        return validateArguments(schema, result, applyBindings);
+    }
+
+    static ArgStatus parseCommandLine(
+        const SchemaData &schema,
+        ResultData &result,
+        u32 argc,
+        char **argv,
+        bool applyBindings)
+    {
+        resetResult(schema, result, applyBindings);
+
+        const ArgStatus status = collectTokens(schema, result, argc, argv);
+        if (!status.ok())
+        {
+            return status;
+        }
+
+        return parseTokens(schema, result, applyBindings);
+    }
+
+    ArgStatus parseArguments(
+        const SchemaData &schema,
+        ResultData &result,
+        u32 argc,
+        char **argv,
+        bool applyBindings)
+    {
+        NTT_ARG_INSTRUMENT(ArgParseMeasure measure(result.counters));
+        const ArgStatus status = parseCommandLine(schema, result, argc, argv, applyBindings);
+        NTT_ARG_INSTRUMENT(measure.finish(status.ok()));
+        return status;
+    }
+
+    ArgStatus parseTokens(const SchemaData &schema, ResultData &result, bool applyBindings)
+    {
+        const std::vector<ArgToken> &tokens = result.tokens;
+        const u32 tokenCount = static_cast<u32>(tokens.size());
+        ArgumentWriter writer(schema, result, applyBindings);
+
+        if (!schema.listArgumentIndexes.empty())
+        {
+            result.listItems.reserve(tokenCount);
+        }
+        i64 currentIndex = NTT_ARGUMENT_INVALID_INDEX;
+        PositionalCursor cursor;
+
+        // The conversions of the loop have their own phase.
+        NTT_ARG_INSTRUMENT(result.counters.tokens += tokenCount;
+                           ArgPhaseTimer lookupTimer(result.counters.lookupNanoseconds,
+                                                     &result.counters.conversionNanoseconds);)
+
+        for (u32 i = 0; i < tokenCount; i++)
+        {
+            const ArgToken &token = tokens[i];
+            if (cursor.isOptionsEnded)
+            {
+                const ArgStatus status = visitPositional(schema, result, cursor, token, i + 1);
+                if (!status.ok())
+                {
+                    return status;
+                }
+                continue;
+            }
+
+            currentIndex = lookupKey(schema, result, token);
+
+            if (currentIndex == NTT_ARGUMENT_INVALID_INDEX)
+            {
+                const i64 subcommand = schema.subcommands.empty()
+                                           ? NTT_ARGUMENT_INVALID_INDEX
+                                           : schema.searchSubcommand(token.data, token.length);
+                if (subcommand != NTT_ARGUMENT_INVALID_INDEX)
+                {
+                    // The remaining tokens belong to the subcommand.
+                    result.subcommand = static_cast<u32>(subcommand);
+                    result.subcommandToken = i;
+                    break;
+                }
+
+                if (isHelpKey(token))
+                {
+                    return ArgStatus(ArgErrorCode::ARG_ERROR_HELP_REQUESTED, i + 1, NTT_ARG_NO_INDEX, token.view());
+                }
+
+                if (!schema.positionals.empty() && token.equals("--", 2))
+                {
+                    cursor.isOptionsEnded = true;
+                    continue;
+                }
+
+                if (isPositionalToken(schema, token))
+                {
+                    const ArgStatus status = visitPositional(schema, result, cursor, token, i + 1);
+                    if (!status.ok())
+                    {
+                        return status;
+                    }
+                    continue;
+                }
+
+                if (schema.matchesByPrefix(token.data, token.length))
+                {
+                    currentIndex = schema.searchByPrefix(token.data, token.length);
+                }
+
+                if (currentIndex == NTT_ARGUMENT_AMBIGUOUS_INDEX)
+                {
+                    return ArgStatus(ArgErrorCode::ARG_ERROR_AMBIGUOUS_KEY, i + 1, NTT_ARG_NO_INDEX, token.view());
+                }
+
+                if (currentIndex == NTT_ARGUMENT_INVALID_INDEX)
+                {
+                    return ArgStatus(ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND, i + 1, NTT_ARG_NO_INDEX, token.view());
+                }
+            }
+
+            const u32 index = static_cast<u32>(currentIndex);
+
+            switch (schema.types[index])
+            {
+            case ArgParserType::STRING:
+                if (i + 1 >= tokenCount)
+                {
+                    return missingValue(i, index, token, "string");
+                }
+
+                writer.storeString(index, tokens[i + 1]);
+                i++;
+                break;
+            case ArgParserType::I32:
+                if (i + 1 >= tokenCount)
+                {
+                    return missingValue(i, index, token, "i32");
+                }
+
+                if (!writer.storeI32(index, tokens[i + 1]))
+                {
+                    return invalidValue(i + 1, index, tokens[i + 1], "i32");
+                }
+                i++;
+                break;
+            case ArgParserType::F32:
+                if (i + 1 >= tokenCount)
+                {
+                    return missingValue(i, index, token, "f32");
+                }
+
+                if (!writer.storeF32(index, tokens[i + 1]))
+                {
+                    return invalidValue(i + 1, index, tokens[i + 1], "f32");
+                }
+                i++;
+                break;
+            case ArgParserType::BOOL:
+                // The explicit value is optional, the flag alone means `true`.
+                if (i + 1 < tokenCount &&
+                    (tokens[i + 1].equals("true", 4) || tokens[i + 1].equals("false", 5)))
+                {
+                    writer.storeBool(index, tokens[i + 1].equals("true", 4));
+                    i++;
+                }
+                else
+                {
+                    writer.storeBool(index, true);
+                }
+                break;
+            case ArgParserType::STRING_LIST:
+            case ArgParserType::I32_LIST:
+            case ArgParserType::F32_LIST:
+            case ArgParserType::BOOL_LIST:
+            {
+                // The values are only recorded here, they are converted by `buildLists`.
+                const bool multipleValues = (schema.flags[index] & ARGUMENT_FLAG_MULTIPLE_VALUES) != 0;
+                const u32 keyTokenIndex = i;
+                u32 valueCount = 0;
+                while (i + 1 < tokenCount &&
+                       (valueCount == 0 || multipleValues) &&
+                       (!multipleValues || !endsListValues(schema, tokens[i + 1])))
+                {
+                    result.listItems.push_back(ListItem{index, i + 1});
+                    valueCount++;
+                    i++;
+                }
+
+                if (valueCount == 0 && (schema.flags[index] & ARGUMENT_FLAG_OPTIONAL_VALUE) == 0)
+                {
+                    return missingValue(keyTokenIndex, index, token, "list");
+                }
+
+                result.markProvided(index);
+                break;
+            }
+            default:
+                throw std::invalid_argument("The type is not supported");
+            }
+        }
+
+        NTT_ARG_INSTRUMENT(lookupTimer.stop());
+        return finishTokens(schema, result, writer, applyBindings, false);
+    }
+
+    /**
+     * Reads the next token of the stream, it is only valid until the following read.
+     */
+    static inline bool nextStreamToken(ArgTokenSource &source, ArgToken &token)
+    {
+        ArgStringView view;
+        if (!source.next(view))
+        {
+            return false;
+        }
+        token = ArgToken{view.data(), view.length(), ARG_TOKEN_FLAG_TRANSIENT};
+        return true;
+    }
+
+    /**
+     * The stream ends before a value of the argument, either it is read completely or its source
+     *      fails at `position`.
+     */
+    static inline ArgStatus streamEnded(
+        const ArgTokenSource &source,
+        u32 position,
+        u32 keyPosition,
+        u32 index,
+        const char *typeName)
+    {
+        if (source.getError() != ArgErrorCode::ARG_ERROR_NONE)
+        {
+            return ArgStatus(source.getError(), position, NTT_ARG_NO_INDEX);
+        }
+
+        // The key may be moved by the last read, it is not kept as the subject.
+        return ArgStatus(ArgErrorCode::ARG_ERROR_MISSING_VALUE, keyPosition, index, ArgStringView(), typeName);
+    }
+
+    /**
+     * Copies the value of a list argument out of the buffer of the source, the token is pointed
+     *      into `streamChars` by `anchorStreamTokens`.
+     */
+    static inline void keepStreamToken(ResultData &result, u32 index, const ArgToken &token)
+    {
+        result.listItems.push_back(ListItem{index, static_cast<u32>(result.tokens.size())});
+        result.tokens.push_back(ArgToken{nullptr, token.length, ARG_TOKEN_FLAG_STABLE});
+        result.streamChars.insert(result.streamChars.end(), token.data, token.data + token.length);
+    }
+
+    static inline void anchorStreamTokens(ResultData &result)
+    {
+        const char *chars = result.streamChars.data();
+        for (ArgToken &token : result.tokens)
+        {
+            token.data = chars;
+            chars += token.length;
+        }
+    }
+
+    static ArgStatus parseStreamTokens(
+        const SchemaData &schema,
+        ResultData &result,
+        ArgTokenSource &source,
+        bool applyBindings)
+    {
+        resetResult(schema, result, applyBindings);
+        result.tokens.clear();
+        result.streamChars.clear();
+        ArgumentWriter writer(schema, result, applyBindings);
+
+        NTT_ARG_INSTRUMENT(ArgPhaseTimer lookupTimer(result.counters.lookupNanoseconds,
+                                                     &result.counters.conversionNanoseconds);)
+
+        // The position of `token` inside the stream, from `1` like the indexes of the `argv`.
+        u32 position = 1;
+        ArgToken token;
+        bool hasToken = nextStreamToken(source, token);
+        PositionalCursor cursor;
+
+        while (hasToken)
+        {
+            i64 currentIndex = cursor.isOptionsEnded ? NTT_ARGUMENT_INVALID_INDEX : lookupKey(schema, result, token);
+            if (currentIndex == NTT_ARGUMENT_INVALID_INDEX)
+            {
+                if (cursor.isOptionsEnded || isPositionalToken(schema, token))
+                {
+                    const ArgStatus status = visitPositional(schema, result, cursor, token, position);
+                    if (!status.ok())
+                    {
+                        return status;
+                    }
+                    position++;
+                    hasToken = nextStreamToken(source, token);
+                    continue;
+                }
+
+                if (isHelpKey(token))
+                {
+                    return ArgStatus(ArgErrorCode::ARG_ERROR_HELP_REQUESTED, position, NTT_ARG_NO_INDEX, token.view());
+                }
+
+                if (!schema.positionals.empty() && token.equals("--", 2))
+                {
+                    cursor.isOptionsEnded = true;
+                    position++;
+                    hasToken = nextStreamToken(source, token);
+                    continue;
+                }
+
+                if (schema.matchesByPrefix(token.data, token.length))
+                {
+                    currentIndex = schema.searchByPrefix(token.data, token.length);
+                }
+
+                if (currentIndex == NTT_ARGUMENT_AMBIGUOUS_INDEX)
+                {
+                    return ArgStatus(ArgErrorCode::ARG_ERROR_AMBIGUOUS_KEY, position, NTT_ARG_NO_INDEX, token.view());
+                }
+
+                if (currentIndex == NTT_ARGUMENT_INVALID_INDEX)
+                {
+                    return ArgStatus(ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND, position, NTT_ARG_NO_INDEX, token.view());
+                }
+            }
+
+            const u32 index = static_cast<u32>(currentIndex);
+            const u32 keyPosition = position;
+
+            switch (schema.types[index])
+            {
+            case ArgParserType::STRING:
+                position++;
+                if (!nextStreamToken(source, token))
+                {
+                    return streamEnded(source, position, keyPosition, index, "string");
+                }
+
+                writer.storeString(index, token);
+                break;
+            case ArgParserType::I32:
+                position++;
+                if (!nextStreamToken(source, token))
+                {
+                    return streamEnded(source, position, keyPosition, index, "i32");
+                }
+
+                if (!writer.storeI32(index, token))
+                {
+                    return invalidValue(position - 1, index, token, "i32");
+                }
+                break;
+            case ArgParserType::F32:
+                position++;
+                if (!nextStreamToken(source, token))
+                {
+                    return streamEnded(source, position, keyPosition, index, "f32");
+                }
+
+                if (!writer.storeF32(index, token))
+                {
+                    return invalidValue(position - 1, index, token, "f32");
+                }
+                break;
+            case ArgParserType::BOOL:
+                // The explicit value is optional, the flag alone means `true`.
+                position++;
+                hasToken = nextStreamToken(source, token);
+                if (hasToken && (token.equals("true", 4) || token.equals("false", 5)))
+                {
+                    writer.storeBool(index, token.equals("true", 4));
+                    break;
+                }
+
+                // The token which is read is the next key.
+                writer.storeBool(index, true);
+                continue;
+            case ArgParserType::STRING_LIST:
+            case ArgParserType::I32_LIST:
+            case ArgParserType::F32_LIST:
+            case ArgParserType::BOOL_LIST:
+            {
+                const bool multipleValues = (schema.flags[index] & ARGUMENT_FLAG_MULTIPLE_VALUES) != 0;
+                u32 valueCount = 0;
+                position++;
+                hasToken = nextStreamToken(source, token);
+                while (hasToken &&
+                       (valueCount == 0 || multipleValues) &&
+                       (!multipleValues || !endsListValues(schema, token)))
+                {
+                    keepStreamToken(result, index, token);
+                    valueCount++;
+                    position++;
+                    hasToken = nextStreamToken(source, token);
+                }
+
+                if (valueCount == 0 && (schema.flags[index] & ARGUMENT_FLAG_OPTIONAL_VALUE) == 0)
+                {
+                    return streamEnded(source, position, keyPosition, index, "list");
+                }
+
+                // The token which is read is the next key.
+                result.markProvided(index);
+                continue;
+            }
+            default:
+                throw std::invalid_argument("The type is not supported");
+            }
+
+            position++;
+            hasToken = nextStreamToken(source, token);
+        }
+
+        if (source.getError() != ArgErrorCode::ARG_ERROR_NONE)
+        {
+            return ArgStatus(source.getError(), position, NTT_ARG_NO_INDEX);
+        }
+
+        anchorStreamTokens(result);
+        NTT_ARG_INSTRUMENT(lookupTimer.stop());
+        return finishTokens(schema, result, writer, applyBindings, true);
+    }
+
+    ArgStatus parseStream(const SchemaData &schema, ResultData &result, ArgTokenSource &source, bool applyBindings)
+    {
+        NTT_ARG_INSTRUMENT(ArgParseMeasure measure(result.counters);
+                           const u64 firstToken = source.getTokenCount();)
+        const ArgStatus status = parseStreamTokens(schema, result, source, applyBindings);
+        NTT_ARG_INSTRUMENT(result.counters.tokens += source.getTokenCount() - firstToken;
+                           measure.finish(status.ok());)
+        return status;
+    }
+} // namespace NTT_NS
@@ -0,0 +1,933 @@
+#pragma once
+#include "parser.hpp"
+#include "key_trie.hpp"
+#include "validator.hpp"
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <regex>
+#include <stdexcept>
+
+// Internal storage of the argument definitions and of the parse results which is shared by
+//      `ArgParser`, `ArgSchema` and `ArgParseResult`, this header is not part of the public API.
+
+#define NTT_ARGUMENT_INVALID_INDEX -1
+
+// The token is the prefix of the keys of several arguments (`SchemaData::searchByPrefix`).
+#define NTT_ARGUMENT_AMBIGUOUS_INDEX -2
+
+// The key index is kept at most half full, the capacity is always a power of 2 so that the
+//      slot can be obtained by masking the hash value.
+#define NTT_ARGUMENT_KEY_INDEX_MIN_CAPACITY 16
+#define NTT_ARGUMENT_KEY_INDEX_EMPTY_SLOT 0xFFFFFFFFu
+
+#define NTT_ARGUMENT_PROVIDED_WORD_BITS 64
+
+// The suggestions of a missing key: at most 3 keys within an edit distance of 3 (and of a third
+//      of the length of the missing key).
+#define NTT_ARGUMENT_SUGGESTION_LIMIT 3
+#define NTT_ARGUMENT_SUGGESTION_MAX_DISTANCE 3
+
+// The number of matched keys listed by the message of an ambiguous prefix.
+#define NTT_ARGUMENT_AMBIGUOUS_CANDIDATE_LIMIT 8
+
+namespace NTT_NS
+{
+    /**
+     * The list of availabel types which the arg can be passed into the
+     *      argparser, this list can be modified later. The type tags are packed into one byte
+     *      each inside the schema.
+     */
+    enum ArgParserType : u8
+    {
+        STRING,
+        I32,
+        F32,
+        BOOL,
+        STRING_LIST,
+        I32_LIST,
+        F32_LIST,
+        BOOL_LIST,
+    };
+
+    /**
+     * The number of list element types, the list types are the last ones of `ArgParserType` and
+     *      `type - STRING_LIST` is the index of the element storage.
+     */
+#define NTT_ARGUMENT_LIST_KIND_COUNT 4
+
+    /**
+     * Per argument flags which are packed next to the type tags.
+     */
+    enum ArgumentFlag : u8
+    {
+        ARGUMENT_FLAG_REQUIRED = 1 << 0,
+        ARGUMENT_FLAG_BOUND = 1 << 1,
+
+        /**
+         * The list argument takes all the following values until the next key, the positional
+         *      argument takes all the following positional tokens.
+         */
+        ARGUMENT_FLAG_MULTIPLE_VALUES = 1 << 2,
+
+        /**
+         * The list argument can be given without any value.
+         */
+        ARGUMENT_FLAG_OPTIONAL_VALUE = 1 << 3,
+
+        /**
+         * The argument has no key, its single "key" is the name which is only shown (see
+         *      `SchemaData::positionals`).
+         */
+        ARGUMENT_FLAG_POSITIONAL = 1 << 4,
+
+        /**
+         * The argument has a validator, the text of its `f32` value is kept for the rejection
+         *      status (`ResultData::f32Texts`).
+         */
+        ARGUMENT_FLAG_VALIDATED = 1 << 5,
+    };
+
+    /**
+     * The values of a list argument, `count` values from `offset` inside the storage of the
+     *      element type (of the result, or of the schema for the default values).
+     */
+    struct ListRange
+    {
+        u32 offset;
+        u32 count;
+    };
+
+    /**
+     * Store the value of the argument, the `STRING` value is a view into either the string pool
+     *      of the schema (default value), the `argv` (zero copy mode) or the owned copy inside the
+     *      result.
+     */
+    union ArgumentValue
+    {
+        i32 i32Value;
+        f32 f32Value;
+        bool boolValue;
+        ArgStringView stringValue;
+        ListRange listValue;
+
+        ArgumentValue() : i32Value(0) {}
+    };
+
+    /**
+     * Flags of a command line token.
+     */
+    enum ArgTokenFlag : u32
+    {
+        /**
+         * The token points into a storage which is owned by the result (a mapped response file),
+         *      so that it can be kept as a view even if the zero copy mode is disabled.
+         */
+        ARG_TOKEN_FLAG_STABLE = 1 << 0,
+
+        /**
+         * The token points into a buffer which is reused by the next read (`ArgTokenSource`) or
+         *      which the process may change (an environment variable), its value is always copied
+         *      and converted (never kept as a raw token).
+         */
+        ARG_TOKEN_FLAG_TRANSIENT = 1 << 1,
+    };
+
+    /**
+     * One token of the command line, it points either into the `argv` or into a mapped response
+     *      file, in both cases the token is not null terminated.
+     */
+    struct ArgToken
+    {
+        const char *data;
+        u32 length;
+        u32 flags;
+
+        inline ArgStringView view() const { return ArgStringView(data, length); }
+
+        inline bool equals(const char *other, u32 otherLength) const
+        {
+            return length == otherLength && memcmp(data, other, length) == 0;
+        }
+    };
+
+    class MappedFile;
+
+    /**
+     * One value of the config file (`ArgParser::parseConfig`) for a matched argument, the text is
+     *      kept inside `SchemaData::configChars` and converted by each parse. A list argument has
+     *      one entry per element, an empty array is kept as an entry without text (its offset is
+     *      `NTT_ARG_NO_INDEX`).
+     */
+    struct ConfigEntry
+    {
+        u32 argument;
+        u32 offset;
+        u32 length;
+    };
+
+    /**
+     * One value of a list argument which is found while parsing, the values are only converted
+     *      and laid out once every token is read so that each list is contiguous.
+     */
+    struct ListItem
+    {
+        u32 argument;
+        u32 token;
+    };
+
+    /**
+     * Location of an interned string inside the string pool of the schema, offsets are used
+     *      instead of pointers so that the pool can grow freely and the schema can be copied.
+     */
+    struct StringRef
+    {
+        u32 offset;
+        u32 length;
+    };
+
+    /**
+     * The information of an argument which is not needed while parsing (only for the error
+     *      messages, the default strings and the bindings), kept apart from the packed columns.
+     */
+    struct ArgumentInfo
+    {
+        u32 firstKey;
+        u32 keyCount;
+        StringRef description;
+        StringRef defaultString;
+
+        /**
+         * The environment variable which is read when the argument is not in the command line,
+         *      empty if there is none.
+         */
+        StringRef environmentName;
+
+        /**
+         * The user storage which is bound via `addArgument`, `nullptr` if the value is kept
+         *      inside the result. The type of the pointed value always matches the type tag.
+         */
+        void *destination;
+    };
+
+    /**
+     * A subcommand of the parser (`ArgParser::addSubcommand`), only its name and its description
+     *      are kept inside the schema, its arguments are defined by its builder once it is selected.
+     */
+    struct SubcommandInfo
+    {
+        StringRef name;
+        StringRef description;
+    };
+
+    /**
+     * Receives the converted value of a positional token, the typed visitor of the user is
+     *      wrapped into it by `ArgParser::addPositional`.
+     */
+    using PositionalCallback = std::function<void(u32 index, const ArgumentValue &value)>;
+
+    /**
+     * A positional argument, the tokens which are not keys are dispatched to the positional
+     *      arguments in the order of their registration. Its value is never stored, only the
+     *      provided bit of its argument slot is set so that the required check covers it.
+     */
+    struct PositionalInfo
+    {
+        u32 argument;
+        PositionalCallback visit;
+    };
+
+    /**
+     * FNV-1a hash of the raw key bytes, the keys are short so that a simple byte-wise hash
+     *      is faster than anything which needs setup.
+     */
+    inline u32 hashKey(const char *key, u32 length)
+    {
+        u32 hash = 2166136261u;
+        for (u32 i = 0; i < length; i++)
+        {
+            hash ^= static_cast<unsigned char>(key[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    /**
+     * Open addressing (linear probing) table which maps every trigger key to the index of its
+     *      argument, the lookup cost does not depend on the number of registered keys. The keys
+     *      are referred by their offset inside the string pool of the schema.
+     */
+    struct KeyIndex
+    {
+        struct Slot
+        {
+            u32 keyOffset;
+            u32 length;
+            u32 hash;
+            u32 index;
+        };
+
+        std::vector<Slot> slots;
+        u32 count = 0;
+
+        inline i64 find(const char *pool, const char *key, u32 length) const
+        {
+            u64 comparisons = 0;
+            return find(pool, key, length, comparisons);
+        }
+
+        /**
+         * Same as the other `find`, the compared slots are added to `comparisons` (see
+         *      `ArgParseCounters::keyComparisons`).
+         */
+        inline i64 find(const char *pool, const char *key, u32 length, u64 &comparisons) const
+        {
+            if (slots.empty())
+            {
+                return NTT_ARGUMENT_INVALID_INDEX;
+            }
+
+            const u32 mask = static_cast<u32>(slots.size()) - 1;
+            const u32 hash = hashKey(key, length);
+
+            for (u32 slotIndex = hash & mask;; slotIndex = (slotIndex + 1) & mask)
+            {
+                const Slot &slot = slots[slotIndex];
+                if (slot.index == NTT_ARGUMENT_KEY_INDEX_EMPTY_SLOT)
+                {
+                    return NTT_ARGUMENT_INVALID_INDEX;
+                }
+
+                comparisons++;
+                if (slot.hash == hash &&
+                    slot.length == length &&
+                    memcmp(pool + slot.keyOffset, key, length) == 0)
+                {
+                    return slot.index;
+                }
+            }
+        }
+
+        void insert(const char *key, StringRef keyRef, u32 index);
+
+    private:
+        void place(const Slot &slot);
+        void grow();
+    };
+
+    enum ValidatorKind : u8
+    {
+        VALIDATOR_RANGE,
+        VALIDATOR_CHOICE,
+        VALIDATOR_REGEX,
+
+        /**
+         * The callable of the user (`ArgHandle::addValidator`).
+         */
+        VALIDATOR_FUNCTION,
+    };
+
+    /**
+     * Checks one value (one element of a list), the typed callable of the user is wrapped into
+     *      it by `ArgParser::addValidator`.
+     */
+    using ValidatorFunction = std::function<bool(const ArgumentValue &value)>;
+
+    /**
+     * A validator of an argument, run by each parse over every value of the argument.
+     */
+    struct ValidatorInfo
+    {
+        u32 argument;
+        ValidatorKind kind;
+
+        /**
+         * The checks of this validator may run on the worker threads (`parallelFor`).
+         */
+        bool isParallel;
+
+        f64 minimum;
+        f64 maximum;
+
+        /**
+         * The choices are interned into the string pool of the schema.
+         */
+        KeyIndex choices;
+        std::shared_ptr<const std::regex> pattern;
+        ValidatorFunction check;
+
+        /**
+         * What the value must be (`inside [1, 64]`, `one of [fast, safe]`), the type name of the
+         *      failed status points into it so that it is shared by every copy of the schema.
+         */
+        std::shared_ptr<const std::string> requirement;
+    };
+
+    /**
+     * One value to check: the validator (index inside `SchemaData::validators`) and the index of
+     *      the value inside the list (`0` for the other arguments).
+     */
+    struct ValidationCheck
+    {
+        u32 validator;
+        u32 value;
+    };
+
+    /**
+     * The definitions of all arguments stored as structure of arrays, the columns which are
+     *      touched for every token (type tags, flags, default values) are packed so that parsing
+     *      and resetting only walk a few contiguous buffers. All keys, descriptions and default
+     *      strings are interned into a single string pool.
+     *
+     * The structure does not contain any pointer into itself so that it can be copied freely
+     *      (`ArgParser::freeze`).
+     */
+    struct SchemaData
+    {
+        std::vector<ArgParserType> types;
+        std::vector<u8> flags;
+
+        /**
+         * The `STRING` entries are not used, their default value is `ArgumentInfo::defaultString`.
+         */
+        std::vector<ArgumentValue> defaultValues;
+        std::vector<ArgumentInfo> infos;
+        std::vector<StringRef> keys;
+        std::vector<char> stringPool;
+        std::vector<u32> requiredArgumentIndexes;
+        std::vector<u32> boundArgumentIndexes;
+        std::vector<u32> stringArgumentIndexes;
+        std::vector<u32> listArgumentIndexes;
+        KeyIndex keyIndex;
+
+        /**
+         * Every trigger key again, only visited when the exact lookup misses: the prefix matching
+         *      and the suggestions of the error messages.
+         */
+        KeyTrie keyTrie;
+
+        /**
+         * The declared environment variable names, so that the environment is scanned once
+         *      whatever the number of declared names is.
+         */
+        KeyIndex environmentIndex;
+
+        /**
+         * The default values of the list arguments, `defaultValues` holds the range of each
+         *      argument inside the column of its element type.
+         */
+        std::vector<StringRef> listDefaultStrings;
+        std::vector<i32> listDefaultI32s;
+        std::vector<f32> listDefaultF32s;
+        std::vector<u8> listDefaultBools;
+
+        /**
+         * The config layer, applied by each parse to the arguments which are not given by the
+         *      command line or the environment.
+         */
+        std::vector<ConfigEntry> configEntries;
+        std::vector<char> configChars;
+
+        /**
+         * The subcommand names, the first command line token which is one of them ends the
+         *      arguments of this schema.
+         */
+        std::vector<SubcommandInfo> subcommands;
+        KeyIndex subcommandIndex;
+
+        /**
+         * The positional arguments in the order of their tokens, only the last one can be
+         *      repeated.
+         */
+        std::vector<PositionalInfo> positionals;
+
+        /**
+         * The validators in the order of their registration, which is the order of their checks.
+         */
+        std::vector<ValidatorInfo> validators;
+
+        /**
+         * The threads of the parallel validators, `0` means the number of hardware threads.
+         */
+        u32 validationThreads = 0;
+
+        bool zeroCopyStrings = false;
+        bool responseFiles = false;
+        bool lazyConversion = false;
+        bool prefixMatching = false;
+        ArgConversionPolicy conversionPolicy = ArgConversionPolicy::LENIENT_CONVERSION;
+
+        inline u32 count() const { return static_cast<u32>(types.size()); }
+
+        inline i64 searchByKey(const char *key, u32 length) const
+        {
+            return keyIndex.find(stringPool.data(), key, length);
+        }
+
+        inline i64 searchByKey(const char *key, u32 length, u64 &comparisons) const
+        {
+            return keyIndex.find(stringPool.data(), key, length, comparisons);
+        }
+
+        inline i64 searchByKey(const String &key) const
+        {
+            return searchByKey(key.c_str(), key.length());
+        }
+
+        inline i64 searchSubcommand(const char *name, u32 length) const
+        {
+            return subcommandIndex.find(stringPool.data(), name, length);
+        }
+
+        /**
+         * @retval true if the token may be resolved by `searchByPrefix`, only the `--` tokens
+         *      are matched by their prefix and only if the prefix matching is enabled.
+         */
+        inline bool matchesByPrefix(const char *key, u32 length) const
+        {
+            return prefixMatching && length > 2 && key[0] == '-' && key[1] == '-';
+        }
+
+        /**
+         * @return The argument of every key which starts with the prefix,
+         *      `NTT_ARGUMENT_AMBIGUOUS_INDEX` if the keys belong to several arguments or
+         *      `NTT_ARGUMENT_INVALID_INDEX` if no key starts with it.
+         */
+        i64 searchByPrefix(const char *prefix, u32 length) const;
+
+        inline ArgStringView viewAt(StringRef ref) const
+        {
+            return ArgStringView(stringPool.data() + ref.offset, ref.length);
+        }
+
+        inline bool isBound(u32 index) const
+        {
+            return (flags[index] & ARGUMENT_FLAG_BOUND) != 0;
+        }
+
+        inline bool isList(u32 index) const
+        {
+            return types[index] >= ArgParserType::STRING_LIST;
+        }
+
+        inline bool isPositional(u32 index) const
+        {
+            return (flags[index] & ARGUMENT_FLAG_POSITIONAL) != 0;
+        }
+
+        template <typename T>
+        inline T &boundSlot(u32 index) const
+        {
+            return *static_cast<T *>(infos[index].destination);
+        }
+
+        /**
+         * Copies the string into the pool (with the terminated null character).
+         */
+        StringRef intern(const char *data, u32 length);
+
+        /**
+         * Throws if any of the keys is already defined (or is given twice).
+         */
+        void checkKeys(const std::vector<String> &triggerKeys) const;
+
+        /**
+         * Appends the default values of a list argument into the column of its element type.
+         *
+         * @return The range which is stored as the default value of the argument.
+         */
+        template <typename T>
+        ListRange internListDefault(const std::vector<T> &defaultValue);
+
+        /**
+         * Only for the list arguments, throws if the argument is not a list.
+         */
+        void setNargs(u32 index, ArgNargs nargs);
+
+        /**
+         * Declares the environment variable of the argument, throws if the argument is a list,
+         *      already has a variable or if the variable is used by another argument.
+         */
+        void setEnvironmentName(u32 index, const String &name);
+
+        /**
+         * Registers the name of a subcommand, throws if the name is empty, starts with `-` or is
+         *      already a key or a subcommand.
+         *
+         * @return The index of the subcommand.
+         */
+        u32 addSubcommand(const String &name, const String &description);
+
+        /**
+         * Registers the argument definition, all of its keys are checked before anything is
+         *      modified so that a rejected definition leaves the schema untouched.
+         *
+         * @return The index of the registered argument.
+         */
+        u32 registerArgument(
+            const std::vector<String> &triggerKeys,
+            const String &description,
+            ArgParserType type,
+            bool isRequired,
+            const ArgumentValue &defaultValue,
+            const String &defaultString,
+            void *destination);
+
+        /**
+         * Registers a positional argument (without any key) which receives the positional
+         *      tokens after the ones of the previous positional arguments. Throws if the name is
+         *      empty, starts with `-` or is already a positional name, if the previous positional
+         *      argument is repeated or if a required one follows an optional one.
+         *
+         * @return The index of the argument slot.
+         */
+        u32 registerPositional(
+            const String &name,
+            const String &description,
+            ArgParserType type,
+            bool isRequired,
+            bool isRepeated,
+            const PositionalCallback &visit);
+
+        /**
+         * Attaches a built-in validator, throws if the type of the argument does not match it
+         *      (or if its bounds or pattern are not valid).
+         */
+        void addValidator(u32 index, const ArgValidator &validator);
+
+        /**
+         * Attaches a validator of the user, its type always matches the argument.
+         */
+        void addValidator(u32 index, const ValidatorFunction &check, const String &requirement, bool isParallel);
+
+        /**
+         * Only used for building the error messages, the name of a positional argument.
+         */
+        std::vector<String> triggerKeysOf(u32 index) const;
+
+        /**
+         * Finds the argument by the key and checks its type.
+         *
+         * @param index Receives the index of the argument if the status is ok.
+         */
+        ArgStatus findTypedArgument(const String &key, ArgParserType type, const char *typeName, u32 &index) const;
+    };
+
+    /**
+     * A word of bits which a thread may test without a lock while another one clears its bits
+     *      under a lock (the pending bits of the lazy reads). The copies are not atomic, they
+     *      only happen while the result is not read.
+     */
+    struct AtomicBitWord
+    {
+        std::atomic<u64> bits;
+
+        AtomicBitWord(u64 value = 0) : bits(value) {}
+        AtomicBitWord(const AtomicBitWord &other) : bits(other.bits.load(std::memory_order_relaxed)) {}
+
+        AtomicBitWord &operator=(const AtomicBitWord &other)
+        {
+            bits.store(other.bits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+    };
+
+    /**
+     * The values of one parse, the columns are indexed the same as the schema.
+     */
+    struct ResultData
+    {
+        std::vector<ArgumentValue> values;
+        std::vector<u64> providedBits;
+
+        /**
+         * The `i32` and `f32` arguments whose value is still the raw token (lazy conversion), the
+         *      token is kept as `stringValue` until the first read. A bit is cleared with a
+         *      release store once the converted value is written, so that a read which sees it
+         *      cleared (acquire load) can read the value without a lock.
+         */
+        std::vector<AtomicBitWord> pendingBits;
+
+        /**
+         * The copies of the `STRING` values when the zero copy mode is disabled.
+         */
+        std::vector<String> ownedStrings;
+
+        /**
+         * The values of all list arguments grouped by element type, the values of each argument
+         *      are contiguous (see `ListRange`). The buffers are sized once per parse and reused.
+         */
+        std::vector<ArgStringView> stringItems;
+        std::vector<i32> i32Items;
+        std::vector<f32> f32Items;
+        std::vector<u8> boolItems;
+
+        /**
+         * The copies of the `STRING` list values when the zero copy mode is disabled.
+         */
+        std::vector<char> listChars;
+        std::vector<ListItem> listItems;
+
+        /**
+         * The tokens of the last parse, kept only to reuse the buffer. The values of the config
+         *      lists are appended after the command line tokens (from `configTokenStart`).
+         */
+        std::vector<ArgToken> tokens;
+        u32 configTokenStart = 0;
+
+        /**
+         * The copies of the list values of a streamed parse, the `tokens` point into it once the
+         *      whole stream is read.
+         */
+        std::vector<char> streamChars;
+
+        /**
+         * The checks of the validators of the last parse and their outcomes (`1` if rejected),
+         *      kept only to reuse the buffers.
+         */
+        std::vector<ValidationCheck> validationChecks;
+        std::vector<u8> validationRejections;
+        std::vector<u32> parallelChecks;
+
+        /**
+         * The text of the number which is rejected by the last parse, the subject of its status.
+         */
+        std::string rejectedValue;
+
+        /**
+         * The tokens of the validated `F32` values as given by the user
+         *      (`ARGUMENT_FLAG_VALIDATED`), a rejection reports them instead of the converted
+         *      float. Copies, since the token of an environment variable or a stream does not
+         *      outlive its store.
+         */
+        std::vector<std::string> f32Texts;
+
+        /**
+         * The arguments which are given by the command line or the environment, copied before
+         *      the config layer is applied.
+         */
+        std::vector<u64> configSkipBits;
+
+        /**
+         * The subcommand which ends the arguments of the last parse and the position of its name
+         *      inside `tokens`, the following tokens are the arguments of the subcommand.
+         */
+        u32 subcommand = NTT_ARG_NO_INDEX;
+        u32 subcommandToken = 0;
+
+        /**
+         * Updated by every parse into this result when the instrumentation is compiled in.
+         */
+        ArgParseCounters counters;
+
+        /**
+         * The response files of the last parse, the `STRING` values may point into them.
+         */
+        std::vector<std::shared_ptr<MappedFile>> mappedFiles;
+
+        inline bool isProvided(u32 index) const
+        {
+            return (providedBits[index / NTT_ARGUMENT_PROVIDED_WORD_BITS] >>
+                    (index % NTT_ARGUMENT_PROVIDED_WORD_BITS)) &
+                   1u;
+        }
+
+        inline void markProvided(u32 index)
+        {
+            providedBits[index / NTT_ARGUMENT_PROVIDED_WORD_BITS] |=
+                u64(1) << (index % NTT_ARGUMENT_PROVIDED_WORD_BITS);
+        }
+
+        inline bool isPending(u32 index) const
+        {
+            const std::atomic<u64> &bits = pendingBits[index / NTT_ARGUMENT_PROVIDED_WORD_BITS].bits;
+            return (bits.load(std::memory_order_acquire) >> (index % NTT_ARGUMENT_PROVIDED_WORD_BITS)) & 1u;
+        }
+
+        /**
+         * Only called by the parse, which does not run concurrently with the reads.
+         */
+        inline void markPending(u32 index)
+        {
+            std::atomic<u64> &bits = pendingBits[index / NTT_ARGUMENT_PROVIDED_WORD_BITS].bits;
+            const u64 mask = u64(1) << (index % NTT_ARGUMENT_PROVIDED_WORD_BITS);
+            bits.store(bits.load(std::memory_order_relaxed) | mask, std::memory_order_relaxed);
+        }
+
+        /**
+         * The callers are serialized (a lock of the parser or an exclusive call), the release
+         *      store publishes the converted value to the reads which do not lock.
+         */
+        inline void clearPending(u32 index)
+        {
+            std::atomic<u64> &bits = pendingBits[index / NTT_ARGUMENT_PROVIDED_WORD_BITS].bits;
+            const u64 mask = u64(1) << (index % NTT_ARGUMENT_PROVIDED_WORD_BITS);
+            bits.store(bits.load(std::memory_order_relaxed) & ~mask, std::memory_order_release);
+        }
+    };
+
+    /**
+     * Makes the result columns match the schema after new arguments are registered, the new
+     *      arguments receive their default values.
+     *
+     * @param oldPool The string pool address before the registration, the `STRING` views are
+     *      rebuilt when the pool has been moved.
+     */
+    void syncResult(const SchemaData &schema, ResultData &result, const char *oldPool);
+
+    /**
+     * Restores every value to its default value.
+     *
+     * @param applyBindings If `true` the defaults are also written into the bound storages.
+     */
+    void resetResult(const SchemaData &schema, ResultData &result, bool applyBindings);
+
+    /**
+     * The whole parsing pass (reset, tokens, required arguments) shared by `ArgParser` and
+     *      `ArgSchema`. Stops at the first error, nothing is thrown.
+     *
+     * @param applyBindings If `true` (the own result of `ArgParser`) the values of the bound
+     *      arguments are written into their storages and the lazy conversion is used if enabled,
+     *      otherwise (the results of `ArgSchema` which can be read from any thread) every value
+     *      is kept inside the result and converted during the parse.
+     */
+    ArgStatus parseArguments(
+        const SchemaData &schema,
+        ResultData &result,
+        u32 argc,
+        char **argv,
+        bool applyBindings);
+
+    /**
+     * Same as `parseArguments` but the tokens are already inside `result.tokens` (the arguments
+     *      of a subcommand), the result must be reset before.
+     */
+    ArgStatus parseTokens(const SchemaData &schema, ResultData &result, bool applyBindings);
+
+    /**
+     * Same as `parseArguments` but the tokens are read from the source while they are parsed
+     *      (see `ArgParser::parseStream`).
+     */
+    ArgStatus parseStream(const SchemaData &schema, ResultData &result, ArgTokenSource &source, bool applyBindings);
+
+    /**
+     * Runs every validator over the values which are provided, the parallel checks are handed to
+     *      the persistent worker pool (`parallelFor`). The status is the first rejection in the
+     *      order of the checks (`ARG_ERROR_VALIDATION_FAILED`) whatever the number of threads is,
+     *      an exception thrown by a validator goes through (the first one in that order as well).
+     */
+    ArgStatus validateArguments(const SchemaData &schema, ResultData &result, bool applyBindings);
+
+    /**
+     * Converts the raw token of a lazily parsed argument and caches the value, nothing is done if
+     *      the argument is not pending. On a rejected value (strict conversion) the argument
+     *      stays pending so that every read reports the error.
+     */
+    ArgStatus resolvePending(const SchemaData &schema, ResultData &result, u32 index);
+
+    /**
+     * Resolves every pending argument, stops at the first error.
+     */
+    ArgStatus resolveAllPending(const SchemaData &schema, ResultData &result);
+
+    /**
+     * Builds the message of the failure, the trigger keys of the argument are read from the schema.
+     */
+    String formatStatus(const SchemaData &schema, const ArgStatus &status);
+
+    /**
+     * Throws `std::invalid_argument` with the formatted message if the status is not ok, used by
+     *      the throwing API on top of the non-throwing one.
+     */
+    inline void throwOnError(const SchemaData &schema, const ArgStatus &status)
+    {
+        if (!status.ok())
+        {
+            throw std::invalid_argument(formatStatus(schema, status).c_str());
+        }
+    }
+
+    /**
+     * Unchecked typed read of the argument at the given index.
+     */
+    template <typename T>
+    struct ArgumentReader;
+
+    template <>
+    struct ArgumentReader<String>
+    {
+        static inline String read(const SchemaData &schema, const ResultData &result, u32 index, bool applyBindings)
+        {
+            return applyBindings && schema.isBound(index)
+                       ? schema.boundSlot<String>(index)
+                       : result.values[index].stringValue.toString();
+        }
+    };
+
+    template <>
+    struct ArgumentReader<ArgStringView>
+    {
+        static inline ArgStringView read(const SchemaData &schema, const ResultData &result, u32 index, bool applyBindings)
+        {
+            if (applyBindings && schema.isBound(index))
+            {
+                const String &value = schema.boundSlot<String>(index);
+                return ArgStringView(value.c_str(), value.length());
+            }
+            return result.values[index].stringValue;
+        }
+    };
+
+    template <>
+    struct ArgumentReader<i32>
+    {
+        static inline i32 read(const SchemaData &schema, const ResultData &result, u32 index, bool applyBindings)
+        {
+            return applyBindings && schema.isBound(index)
+                       ? schema.boundSlot<i32>(index)
+                       : result.values[index].i32Value;
+        }
+    };
+
+    template <>
+    struct ArgumentReader<f32>
+    {
+        static inline f32 read(const SchemaData &schema, const ResultData &result, u32 index, bool applyBindings)
+        {
+            return applyBindings && schema.isBound(index)
+                       ? schema.boundSlot<f32>(index)
+                       : result.values[index].f32Value;
+        }
+    };
+
+    template <>
+    struct ArgumentReader<bool>
+    {
+        static inline bool read(const SchemaData &schema, const ResultData &result, u32 index, bool applyBindings)
+        {
+            return applyBindings && schema.isBound(index)
+                       ? schema.boundSlot<bool>(index)
+                       : result.values[index].boolValue;
+        }
+    };
+
+    /**
+     * The list values are always kept inside the result (the bound storages only receive a copy).
+     */
+#define NTT_ARGUMENT_LIST_READER_DEF(typeName, items)                                                          \
+    template <>                                                                                                \
+    struct ArgumentReader<std::vector<typeName>>                                                               \
+    {                                                                                                          \
+        static inline ArgValueType<std::vector<typeName>>::Type read(                                          \
+            const SchemaData &, const ResultData &result, u32 index, bool)                                     \
+        {                                                                                                      \
+            const ListRange &range = result.values[index].listValue;                                           \
+            return ArgValueType<std::vector<typeName>>::Type(result.items.data() + range.offset, range.count); \
+        }                                                                                                      \
+    };
+
+    NTT_ARGUMENT_LIST_READER_DEF(String, stringItems);
+    NTT_ARGUMENT_LIST_READER_DEF(i32, i32Items);
+    NTT_ARGUMENT_LIST_READER_DEF(f32, f32Items);
+    NTT_ARGUMENT_LIST_READER_DEF(bool, boolItems);
+} // namespace NTT_NS
@@ -0,0 +1,289 @@
+#include "completion.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "memory.hpp"
+#include "completion_index.hpp"
+#include "response_file.hpp"
+
+namespace NTT_NS
+{
+    class ArgCompletionIndex::ArgCompletionIndexPrivate
+    {
+    public:
+        /**
+         * Only set if the index is opened from a file.
+         */
+        Scope<MappedFile> file;
+        CompletionLayout layout;
+
+        inline bool startsWith(ArgStringView text, ArgStringView prefix) const
+        {
+            return text.length() >= prefix.length() && memcmp(text.data(), prefix.data(), prefix.length()) == 0;
+        }
+
+        /**
+         * @return The first key which is not before `word` in the sorted order.
+         */
+        u32 lowerBound(ArgStringView word) const
+        {
+            u32 first = 0;
+            u32 last = layout.header->keyCount;
+            while (first < last)
+            {
+                const u32 middle = first + (last - first) / 2;
+                const ArgStringView text = layout.textAt(layout.keys[middle].text);
+                const i32 order = memcmp(text.data(), word.data(), std::min(text.length(), word.length()));
+                if (order < 0 || (order == 0 && text.length() < word.length()))
+                {
+                    first = middle + 1;
+                }
+                else
+                {
+                    last = middle;
+                }
+            }
+            return first;
+        }
+
+        /**
+         * @return The option of the key which is exactly `word`, `nullptr` if there is none.
+         */
+        const CompletionOption *findOption(ArgStringView word) const
+        {
+            const u32 key = lowerBound(word);
+            if (key == layout.header->keyCount)
+            {
+                return nullptr;
+            }
+
+            const ArgStringView text = layout.textAt(layout.keys[key].text);
+            if (text.length() != word.length() || memcmp(text.data(), word.data(), word.length()) != 0)
+            {
+                return nullptr;
+            }
+            return layout.optionOf(layout.keys[key]);
+        }
+    };
+
+    ArgCompletionIndex::ArgCompletionIndex()
+    {
+        impl = CreateScope<ArgCompletionIndexPrivate>();
+    }
+
+    ArgCompletionIndex::ArgCompletionIndex(ArgCompletionIndex &&other)
+    {
+        impl = std::move(other.impl);
+        other.impl = CreateScope<ArgCompletionIndexPrivate>();
+    }
+
+    ArgCompletionIndex &ArgCompletionIndex::operator=(ArgCompletionIndex &&other)
+    {
+        if (this != &other)
+        {
+            impl = std::move(other.impl);
+            other.impl = CreateScope<ArgCompletionIndexPrivate>();
+        }
+        return *this;
+    }
+
+    ArgCompletionIndex::~ArgCompletionIndex() {}
+
+    bool ArgCompletionIndex::open(const String &path)
+    {
+        impl->layout = CompletionLayout();
+        impl->file = CreateScope<MappedFile>();
+        if (!impl->file->open(path.c_str()) ||
+            !attachCompletionIndex(impl->file->data(), impl->file->size(), impl->layout))
+        {
+            impl->file.reset();
+            impl->layout = CompletionLayout();
+            return false;
+        }
+        return true;
+    }
+
+    bool ArgCompletionIndex::attach(const void *data, u64 size)
+    {
+        impl->file.reset();
+        impl->layout = CompletionLayout();
+        if (!attachCompletionIndex(data, size, impl->layout))
+        {
+            impl->layout = CompletionLayout();
+            return false;
+        }
+        return true;
+    }
+
+    bool ArgCompletionIndex::isAttached() const
+    {
+        return impl->layout.header != nullptr;
+    }
+
+    u32 ArgCompletionIndex::getKeyCount() const
+    {
+        return isAttached() ? impl->layout.header->keyCount : 0;
+    }
+
+    void ArgCompletionIndex::complete(
+        ArgStringView word,
+        ArgStringView previous,
+        std::vector<ArgCompletionCandidate> &candidates) const
+    {
+        candidates.clear();
+        if (!isAttached())
+        {
+            return;
+        }
+
+        const CompletionLayout &layout = impl->layout;
+        const bool isKey = !word.empty() && word.data()[0] == '-';
+        const CompletionOption *previousOption = previous.empty() || isKey ? nullptr : impl->findOption(previous);
+
+        if (previousOption != nullptr &&
+            previousOption->kind == CompletionOptionKind::COMPLETION_OPTION_ARGUMENT &&
+            previousOption->type != ArgParserType::BOOL)
+        {
+            if (static_cast<u64>(previousOption->firstChoice) + previousOption->choiceCount > layout.header->choiceCount)
+            {
+                return;
+            }
+
+            for (u32 choice = 0; choice < previousOption->choiceCount; choice++)
+            {
+                const ArgStringView text = layout.textAt(layout.choices[previousOption->firstChoice + choice]);
+                if (impl->startsWith(text, word))
+                {
+                    candidates.push_back(ArgCompletionCandidate{text, ArgStringView()});
+                }
+            }
+            return;
+        }
+
+        for (u32 key = impl->lowerBound(word); key < layout.header->keyCount; key++)
+        {
+            const ArgStringView text = layout.textAt(layout.keys[key].text);
+            if (!impl->startsWith(text, word))
+            {
+                break;
+            }
+
+            const CompletionOption *option = layout.optionOf(layout.keys[key]);
+            candidates.push_back(ArgCompletionCandidate{
+                text,
+                option == nullptr ? ArgStringView() : layout.textAt(option->description)});
+        }
+    }
+
+    bool ArgCompletionIndex::run(u32 argc, char **argv, const String &indexPath)
+    {
+        if (argc < 2 || strcmp(argv[1], NTT_ARG_COMPLETE_FLAG) != 0)
+        {
+            return false;
+        }
+
+        ArgCompletionIndex index;
+        if (!index.open(indexPath))
+        {
+            return true;
+        }
+
+        const ArgStringView word = argc > 2 ? ArgStringView(argv[2], static_cast<u32>(strlen(argv[2]))) : ArgStringView();
+        const ArgStringView previous = argc > 3 ? ArgStringView(argv[3], static_cast<u32>(strlen(argv[3]))) : ArgStringView();
+        std::vector<ArgCompletionCandidate> candidates;
+        index.complete(word, previous, candidates);
+
+        // One write for all of the candidates, the shell waits for the whole output anyway.
+        std::string output;
+        for (const ArgCompletionCandidate &candidate : candidates)
+        {
+            output.append(candidate.text.data(), candidate.text.length());
+
+            const char *lineEnd = static_cast<const char *>(
+                memchr(candidate.description.data(), '\n', candidate.description.length()));
+            const u32 descriptionLength = lineEnd == nullptr
+                                              ? candidate.description.length()
+                                              : static_cast<u32>(lineEnd - candidate.description.data());
+            if (descriptionLength != 0)
+            {
+                output.push_back('\t');
+                output.append(candidate.description.data(), descriptionLength);
+            }
+            output.push_back('\n');
+        }
+        fwrite(output.data(), 1, output.size(), stdout);
+        fflush(stdout);
+        return true;
+    }
+
+    String ArgCompletionIndex::getScript(ArgCompletionShell shell, const String &programName)
+    {
+        // The name of the shell functions, only the letters, digits and underscores are kept.
+        std::string identifier;
+        for (char character : programName)
+        {
+            const bool isWordCharacter = (character >= 'a' && character <= 'z') ||
+                                         (character >= 'A' && character <= 'Z') ||
+                                         (character >= '0' && character <= '9');
+            identifier.push_back(isWordCharacter ? character : '_');
+        }
+
+        std::string script;
+        switch (shell)
+        {
+        case ArgCompletionShell::ARG_COMPLETION_SHELL_BASH:
+        {
+            // Without any candidate (the value of a key) bash falls back to the file names.
+            const std::string functionName = "_ntt_complete_" + identifier;
+            script = functionName + "()\n"
+                                    "{\n"
+                                    "    local word=\"${COMP_WORDS[COMP_CWORD]}\" previous=\"\" line\n"
+                                    "    if [ \"$COMP_CWORD\" -gt 0 ]; then\n"
+                                    "        previous=\"${COMP_WORDS[COMP_CWORD-1]}\"\n"
+                                    "    fi\n"
+                                    "    COMPREPLY=()\n"
+                                    "    while IFS= read -r line; do\n"
+                                    "        COMPREPLY+=(\"${line%%$'\\t'*}\")\n"
+                                    "    done < <(\"${COMP_WORDS[0]}\" " NTT_ARG_COMPLETE_FLAG " \"$word\" \"$previous\" 2>/dev/null)\n"
+                                    "}\n"
+                                    "complete -o default -F " +
+                     functionName + " " + programName.c_str() + "\n";
+            break;
+        }
+        case ArgCompletionShell::ARG_COMPLETION_SHELL_ZSH:
+        {
+            // Either autoloaded from the `_<program>` file of the `fpath` (the first call
+            //      completes as well) or sourced after `compinit`.
+            const std::string functionName = "_" + identifier;
+            script = std::string("#compdef ") + programName.c_str() + "\n" +
+                     functionName + "()\n"
+                                    "{\n"
+                                    "    local -a candidates\n"
+                                    "    local line text description\n"
+                                    "    for line in \"${(@f)$(\"${words[1]}\" " NTT_ARG_COMPLETE_FLAG " \"${words[CURRENT]}\" \"${words[CURRENT-1]}\" 2>/dev/null)}\"; do\n"
+                                    "        [[ -n \"$line\" ]] || continue\n"
+                                    "        text=\"${line%%$'\\t'*}\"\n"
+                                    "        description=\"\"\n"
+                                    "        [[ \"$line\" == *$'\\t'* ]] && description=\"${line#*$'\\t'}\"\n"
+                                    "        candidates+=(\"${text//:/\\\\:}${description:+:$description}\")\n"
+                                    "    done\n"
+                                    "    if (( ${#candidates} )); then\n"
+                                    "        _describe 'argument' candidates\n"
+                                    "    else\n"
+                                    "        _files\n"
+                                    "    fi\n"
+                                    "}\n"
+                                    "if [[ \"${funcstack[1]}\" == \"" +
+                     functionName + "\" ]]; then\n"
+                                    "    " +
+                     functionName + " \"$@\"\n"
+                                    "else\n"
+                                    "    compdef " +
+                     functionName + " " + programName.c_str() + "\n"
+                                                                "fi\n";
+            break;
+        }
+        }
+        return String(script);
+    }
+} // namespace NTT_NS
@@ -0,0 +1,120 @@
+#pragma once
+#include "parser.hpp"
+
+/**
+ * The flag which turns the program into a completion query (see `ArgCompletionIndex::run`).
+ */
+#define NTT_ARG_COMPLETE_FLAG "--complete"
+
+namespace NTT_NS
+{
+    enum ArgCompletionShell : u8
+    {
+        ARG_COMPLETION_SHELL_BASH,
+        ARG_COMPLETION_SHELL_ZSH,
+    };
+
+    /**
+     * A completed word, both views point into the index.
+     */
+    struct ArgCompletionCandidate
+    {
+        ArgStringView text;
+
+        /**
+         * The description of the argument (or of the subcommand), empty for the choices.
+         */
+        ArgStringView description;
+    };
+
+    /**
+     * Read only view over a completion index written by `ArgParser::writeCompletionIndex`, the
+     *      shell completion queries it on every key press without building the parser. The keys
+     *      are sorted inside the index so that a query only costs a binary search and the copy
+     *      of the matching words, nothing is allocated apart from the candidates.
+     *
+     * @example
+     * ```c++
+     * // at build time: parser.writeCompletionIndex("tool.argc");
+     * int main(int argc, char **argv)
+     * {
+     *     if (ArgCompletionIndex::run(argc, argv, "/usr/share/tool/tool.argc"))
+     *     {
+     *         return 0;
+     *     }
+     *     ArgParser parser("The tool"); // only built for the real runs
+     *     ...
+     * }
+     * ```
+     */
+    class ArgCompletionIndex
+    {
+        NTT_PRIVATE_DEF(ArgCompletionIndex);
+
+    public:
+        ArgCompletionIndex();
+        ArgCompletionIndex(ArgCompletionIndex &&other);
+        ArgCompletionIndex &operator=(ArgCompletionIndex &&other);
+        ~ArgCompletionIndex();
+
+    public:
+        /**
+         * Maps the index file, the mapping is released with the index.
+         *
+         * @retval true if the file is mapped and is a completion index.
+         * @retval false if the file cannot be mapped or is not a completion index (the index is
+         *      detached).
+         */
+        bool open(const String &path);
+
+        /**
+         * Same as `open` but the index is already in memory, nothing is copied: the memory must
+         *      outlive the index and must be aligned to 8 bytes (a mapping or a heap buffer).
+         *
+         * @param size The size of the readable memory, it may be larger than the index.
+         */
+        bool attach(const void *data, u64 size);
+
+        /**
+         * @retval true if the index is attached to a completion index.
+         * @retval false if it is default constructed or the last open (or attach) failed.
+         */
+        bool isAttached() const;
+
+        /**
+         * @return The number of completed words (the keys and the subcommand names).
+         */
+        u32 getKeyCount() const;
+
+        /**
+         * Finds the candidates of the word under the cursor in the sorted order. After a key
+         *      whose argument has choices (`ArgValidator::choice`) the candidates are the
+         *      choices which start with `word`, after another key which takes a value there is
+         *      no candidate (the shell completes a file name), otherwise the candidates are the
+         *      keys and the subcommand names which start with `word`.
+         *
+         * @param previous The word before the cursor, empty if there is none.
+         * @param candidates Receives the candidates, its previous content is cleared.
+         */
+        void complete(ArgStringView word, ArgStringView previous, std::vector<ArgCompletionCandidate> &candidates) const;
+
+        /**
+         * Answers `<program> --complete <word> [<previous>]` (the query of the completion
+         *      scripts, see `getScript`) by printing every candidate on its own line into the
+         *      standard output, followed by a tab and the first line of its description if it
+         *      has one. Nothing is printed if the index cannot be opened.
+         *
+         * @retval true if the command line is a completion query, the program should exit.
+         * @retval false otherwise, nothing is opened.
+         */
+        static bool run(u32 argc, char **argv, const String &indexPath);
+
+        /**
+         * @return The completion script of the program for the shell, it runs
+         *      `<program> --complete` for each completion. The bash script is sourced (from
+         *      `.bashrc` or `bash_completion.d`), the zsh script is the `_<program>` file of
+         *      the `fpath` (or is sourced after `compinit`).
+         */
+        static String getScript(ArgCompletionShell shell, const String &programName);
+    };
+} // namespace NTT_NS
@@ -0,0 +1,237 @@
+#include "completion_index.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace NTT_NS
+{
+    static inline u64 alignOffset(u64 offset)
+    {
+        return (offset + NTT_COMPLETION_ALIGNMENT - 1) & ~static_cast<u64>(NTT_COMPLETION_ALIGNMENT - 1);
+    }
+
+    /**
+     * Places a section of `count` elements at the current offset and moves the offset after it.
+     */
+    static inline u64 placeSection(u64 &offset, u64 count, u64 elementSize)
+    {
+        const u64 sectionOffset = alignOffset(offset);
+        offset = sectionOffset + count * elementSize;
+        return sectionOffset;
+    }
+
+    static inline bool isBefore(ArgStringView first, ArgStringView second)
+    {
+        const i32 order = memcmp(first.data(), second.data(), std::min(first.length(), second.length()));
+        return order < 0 || (order == 0 && first.length() < second.length());
+    }
+
+    /**
+     * A word of the index before it is written, `option` is the index inside the option section.
+     */
+    struct CompletionWord
+    {
+        ArgStringView text;
+        u32 option;
+    };
+
+    /**
+     * The choices of every argument, an argument with several choice validators only accepts
+     *      the choices which are in all of them.
+     */
+    static std::vector<std::vector<ArgStringView>> collectChoices(const SchemaData &schema)
+    {
+        std::vector<std::vector<ArgStringView>> choices(schema.count());
+        std::vector<bool> hasChoices(schema.count(), false);
+
+        for (const ValidatorInfo &validator : schema.validators)
+        {
+            if (validator.kind != ValidatorKind::VALIDATOR_CHOICE)
+            {
+                continue;
+            }
+
+            std::vector<ArgStringView> &argumentChoices = choices[validator.argument];
+            if (!hasChoices[validator.argument])
+            {
+                hasChoices[validator.argument] = true;
+                for (const KeyIndex::Slot &slot : validator.choices.slots)
+                {
+                    if (slot.index != NTT_ARGUMENT_KEY_INDEX_EMPTY_SLOT)
+                    {
+                        argumentChoices.push_back(schema.viewAt(StringRef{slot.keyOffset, slot.length}));
+                    }
+                }
+                std::sort(argumentChoices.begin(), argumentChoices.end(), isBefore);
+                continue;
+            }
+
+            const char *pool = schema.stringPool.data();
+            argumentChoices.erase(std::remove_if(argumentChoices.begin(),
+                                                 argumentChoices.end(),
+                                                 [&validator, pool](ArgStringView choice)
+                                                 {
+                                                     return validator.choices.find(pool, choice.data(), choice.length()) ==
+                                                            NTT_ARGUMENT_INVALID_INDEX;
+                                                 }),
+                                  argumentChoices.end());
+        }
+        return choices;
+    }
+
+    void buildCompletionIndex(const SchemaData &schema, std::vector<u8> &index)
+    {
+        const u32 count = schema.count();
+        const std::vector<std::vector<ArgStringView>> choices = collectChoices(schema);
+
+        // The arguments first (without the positional ones), then the subcommands.
+        std::vector<u32> optionArguments;
+        std::vector<CompletionWord> words;
+        u64 charCount = 0;
+        u32 choiceCount = 0;
+
+        for (u32 argument = 0; argument < count; argument++)
+        {
+            if (schema.isPositional(argument))
+            {
+                continue;
+            }
+
+            const u32 option = static_cast<u32>(optionArguments.size());
+            const ArgumentInfo &info = schema.infos[argument];
+            optionArguments.push_back(argument);
+            charCount += info.description.length + 1;
+            for (u32 key = 0; key < info.keyCount; key++)
+            {
+                const ArgStringView text = schema.viewAt(schema.keys[info.firstKey + key]);
+                words.push_back(CompletionWord{text, option});
+                charCount += text.length() + 1;
+            }
+            for (const ArgStringView &choice : choices[argument])
+            {
+                charCount += choice.length() + 1;
+            }
+            choiceCount += static_cast<u32>(choices[argument].size());
+        }
+
+        const u32 argumentOptionCount = static_cast<u32>(optionArguments.size());
+        for (u32 subcommand = 0; subcommand < schema.subcommands.size(); subcommand++)
+        {
+            const SubcommandInfo &info = schema.subcommands[subcommand];
+            words.push_back(CompletionWord{schema.viewAt(info.name), argumentOptionCount + subcommand});
+            charCount += info.name.length + 1 + info.description.length + 1;
+        }
+
+        std::sort(words.begin(),
+                  words.end(),
+                  [](const CompletionWord &first, const CompletionWord &second)
+                  { return isBefore(first.text, second.text); });
+
+        CompletionHeader header = {};
+        header.magic = NTT_COMPLETION_MAGIC;
+        header.version = NTT_COMPLETION_VERSION;
+        header.keyCount = static_cast<u32>(words.size());
+        header.optionCount = argumentOptionCount + static_cast<u32>(schema.subcommands.size());
+        header.choiceCount = choiceCount;
+        header.charCount = static_cast<u32>(charCount);
+
+        u64 offset = sizeof(CompletionHeader);
+        header.keysOffset = placeSection(offset, header.keyCount, sizeof(CompletionKey));
+        header.optionsOffset = placeSection(offset, header.optionCount, sizeof(CompletionOption));
+        header.choicesOffset = placeSection(offset, header.choiceCount, sizeof(StringRef));
+        header.charsOffset = placeSection(offset, header.charCount, sizeof(char));
+        header.size = alignOffset(offset);
+
+        // The padding of the structures stays zero so that the same schema gives the same bytes.
+        index.assign(header.size, 0);
+        memcpy(index.data(), &header, sizeof(header));
+
+        CompletionKey *keys = reinterpret_cast<CompletionKey *>(index.data() + header.keysOffset);
+        CompletionOption *options = reinterpret_cast<CompletionOption *>(index.data() + header.optionsOffset);
+        StringRef *choiceRefs = reinterpret_cast<StringRef *>(index.data() + header.choicesOffset);
+        char *chars = reinterpret_cast<char *>(index.data() + header.charsOffset);
+
+        u32 charOffset = 0;
+        auto appendText = [chars, &charOffset](ArgStringView text)
+        {
+            const StringRef ref{charOffset, text.length()};
+            memcpy(chars + charOffset, text.data(), text.length());
+            charOffset += text.length() + 1;
+            return ref;
+        };
+
+        for (u32 key = 0; key < header.keyCount; key++)
+        {
+            keys[key].text = appendText(words[key].text);
+            keys[key].option = words[key].option;
+        }
+
+        u32 choiceOffset = 0;
+        for (u32 option = 0; option < argumentOptionCount; option++)
+        {
+            const u32 argument = optionArguments[option];
+            CompletionOption &completionOption = options[option];
+            completionOption.description = appendText(schema.viewAt(schema.infos[argument].description));
+            completionOption.firstChoice = choiceOffset;
+            completionOption.choiceCount = static_cast<u32>(choices[argument].size());
+            completionOption.type = schema.types[argument];
+            completionOption.kind = CompletionOptionKind::COMPLETION_OPTION_ARGUMENT;
+
+            for (const ArgStringView &choice : choices[argument])
+            {
+                choiceRefs[choiceOffset++] = appendText(choice);
+            }
+        }
+
+        for (u32 subcommand = 0; subcommand < schema.subcommands.size(); subcommand++)
+        {
+            CompletionOption &completionOption = options[argumentOptionCount + subcommand];
+            completionOption.description = appendText(schema.viewAt(schema.subcommands[subcommand].description));
+            completionOption.firstChoice = choiceOffset;
+            completionOption.type = ArgParserType::BOOL;
+            completionOption.kind = CompletionOptionKind::COMPLETION_OPTION_SUBCOMMAND;
+        }
+    }
+
+    static inline bool fitsSection(const CompletionHeader &header, u64 offset, u64 count, u64 elementSize)
+    {
+        return offset % NTT_COMPLETION_ALIGNMENT == 0 &&
+               offset >= sizeof(CompletionHeader) &&
+               offset <= header.size &&
+               count <= (header.size - offset) / elementSize;
+    }
+
+    bool attachCompletionIndex(const void *data, u64 size, CompletionLayout &layout)
+    {
+        if (data == nullptr ||
+            size < sizeof(CompletionHeader) ||
+            reinterpret_cast<uintptr_t>(data) % NTT_COMPLETION_ALIGNMENT != 0)
+        {
+            return false;
+        }
+
+        const u8 *bytes = static_cast<const u8 *>(data);
+        const CompletionHeader &header = *reinterpret_cast<const CompletionHeader *>(bytes);
+        if (header.magic != NTT_COMPLETION_MAGIC ||
+            header.version != NTT_COMPLETION_VERSION ||
+            header.size > size)
+        {
+            return false;
+        }
+
+        if (!fitsSection(header, header.keysOffset, header.keyCount, sizeof(CompletionKey)) ||
+            !fitsSection(header, header.optionsOffset, header.optionCount, sizeof(CompletionOption)) ||
+            !fitsSection(header, header.choicesOffset, header.choiceCount, sizeof(StringRef)) ||
+            !fitsSection(header, header.charsOffset, header.charCount, sizeof(char)))
+        {
+            return false;
+        }
+
+        layout.header = &header;
+        layout.keys = reinterpret_cast<const CompletionKey *>(bytes + header.keysOffset);
+        layout.options = reinterpret_cast<const CompletionOption *>(bytes + header.optionsOffset);
+        layout.choices = reinterpret_cast<const StringRef *>(bytes + header.choicesOffset);
+        layout.chars = reinterpret_cast<const char *>(bytes + header.charsOffset);
+        return true;
+    }
+} // namespace NTT_NS
@@ -0,0 +1,114 @@
+#pragma once
+#include "argument_data.hpp"
+
+// The flat layout of a completion index (`ArgParser::buildCompletionIndex`), every section is
+//      addressed by its offset from the start of the index so that the file can be mapped at any
+//      address and queried without building the schema.
+
+#define NTT_COMPLETION_MAGIC 0x43475241u // "ARGC"
+#define NTT_COMPLETION_VERSION 1u
+
+/**
+ * Every section starts at a multiple of the alignment, the attached index must be aligned the
+ *      same (which is always true for a mapping or a heap allocation).
+ */
+#define NTT_COMPLETION_ALIGNMENT 8
+
+namespace NTT_NS
+{
+    /**
+     * The first bytes of the index. The sections follow in the order of the fields: keys,
+     *      options, choices and the characters of the strings.
+     */
+    struct CompletionHeader
+    {
+        u32 magic;
+        u32 version;
+        u64 size;
+        u32 keyCount;
+        u32 optionCount;
+        u32 choiceCount;
+        u32 charCount;
+
+        u64 keysOffset;
+        u64 optionsOffset;
+        u64 choicesOffset;
+        u64 charsOffset;
+    };
+
+    /**
+     * A completed word (a trigger key or a subcommand name), the keys are sorted by their bytes
+     *      so that the words of a prefix are contiguous.
+     */
+    struct CompletionKey
+    {
+        StringRef text;
+        u32 option;
+    };
+
+    enum CompletionOptionKind : u8
+    {
+        COMPLETION_OPTION_ARGUMENT,
+        COMPLETION_OPTION_SUBCOMMAND,
+    };
+
+    /**
+     * An argument or a subcommand, shared by all of its keys. The choices are the ones of its
+     *      `ArgValidator::choice` validators, sorted.
+     */
+    struct CompletionOption
+    {
+        StringRef description;
+        u32 firstChoice;
+        u32 choiceCount;
+        ArgParserType type;
+        CompletionOptionKind kind;
+    };
+
+    /**
+     * The sections of an attached index. Only the sections are checked by
+     *      `attachCompletionIndex` so that the attach does not depend on the number of keys, each
+     *      read is checked instead (see `textAt`).
+     */
+    struct CompletionLayout
+    {
+        const CompletionHeader *header = nullptr;
+        const CompletionKey *keys = nullptr;
+        const CompletionOption *options = nullptr;
+        const StringRef *choices = nullptr;
+        const char *chars = nullptr;
+
+        /**
+         * @return An empty view if the string is not inside the character section.
+         */
+        inline ArgStringView textAt(StringRef ref) const
+        {
+            if (static_cast<u64>(ref.offset) + ref.length >= header->charCount)
+            {
+                return ArgStringView();
+            }
+            return ArgStringView(chars + ref.offset, ref.length);
+        }
+
+        /**
+         * @return `nullptr` if the option of the key is not inside the option section.
+         */
+        inline const CompletionOption *optionOf(const CompletionKey &key) const
+        {
+            return key.option < header->optionCount ? options + key.option : nullptr;
+        }
+    };
+
+    /**
+     * Writes the sorted keys of the arguments (the positional names are not keys) and the names
+     *      of the subcommands, with their descriptions, types and choices.
+     */
+    void buildCompletionIndex(const SchemaData &schema, std::vector<u8> &index);
+
+    /**
+     * Checks the header and the bounds of every section without reading the keys.
+     *
+     * @retval false if the data is not a completion index (or is truncated).
+     */
+    bool attachCompletionIndex(const void *data, u64 size, CompletionLayout &layout);
+} // namespace NTT_NS
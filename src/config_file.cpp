@@ -0,0 +1,306 @@
+#include "config_file.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+/**
+ * The size of the chunks read to find the line of an error.
+ */
+#define NTT_CONFIG_BUFFER_SIZE (64 * 1024)
+
+namespace NTT_NS
+{
+    /**
+     * Receives the JSON events of the config file. The path of the current member is built as the
+     *      key which it matches (`--output.path` for `"output": {"path": ...}`), the members of a
+     *      nested object are only matched if some key starts with the path of the object.
+     */
+    class ConfigHandler : public nlohmann::json_sax<nlohmann::json>
+    {
+    public:
+        explicit ConfigHandler(SchemaData &schema)
+            : m_schema(schema)
+        {
+            // The prefixes are views into the pool, `--output` for `--output.path`.
+            for (const StringRef &key : m_schema.keys)
+            {
+                const char *text = m_schema.stringPool.data() + key.offset;
+                for (u32 length = 1; length < key.length; length++)
+                {
+                    if (text[length] == '.' &&
+                        m_objectPrefixes.find(m_schema.stringPool.data(), text, length) == NTT_ARGUMENT_INVALID_INDEX)
+                    {
+                        m_objectPrefixes.insert(text, StringRef{key.offset, length}, 0);
+                    }
+                }
+            }
+        }
+
+        bool null() override
+        {
+            // The argument keeps the value of the other sources.
+            if (m_frames.empty())
+            {
+                return false;
+            }
+            takeValue();
+            return true;
+        }
+
+        bool boolean(bool value) override
+        {
+            return value ? addValue("true", 4) : addValue("false", 5);
+        }
+
+        bool number_integer(number_integer_t value) override
+        {
+            const std::string text = std::to_string(value);
+            return addValue(text.data(), static_cast<u32>(text.length()));
+        }
+
+        bool number_unsigned(number_unsigned_t value) override
+        {
+            const std::string text = std::to_string(value);
+            return addValue(text.data(), static_cast<u32>(text.length()));
+        }
+
+        /**
+         * The text of the number is kept, it is checked by the conversion of the argument.
+         */
+        bool number_float(number_float_t, const string_t &text) override
+        {
+            return addValue(text.data(), static_cast<u32>(text.length()));
+        }
+
+        bool string(string_t &text) override
+        {
+            return addValue(text.data(), static_cast<u32>(text.length()));
+        }
+
+        bool binary(binary_t &) override
+        {
+            return false;
+        }
+
+        bool start_object(std::size_t) override
+        {
+            if (m_frames.empty())
+            {
+                m_frames.push_back(Frame{false, true, NTT_ARGUMENT_INVALID_INDEX, 0, true});
+                return true;
+            }
+
+            // A matched argument only takes a scalar or an array.
+            const bool matching = !m_frames.back().isArray && m_frames.back().matching && isObjectPrefix();
+            if (takeValue() != NTT_ARGUMENT_INVALID_INDEX)
+            {
+                return false;
+            }
+
+            m_frames.push_back(Frame{false, matching, NTT_ARGUMENT_INVALID_INDEX, m_path.size(), true});
+            return true;
+        }
+
+        bool key(string_t &text) override
+        {
+            const Frame &frame = m_frames.back();
+            m_member = NTT_ARGUMENT_INVALID_INDEX;
+            if (!frame.matching)
+            {
+                return true;
+            }
+
+            m_path.resize(frame.pathLength);
+            if (frame.pathLength != 0)
+            {
+                m_path.push_back('.');
+            }
+            else if (text.empty() || text[0] != '-')
+            {
+                m_path.append("--");
+            }
+            m_path.append(text);
+            m_member = m_schema.searchByKey(m_path.data(), static_cast<u32>(m_path.size()));
+            return true;
+        }
+
+        bool end_object() override
+        {
+            m_frames.pop_back();
+            return true;
+        }
+
+        bool start_array(std::size_t) override
+        {
+            if (m_frames.empty())
+            {
+                return false;
+            }
+
+            const bool inArray = m_frames.back().isArray;
+            const i64 argument = takeValue();
+            if (argument != NTT_ARGUMENT_INVALID_INDEX && (inArray || !m_schema.isList(static_cast<u32>(argument))))
+            {
+                return false;
+            }
+
+            m_frames.push_back(Frame{true, false, argument, m_path.size(), true});
+            return true;
+        }
+
+        bool end_array() override
+        {
+            // The empty array replaces the default list.
+            const Frame &frame = m_frames.back();
+            if (frame.argument != NTT_ARGUMENT_INVALID_INDEX && frame.isEmpty)
+            {
+                m_schema.configEntries.push_back(ConfigEntry{static_cast<u32>(frame.argument), NTT_ARG_NO_INDEX, 0});
+            }
+            m_frames.pop_back();
+            return true;
+        }
+
+        bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &) override
+        {
+            return false;
+        }
+
+    private:
+        /**
+         * An object or an array which is being read.
+         */
+        struct Frame
+        {
+            bool isArray;
+
+            /**
+             * `false` for the skipped objects and for the arrays, whose members are never matched.
+             */
+            bool matching;
+
+            /**
+             * The list argument which receives the elements of the array.
+             */
+            i64 argument;
+
+            /**
+             * The length of the path of the object, its members are appended after it.
+             */
+            u64 pathLength;
+
+            bool isEmpty;
+        };
+
+        /**
+         * Takes the next value of the current object or array.
+         *
+         * @return The argument which receives the value, `NTT_ARGUMENT_INVALID_INDEX` if the value
+         *      is skipped.
+         */
+        inline i64 takeValue()
+        {
+            Frame &frame = m_frames.back();
+            if (frame.isArray)
+            {
+                frame.isEmpty = false;
+                return frame.argument;
+            }
+            return m_member;
+        }
+
+        bool addValue(const char *data, u32 length)
+        {
+            // The document itself is an object.
+            if (m_frames.empty())
+            {
+                return false;
+            }
+
+            const i64 argument = takeValue();
+            if (argument == NTT_ARGUMENT_INVALID_INDEX)
+            {
+                return true;
+            }
+
+            const u32 offset = static_cast<u32>(m_schema.configChars.size());
+            m_schema.configChars.insert(m_schema.configChars.end(), data, data + length);
+            m_schema.configEntries.push_back(ConfigEntry{static_cast<u32>(argument), offset, length});
+            return true;
+        }
+
+        inline bool isObjectPrefix() const
+        {
+            return m_objectPrefixes.find(m_schema.stringPool.data(), m_path.data(), static_cast<u32>(m_path.size())) !=
+                   NTT_ARGUMENT_INVALID_INDEX;
+        }
+
+    private:
+        SchemaData &m_schema;
+        KeyIndex m_objectPrefixes;
+        std::vector<Frame> m_frames;
+        std::string m_path;
+
+        /**
+         * The argument matched by the last key of the current object.
+         */
+        i64 m_member = NTT_ARGUMENT_INVALID_INDEX;
+    };
+
+    /**
+     * The line of the last character read from the file, which is the one the reader stopped at.
+     */
+    static u32 lineOfLastRead(FILE *file)
+    {
+        const long position = ftell(file);
+        if (position <= 0 || fseek(file, 0, SEEK_SET) != 0)
+        {
+            return 1;
+        }
+
+        std::vector<char> buffer(NTT_CONFIG_BUFFER_SIZE);
+        u64 remaining = static_cast<u64>(position - 1);
+        u32 line = 1;
+        while (remaining != 0)
+        {
+            const u64 count = fread(buffer.data(), 1, remaining < buffer.size() ? remaining : buffer.size(), file);
+            if (count == 0)
+            {
+                break;
+            }
+
+            line += static_cast<u32>(std::count(buffer.data(), buffer.data() + count, '\n'));
+            remaining -= count;
+        }
+        return line;
+    }
+
+    ArgStatus loadConfigFile(SchemaData &schema, const char *path)
+    {
+        schema.configEntries.clear();
+        schema.configChars.clear();
+
+        const ArgStringView pathView(path, static_cast<u32>(strlen(path)));
+        FILE *file = fopen(path, "rb");
+        if (file == nullptr)
+        {
+            return ArgStatus(ArgErrorCode::ARG_ERROR_CONFIG_FILE_NOT_OPENED, NTT_ARG_NO_INDEX, NTT_ARG_NO_INDEX, pathView);
+        }
+
+        ConfigHandler handler(schema);
+        const bool isValid = nlohmann::json::sax_parse(file, &handler);
+        const u32 line = isValid ? 0 : lineOfLastRead(file);
+        fclose(file);
+
+        if (!isValid)
+        {
+            schema.configEntries.clear();
+            schema.configChars.clear();
+            return ArgStatus(ArgErrorCode::ARG_ERROR_CONFIG_FILE_INVALID, line, NTT_ARG_NO_INDEX, pathView);
+        }
+
+        return ArgStatus();
+    }
+} // namespace NTT_NS
@@ -0,0 +1,21 @@
+#pragma once
+#include <NTTLib.hpp>
+#include "argument_data.hpp"
+
+namespace NTT_NS
+{
+    /**
+     * Streams the JSON config file at `path` through the SAX parser of nlohmann/json and replaces
+     *      the config layer of the schema (`configEntries`, `configChars`). No document is built,
+     *      each member is matched against the long keys while it is read (`"radius"` and
+     *      `"--radius"` both match `--radius`, the members of a nested object are joined with
+     *      `.`), only the values of the matched members are kept and the others are skipped. The
+     *      values are kept as text and converted by each parse like the command line values.
+     *
+     * On failure the config layer of the schema is left empty.
+     *
+     * @return `ARG_ERROR_CONFIG_FILE_NOT_OPENED` or `ARG_ERROR_CONFIG_FILE_INVALID` (whose token
+     *      index is the line of the error) on failure.
+     */
+    ArgStatus loadConfigFile(SchemaData &schema, const char *path);
+} // namespace NTT_NS
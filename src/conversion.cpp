@@ -0,0 +1,459 @@
+#include "conversion.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+// Only this number of significant digits are accumulated into the mantissa, the remaining digits
+//      only adjust the exponent (u64 holds 19 decimal digits without overflow).
+#define NTT_CONVERSION_MAX_MANTISSA_DIGITS 19
+
+// Exponents outside this range always overflow or underflow the f32 range.
+#define NTT_CONVERSION_MAX_EXPONENT 400
+
+// The significant digits of `formatF64`, the default precision of `%g`.
+#define NTT_CONVERSION_FORMAT_DIGITS 6
+
+namespace NTT_NS
+{
+    /**
+     * Powers of 10 which are exactly representable in double.
+     */
+    static const f64 s_exactPowersOf10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    static const i32 s_maxExactPowerOf10 = 22;
+
+    static inline bool isDigit(char character)
+    {
+        return character >= '0' && character <= '9';
+    }
+
+    static inline char toLower(char character)
+    {
+        return (character >= 'A' && character <= 'Z') ? static_cast<char>(character - 'A' + 'a') : character;
+    }
+
+    /**
+     * Case insensitive comparison of the whole range with the lower case `word`.
+     */
+    static bool equalsWord(const char *begin, const char *end, const char *word)
+    {
+        for (; begin != end; begin++, word++)
+        {
+            if (*word == '\0' || toLower(*begin) != *word)
+            {
+                return false;
+            }
+        }
+        return *word == '\0';
+    }
+
+    static inline bool isSpace(char character)
+    {
+        return character == ' ' || (character >= '\t' && character <= '\r');
+    }
+
+    /**
+     * Case insensitive check that the range starts with the lower case `word`.
+     */
+    static bool startsWithWord(const char *begin, const char *end, const char *word)
+    {
+        for (; *word != '\0'; begin++, word++)
+        {
+            if (begin == end || toLower(*begin) != *word)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static const char *skipDigits(const char *begin, const char *end)
+    {
+        while (begin != end && isDigit(*begin))
+        {
+            begin++;
+        }
+        return begin;
+    }
+
+    static f64 scaleByPowerOf10(f64 value, i32 exponent)
+    {
+        if (exponent >= 0)
+        {
+            while (exponent > s_maxExactPowerOf10)
+            {
+                value *= s_exactPowersOf10[s_maxExactPowerOf10];
+                exponent -= s_maxExactPowerOf10;
+            }
+            return value * s_exactPowersOf10[exponent];
+        }
+
+        exponent = -exponent;
+        while (exponent > s_maxExactPowerOf10)
+        {
+            value /= s_exactPowersOf10[s_maxExactPowerOf10];
+            exponent -= s_maxExactPowerOf10;
+        }
+        return value / s_exactPowersOf10[exponent];
+    }
+
+    bool parseI32(const char *begin, const char *end, i32 &out)
+    {
+        if (begin == end)
+        {
+            return false;
+        }
+
+        bool negative = false;
+        if (*begin == '+' || *begin == '-')
+        {
+            negative = *begin == '-';
+            begin++;
+        }
+
+        if (begin == end)
+        {
+            return false;
+        }
+
+        // The magnitude of the minimum value is one more than the maximum value.
+        const u64 limit = negative
+                              ? static_cast<u64>(std::numeric_limits<i32>::max()) + 1
+                              : static_cast<u64>(std::numeric_limits<i32>::max());
+        u64 magnitude = 0;
+
+        for (; begin != end; begin++)
+        {
+            if (!isDigit(*begin))
+            {
+                return false;
+            }
+
+            magnitude = magnitude * 10 + static_cast<u64>(*begin - '0');
+            if (magnitude > limit)
+            {
+                return false;
+            }
+        }
+
+        out = negative
+                  ? static_cast<i32>(-static_cast<i64>(magnitude))
+                  : static_cast<i32>(magnitude);
+        return true;
+    }
+
+    bool parseF32(const char *begin, const char *end, f32 &out)
+    {
+        if (begin == end)
+        {
+            return false;
+        }
+
+        bool negative = false;
+        if (*begin == '+' || *begin == '-')
+        {
+            negative = *begin == '-';
+            begin++;
+        }
+
+        if (begin == end)
+        {
+            return false;
+        }
+
+        if (!isDigit(*begin) && *begin != '.')
+        {
+            f32 special = 0.0f;
+            if (equalsWord(begin, end, "inf") || equalsWord(begin, end, "infinity"))
+            {
+                special = std::numeric_limits<f32>::infinity();
+            }
+            else if (equalsWord(begin, end, "nan"))
+            {
+                special = std::numeric_limits<f32>::quiet_NaN();
+            }
+            else
+            {
+                return false;
+            }
+
+            out = negative ? -special : special;
+            return true;
+        }
+
+        u64 mantissa = 0;
+        u32 mantissaDigits = 0;
+        i32 exponent = 0;
+        bool hasDigits = false;
+
+        for (; begin != end && isDigit(*begin); begin++)
+        {
+            hasDigits = true;
+            if (mantissaDigits < NTT_CONVERSION_MAX_MANTISSA_DIGITS)
+            {
+                mantissa = mantissa * 10 + static_cast<u64>(*begin - '0');
+                mantissaDigits += mantissa != 0 ? 1 : 0;
+            }
+            else
+            {
+                exponent++;
+            }
+        }
+
+        if (begin != end && *begin == '.')
+        {
+            begin++;
+            for (; begin != end && isDigit(*begin); begin++)
+            {
+                hasDigits = true;
+                if (mantissaDigits < NTT_CONVERSION_MAX_MANTISSA_DIGITS)
+                {
+                    mantissa = mantissa * 10 + static_cast<u64>(*begin - '0');
+                    mantissaDigits += mantissa != 0 ? 1 : 0;
+                    exponent--;
+                }
+            }
+        }
+
+        if (!hasDigits)
+        {
+            return false;
+        }
+
+        if (begin != end && (*begin == 'e' || *begin == 'E'))
+        {
+            begin++;
+
+            bool negativeExponent = false;
+            if (begin != end && (*begin == '+' || *begin == '-'))
+            {
+                negativeExponent = *begin == '-';
+                begin++;
+            }
+
+            if (begin == end)
+            {
+                return false;
+            }
+
+            i32 explicitExponent = 0;
+            for (; begin != end; begin++)
+            {
+                if (!isDigit(*begin))
+                {
+                    return false;
+                }
+
+                if (explicitExponent < NTT_CONVERSION_MAX_EXPONENT)
+                {
+                    explicitExponent = explicitExponent * 10 + (*begin - '0');
+                }
+            }
+
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        if (begin != end)
+        {
+            return false;
+        }
+
+        f64 value = 0.0;
+        if (mantissa != 0)
+        {
+            if (exponent > NTT_CONVERSION_MAX_EXPONENT)
+            {
+                return false;
+            }
+
+            if (exponent >= -NTT_CONVERSION_MAX_EXPONENT)
+            {
+                value = scaleByPowerOf10(static_cast<f64>(mantissa), exponent);
+            }
+        }
+
+        // Checked after the rounding, the values just above `FLT_MAX` (`3.4028235e38`) round to it.
+        const f32 rounded = static_cast<f32>(value);
+        if (std::isinf(rounded))
+        {
+            return false;
+        }
+
+        out = negative ? -rounded : rounded;
+        return true;
+    }
+
+    bool parseI32Prefix(const char *begin, const char *end, i32 &out)
+    {
+        while (begin != end && isSpace(*begin))
+        {
+            begin++;
+        }
+
+        const char *cursor = begin;
+        if (cursor != end && (*cursor == '+' || *cursor == '-'))
+        {
+            cursor++;
+        }
+
+        return parseI32(begin, skipDigits(cursor, end), out);
+    }
+
+    bool parseF32Prefix(const char *begin, const char *end, f32 &out)
+    {
+        while (begin != end && isSpace(*begin))
+        {
+            begin++;
+        }
+
+        const char *cursor = begin;
+        if (cursor != end && (*cursor == '+' || *cursor == '-'))
+        {
+            cursor++;
+        }
+
+        // The longest word first, `infinity` also starts with `inf`.
+        static const char *const s_words[] = {"infinity", "inf", "nan"};
+        for (const char *word : s_words)
+        {
+            if (startsWithWord(cursor, end, word))
+            {
+                return parseF32(begin, cursor + strlen(word), out);
+            }
+        }
+
+        const char *digitsEnd = skipDigits(cursor, end);
+        if (digitsEnd != end && *digitsEnd == '.')
+        {
+            digitsEnd = skipDigits(digitsEnd + 1, end);
+        }
+
+        // The exponent only belongs to the number when it has digits.
+        if (digitsEnd != end && (*digitsEnd == 'e' || *digitsEnd == 'E'))
+        {
+            const char *exponent = digitsEnd + 1;
+            if (exponent != end && (*exponent == '+' || *exponent == '-'))
+            {
+                exponent++;
+            }
+
+            const char *exponentEnd = skipDigits(exponent, end);
+            if (exponentEnd != exponent)
+            {
+                digitsEnd = exponentEnd;
+            }
+        }
+
+        return parseF32(begin, digitsEnd, out);
+    }
+
+    static char *appendText(char *out, const char *text)
+    {
+        while (*text != '\0')
+        {
+            *out++ = *text++;
+        }
+        return out;
+    }
+
+    u32 formatF64(f64 value, char *out)
+    {
+        char *cursor = out;
+        if (std::signbit(value))
+        {
+            *cursor++ = '-';
+            value = -value;
+        }
+
+        if (std::isnan(value))
+        {
+            cursor = appendText(cursor, "nan");
+        }
+        else if (std::isinf(value))
+        {
+            cursor = appendText(cursor, "inf");
+        }
+        else
+        {
+            // `%.5e` rounds to the same digits as `%g`, only its decimal separator depends on the
+            //      locale so the digits and the exponent are picked out of it.
+            char scientific[32];
+            snprintf(scientific, sizeof(scientific), "%.*e", NTT_CONVERSION_FORMAT_DIGITS - 1, value);
+
+            char digits[NTT_CONVERSION_FORMAT_DIGITS];
+            i32 digitCount = 0;
+            const char *text = scientific;
+            for (; *text != 'e' && *text != '\0'; text++)
+            {
+                if (isDigit(*text) && digitCount < NTT_CONVERSION_FORMAT_DIGITS)
+                {
+                    digits[digitCount++] = *text;
+                }
+            }
+
+            i32 exponent = 0;
+            const bool negativeExponent = text[0] == 'e' && text[1] == '-';
+            for (text += text[0] == 'e' ? 2 : 0; isDigit(*text); text++)
+            {
+                exponent = exponent * 10 + (*text - '0');
+            }
+            exponent = negativeExponent ? -exponent : exponent;
+
+            while (digitCount > 1 && digits[digitCount - 1] == '0')
+            {
+                digitCount--;
+            }
+
+            if (exponent < -4 || exponent >= NTT_CONVERSION_FORMAT_DIGITS)
+            {
+                *cursor++ = digits[0];
+                if (digitCount > 1)
+                {
+                    *cursor++ = '.';
+                    memcpy(cursor, digits + 1, digitCount - 1);
+                    cursor += digitCount - 1;
+                }
+
+                *cursor++ = 'e';
+                *cursor++ = exponent < 0 ? '-' : '+';
+                const i32 magnitude = exponent < 0 ? -exponent : exponent;
+                if (magnitude >= 100)
+                {
+                    *cursor++ = static_cast<char>('0' + magnitude / 100);
+                }
+                *cursor++ = static_cast<char>('0' + magnitude / 10 % 10);
+                *cursor++ = static_cast<char>('0' + magnitude % 10);
+            }
+            else if (exponent >= 0)
+            {
+                for (i32 digit = 0; digit <= exponent; digit++)
+                {
+                    *cursor++ = digit < digitCount ? digits[digit] : '0';
+                }
+                if (digitCount > exponent + 1)
+                {
+                    *cursor++ = '.';
+                    memcpy(cursor, digits + exponent + 1, digitCount - exponent - 1);
+                    cursor += digitCount - exponent - 1;
+                }
+            }
+            else
+            {
+                *cursor++ = '0';
+                *cursor++ = '.';
+                for (i32 zero = -1; zero > exponent; zero--)
+                {
+                    *cursor++ = '0';
+                }
+                memcpy(cursor, digits, digitCount);
+                cursor += digitCount;
+            }
+        }
+
+        *cursor = '\0';
+        return static_cast<u32>(cursor - out);
+    }
+} // namespace NTT_NS
@@ -0,0 +1,72 @@
+#pragma once
+#include <NTTLib.hpp>
+
+// The size of the buffer which `formatF64` writes into, the longest text is `-1.23457e-308`.
+#define NTT_CONVERSION_FORMAT_CAPACITY 16
+
+namespace NTT_NS
+{
+    /**
+     * Converts the whole range `[begin, end)` into a 32 bit signed integer. The conversion never
+     *      throws, never allocates and does not depend on the current locale.
+     *
+     * Accepted format: an optional sign followed by at least one decimal digit, nothing else (no
+     *      spaces, no trailing characters).
+     *
+     * @param out Receives the value only when the conversion succeeds.
+     *
+     * @retval true if the range is a valid integer which fits into `i32`.
+     * @retval false otherwise, `out` is untouched.
+     */
+    bool parseI32(const char *begin, const char *end, i32 &out);
+
+    /**
+     * Converts the whole range `[begin, end)` into a 32 bit float. The conversion never throws,
+     *      never allocates and does not depend on the current locale (the decimal separator is
+     *      always `.`).
+     *
+     * Accepted format: an optional sign followed by either `inf`, `infinity`, `nan` (case
+     *      insensitive) or decimal digits with an optional fraction and an optional exponent
+     *      (`1`, `1.`, `.5`, `-2.5e-3`). The result is computed in double precision, so that it is
+     *      exact for the usual inputs (up to 15 significant digits).
+     *
+     * @param out Receives the value only when the conversion succeeds.
+     *
+     * @retval true if the range is a valid number which does not overflow `f32`.
+     * @retval false otherwise, `out` is untouched.
+     */
+    bool parseF32(const char *begin, const char *end, f32 &out);
+
+    /**
+     * Converts the longest integer at the start of `[begin, end)` like `std::stoi` does: the
+     *      leading white space is skipped and the characters after the digits are ignored
+     *      (`12abc` gives `12`). Used by `LENIENT_CONVERSION` for the values which `parseI32`
+     *      rejects.
+     *
+     * @retval true if the range starts with a valid integer which fits into `i32`.
+     * @retval false otherwise, `out` is untouched.
+     */
+    bool parseI32Prefix(const char *begin, const char *end, i32 &out);
+
+    /**
+     * Converts the longest number at the start of `[begin, end)` like `std::stof` does (apart
+     *      from the hexadecimal form): the leading white space is skipped and the characters after
+     *      the number are ignored (`2.5x` gives `2.5`, `1e` gives `1`). Used by
+     *      `LENIENT_CONVERSION` for the values which `parseF32` rejects.
+     *
+     * @retval true if the range starts with a valid number which does not overflow `f32`.
+     * @retval false otherwise, `out` is untouched.
+     */
+    bool parseF32Prefix(const char *begin, const char *end, f32 &out);
+
+    /**
+     * Writes the value the way `printf("%g")` does in the "C" locale (6 significant digits, no
+     *      trailing zeros, `.` as the decimal separator whatever the current locale is).
+     *
+     * @param out Receives the text and a terminating `\0`, it holds at least
+     *      `NTT_CONVERSION_FORMAT_CAPACITY` characters.
+     *
+     * @return The length of the text.
+     */
+    u32 formatF64(f64 value, char *out);
+} // namespace NTT_NS
@@ -0,0 +1,417 @@
+#include "help.hpp"
+#include <cstdio>
+#include <cstring>
+#include "conversion.hpp"
+
+#ifdef NTT_PLATFORM_UNIX
+#include <cerrno>
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+/**
+ * The descriptions are aligned after the widest keys up to this width, the longer keys are
+ *      followed by a new line instead.
+ */
+#define NTT_HELP_MAX_KEY_WIDTH 32
+#define NTT_HELP_INDENT 2
+#define NTT_HELP_GAP 2
+
+namespace NTT_NS
+{
+    /**
+     * Receives the pieces of the text, only counts them when no output is given so that the
+     *      same layout measures the text before it is copied into the buffer of that size.
+     */
+    class HelpSink
+    {
+    public:
+        explicit HelpSink(char *output)
+            : m_output(output)
+        {
+        }
+
+        inline void append(const char *data, u64 length)
+        {
+            if (m_output != nullptr)
+            {
+                memcpy(m_output + m_size, data, length);
+            }
+            m_size += length;
+        }
+
+        inline void append(const char *text) { append(text, strlen(text)); }
+        inline void append(ArgStringView text) { append(text.data(), text.length()); }
+
+        inline void fill(char character, u64 count)
+        {
+            if (m_output != nullptr)
+            {
+                memset(m_output + m_size, character, count);
+            }
+            m_size += count;
+        }
+
+        inline u64 size() const { return m_size; }
+
+    private:
+        char *m_output;
+        u64 m_size = 0;
+    };
+
+    /**
+     * The value placeholder after the keys, `-c <i32>`, `--inputs <string>...`. The flags have
+     *      no value.
+     */
+    struct ValueHint
+    {
+        const char *open;
+        const char *typeName;
+        const char *close;
+
+        inline u64 length() const { return strlen(open) + strlen(typeName) + strlen(close); }
+    };
+
+    static ValueHint valueHint(const SchemaData &schema, u32 index)
+    {
+        // The positional arguments are shown by their name, `inputs...` when repeated.
+        if (schema.isPositional(index))
+        {
+            return ValueHint{"", "", (schema.flags[index] & ARGUMENT_FLAG_MULTIPLE_VALUES) != 0 ? "..." : ""};
+        }
+
+        const char *typeName = "";
+        switch (schema.types[index])
+        {
+        case ArgParserType::STRING:
+        case ArgParserType::STRING_LIST:
+            typeName = "string";
+            break;
+        case ArgParserType::I32:
+        case ArgParserType::I32_LIST:
+            typeName = "i32";
+            break;
+        case ArgParserType::F32:
+        case ArgParserType::F32_LIST:
+            typeName = "f32";
+            break;
+        case ArgParserType::BOOL_LIST:
+            typeName = "bool";
+            break;
+        case ArgParserType::BOOL:
+        default:
+            return ValueHint{"", "", ""};
+        }
+
+        if (!schema.isList(index) || (schema.flags[index] & ARGUMENT_FLAG_MULTIPLE_VALUES) == 0)
+        {
+            return ValueHint{" <", typeName, ">"};
+        }
+        if ((schema.flags[index] & ARGUMENT_FLAG_OPTIONAL_VALUE) != 0)
+        {
+            return ValueHint{" [<", typeName, ">...]"};
+        }
+        return ValueHint{" <", typeName, ">..."};
+    }
+
+    static u64 keyWidth(const SchemaData &schema, u32 index)
+    {
+        const ArgumentInfo &info = schema.infos[index];
+        u64 width = valueHint(schema, index).length() + (info.keyCount - 1) * 2;
+        for (u32 key = 0; key < info.keyCount; key++)
+        {
+            width += schema.keys[info.firstKey + key].length;
+        }
+        return width;
+    }
+
+    static void appendNumber(HelpSink &sink, f64 value)
+    {
+        char text[NTT_CONVERSION_FORMAT_CAPACITY];
+        sink.append(text, formatF64(value, text));
+    }
+
+    static void appendNumber(HelpSink &sink, i32 value)
+    {
+        char text[16];
+        char *end = text + sizeof(text);
+        char *begin = end;
+
+        // Through u32 so that the smallest i32 is negated without overflow.
+        u32 magnitude = value < 0 ? 0u - static_cast<u32>(value) : static_cast<u32>(value);
+        do
+        {
+            *--begin = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+
+        if (value < 0)
+        {
+            *--begin = '-';
+        }
+        sink.append(begin, static_cast<u64>(end - begin));
+    }
+
+    static void appendListDefault(HelpSink &sink, const SchemaData &schema, u32 index)
+    {
+        const ListRange range = schema.defaultValues[index].listValue;
+
+        sink.append(" (default: [");
+        for (u32 i = 0; i < range.count; i++)
+        {
+            if (i != 0)
+            {
+                sink.append(", ");
+            }
+
+            const u32 item = range.offset + i;
+            switch (schema.types[index])
+            {
+            case ArgParserType::STRING_LIST:
+                sink.append(schema.viewAt(schema.listDefaultStrings[item]));
+                break;
+            case ArgParserType::I32_LIST:
+                appendNumber(sink, schema.listDefaultI32s[item]);
+                break;
+            case ArgParserType::F32_LIST:
+                appendNumber(sink, schema.listDefaultF32s[item]);
+                break;
+            case ArgParserType::BOOL_LIST:
+                sink.append(schema.listDefaultBools[item] != 0 ? "true" : "false");
+                break;
+            case ArgParserType::STRING:
+            case ArgParserType::I32:
+            case ArgParserType::F32:
+            case ArgParserType::BOOL:
+            default:
+                break;
+            }
+        }
+        sink.append("])");
+    }
+
+    /**
+     * ` (required)` or ` (default: ...)`, nothing for the empty defaults (empty string, `false`
+     *      flag, empty list).
+     */
+    static void appendSuffix(HelpSink &sink, const SchemaData &schema, u32 index)
+    {
+        if ((schema.flags[index] & ARGUMENT_FLAG_REQUIRED) != 0)
+        {
+            sink.append(" (required)");
+            return;
+        }
+
+        if (schema.isPositional(index))
+        {
+            return;
+        }
+
+        const ArgumentValue &value = schema.defaultValues[index];
+        switch (schema.types[index])
+        {
+        case ArgParserType::STRING:
+            if (schema.infos[index].defaultString.length != 0)
+            {
+                sink.append(" (default: ");
+                sink.append(schema.viewAt(schema.infos[index].defaultString));
+                sink.append(")");
+            }
+            break;
+        case ArgParserType::I32:
+            sink.append(" (default: ");
+            appendNumber(sink, value.i32Value);
+            sink.append(")");
+            break;
+        case ArgParserType::F32:
+            sink.append(" (default: ");
+            appendNumber(sink, value.f32Value);
+            sink.append(")");
+            break;
+        case ArgParserType::BOOL:
+            if (value.boolValue)
+            {
+                sink.append(" (default: true)");
+            }
+            break;
+        case ArgParserType::STRING_LIST:
+        case ArgParserType::I32_LIST:
+        case ArgParserType::F32_LIST:
+        case ArgParserType::BOOL_LIST:
+            if (value.listValue.count != 0)
+            {
+                appendListDefault(sink, schema, index);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    /**
+     * Pads the line from the keys (of the given width) to the description column.
+     */
+    static void alignDescription(HelpSink &sink, u64 width, u64 column)
+    {
+        if (width + NTT_HELP_INDENT + NTT_HELP_GAP <= column)
+        {
+            sink.fill(' ', column - width - NTT_HELP_INDENT);
+        }
+        else
+        {
+            sink.append("\n");
+            sink.fill(' ', column);
+        }
+    }
+
+    /**
+     * One line of the help: the keys (or the name of a positional argument), the value type,
+     *      the description and the suffixes.
+     */
+    static void appendArgument(HelpSink &sink, const SchemaData &schema, u32 index, u64 column)
+    {
+        const ArgumentInfo &info = schema.infos[index];
+
+        sink.fill(' ', NTT_HELP_INDENT);
+        for (u32 key = 0; key < info.keyCount; key++)
+        {
+            if (key != 0)
+            {
+                sink.append(", ");
+            }
+            sink.append(schema.viewAt(schema.keys[info.firstKey + key]));
+        }
+
+        const ValueHint hint = valueHint(schema, index);
+        sink.append(hint.open);
+        sink.append(hint.typeName);
+        sink.append(hint.close);
+
+        alignDescription(sink, keyWidth(schema, index), column);
+        sink.append(schema.viewAt(info.description));
+        appendSuffix(sink, schema, index);
+        if (info.environmentName.length != 0)
+        {
+            sink.append(" [env: ");
+            sink.append(schema.viewAt(info.environmentName));
+            sink.append("]");
+        }
+        sink.append("\n");
+    }
+
+    static void layoutHelp(const String &description, const SchemaData &schema, HelpSink &sink)
+    {
+        const bool showShortHelp = schema.searchByKey("-h", 2) == NTT_ARGUMENT_INVALID_INDEX;
+        const bool showLongHelp = schema.searchByKey("--help", 6) == NTT_ARGUMENT_INVALID_INDEX;
+        const u64 helpWidth = (showShortHelp ? 2 : 0) + (showLongHelp ? 6 : 0) + (showShortHelp && showLongHelp ? 2 : 0);
+
+        u64 widest = helpWidth;
+        for (u32 index = 0; index < schema.count(); index++)
+        {
+            const u64 width = keyWidth(schema, index);
+            if (width <= NTT_HELP_MAX_KEY_WIDTH && width > widest)
+            {
+                widest = width;
+            }
+        }
+        for (const SubcommandInfo &subcommand : schema.subcommands)
+        {
+            if (subcommand.name.length <= NTT_HELP_MAX_KEY_WIDTH && subcommand.name.length > widest)
+            {
+                widest = subcommand.name.length;
+            }
+        }
+        const u64 column = NTT_HELP_INDENT + widest + NTT_HELP_GAP;
+
+        if (description.length() != 0)
+        {
+            sink.append(description.c_str(), description.length());
+            sink.append("\n\n");
+        }
+        if (!schema.positionals.empty())
+        {
+            sink.append("Arguments:\n");
+            for (const PositionalInfo &positional : schema.positionals)
+            {
+                appendArgument(sink, schema, positional.argument, column);
+            }
+            sink.append("\n");
+        }
+        sink.append("Options:\n");
+
+        if (helpWidth != 0)
+        {
+            sink.fill(' ', NTT_HELP_INDENT);
+            sink.append(showShortHelp ? (showLongHelp ? "-h, --help" : "-h") : "--help");
+            alignDescription(sink, helpWidth, column);
+            sink.append("Show this help message and exit\n");
+        }
+
+        for (u32 index = 0; index < schema.count(); index++)
+        {
+            if (!schema.isPositional(index))
+            {
+                appendArgument(sink, schema, index, column);
+            }
+        }
+
+        if (!schema.subcommands.empty())
+        {
+            sink.append("\nCommands:\n");
+        }
+        for (const SubcommandInfo &subcommand : schema.subcommands)
+        {
+            sink.fill(' ', NTT_HELP_INDENT);
+            sink.append(schema.viewAt(subcommand.name));
+            alignDescription(sink, subcommand.name.length, column);
+            sink.append(schema.viewAt(subcommand.description));
+            sink.append("\n");
+        }
+    }
+
+    void HelpText::update(const String &description, const SchemaData &schema)
+    {
+        if (m_isValid)
+        {
+            return;
+        }
+
+        HelpSink measure(nullptr);
+        layoutHelp(description, schema, measure);
+
+        m_buffer.resize(measure.size());
+        HelpSink sink(m_buffer.data());
+        layoutHelp(description, schema, sink);
+
+        m_isValid = true;
+    }
+
+    void HelpText::write() const
+    {
+        fflush(stdout);
+
+        const char *data = m_buffer.data();
+        u64 remaining = m_buffer.size();
+        while (remaining != 0)
+        {
+#ifdef NTT_PLATFORM_UNIX
+            const ssize_t written = ::write(STDOUT_FILENO, data, remaining);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+#else
+            const int written = _write(1, data, static_cast<unsigned int>(remaining));
+#endif
+            if (written <= 0)
+            {
+                return;
+            }
+
+            // A single call writes the whole text unless the output is a full pipe.
+            data += written;
+            remaining -= static_cast<u64>(written);
+        }
+    }
+} // namespace NTT_NS
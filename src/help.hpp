@@ -0,0 +1,51 @@
+#pragma once
+#include <NTTLib.hpp>
+#include <vector>
+#include "argument_data.hpp"
+
+namespace NTT_NS
+{
+    /**
+     * The help (usage) text of a schema: the description followed by one line per argument (keys,
+     *      value type, description, required flag or default value) and one line per subcommand.
+     *      The text is laid out once into a single buffer whose size is measured beforehand, so
+     *      that the buffer is allocated once, and it is kept until `invalidate`.
+     */
+    class HelpText
+    {
+    public:
+        /**
+         * Lays out the text if it is not valid anymore (the first call or after `invalidate`).
+         */
+        void update(const String &description, const SchemaData &schema);
+
+        /**
+         * Must be called whenever an argument is added or changed.
+         */
+        inline void invalidate() { m_isValid = false; }
+
+        inline ArgStringView view() const
+        {
+            return ArgStringView(m_buffer.data(), static_cast<u32>(m_buffer.size()));
+        }
+
+        /**
+         * Writes the whole text into the standard output with a single system call (the
+         *      buffered `stdout` is flushed first so that the order of the outputs is kept).
+         */
+        void write() const;
+
+    private:
+        std::vector<char> m_buffer;
+        bool m_isValid = false;
+    };
+
+    /**
+     * @retval true if the token is `-h` or `--help`, only checked for the keys which are not
+     *      defined by the schema.
+     */
+    inline bool isHelpKey(const ArgToken &token)
+    {
+        return token.equals("-h", 2) || token.equals("--help", 6);
+    }
+} // namespace NTT_NS
@@ -0,0 +1,64 @@
+#include "instrumentation.hpp"
+#include <atomic>
+#include <string>
+
+namespace NTT_NS
+{
+    static std::atomic<ArgAllocationCounter> s_allocationCounter(nullptr);
+
+    void setArgAllocationCounter(ArgAllocationCounter counter)
+    {
+        s_allocationCounter.store(counter, std::memory_order_release);
+    }
+
+    static inline void appendJsonField(std::string &json, const char *name, u64 value)
+    {
+        json.append(", \"");
+        json.append(name);
+        json.append("\": ");
+        json.append(std::to_string(value));
+    }
+
+    String ArgParseCounters::toJson() const
+    {
+        std::string json = isArgInstrumentationEnabled() ? "{\"enabled\": true" : "{\"enabled\": false";
+        appendJsonField(json, "parses", parses);
+        appendJsonField(json, "failed_parses", failedParses);
+        appendJsonField(json, "tokens", tokens);
+        appendJsonField(json, "key_lookups", keyLookups);
+        appendJsonField(json, "key_comparisons", keyComparisons);
+        appendJsonField(json, "conversions", conversions);
+        appendJsonField(json, "conversion_failures", conversionFailures);
+        appendJsonField(json, "allocations", allocations);
+        appendJsonField(json, "parse_ns", parseNanoseconds);
+        appendJsonField(json, "lookup_ns", lookupNanoseconds);
+        appendJsonField(json, "conversion_ns", conversionNanoseconds);
+        appendJsonField(json, "source_ns", sourceNanoseconds);
+        appendJsonField(json, "required_check_ns", requiredCheckNanoseconds);
+        appendJsonField(json, "validations", validations);
+        appendJsonField(json, "validation_ns", validationNanoseconds);
+        json.append("}");
+        return String(json);
+    }
+
+#ifdef NTT_ARG_INSTRUMENTATION
+    ArgParseMeasure::ArgParseMeasure(ArgParseCounters &counters)
+        : m_counters(counters),
+          m_allocationCounter(s_allocationCounter.load(std::memory_order_acquire)),
+          m_allocationStart(m_allocationCounter != nullptr ? m_allocationCounter() : 0),
+          m_start(instrumentationNow())
+    {
+    }
+
+    void ArgParseMeasure::finish(bool succeeded)
+    {
+        m_counters.parseNanoseconds += instrumentationNow() - m_start;
+        if (m_allocationCounter != nullptr)
+        {
+            m_counters.allocations += m_allocationCounter() - m_allocationStart;
+        }
+        m_counters.parses++;
+        m_counters.failedParses += succeeded ? 0 : 1;
+    }
+#endif
+} // namespace NTT_NS
@@ -0,0 +1,162 @@
+#pragma once
+#include <NTTLib.hpp>
+
+// The parse counters are only updated when the library is built with `NTT_ARG_INSTRUMENTATION`
+//      (the `NTTArgParser_USE_INSTRUMENTATION` option), otherwise every hook is compiled out and
+//      the counters stay `0`.
+#ifdef NTT_ARG_INSTRUMENTATION
+#include <chrono>
+#define NTT_ARG_INSTRUMENT(...) __VA_ARGS__
+#else
+#define NTT_ARG_INSTRUMENT(...)
+#endif
+
+namespace NTT_NS
+{
+    /**
+     * What the parses into one result cost, accumulated until `ArgParser::resetCounters` (the
+     *      values and `reset()` do not affect them). The time of a phase is the wall time spent
+     *      inside it, the conversions done during the token loop are not part of the lookup.
+     */
+    struct ArgParseCounters
+    {
+        u64 parses = 0;
+        u64 failedParses = 0;
+
+        /**
+         * The tokens handed to the parse (after the expansion of the response files).
+         */
+        u64 tokens = 0;
+
+        /**
+         * The lookups of the key tokens and the slots of the key index which are compared by them
+         *      (`1` per lookup without any collision).
+         */
+        u64 keyLookups = 0;
+        u64 keyComparisons = 0;
+
+        /**
+         * The `i32` and `f32` values (list items included) which are converted and those which
+         *      cannot be (whatever the conversion policy is).
+         */
+        u64 conversions = 0;
+        u64 conversionFailures = 0;
+
+        /**
+         * The heap allocations during the parses, only counted once a counter is installed by
+         *      `setArgAllocationCounter`.
+         */
+        u64 allocations = 0;
+
+        u64 parseNanoseconds = 0;
+        u64 lookupNanoseconds = 0;
+        u64 conversionNanoseconds = 0;
+
+        /**
+         * The environment variables and the config layer.
+         */
+        u64 sourceNanoseconds = 0;
+        u64 requiredCheckNanoseconds = 0;
+
+        /**
+         * The values which are checked by the validators (one per validator and value) and the
+         *      wall time of the checks, the parallel ones included.
+         */
+        u64 validations = 0;
+        u64 validationNanoseconds = 0;
+
+        /**
+         * @return The counters as a single line JSON object (snake case names), with `enabled`
+         *      telling whether the library counts anything.
+         */
+        String toJson() const;
+    };
+
+    /**
+     * @return The number of heap allocations since the start of the process, provided by the
+     *      application (a replaced `operator new`, the statistics of the allocator, ...).
+     */
+    using ArgAllocationCounter = u64 (*)();
+
+    /**
+     * Installs the allocation counter which is sampled before and after every parse, `nullptr`
+     *      (the default) disables the allocation accounting. The counter is shared by every
+     *      parser and must be callable from any thread which parses.
+     */
+    void setArgAllocationCounter(ArgAllocationCounter counter);
+
+    constexpr bool isArgInstrumentationEnabled()
+    {
+#ifdef NTT_ARG_INSTRUMENTATION
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#ifdef NTT_ARG_INSTRUMENTATION
+    inline u64 instrumentationNow()
+    {
+        return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count());
+    }
+
+    /**
+     * Adds the time until `stop` (or the end of the scope) to a phase counter, the time which is
+     *      added to `excluded` meanwhile (a nested phase) is not counted twice.
+     */
+    class ArgPhaseTimer
+    {
+    public:
+        explicit ArgPhaseTimer(u64 &nanoseconds, const u64 *excluded = nullptr)
+            : m_nanoseconds(nanoseconds),
+              m_excluded(excluded),
+              m_excludedStart(excluded != nullptr ? *excluded : 0),
+              m_start(instrumentationNow())
+        {
+        }
+
+        ~ArgPhaseTimer() { stop(); }
+
+        inline void stop()
+        {
+            if (m_isRunning)
+            {
+                const u64 excluded = m_excluded != nullptr ? *m_excluded - m_excludedStart : 0;
+                m_nanoseconds += instrumentationNow() - m_start - excluded;
+                m_isRunning = false;
+            }
+        }
+
+    private:
+        u64 &m_nanoseconds;
+        const u64 *m_excluded;
+        u64 m_excludedStart;
+        u64 m_start;
+        bool m_isRunning = true;
+    };
+
+    /**
+     * Counts one whole parse: its time, its allocations and its outcome.
+     */
+    class ArgParseMeasure
+    {
+    public:
+        explicit ArgParseMeasure(ArgParseCounters &counters);
+
+        void finish(bool succeeded);
+
+    private:
+        ArgParseCounters &m_counters;
+
+        /**
+         * The counter which is installed when the parse starts, so that both samples come from
+         *      the same one.
+         */
+        ArgAllocationCounter m_allocationCounter;
+        u64 m_allocationStart;
+        u64 m_start;
+    };
+#endif
+} // namespace NTT_NS
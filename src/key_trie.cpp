@@ -0,0 +1,230 @@
+#include "key_trie.hpp"
+#include <algorithm>
+
+namespace NTT_NS
+{
+    KeyTrie::KeyTrie()
+    {
+        m_nodes.push_back(Node{NTT_KEY_TRIE_NO_NODE, NTT_KEY_TRIE_NO_NODE, NTT_KEY_TRIE_NO_ARGUMENT, NTT_KEY_TRIE_NO_ARGUMENT, '\0'});
+    }
+
+    static inline void mergeArgument(u32 &subtreeArgument, u32 argument)
+    {
+        if (subtreeArgument == NTT_KEY_TRIE_NO_ARGUMENT)
+        {
+            subtreeArgument = argument;
+        }
+        else if (subtreeArgument != argument)
+        {
+            subtreeArgument = NTT_KEY_TRIE_AMBIGUOUS;
+        }
+    }
+
+    void KeyTrie::insert(const char *key, u32 length, u32 argument)
+    {
+        u32 node = 0;
+        mergeArgument(m_nodes[node].subtreeArgument, argument);
+
+        for (u32 i = 0; i < length; i++)
+        {
+            const unsigned char label = static_cast<unsigned char>(key[i]);
+
+            // The siblings are sorted so that the keys are visited in the alphabetical order.
+            u32 previous = NTT_KEY_TRIE_NO_NODE;
+            u32 current = m_nodes[node].firstChild;
+            while (current != NTT_KEY_TRIE_NO_NODE && static_cast<unsigned char>(m_nodes[current].label) < label)
+            {
+                previous = current;
+                current = m_nodes[current].nextSibling;
+            }
+
+            if (current == NTT_KEY_TRIE_NO_NODE || static_cast<unsigned char>(m_nodes[current].label) != label)
+            {
+                const u32 created = static_cast<u32>(m_nodes.size());
+                m_nodes.push_back(Node{NTT_KEY_TRIE_NO_NODE, current, NTT_KEY_TRIE_NO_ARGUMENT, NTT_KEY_TRIE_NO_ARGUMENT, key[i]});
+                if (previous == NTT_KEY_TRIE_NO_NODE)
+                {
+                    m_nodes[node].firstChild = created;
+                }
+                else
+                {
+                    m_nodes[previous].nextSibling = created;
+                }
+                current = created;
+            }
+
+            node = current;
+            mergeArgument(m_nodes[node].subtreeArgument, argument);
+        }
+
+        m_nodes[node].argument = argument;
+    }
+
+    u32 KeyTrie::findChild(u32 node, char label) const
+    {
+        for (u32 child = m_nodes[node].firstChild; child != NTT_KEY_TRIE_NO_NODE; child = m_nodes[child].nextSibling)
+        {
+            if (m_nodes[child].label == label)
+            {
+                return child;
+            }
+        }
+        return NTT_KEY_TRIE_NO_NODE;
+    }
+
+    u32 KeyTrie::findNode(const char *prefix, u32 length) const
+    {
+        u32 node = 0;
+        for (u32 i = 0; i < length && node != NTT_KEY_TRIE_NO_NODE; i++)
+        {
+            node = findChild(node, prefix[i]);
+        }
+        return node;
+    }
+
+    u32 KeyTrie::resolvePrefix(const char *prefix, u32 length) const
+    {
+        const u32 node = findNode(prefix, length);
+        return node == NTT_KEY_TRIE_NO_NODE ? NTT_KEY_TRIE_NO_ARGUMENT : m_nodes[node].subtreeArgument;
+    }
+
+    void KeyTrie::collect(u32 node, std::vector<char> &path, u32 limit, std::vector<String> &keys) const
+    {
+        if (m_nodes[node].argument != NTT_KEY_TRIE_NO_ARGUMENT)
+        {
+            keys.push_back(String(std::string(path.begin(), path.end())));
+        }
+
+        for (u32 child = m_nodes[node].firstChild;
+             child != NTT_KEY_TRIE_NO_NODE && keys.size() < limit;
+             child = m_nodes[child].nextSibling)
+        {
+            path.push_back(m_nodes[child].label);
+            collect(child, path, limit, keys);
+            path.pop_back();
+        }
+    }
+
+    void KeyTrie::collectPrefixed(const char *prefix, u32 length, u32 limit, std::vector<String> &keys) const
+    {
+        const u32 node = findNode(prefix, length);
+        if (node == NTT_KEY_TRIE_NO_NODE || limit == 0)
+        {
+            return;
+        }
+
+        std::vector<char> path(prefix, prefix + length);
+        collect(node, path, static_cast<u32>(keys.size()) + limit, keys);
+    }
+
+    /**
+     * Keeps the suggestions sorted by distance, the keys of the same distance stay in the order of
+     *      the visit (alphabetical).
+     */
+    static void keepSuggestion(std::vector<KeySuggestion> &suggestions, u32 limit, u32 distance, const std::vector<char> &path)
+    {
+        if (suggestions.size() == limit && suggestions.back().distance <= distance)
+        {
+            return;
+        }
+
+        std::vector<KeySuggestion>::iterator position = std::upper_bound(
+            suggestions.begin(),
+            suggestions.end(),
+            distance,
+            [](u32 value, const KeySuggestion &suggestion)
+            { return value < suggestion.distance; });
+        suggestions.insert(position, KeySuggestion{distance, String(std::string(path.begin(), path.end()))});
+
+        if (suggestions.size() > limit)
+        {
+            suggestions.pop_back();
+        }
+    }
+
+    void KeyTrie::suggestBelow(
+        u32 node,
+        const char *key,
+        u32 length,
+        u32 maxDistance,
+        u32 limit,
+        std::vector<u32> &rows,
+        std::vector<char> &path,
+        std::vector<KeySuggestion> &suggestions) const
+    {
+        // One row of the distance matrix per depth, the row of the node is the last one. Only the
+        //      cells which are at most `maxDistance` away from the diagonal are computed, the
+        //      others are always farther than the bound and are kept as `maxDistance + 1`.
+        const u32 width = length + 1;
+        const u32 depth = static_cast<u32>(path.size());
+        const u64 parentRow = static_cast<u64>(depth - 1) * width;
+        const u64 row = static_cast<u64>(depth) * width;
+        if (rows.size() < row + width)
+        {
+            rows.resize(row + width);
+        }
+
+        const u32 first = depth > maxDistance ? depth - maxDistance : 1;
+        const u32 last = std::min(length, depth + maxDistance);
+        if (first > last)
+        {
+            return;
+        }
+
+        const char label = m_nodes[node].label;
+        rows[row + first - 1] = first == 1 ? depth : maxDistance + 1;
+        u32 smallest = rows[row + first - 1];
+        for (u32 j = first; j <= last; j++)
+        {
+            const u32 replaced = rows[parentRow + j - 1] + (key[j - 1] == label ? 0 : 1);
+            const u32 inserted = rows[parentRow + j] + 1;
+            const u32 removed = rows[row + j - 1] + 1;
+            rows[row + j] = std::min(replaced, std::min(inserted, removed));
+            smallest = std::min(smallest, rows[row + j]);
+        }
+        if (last < length)
+        {
+            rows[row + last + 1] = maxDistance + 1;
+        }
+
+        if (m_nodes[node].argument != NTT_KEY_TRIE_NO_ARGUMENT && last == length && rows[row + length] <= maxDistance)
+        {
+            keepSuggestion(suggestions, limit, rows[row + length], path);
+        }
+
+        // Every key below is at least as far as the smallest value of the row.
+        if (smallest > maxDistance || (suggestions.size() == limit && smallest >= suggestions.back().distance))
+        {
+            return;
+        }
+
+        for (u32 child = m_nodes[node].firstChild; child != NTT_KEY_TRIE_NO_NODE; child = m_nodes[child].nextSibling)
+        {
+            path.push_back(m_nodes[child].label);
+            suggestBelow(child, key, length, maxDistance, limit, rows, path, suggestions);
+            path.pop_back();
+        }
+    }
+
+    void KeyTrie::suggest(const char *key, u32 length, u32 maxDistance, u32 limit, std::vector<KeySuggestion> &suggestions) const
+    {
+        if (limit == 0)
+        {
+            return;
+        }
+
+        std::vector<u32> rows(length + 1);
+        for (u32 j = 0; j <= length; j++)
+        {
+            rows[j] = j;
+        }
+
+        std::vector<char> path;
+        for (u32 child = m_nodes[0].firstChild; child != NTT_KEY_TRIE_NO_NODE; child = m_nodes[child].nextSibling)
+        {
+            path.push_back(m_nodes[child].label);
+            suggestBelow(child, key, length, maxDistance, limit, rows, path, suggestions);
+            path.pop_back();
+        }
+    }
+} // namespace NTT_NS
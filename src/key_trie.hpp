@@ -0,0 +1,93 @@
+#pragma once
+#include <NTTLib.hpp>
+#include <vector>
+
+// The argument of a trie node which no key ends at (or no key is below).
+#define NTT_KEY_TRIE_NO_ARGUMENT 0xFFFFFFFFu
+
+// The keys below the node belong to several arguments.
+#define NTT_KEY_TRIE_AMBIGUOUS 0xFFFFFFFEu
+
+#define NTT_KEY_TRIE_NO_NODE 0xFFFFFFFFu
+
+namespace NTT_NS
+{
+    /**
+     * One key which is close to a missing key, see `KeyTrie::suggest`.
+     */
+    struct KeySuggestion
+    {
+        u32 distance;
+        String key;
+    };
+
+    /**
+     * Character trie over every trigger key, kept next to the hash index (`KeyIndex`) which stays
+     *      the only structure of the exact lookups. The trie resolves the unambiguous prefixes in
+     *      a time proportional to the prefix length and finds the keys which are close to a
+     *      missing key without comparing it against every key. The children of a node are a
+     *      linked list sorted by character so that the keys are inserted one by one.
+     */
+    class KeyTrie
+    {
+    public:
+        KeyTrie();
+
+        void insert(const char *key, u32 length, u32 argument);
+
+        /**
+         * @return The argument of the only key which starts with `prefix` (the key itself
+         *      included), `NTT_KEY_TRIE_AMBIGUOUS` if the keys starting with it belong to several
+         *      arguments, `NTT_KEY_TRIE_NO_ARGUMENT` if no key starts with it.
+         */
+        u32 resolvePrefix(const char *prefix, u32 length) const;
+
+        /**
+         * Appends every key which starts with `prefix` in the alphabetical order, at most `limit`.
+         */
+        void collectPrefixed(const char *prefix, u32 length, u32 limit, std::vector<String> &keys) const;
+
+        /**
+         * Finds the keys whose edit distance (Levenshtein) to `key` is at most `maxDistance`, the
+         *      branches whose distance already exceeds it are not visited.
+         *
+         * @param limit The number of kept suggestions, the closest first then the alphabetical order.
+         */
+        void suggest(const char *key, u32 length, u32 maxDistance, u32 limit, std::vector<KeySuggestion> &suggestions) const;
+
+    private:
+        struct Node
+        {
+            u32 firstChild;
+            u32 nextSibling;
+
+            /**
+             * The argument of the key which ends at this node.
+             */
+            u32 argument;
+
+            /**
+             * The argument of every key below this node (this one included).
+             */
+            u32 subtreeArgument;
+            char label;
+        };
+
+        u32 findChild(u32 node, char label) const;
+        u32 findNode(const char *prefix, u32 length) const;
+
+        void collect(u32 node, std::vector<char> &path, u32 limit, std::vector<String> &keys) const;
+
+        void suggestBelow(
+            u32 node,
+            const char *key,
+            u32 length,
+            u32 maxDistance,
+            u32 limit,
+            std::vector<u32> &rows,
+            std::vector<char> &path,
+            std::vector<KeySuggestion> &suggestions) const;
+
+        std::vector<Node> m_nodes;
+    };
+} // namespace NTT_NS
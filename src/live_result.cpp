@@ -0,0 +1,217 @@
+#include "live_result.hpp"
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "memory.hpp"
+
+// The reader slots are spread over separated cache lines, the readers of different threads do
+//      not invalidate each other.
+#define NTT_ARG_LIVE_SLOT_BYTES 64
+
+namespace NTT_NS
+{
+    struct LiveSnapshot
+    {
+        ArgParseResult result;
+        u64 generation = 0;
+
+        /**
+         * The epoch which follows the replacement of the snapshot, only the readers which pinned
+         *      an older epoch can still see it.
+         */
+        u64 retiredEpoch = 0;
+    };
+
+    struct LiveReaderSlot
+    {
+        /**
+         * The epoch when the reader started, `0` when the slot is free.
+         */
+        std::atomic<u64> epoch{0};
+        char padding[NTT_ARG_LIVE_SLOT_BYTES - sizeof(std::atomic<u64>)];
+    };
+
+    class ArgLiveResult::ArgLiveResultPrivate
+    {
+    public:
+        std::shared_ptr<const ArgSchema> schema;
+        std::atomic<LiveSnapshot *> current{nullptr};
+        std::atomic<u64> epoch{1};
+        LiveReaderSlot slots[NTT_ARG_LIVE_READER_SLOTS];
+
+        /**
+         * Serializes the publications, everything below is only touched under it.
+         */
+        std::mutex writerMutex;
+        std::vector<Scope<LiveSnapshot>> retired;
+
+        /**
+         * A reclaimed snapshot whose buffers are reused by the next reload.
+         */
+        Scope<LiveSnapshot> spare;
+
+        /**
+         * The generation of the current snapshot, readable without pinning it.
+         */
+        std::atomic<u64> generation{0};
+
+        /**
+         * Destroys the retired snapshots which no reader can see anymore.
+         */
+        void reclaim()
+        {
+            u64 oldestPinned = UINT64_MAX;
+            for (const LiveReaderSlot &slot : slots)
+            {
+                const u64 pinned = slot.epoch.load();
+                if (pinned != 0 && pinned < oldestPinned)
+                {
+                    oldestPinned = pinned;
+                }
+            }
+
+            for (u32 index = 0; index < retired.size();)
+            {
+                if (retired[index]->retiredEpoch > oldestPinned)
+                {
+                    index++;
+                    continue;
+                }
+
+                if (spare == nullptr)
+                {
+                    spare = std::move(retired[index]);
+                }
+                retired[index] = std::move(retired.back());
+                retired.pop_back();
+            }
+        }
+    };
+
+    // Where the thread found a free slot the last time, its next view usually gets the same one.
+    static thread_local u32 t_readerSlotHint = 0;
+
+    ArgLiveView::ArgLiveView(std::atomic<u64> *slot, const ArgParseResult *result, u64 generation)
+        : m_slot(slot),
+          m_result(result),
+          m_generation(generation)
+    {
+    }
+
+    ArgLiveView::ArgLiveView(ArgLiveView &&other)
+        : m_slot(other.m_slot),
+          m_result(other.m_result),
+          m_generation(other.m_generation)
+    {
+        other.m_slot = nullptr;
+    }
+
+    ArgLiveView::~ArgLiveView()
+    {
+        if (m_slot != nullptr)
+        {
+            m_slot->store(0, std::memory_order_release);
+        }
+    }
+
+    ArgLiveResult::ArgLiveResult(std::shared_ptr<const ArgSchema> schema)
+    {
+        if (schema == nullptr)
+        {
+            throw std::invalid_argument("The live result needs a schema");
+        }
+
+        // The snapshots outlive the `argv` of their reload.
+        if (schema->hasZeroCopyStrings())
+        {
+            throw std::invalid_argument("The live result needs a schema which copies the string values");
+        }
+
+        impl = CreateScope<ArgLiveResultPrivate>();
+        impl->schema = std::move(schema);
+        impl->current.store(new LiveSnapshot());
+    }
+
+    ArgLiveResult::~ArgLiveResult()
+    {
+        delete impl->current.load();
+    }
+
+    void ArgLiveResult::reload(u32 argc, char **argv)
+    {
+        const ArgStatus status = tryReload(argc, argv);
+        if (!status.ok())
+        {
+            throw std::invalid_argument(impl->schema->getErrorMessage(status).c_str());
+        }
+    }
+
+    ArgStatus ArgLiveResult::tryReload(u32 argc, char **argv)
+    {
+        Scope<LiveSnapshot> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(impl->writerMutex);
+            snapshot = std::move(impl->spare);
+        }
+        if (snapshot == nullptr)
+        {
+            snapshot = CreateScope<LiveSnapshot>();
+        }
+
+        // Parsed before the publication, a failed reload is never seen by the readers.
+        const ArgStatus status = impl->schema->tryParse(argc, argv, snapshot->result);
+
+        std::lock_guard<std::mutex> lock(impl->writerMutex);
+        if (!status.ok())
+        {
+            impl->spare = std::move(snapshot);
+            return status;
+        }
+
+        const u64 generation = impl->generation.load() + 1;
+        snapshot->generation = generation;
+        LiveSnapshot *replaced = impl->current.exchange(snapshot.release());
+        impl->generation.store(generation);
+
+        // A reader which can still see the replaced snapshot pinned an epoch before this one.
+        replaced->retiredEpoch = impl->epoch.fetch_add(1) + 1;
+        impl->retired.emplace_back(replaced);
+        impl->reclaim();
+        return status;
+    }
+
+    ArgLiveView ArgLiveResult::read() const
+    {
+        for (;;)
+        {
+            for (u32 attempt = 0; attempt < NTT_ARG_LIVE_READER_SLOTS; attempt++)
+            {
+                const u32 index = (t_readerSlotHint + attempt) % NTT_ARG_LIVE_READER_SLOTS;
+                std::atomic<u64> &slot = impl->slots[index].epoch;
+
+                // The slot is pinned before the snapshot is loaded, a snapshot which is replaced
+                //      afterwards is retired with a newer epoch and is kept by `reclaim`.
+                u64 expected = 0;
+                if (slot.load(std::memory_order_relaxed) == 0 &&
+                    slot.compare_exchange_strong(expected, impl->epoch.load()))
+                {
+                    t_readerSlotHint = index;
+                    const LiveSnapshot *snapshot = impl->current.load();
+                    return ArgLiveView(&slot, &snapshot->result, snapshot->generation);
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    u64 ArgLiveResult::getGeneration() const
+    {
+        return impl->generation.load();
+    }
+
+    u32 ArgLiveResult::getRetiredCount() const
+    {
+        std::lock_guard<std::mutex> lock(impl->writerMutex);
+        return static_cast<u32>(impl->retired.size());
+    }
+} // namespace NTT_NS
@@ -0,0 +1,139 @@
+#pragma once
+#include "schema.hpp"
+#include <atomic>
+#include <memory>
+
+/**
+ * The readers which can hold an `ArgLiveView` of the same live result at once, another reader
+ *      waits until a view is released.
+ */
+#define NTT_ARG_LIVE_READER_SLOTS 64
+
+namespace NTT_NS
+{
+    class ArgLiveResult;
+
+    /**
+     * Consistent read access to the snapshot which is published when the view is taken: every
+     *      value comes from the same reload, whatever is reloaded meanwhile. The snapshot is not
+     *      reclaimed while the view is alive, so that a view must be short lived (one request,
+     *      one tick) and must not outlive its live result.
+     */
+    class ArgLiveView
+    {
+    public:
+        ArgLiveView(ArgLiveView &&other);
+        ArgLiveView(const ArgLiveView &) = delete;
+        ArgLiveView &operator=(const ArgLiveView &) = delete;
+        ArgLiveView &operator=(ArgLiveView &&) = delete;
+        ~ArgLiveView();
+
+    public:
+        /**
+         * @return The result of the reload which published the snapshot, it is never parsed
+         *      (`isParsed` is `false`) before the first successful reload.
+         */
+        inline const ArgParseResult &getResult() const { return *m_result; }
+
+        /**
+         * @return The number of successful reloads up to this snapshot, `0` before the first one.
+         */
+        inline u64 getGeneration() const { return m_generation; }
+
+        /**
+         * Same contract as `ArgParseResult::getArgument`.
+         */
+        template <typename T>
+        inline typename ArgValueType<T>::Type getArgument(const String &key) const
+        {
+            return m_result->getArgument<T>(key);
+        }
+
+        /**
+         * Same contract as `ArgParseResult::get`.
+         */
+        template <typename T>
+        inline typename ArgValueType<T>::Type get(const ArgHandle<T> &handle) const
+        {
+            return m_result->get(handle);
+        }
+
+    private:
+        friend class ArgLiveResult;
+
+        ArgLiveView(std::atomic<u64> *slot, const ArgParseResult *result, u64 generation);
+
+        /**
+         * The reader slot which pins the snapshot, `nullptr` once moved.
+         */
+        std::atomic<u64> *m_slot;
+        const ArgParseResult *m_result;
+        u64 m_generation;
+    };
+
+    /**
+     * Parsed values which are reloaded (on `SIGHUP`, from a control socket, ...) while other
+     *      threads keep reading them. Each reload parses into a new immutable snapshot which is
+     *      published atomically, the readers never lock: `read` pins the current snapshot through
+     *      a reader slot and the replaced snapshots are only destroyed once no view pins them
+     *      anymore (epoch based reclamation, checked by every reload).
+     *
+     * The reloads are serialized with each other but do not block the readers. The `String`
+     *      values are copied into the snapshot, a schema frozen in zero copy mode is rejected by
+     *      the constructor since the `argv` of a reload does not live as long as its snapshot.
+     *
+     * @example
+     * ```c++
+     * ArgLiveResult live(parser.freeze());
+     * live.reload(argc, argv);
+     *
+     * // worker thread
+     * ArgLiveView view = live.read();
+     * f32 radius = view.get(radiusHandle);
+     * ```
+     */
+    class ArgLiveResult
+    {
+        NTT_PRIVATE_DEF(ArgLiveResult);
+
+    public:
+        explicit ArgLiveResult(std::shared_ptr<const ArgSchema> schema);
+        ArgLiveResult(const ArgLiveResult &) = delete;
+        ArgLiveResult &operator=(const ArgLiveResult &) = delete;
+
+        /**
+         * Every view must be released before.
+         */
+        ~ArgLiveResult();
+
+    public:
+        /**
+         * Parses the command line into a new snapshot and publishes it, throws
+         *      `std::invalid_argument` on error like `ArgSchema::parse`. The published snapshot
+         *      is kept on failure.
+         */
+        void reload(u32 argc, char **argv);
+
+        /**
+         * Same as `reload` but the failure is returned instead of thrown, its message is formatted
+         *      by `ArgSchema::getErrorMessage` while the `argv` is still valid.
+         */
+        ArgStatus tryReload(u32 argc, char **argv);
+
+        /**
+         * Pins the current snapshot, without any lock or allocation.
+         */
+        ArgLiveView read() const;
+
+        /**
+         * @return The number of successful reloads.
+         */
+        u64 getGeneration() const;
+
+        /**
+         * @return The replaced snapshots which are still pinned by a view (or not checked by a
+         *      reload since their views are released).
+         */
+        u32 getRetiredCount() const;
+    };
+} // namespace NTT_NS
@@ -0,0 +1,253 @@
+#include "parallel.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+// Every worker takes this many chunks of work in average, a bigger number gives a better balance
+//      for uneven tasks but more contention on the counter.
+#define NTT_PARALLEL_CHUNKS_PER_THREAD 8
+
+namespace NTT_NS
+{
+    // Set while the thread runs the tasks of a `parallelFor` with several threads.
+    static thread_local bool t_isParallelWorker = false;
+
+    /**
+     * Marks the thread as a worker until the end of the scope, even if a task throws.
+     */
+    struct WorkerScope
+    {
+        WorkerScope() { t_isParallelWorker = true; }
+        ~WorkerScope() { t_isParallelWorker = false; }
+    };
+
+    /**
+     * The tasks of one `parallelFor`, handed out in chunks to the calling thread and to the
+     *      workers of the pool which join it.
+     */
+    class ParallelJob
+    {
+    public:
+        ParallelJob(u32 taskCount, u32 chunkSize, const std::function<void(u32)> &task)
+            : m_task(task), m_taskCount(taskCount), m_chunkSize(chunkSize), m_nextTask(0), m_failedTask(taskCount)
+        {
+        }
+
+        void work()
+        {
+            WorkerScope scope;
+            for (;;)
+            {
+                const u32 begin = m_nextTask.fetch_add(m_chunkSize, std::memory_order_relaxed);
+                if (begin >= m_taskCount)
+                {
+                    return;
+                }
+
+                const u32 end = std::min(m_taskCount, begin + m_chunkSize);
+                for (u32 index = begin; index < end; index++)
+                {
+                    try
+                    {
+                        m_task(index);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(m_failureMutex);
+                        if (index < m_failedTask)
+                        {
+                            m_failedTask = index;
+                            m_failure = std::current_exception();
+                        }
+
+                        // The following chunks are not handed out anymore.
+                        m_nextTask.store(m_taskCount, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+            }
+        }
+
+        /**
+         * Rethrows the exception of the lowest task, the chunks are handed out in the order of
+         *      the tasks so that every task before it runs and the same exception is thrown as by
+         *      a loop.
+         */
+        void rethrowFailure() const
+        {
+            if (m_failure)
+            {
+                std::rethrow_exception(m_failure);
+            }
+        }
+
+    public:
+        /**
+         * The workers which may still join the job and the ones which run it, guarded by the
+         *      mutex of the pool.
+         */
+        u32 freeSlots = 0;
+        u32 activeWorkers = 0;
+
+    private:
+        const std::function<void(u32)> &m_task;
+        const u32 m_taskCount;
+        const u32 m_chunkSize;
+        std::atomic<u32> m_nextTask;
+
+        std::mutex m_failureMutex;
+        std::exception_ptr m_failure;
+        u32 m_failedTask;
+    };
+
+    /**
+     * The worker threads shared by every `parallelFor` of the process. They are started the first
+     *      time they are needed, a call only starts the ones which are missing, and wait for the
+     *      next job once their job is done.
+     */
+    class WorkerPool
+    {
+    public:
+        static WorkerPool &instance()
+        {
+            static WorkerPool s_pool;
+            return s_pool;
+        }
+
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_isStopping = true;
+            }
+            m_wake.notify_all();
+
+            for (std::thread &thread : m_threads)
+            {
+                thread.join();
+            }
+        }
+
+        /**
+         * Runs the job on the calling thread and on up to `workerCount` workers, returns once
+         *      none of them runs it anymore.
+         */
+        void run(ParallelJob &job, u32 workerCount)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                while (m_threads.size() < workerCount)
+                {
+                    try
+                    {
+                        m_threads.emplace_back(&WorkerPool::workerLoop, this);
+                    }
+                    catch (const std::system_error &)
+                    {
+                        // No more thread can be started, the job is shared by the started ones.
+                        break;
+                    }
+                }
+
+                job.freeSlots = std::min(workerCount, static_cast<u32>(m_threads.size()));
+                if (job.freeSlots != 0)
+                {
+                    m_jobs.push_back(&job);
+                }
+            }
+            m_wake.notify_all();
+
+            job.work();
+
+            // The workers which did not join yet would only find an empty job.
+            std::unique_lock<std::mutex> lock(m_mutex);
+            std::deque<ParallelJob *>::iterator queued = std::find(m_jobs.begin(), m_jobs.end(), &job);
+            if (queued != m_jobs.end())
+            {
+                m_jobs.erase(queued);
+            }
+            m_finished.wait(lock, [&job]()
+                            { return job.activeWorkers == 0; });
+        }
+
+    private:
+        WorkerPool() = default;
+
+        void workerLoop()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;)
+            {
+                m_wake.wait(lock, [this]()
+                            { return m_isStopping || !m_jobs.empty(); });
+                if (m_isStopping)
+                {
+                    return;
+                }
+
+                ParallelJob &job = *m_jobs.front();
+                job.activeWorkers++;
+                if (--job.freeSlots == 0)
+                {
+                    m_jobs.pop_front();
+                }
+
+                lock.unlock();
+                job.work();
+                lock.lock();
+
+                if (--job.activeWorkers == 0)
+                {
+                    m_finished.notify_all();
+                }
+            }
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_finished;
+        std::deque<ParallelJob *> m_jobs;
+        std::vector<std::thread> m_threads;
+        bool m_isStopping = false;
+    };
+
+    void parallelFor(u32 taskCount, u32 threadCount, const std::function<void(u32)> &task)
+    {
+        if (taskCount == 0)
+        {
+            return;
+        }
+
+        if (t_isParallelWorker)
+        {
+            threadCount = 1;
+        }
+
+        if (threadCount == 0)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threadCount = std::min(threadCount, taskCount);
+
+        if (threadCount == 1)
+        {
+            for (u32 index = 0; index < taskCount; index++)
+            {
+                task(index);
+            }
+            return;
+        }
+
+        const u32 chunkSize = std::max(1u, taskCount / (threadCount * NTT_PARALLEL_CHUNKS_PER_THREAD));
+        ParallelJob job(taskCount, chunkSize, task);
+        WorkerPool::instance().run(job, threadCount - 1);
+        job.rethrowFailure();
+    }
+} // namespace NTT_NS
@@ -0,0 +1,28 @@
+#pragma once
+#include <NTTLib.hpp>
+#include <functional>
+
+namespace NTT_NS
+{
+    /**
+     * Runs `task(index)` for every index inside `[0, taskCount)` on a pool of worker threads, the
+     *      calling thread is one of the workers and the function returns when every task is done.
+     *      The tasks are handed out in small chunks through a shared atomic counter so that the
+     *      uneven tasks are balanced between the workers.
+     *
+     * The pool is shared by the whole process and kept until its exit: the workers are only
+     *      started by the first call which needs them, the following calls hand their chunks to
+     *      the idle workers without starting any thread. The calls of several threads share the
+     *      workers.
+     *
+     * @param threadCount The maximum number of threads, `0` means the number of hardware threads.
+     *
+     * A call from inside a task (a parse of a batch which runs the parallel validators) runs its
+     *      tasks on the calling thread, the workers are not multiplied.
+     *
+     * A task may throw: the following chunks are not handed out anymore and, once no thread runs
+     *      the tasks anymore, the exception of the lowest task is rethrown (the same one as a
+     *      plain loop).
+     */
+    void parallelFor(u32 taskCount, u32 threadCount, const std::function<void(u32)> &task);
+} // namespace NTT_NS
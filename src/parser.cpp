@@ -2,78 +2,165 @@
 #include <exception>
 #include <stdexcept>
 #include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <mutex>
 #include "memory.hpp"
-
-// The number of arguments inside this module usually will not exceed 10 so that using linear search
-//      is acceptable.
-
-#define NTT_ARGUMENT_INVALID_INDEX -1
+#include "argument_data.hpp"
+#include "schema.hpp"
+#include "help.hpp"
+#include "config_file.hpp"
+#include "snapshot.hpp"
+#include "serialization.hpp"
+#include "completion_index.hpp"
 
 namespace NTT_NS
 {
-    /**
-     * The list of availabel types which the arg can be passed into the
-     *      argparser, this list can be modified later.
-     */
-    enum ArgParserType
-    {
-        STRING,
-        I32,
-        F32,
-        BOOL,
-    };
-
-    /**
-     * Store the number value of the argument.
-     */
-    union ArgumentValue
-    {
-        i32 i32Value;
-        f32 f32Value;
-        bool boolValue;
-
-        ArgumentValue() : i32Value(0) {}
-    };
-
-    /**
-     * Store all needed information of the argument (definition
-     *      information, value, etc.).
-     */
-    struct ArgumentData
-    {
-        std::vector<String> triggerKeys;
-        String description;
-        String stringValue;
-        String defaultStringValue;
-        ArgParserType type;
-        ArgumentValue value;
-        ArgumentValue defaultValue;
-        bool isRequired;
-        bool provided;
-    };
-
     class ArgParser::ArgParserPrivate
     {
     public:
         String description;
-        std::vector<Scope<ArgumentData>> arguments;
-        std::vector<u32> requiredArgumentIndexes;
+        SchemaData schema;
+        ResultData result;
+        HelpText help;
+
+        /**
+         * The hash of the definitions which is written into (and checked against) the serialized
+         *      results, computed once per change of the arguments.
+         */
+        u64 schemaHash = 0;
+        bool isSchemaHashValid = false;
+
+        /**
+         * The builders of the subcommands (indexed like `SchemaData::subcommands`) and their
+         *      parsers which are only created when the subcommand is selected.
+         */
+        struct Subcommand
+        {
+            ArgSubcommandBuilder builder;
+            Scope<ArgParser> parser;
+        };
+
+        std::vector<Subcommand> subcommands;
+        u32 selectedSubcommand = NTT_ARG_NO_INDEX;
+        bool isSubcommand = false;
+
+        /**
+         * Creates the parser of the subcommand and runs its builder on the first selection.
+         */
+        ArgParser &subcommandParser(u32 index)
+        {
+            Subcommand &subcommand = subcommands[index];
+            if (subcommand.parser == nullptr)
+            {
+                const String description = schema.viewAt(schema.subcommands[index].description).toString();
+                Scope<ArgParser> parser = CreateScope<ArgParser>(description);
+                parser->impl->isSubcommand = true;
+
+                // A builder which throws leaves the subcommand unbuilt.
+                subcommand.builder(*parser);
+                subcommand.parser = std::move(parser);
+            }
+            return *subcommand.parser;
+        }
+
+        inline u64 currentSchemaHash()
+        {
+            if (!isSchemaHashValid)
+            {
+                schemaHash = hashSchema(schema);
+                isSchemaHashValid = true;
+            }
+            return schemaHash;
+        }
+
+        /**
+         * Drops what is derived from the definitions after an argument is added or changed.
+         */
+        inline void invalidateDefinitions()
+        {
+            help.invalidate();
+            isSchemaHashValid = false;
+        }
 
-        i64 searchByKey(const String &key)
+        /**
+         * Serializes the conversions of the lazy values, the first read of a value writes it and
+         *      the parser may be read from several threads (the handles of the worker loops).
+         */
+        std::mutex pendingMutex;
+
+        /**
+         * Converts the value if it is still pending. Only the first reads of the lazy `i32` and
+         *      `f32` values (the only ones which are ever pending) take the lock, the other reads
+         *      only test the pending bit.
+         */
+        inline ArgStatus resolvePendingRead(u32 index)
         {
-            for (u32 i = 0; i < arguments.size(); i++)
+            if (!result.isPending(index))
             {
-                Scope<ArgumentData> &argument = arguments[i];
-                for (const String &triggerKey : argument->triggerKeys)
-                {
-                    if (triggerKey == key)
-                    {
-                        return i;
-                    }
-                }
+                return ArgStatus();
             }
 
-            return NTT_ARGUMENT_INVALID_INDEX;
+            // The bit is tested again under the lock, another read may have converted it.
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            return resolvePending(schema, result, index);
+        }
+
+        /**
+         * Registers the argument into the schema and grows the result columns.
+         */
+        u32 registerArgument(
+            const std::vector<String> &triggerKeys,
+            const String &argumentDescription,
+            ArgParserType type,
+            bool isRequired,
+            const ArgumentValue &defaultValue,
+            const String &defaultString,
+            void *destination)
+        {
+            const char *oldPool = schema.stringPool.data();
+            const u32 index = schema.registerArgument(
+                triggerKeys,
+                argumentDescription,
+                type,
+                isRequired,
+                defaultValue,
+                defaultString,
+                destination);
+            syncResult(schema, result, oldPool);
+            invalidateDefinitions();
+            return index;
+        }
+
+        /**
+         * Same as `registerArgument` but the default values are stored into the list columns.
+         */
+        template <typename T>
+        u32 registerListArgument(
+            const std::vector<String> &triggerKeys,
+            const String &argumentDescription,
+            ArgParserType type,
+            bool isRequired,
+            const std::vector<T> &defaultValue,
+            void *destination)
+        {
+            schema.checkKeys(triggerKeys);
+
+            const char *oldPool = schema.stringPool.data();
+            ArgumentValue value;
+            value.listValue = schema.internListDefault(defaultValue);
+
+            const u32 index = schema.registerArgument(
+                triggerKeys,
+                argumentDescription,
+                type,
+                isRequired,
+                value,
+                NTT_STRING_EMPTY,
+                destination);
+            syncResult(schema, result, oldPool);
+            invalidateDefinitions();
+            return index;
         }
     };
 
@@ -85,288 +172,511 @@ namespace NTT_NS
 
     ArgParser::~ArgParser() {}
 
-    /**
-     * override for printing method of with the argument value.
-     */
-    template <>
-    String format(const String &formatMsg, const ArgumentValue &value)
-    {
-        const String data = format("<int={}, float={}, bool={}>",
-                                   value.i32Value,
-                                   value.f32Value,
-                                   value.boolValue);
-        return format(formatMsg, data);
+#define NTT_ARGUMENT_ADD_ARGUMENT_DEF(typeName, argParserType, valueState) \
+    template <>                                                            \
+    ArgHandle<typeName> ArgParser::addArgument<typeName>(                  \
+        const std::vector<String> &triggerKeys,                            \
+        typeName *destination,                                             \
+        const String &description,                                         \
+        bool isRequired,                                                   \
+        const typeName defaultValue)                                       \
+    {                                                                      \
+        ArgumentValue value;                                               \
+        String defaultString = NTT_STRING_EMPTY;                           \
+        valueState;                                                        \
+                                                                           \
+        const u32 index = impl->registerArgument(                          \
+            triggerKeys,                                                   \
+            description,                                                   \
+            argParserType,                                                 \
+            isRequired,                                                    \
+            value,                                                         \
+            defaultString,                                                 \
+            destination);                                                  \
+                                                                           \
+        if (destination != nullptr)                                        \
+        {                                                                  \
+            *destination = defaultValue;                                   \
+        }                                                                  \
+                                                                           \
+        return ArgHandle<typeName>(this, index);                           \
+    }                                                                      \
+                                                                           \
+    template <>                                                            \
+    ArgHandle<typeName> ArgParser::addArgument<typeName>(                  \
+        const std::vector<String> &triggerKeys,                            \
+        const String &description,                                         \
+        bool isRequired,                                                   \
+        const typeName defaultValue)                                       \
+    {                                                                      \
+        return addArgument<typeName>(                                      \
+            triggerKeys,                                                   \
+            static_cast<typeName *>(nullptr),                              \
+            description,                                                   \
+            isRequired,                                                    \
+            defaultValue);                                                 \
+    }
+
+    NTT_ARGUMENT_ADD_ARGUMENT_DEF(
+        String, ArgParserType::STRING,
+        defaultString = defaultValue);
+    NTT_ARGUMENT_ADD_ARGUMENT_DEF(
+        i32, ArgParserType::I32,
+        value.i32Value = defaultValue);
+    NTT_ARGUMENT_ADD_ARGUMENT_DEF(
+        f32, ArgParserType::F32,
+        value.f32Value = defaultValue);
+    NTT_ARGUMENT_ADD_ARGUMENT_DEF(
+        bool, ArgParserType::BOOL,
+        value.boolValue = defaultValue);
+
+#define NTT_ARGUMENT_ADD_LIST_ARGUMENT_DEF(elementType, argParserType)      \
+    template <>                                                             \
+    ArgHandle<std::vector<elementType>>                                     \
+    ArgParser::addArgument<std::vector<elementType>>(                       \
+        const std::vector<String> &triggerKeys,                             \
+        std::vector<elementType> *destination,                              \
+        const String &description,                                          \
+        bool isRequired,                                                    \
+        const std::vector<elementType> defaultValue)                        \
+    {                                                                       \
+        const u32 index = impl->registerListArgument(                       \
+            triggerKeys,                                                    \
+            description,                                                    \
+            argParserType,                                                  \
+            isRequired,                                                     \
+            defaultValue,                                                   \
+            destination);                                                   \
+                                                                            \
+        if (destination != nullptr)                                         \
+        {                                                                   \
+            *destination = defaultValue;                                    \
+        }                                                                   \
+                                                                            \
+        return ArgHandle<std::vector<elementType>>(this, index);            \
+    }                                                                       \
+                                                                            \
+    template <>                                                             \
+    ArgHandle<std::vector<elementType>>                                     \
+    ArgParser::addArgument<std::vector<elementType>>(                       \
+        const std::vector<String> &triggerKeys,                             \
+        const String &description,                                          \
+        bool isRequired,                                                    \
+        const std::vector<elementType> defaultValue)                        \
+    {                                                                       \
+        return addArgument<std::vector<elementType>>(                       \
+            triggerKeys,                                                    \
+            static_cast<std::vector<elementType> *>(nullptr),               \
+            description,                                                    \
+            isRequired,                                                     \
+            defaultValue);                                                  \
+    }
+
+    NTT_ARGUMENT_ADD_LIST_ARGUMENT_DEF(String, ArgParserType::STRING_LIST);
+    NTT_ARGUMENT_ADD_LIST_ARGUMENT_DEF(i32, ArgParserType::I32_LIST);
+    NTT_ARGUMENT_ADD_LIST_ARGUMENT_DEF(f32, ArgParserType::F32_LIST);
+    NTT_ARGUMENT_ADD_LIST_ARGUMENT_DEF(bool, ArgParserType::BOOL_LIST);
+
+#define NTT_ARGUMENT_ADD_POSITIONAL_DEF(typeName, argParserType, member) \
+    template <>                                                          \
+    void ArgParser::addPositional<typeName>(                             \
+        const String &name,                                              \
+        const ArgPositionalVisitor<typeName> &visitor,                   \
+        const String &description,                                       \
+        bool isRequired,                                                 \
+        bool isRepeated)                                                 \
+    {                                                                    \
+        const char *oldPool = impl->schema.stringPool.data();            \
+        impl->schema.registerPositional(                                 \
+            name,                                                        \
+            description,                                                 \
+            argParserType,                                               \
+            isRequired,                                                  \
+            isRepeated,                                                  \
+            [visitor](u32 index, const ArgumentValue &value)             \
+            { visitor(index, value.member); });                          \
+        syncResult(impl->schema, impl->result, oldPool);                 \
+        impl->invalidateDefinitions();                                   \
     }
 
-    /**
-     * override for printing method of with the argument type.
-     */
-    template <>
-    String format(const String &formatMsg, const ArgParserType &value)
+    NTT_ARGUMENT_ADD_POSITIONAL_DEF(String, ArgParserType::STRING, stringValue);
+    NTT_ARGUMENT_ADD_POSITIONAL_DEF(i32, ArgParserType::I32, i32Value);
+    NTT_ARGUMENT_ADD_POSITIONAL_DEF(f32, ArgParserType::F32, f32Value);
+    NTT_ARGUMENT_ADD_POSITIONAL_DEF(bool, ArgParserType::BOOL, boolValue);
+
+    void ArgParser::addSubcommand(const String &name, const String &description, const ArgSubcommandBuilder &builder)
     {
-        String typeStr = NTT_STRING_EMPTY;
-        switch (value)
+        if (impl->isSubcommand)
         {
-        case ArgParserType::STRING:
-            typeStr = "STRING";
-            break;
-        case ArgParserType::I32:
-            typeStr = "I32";
-            break;
-        case ArgParserType::F32:
-            typeStr = "F32";
-            break;
-        case ArgParserType::BOOL:
-            typeStr = "BOOL";
-            break;
-        default:
-            typeStr = "UNKNOWN";
-            break;
+            throw std::invalid_argument(format("The subcommand {} cannot be added into a subcommand", name).c_str());
         }
 
-        return format(formatMsg, typeStr);
-    }
-
-    /**
-     * override for printing method of with the argument data.
-     */
-    template <>
-    String format(const String &formatMsg, const ArgumentData &value)
-    {
-        const String data = format(R"({
-    keys: {}
-    description: {}
-    type: {}
-    value: {}
-    isRequired: {}
-    stringValue: {}
-    provided: {}
-})",
-                                   value.triggerKeys,
-                                   value.description,
-                                   value.type,
-                                   value.value,
-                                   value.isRequired,
-                                   value.stringValue,
-                                   value.provided);
-        return format(formatMsg, data);
-    }
-
-    static i32 safeStoi(const String &str, i32 defaultValue)
-    {
-        try
-        {
-            return std::stoi(str);
-        }
-        catch (const std::exception &e)
+        impl->schema.addSubcommand(name, description);
+        impl->subcommands.push_back(ArgParserPrivate::Subcommand{builder, nullptr});
+        impl->invalidateDefinitions();
+    }
+
+    ArgParser *ArgParser::getSubcommand() const
+    {
+        return impl->selectedSubcommand == NTT_ARG_NO_INDEX
+                   ? nullptr
+                   : impl->subcommands[impl->selectedSubcommand].parser.get();
+    }
+
+    ArgStringView ArgParser::getSubcommandName() const
+    {
+        return impl->selectedSubcommand == NTT_ARG_NO_INDEX
+                   ? ArgStringView()
+                   : impl->schema.viewAt(impl->schema.subcommands[impl->selectedSubcommand].name);
+    }
+
+    void ArgParser::parse(u32 argc, char **argv)
+    {
+        const ArgStatus status = tryParse(argc, argv);
+        if (status.code() == ArgErrorCode::ARG_ERROR_HELP_REQUESTED)
         {
-            return defaultValue;
+            if (status.subcommandIndex() != NTT_ARG_NO_INDEX)
+            {
+                impl->subcommands[status.subcommandIndex()].parser->printHelp();
+            }
+            else
+            {
+                printHelp();
+            }
+            std::exit(EXIT_SUCCESS);
         }
+        throwOnError(impl->schema, status);
     }
 
-    static f32 safeStof(const String &str, f32 defaultValue)
+    ArgStatus ArgParser::tryParse(u32 argc, char **argv)
     {
-        try
+        m_isParsed = false;
+        impl->selectedSubcommand = NTT_ARG_NO_INDEX;
+
+        ArgStatus status = parseArguments(impl->schema, impl->result, argc, argv, true);
+        if (status.ok() && impl->result.subcommand != NTT_ARG_NO_INDEX)
         {
-            return std::stof(str);
+            const u32 index = impl->result.subcommand;
+            const u32 firstToken = impl->result.subcommandToken + 1;
+            ArgParser &subcommand = impl->subcommandParser(index);
+            impl->selectedSubcommand = index;
+
+            // The subcommand receives the remaining tokens (which may point into the response files
+            //      of this parser), its token indexes are shifted to match the whole command line.
+            ResultData &subcommandResult = subcommand.impl->result;
+            subcommand.m_isParsed = false;
+            resetResult(subcommand.impl->schema, subcommandResult, true);
+            subcommandResult.tokens.assign(impl->result.tokens.begin() + firstToken, impl->result.tokens.end());
+
+            NTT_ARG_INSTRUMENT(ArgParseMeasure measure(subcommandResult.counters));
+            const ArgStatus subcommandStatus = parseTokens(subcommand.impl->schema, subcommandResult, true);
+            NTT_ARG_INSTRUMENT(measure.finish(subcommandStatus.ok()));
+            subcommand.m_isParsed = subcommandStatus.ok();
+            if (!subcommandStatus.ok())
+            {
+                status = ArgStatus(subcommandStatus.code(),
+                                   subcommandStatus.tokenIndex() == NTT_ARG_NO_INDEX
+                                       ? NTT_ARG_NO_INDEX
+                                       : subcommandStatus.tokenIndex() + firstToken,
+                                   subcommandStatus.argumentIndex(),
+                                   subcommandStatus.subject(),
+                                   subcommandStatus.typeName(),
+                                   index);
+            }
         }
-        catch (const std::exception &e)
+
+        m_isParsed = status.ok();
+        return status;
+    }
+
+    void ArgParser::parseStream(ArgTokenSource &source)
+    {
+        const ArgStatus status = tryParseStream(source);
+        if (status.code() == ArgErrorCode::ARG_ERROR_HELP_REQUESTED)
         {
-            return defaultValue;
+            printHelp();
+            std::exit(EXIT_SUCCESS);
         }
+        throwOnError(impl->schema, status);
     }
 
-#define NTT_ARGUMENT_ADD_ARGUMENT_DEF(typeName, argParserType, valueState)   \
-    template <>                                                              \
-    void ArgParser::addArgument<typeName>(                                   \
-        const std::vector<String> &triggerKeys,                              \
-        const String &description,                                           \
-        bool isRequired,                                                     \
-        const typeName defaultValue)                                         \
-    {                                                                        \
-        Scope<ArgumentData> argument = CreateScope<ArgumentData>();          \
-        argument->triggerKeys = triggerKeys;                                 \
-        argument->type = argParserType;                                      \
-        argument->description = description;                                 \
-        argument->isRequired = isRequired;                                   \
-        argument->value = ArgumentValue();                                   \
-        valueState;                                                          \
-        argument->provided = false;                                          \
-                                                                             \
-        if (isRequired)                                                      \
-        {                                                                    \
-            impl->requiredArgumentIndexes.push_back(impl->arguments.size()); \
-        }                                                                    \
-                                                                             \
-        impl->arguments.push_back(std::move(argument));                      \
+    ArgStatus ArgParser::tryParseStream(ArgTokenSource &source)
+    {
+        m_isParsed = false;
+        impl->selectedSubcommand = NTT_ARG_NO_INDEX;
+
+        const ArgStatus status = NTT_NS::parseStream(impl->schema, impl->result, source, true);
+        m_isParsed = status.ok();
+        return status;
     }
 
-    NTT_ARGUMENT_ADD_ARGUMENT_DEF(
-        String, ArgParserType::STRING,
-        argument->stringValue = defaultValue;
-        argument->defaultStringValue = defaultValue;
-        argument->value.boolValue = false);
-    NTT_ARGUMENT_ADD_ARGUMENT_DEF(
-        i32, ArgParserType::I32,
-        argument->value.i32Value = defaultValue;
-        argument->defaultValue.i32Value = defaultValue;
-        argument->stringValue = NTT_STRING_EMPTY);
-    NTT_ARGUMENT_ADD_ARGUMENT_DEF(
-        f32, ArgParserType::F32,
-        argument->value.f32Value = defaultValue;
-        argument->defaultValue.f32Value = defaultValue;
-        argument->stringValue = NTT_STRING_EMPTY);
-    NTT_ARGUMENT_ADD_ARGUMENT_DEF(
-        bool, ArgParserType::BOOL,
-        argument->value.boolValue = defaultValue;
-        argument->defaultValue.boolValue = defaultValue;
-        argument->stringValue = NTT_STRING_EMPTY);
+    void ArgParser::validateAll()
+    {
+        throwOnError(impl->schema, tryValidateAll());
+    }
 
-    void ArgParser::parse(u32 argc, char **argv)
+    ArgStatus ArgParser::tryValidateAll()
+    {
+        return resolveAllPending(impl->schema, impl->result);
+    }
+
+    ArgStringView ArgParser::getHelp() const
+    {
+        impl->help.update(impl->description, impl->schema);
+        return impl->help.view();
+    }
+
+    void ArgParser::printHelp() const
     {
+        impl->help.update(impl->description, impl->schema);
+        impl->help.write();
+    }
+
+    void ArgParser::parseConfig(const String &path)
+    {
+        throwOnError(impl->schema, tryParseConfig(path));
+    }
+
+    ArgStatus ArgParser::tryParseConfig(const String &path)
+    {
+        // The values of the previous parse may point into the config layer which is replaced.
         reset();
+        return loadConfigFile(impl->schema, path.c_str());
+    }
+
+    String ArgParser::getErrorMessage(const ArgStatus &status) const
+    {
+        if (status.subcommandIndex() != NTT_ARG_NO_INDEX &&
+            status.subcommandIndex() < impl->subcommands.size() &&
+            impl->subcommands[status.subcommandIndex()].parser != nullptr)
+        {
+            return impl->subcommands[status.subcommandIndex()].parser->getErrorMessage(
+                ArgStatus(status.code(), status.tokenIndex(), status.argumentIndex(), status.subject(), status.typeName()));
+        }
+        return formatStatus(impl->schema, status);
+    }
 
-        i64 currentIndex = NTT_ARGUMENT_INVALID_INDEX;
+    void ArgParser::reset()
+    {
+        m_isParsed = false;
+        resetResult(impl->schema, impl->result, true);
 
-        // The first argument is the program name, so we start from the second argument.
-        for (u32 i = 1; i < argc; i++)
+        // The values of the subcommand may point into the response files of this parser.
+        if (impl->selectedSubcommand != NTT_ARG_NO_INDEX)
         {
-            String arg = argv[i];
-            currentIndex = impl->searchByKey(arg);
+            impl->subcommands[impl->selectedSubcommand].parser->reset();
+            impl->selectedSubcommand = NTT_ARG_NO_INDEX;
+        }
+    }
 
-            if (currentIndex == NTT_ARGUMENT_INVALID_INDEX)
-            {
-                throw std::invalid_argument(format("The key {} is not found", arg).c_str());
-            }
+    const ArgParseCounters &ArgParser::getCounters() const
+    {
+        return impl->result.counters;
+    }
 
-            if (currentIndex != NTT_ARGUMENT_INVALID_INDEX)
-            {
-                Scope<ArgumentData> &argument = impl->arguments[currentIndex];
-
-                if (argument->type == ArgParserType::STRING)
-                {
-                    if (i + 1 >= argc)
-                    {
-                        throw std::invalid_argument(
-                            format("The string argument {} is not followed by a value",
-                                   argument->triggerKeys)
-                                .c_str());
-                    }
-
-                    argument->stringValue = argv[i + 1];
-                    argument->provided = true;
-                    i++;
-                }
-                else if (argument->type == ArgParserType::I32)
-                {
-                    if (i + 1 >= argc)
-                    {
-                        throw std::invalid_argument(
-                            format("The i32 argument {} is not followed by a value",
-                                   argument->triggerKeys)
-                                .c_str());
-                    }
-
-                    argument->value.i32Value = safeStoi(argv[i + 1], argument->defaultValue.i32Value);
-                    argument->provided = true;
-                    i++;
-                }
-                else if (argument->type == ArgParserType::F32)
-                {
-                    if (i + 1 >= argc)
-                    {
-                        throw std::invalid_argument(
-                            format("The f32 argument {} is not followed by a value",
-                                   argument->triggerKeys)
-                                .c_str());
-                    }
-
-                    argument->value.f32Value = safeStof(argv[i + 1], argument->defaultValue.f32Value);
-                    argument->provided = true;
-                    i++;
-                }
-                else if (argument->type == ArgParserType::BOOL)
-                {
-                    if (i + 1 >= argc)
-                    {
-                        argument->value.boolValue = true;
-                        argument->provided = true;
-                        continue;
-                    }
-
-                    if (strcmp(argv[i + 1], "true") == 0 || strcmp(argv[i + 1], "false") == 0)
-                    {
-                        argument->value.boolValue = strcmp(argv[i + 1], "true") == 0;
-                        argument->provided = true;
-                        i++;
-                    }
-                }
-                else
-                {
-                    throw std::invalid_argument("The type is not supported");
-                }
-            }
+    void ArgParser::resetCounters()
+    {
+        impl->result.counters = ArgParseCounters();
+    }
+
+    std::shared_ptr<const ArgSchema> ArgParser::freeze() const
+    {
+        if (!impl->subcommands.empty())
+        {
+            throw std::invalid_argument("The parser with subcommands cannot be frozen");
         }
+        return std::shared_ptr<const ArgSchema>(new ArgSchema(impl->description, impl->schema));
+    }
 
-        for (u32 i = 0; i < impl->requiredArgumentIndexes.size(); i++)
+    std::vector<u8> ArgParser::serialize()
+    {
+        std::vector<u8> blob;
+        throwOnError(impl->schema, trySerialize(blob));
+        return blob;
+    }
+
+    ArgStatus ArgParser::trySerialize(std::vector<u8> &blob)
+    {
+        const ArgStatus status = resolveAllPending(impl->schema, impl->result);
+        if (status.ok())
         {
-            u32 index = impl->requiredArgumentIndexes[i];
-            Scope<ArgumentData> &argument = impl->arguments[index];
-            if (!argument->provided)
-            {
-                throw std::invalid_argument(
-                    format("The required argument {} is not provided", argument->triggerKeys).c_str());
-            }
+            serializeResult(impl->schema, impl->currentSchemaHash(), impl->result, blob);
         }
+        return status;
+    }
 
-        m_isParsed = true;
+    ArgSnapshot ArgParser::attach(const void *data, u64 size) const
+    {
+        ArgSnapshot snapshot;
+        throwOnError(impl->schema, tryAttach(data, size, snapshot));
+        return snapshot;
     }
 
-    void ArgParser::reset()
+    ArgStatus ArgParser::tryAttach(const void *data, u64 size, ArgSnapshot &snapshot) const
     {
-        for (Scope<ArgumentData> &argument : impl->arguments)
+        return snapshot.attach(impl->schema, impl->currentSchemaHash(), data, size);
+    }
+
+    std::vector<u8> ArgParser::buildCompletionIndex() const
+    {
+        std::vector<u8> index;
+        NTT_NS::buildCompletionIndex(impl->schema, index);
+        return index;
+    }
+
+    void ArgParser::writeCompletionIndex(const String &path) const
+    {
+        const std::vector<u8> index = buildCompletionIndex();
+        FILE *file = fopen(path.c_str(), "wb");
+        bool isWritten = file != nullptr && fwrite(index.data(), 1, index.size(), file) == index.size();
+        if (file != nullptr)
         {
-            switch (argument->type)
-            {
-            case ArgParserType::STRING:
-                argument->stringValue = argument->defaultStringValue;
-                break;
-            case ArgParserType::I32:
-                argument->value.i32Value = argument->defaultValue.i32Value;
-                break;
-            case ArgParserType::F32:
-                argument->value.f32Value = argument->defaultValue.f32Value;
-                break;
-            case ArgParserType::BOOL:
-                argument->value.boolValue = argument->defaultValue.boolValue;
-                break;
-            default:
-                break;
-            }
+            isWritten = fclose(file) == 0 && isWritten;
+        }
+
+        if (!isWritten)
+        {
+            throw std::invalid_argument(format("The completion index {} cannot be written", path).c_str());
         }
     }
 
-#define NTT_ARGUMENT_GET_VALUE_DEF(typeName, argParserType, getStatement)                                         \
-    template <>                                                                                                   \
-    typeName ArgParser::getArgument<typeName>(const String &key)                                                  \
-    {                                                                                                             \
-        i64 index = impl->searchByKey(key);                                                                       \
-        if (index == NTT_ARGUMENT_INVALID_INDEX)                                                                  \
-        {                                                                                                         \
-            throw std::invalid_argument(format("The key {} is not found", key).c_str());                          \
-        }                                                                                                         \
-                                                                                                                  \
-        Scope<ArgumentData> &argument = impl->arguments[index];                                                   \
-        if (argument->type != argParserType)                                                                      \
-        {                                                                                                         \
-            throw std::invalid_argument(format("The key {} is not a " #typeName, argument->triggerKeys).c_str()); \
-        }                                                                                                         \
-                                                                                                                  \
-        return getStatement;                                                                                      \
-    }
-
-    NTT_ARGUMENT_GET_VALUE_DEF(String, ArgParserType::STRING, argument->stringValue);
-    NTT_ARGUMENT_GET_VALUE_DEF(i32, ArgParserType::I32, argument->value.i32Value);
-    NTT_ARGUMENT_GET_VALUE_DEF(f32, ArgParserType::F32, argument->value.f32Value);
-    NTT_ARGUMENT_GET_VALUE_DEF(bool, ArgParserType::BOOL, argument->value.boolValue);
+#define NTT_ARGUMENT_GET_VALUE_DEF(typeName, argParserType)                                          \
+    template <>                                                                                      \
+    ArgValueType<typeName>::Type ArgParser::getArgument<typeName>(const String &key)                 \
+    {                                                                                                \
+        u32 index = 0;                                                                               \
+        throwOnError(impl->schema,                                                                   \
+                     impl->schema.findTypedArgument(key, argParserType, #typeName, index));          \
+        throwOnError(impl->schema, impl->resolvePendingRead(index));                                 \
+        return ArgumentReader<typeName>::read(impl->schema, impl->result, index, true);              \
+    }                                                                                                \
+                                                                                                     \
+    template <>                                                                                      \
+    ArgStatus ArgParser::tryGetArgument<typeName>(                                                   \
+        const String &key,                                                                           \
+        ArgValueType<typeName>::Type &value) const                                                   \
+    {                                                                                                \
+        u32 index = 0;                                                                               \
+        ArgStatus status = impl->schema.findTypedArgument(key, argParserType, #typeName, index);     \
+        if (status.ok())                                                                             \
+        {                                                                                            \
+            status = impl->resolvePendingRead(index);                                                \
+        }                                                                                            \
+        if (status.ok())                                                                             \
+        {                                                                                            \
+            value = ArgumentReader<typeName>::read(impl->schema, impl->result, index, true);         \
+        }                                                                                            \
+        return status;                                                                               \
+    }
+
+    NTT_ARGUMENT_GET_VALUE_DEF(String, ArgParserType::STRING);
+    NTT_ARGUMENT_GET_VALUE_DEF(ArgStringView, ArgParserType::STRING);
+    NTT_ARGUMENT_GET_VALUE_DEF(i32, ArgParserType::I32);
+    NTT_ARGUMENT_GET_VALUE_DEF(f32, ArgParserType::F32);
+    NTT_ARGUMENT_GET_VALUE_DEF(bool, ArgParserType::BOOL);
+    NTT_ARGUMENT_GET_VALUE_DEF(std::vector<String>, ArgParserType::STRING_LIST);
+    NTT_ARGUMENT_GET_VALUE_DEF(std::vector<i32>, ArgParserType::I32_LIST);
+    NTT_ARGUMENT_GET_VALUE_DEF(std::vector<f32>, ArgParserType::F32_LIST);
+    NTT_ARGUMENT_GET_VALUE_DEF(std::vector<bool>, ArgParserType::BOOL_LIST);
+
+    ArgStringView ArgParser::getArgumentView(const String &key)
+    {
+        return getArgument<ArgStringView>(key);
+    }
+
+    void ArgParser::setConversionPolicy(ArgConversionPolicy policy)
+    {
+        impl->schema.conversionPolicy = policy;
+    }
+
+    void ArgParser::setLazyConversion(bool enabled)
+    {
+        impl->schema.lazyConversion = enabled;
+        reset();
+    }
+
+    void ArgParser::setResponseFiles(bool enabled)
+    {
+        impl->schema.responseFiles = enabled;
+    }
+
+    void ArgParser::setPrefixMatching(bool enabled)
+    {
+        impl->schema.prefixMatching = enabled;
+    }
+
+    void ArgParser::setValidationThreads(u32 threadCount)
+    {
+        impl->schema.validationThreads = threadCount;
+    }
+
+    void ArgParser::setZeroCopyStrings(bool enabled)
+    {
+        impl->schema.zeroCopyStrings = enabled;
+        reset();
+    }
+
+#define NTT_ARGUMENT_GET_VALUE_AT_DEF(typeName)                                         \
+    template <>                                                                         \
+    ArgValueType<typeName>::Type ArgParser::getArgumentAt<typeName>(u32 index) const    \
+    {                                                                                   \
+        throwOnError(impl->schema, impl->resolvePendingRead(index));                    \
+        return ArgumentReader<typeName>::read(impl->schema, impl->result, index, true); \
+    }
+
+    NTT_ARGUMENT_GET_VALUE_AT_DEF(String);
+    NTT_ARGUMENT_GET_VALUE_AT_DEF(i32);
+    NTT_ARGUMENT_GET_VALUE_AT_DEF(f32);
+    NTT_ARGUMENT_GET_VALUE_AT_DEF(bool);
+    NTT_ARGUMENT_GET_VALUE_AT_DEF(std::vector<String>);
+    NTT_ARGUMENT_GET_VALUE_AT_DEF(std::vector<i32>);
+    NTT_ARGUMENT_GET_VALUE_AT_DEF(std::vector<f32>);
+    NTT_ARGUMENT_GET_VALUE_AT_DEF(std::vector<bool>);
+
+    void ArgParser::setNargs(u32 index, ArgNargs nargs)
+    {
+        impl->schema.setNargs(index, nargs);
+        impl->invalidateDefinitions();
+    }
+
+    void ArgParser::setEnvironmentVariable(u32 index, const String &name)
+    {
+        const char *oldPool = impl->schema.stringPool.data();
+        impl->schema.setEnvironmentName(index, name);
+        syncResult(impl->schema, impl->result, oldPool);
+        impl->invalidateDefinitions();
+    }
+
+    void ArgParser::addValidator(u32 index, const ArgValidator &validator)
+    {
+        // The choices are interned into the pool.
+        const char *oldPool = impl->schema.stringPool.data();
+        impl->schema.addValidator(index, validator);
+        syncResult(impl->schema, impl->result, oldPool);
+    }
+
+#define NTT_ARGUMENT_ADD_VALIDATOR_DEF(typeName, member)                          \
+    template <>                                                                   \
+    void ArgParser::addValidator<typeName>(                                       \
+        u32 index,                                                                \
+        const ArgValidatorFunction<typeName> &check,                              \
+        const String &requirement,                                                \
+        bool isParallel)                                                          \
+    {                                                                             \
+        impl->schema.addValidator(                                                \
+            index,                                                                \
+            [check](const ArgumentValue &value)                                   \
+            { return check(value.member); },                                      \
+            requirement,                                                          \
+            isParallel);                                                          \
+    }
+
+    NTT_ARGUMENT_ADD_VALIDATOR_DEF(String, stringValue);
+    NTT_ARGUMENT_ADD_VALIDATOR_DEF(i32, i32Value);
+    NTT_ARGUMENT_ADD_VALIDATOR_DEF(f32, f32Value);
+    NTT_ARGUMENT_ADD_VALIDATOR_DEF(bool, boolValue);
+    NTT_ARGUMENT_ADD_VALIDATOR_DEF(std::vector<String>, stringValue);
+    NTT_ARGUMENT_ADD_VALIDATOR_DEF(std::vector<i32>, i32Value);
+    NTT_ARGUMENT_ADD_VALIDATOR_DEF(std::vector<f32>, f32Value);
+    NTT_ARGUMENT_ADD_VALIDATOR_DEF(std::vector<bool>, boolValue);
 } // namespace NTT_NS
@@ -1,13 +1,516 @@
 #pragma once
 #include <NTTLib.hpp>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "instrumentation.hpp"
 
 namespace NTT_NS
 {
+    class ArgParser;
+    class ArgSchema;
+    class ArgParseResult;
+    class ArgSnapshot;
+    class ArgTokenSource;
+    class ArgValidator;
+
+    /**
+     * Non-owning view over a string value of the parser, the view does not allocate anything
+     *      and is valid as long as the storage which it refers to (the `argv` passed into
+     *      `ArgParser::parse` or the default value inside the parser).
+     */
+    class ArgStringView
+    {
+    public:
+        ArgStringView() = default;
+        ArgStringView(const char *data, u32 length)
+            : m_data(data), m_length(length)
+        {
+        }
+
+        inline const char *data() const { return m_data; }
+        inline u32 length() const { return m_length; }
+        inline bool empty() const { return m_length == 0; }
+
+        /**
+         * Copies the viewed characters into a new owning string.
+         */
+        inline String toString() const { return String(std::string(m_data, m_length)); }
+
+        inline bool operator==(const char *other) const
+        {
+            return strncmp(m_data, other, m_length) == 0 && other[m_length] == '\0';
+        }
+
+        inline bool operator!=(const char *other) const { return !(*this == other); }
+
+    private:
+        const char *m_data = "";
+        u32 m_length = 0;
+    };
+
+    /**
+     * Decides what `ArgParser::parse` does with an `i32` or `f32` value which cannot be converted
+     *      (`-c abc`, `-c 12abc`, `-c 99999999999`).
+     */
+    enum ArgConversionPolicy
+    {
+        /**
+         * The number at the start of the value is kept like `std::stoi` and `std::stof` did
+         *      (`12abc` gives `12`), a value without one keeps the default value (but the argument
+         *      is still marked as provided).
+         */
+        LENIENT_CONVERSION,
+
+        /**
+         * `parse` throws `std::invalid_argument` which names the value and the argument.
+         */
+        STRICT_CONVERSION,
+    };
+
+    /**
+     * The token or argument index of an `ArgStatus` which does not refer to any token (or argument).
+     */
+#define NTT_ARG_NO_INDEX 0xFFFFFFFFu
+
+    /**
+     * The reason of a failed `ArgParser::tryParse` or `ArgParser::tryGetArgument`, each code matches
+     *      one of the messages which are thrown by `parse` and `getArgument`.
+     */
+    enum ArgErrorCode : u8
+    {
+        ARG_ERROR_NONE,
+
+        /**
+         * The token is not any defined key (or the key passed to `tryGetArgument`).
+         */
+        ARG_ERROR_KEY_NOT_FOUND,
+
+        /**
+         * The key of a `String`, `i32`, `f32` or list argument is the last token.
+         */
+        ARG_ERROR_MISSING_VALUE,
+
+        /**
+         * The value cannot be converted (only with `STRICT_CONVERSION`).
+         */
+        ARG_ERROR_INVALID_VALUE,
+        ARG_ERROR_REQUIRED_NOT_PROVIDED,
+
+        /**
+         * `tryGetArgument` is called with another type than the one of the argument.
+         */
+        ARG_ERROR_TYPE_MISMATCH,
+        ARG_ERROR_RESPONSE_FILE_NOT_OPENED,
+        ARG_ERROR_RESPONSE_FILE_UNTERMINATED_QUOTE,
+
+        /**
+         * `ArgParseResult::tryGetArgument` is called on a result which is never parsed.
+         */
+        ARG_ERROR_NOT_PARSED,
+
+        /**
+         * The command line contains `-h` or `--help` (which are not defined by the user), the
+         *      help text can be obtained by `getHelp`.
+         */
+        ARG_ERROR_HELP_REQUESTED,
+
+        /**
+         * `ArgParser::parseConfig` cannot open the file, the subject is the path.
+         */
+        ARG_ERROR_CONFIG_FILE_NOT_OPENED,
+
+        /**
+         * The config file is not a valid JSON object or a matched member has a value which the
+         *      argument cannot take (an object, an array for a non list argument), the subject is
+         *      the path and the token index is the line.
+         */
+        ARG_ERROR_CONFIG_FILE_INVALID,
+
+        /**
+         * `ArgParser::attach` is given a blob which is not a serialized result (or is truncated).
+         */
+        ARG_ERROR_SNAPSHOT_INVALID,
+
+        /**
+         * The serialized result is built by a parser with other arguments.
+         */
+        ARG_ERROR_SNAPSHOT_SCHEMA_MISMATCH,
+
+        /**
+         * The token is the prefix of the keys of several arguments (only with
+         *      `ArgParser::setPrefixMatching`).
+         */
+        ARG_ERROR_AMBIGUOUS_KEY,
+
+        /**
+         * The reader of an `ArgTokenSource` fails, the token index is the one of the token which
+         *      would follow.
+         */
+        ARG_ERROR_STREAM_READ_FAILED,
+
+        /**
+         * A token of an `ArgTokenSource` does not fit into its buffer.
+         */
+        ARG_ERROR_STREAM_TOKEN_TOO_LONG,
+
+        /**
+         * A positional token is left after the values of every positional argument, the subject
+         *      is the token. Without any positional argument such a token is
+         *      `ARG_ERROR_KEY_NOT_FOUND`.
+         */
+        ARG_ERROR_UNEXPECTED_POSITIONAL,
+
+        /**
+         * A validator rejects a value (see `ArgHandle::addValidator`), the subject is the value
+         *      and the type name is what the value must be. There is no token index.
+         */
+        ARG_ERROR_VALIDATION_FAILED,
+    };
+
+    /**
+     * Compact outcome of the non-throwing API, it is trivially copyable and building it never
+     *      allocates. The message is only formatted on demand by `ArgParser::getErrorMessage` (or
+     *      `ArgSchema::getErrorMessage`), the subject is a view into the `argv` (or into the key
+     *      passed to `tryGetArgument`) which must still be valid at that time.
+     */
+    class ArgStatus
+    {
+    public:
+        ArgStatus() = default;
+        ArgStatus(ArgErrorCode code,
+                  u32 tokenIndex,
+                  u32 argumentIndex,
+                  ArgStringView subject = ArgStringView(),
+                  const char *typeName = "",
+                  u32 subcommandIndex = NTT_ARG_NO_INDEX)
+            : m_code(code),
+              m_tokenIndex(tokenIndex),
+              m_argumentIndex(argumentIndex),
+              m_subject(subject),
+              m_typeName(typeName),
+              m_subcommandIndex(subcommandIndex)
+        {
+        }
+
+        inline ArgErrorCode code() const { return m_code; }
+        inline bool ok() const { return m_code == ArgErrorCode::ARG_ERROR_NONE; }
+
+        /**
+         * @return The index of the offending token inside the command line (same as the index in
+         *      `argv` if there is no response file, `1` for the first token after the program
+         *      name), `NTT_ARG_NO_INDEX` if the error is not caused by a token.
+         */
+        inline u32 tokenIndex() const { return m_tokenIndex; }
+
+        /**
+         * @return The slot of the argument (the same order as `addArgument`), `NTT_ARG_NO_INDEX` if
+         *      the error is not related to a defined argument.
+         */
+        inline u32 argumentIndex() const { return m_argumentIndex; }
+
+        /**
+         * @return The offending text: the token, the value, the key or the response file path.
+         */
+        inline ArgStringView subject() const { return m_subject; }
+
+        /**
+         * @return The name of the expected type for `ARG_ERROR_MISSING_VALUE`,
+         *      `ARG_ERROR_INVALID_VALUE` and `ARG_ERROR_TYPE_MISMATCH`, the requirement of the
+         *      validator for `ARG_ERROR_VALIDATION_FAILED` (valid as long as the parser), empty
+         *      otherwise.
+         */
+        inline const char *typeName() const { return m_typeName; }
+
+        /**
+         * @return The subcommand (the same order as `addSubcommand`) whose parse failed, the
+         *      argument index then refers to the arguments of that subcommand.
+         *      `NTT_ARG_NO_INDEX` if the error is not inside a subcommand.
+         */
+        inline u32 subcommandIndex() const { return m_subcommandIndex; }
+
+    private:
+        ArgErrorCode m_code = ArgErrorCode::ARG_ERROR_NONE;
+        u32 m_tokenIndex = NTT_ARG_NO_INDEX;
+        u32 m_argumentIndex = NTT_ARG_NO_INDEX;
+        ArgStringView m_subject;
+        const char *m_typeName = "";
+        u32 m_subcommandIndex = NTT_ARG_NO_INDEX;
+    };
+
+    /**
+     * The element type which is stored inside the contiguous storage of a list argument, the
+     *      `bool` values are stored as bytes and the `String` values as views.
+     */
+    template <typename T>
+    struct ArgSpanElement
+    {
+        using Type = T;
+    };
+
+    template <>
+    struct ArgSpanElement<bool>
+    {
+        using Type = u8;
+    };
+
+    /**
+     * Non-owning read only view over the values of a list argument (`std::vector<T>`), the values
+     *      are contiguous inside the parser (or the result) and the view is valid until the next
+     *      `parse`, `reset` or `addArgument`.
+     *
+     * @tparam T `ArgStringView`, `i32`, `f32` or `bool`.
+     */
+    template <typename T>
+    class ArgSpan
+    {
+    public:
+        using Element = typename ArgSpanElement<T>::Type;
+
+        ArgSpan() = default;
+        ArgSpan(const Element *data, u32 size)
+            : m_data(data), m_size(size)
+        {
+        }
+
+        inline const Element *data() const { return m_data; }
+        inline u32 size() const { return m_size; }
+        inline bool empty() const { return m_size == 0; }
+
+        inline T operator[](u32 index) const { return static_cast<T>(m_data[index]); }
+
+        inline const Element *begin() const { return m_data; }
+        inline const Element *end() const { return m_data + m_size; }
+
+    private:
+        const Element *m_data = nullptr;
+        u32 m_size = 0;
+    };
+
+    /**
+     * The type which is returned when an argument of type `T` is read, the list arguments are
+     *      read as `ArgSpan` so that their values are never copied.
+     */
+    template <typename T>
+    struct ArgValueType
+    {
+        using Type = T;
+    };
+
+    template <typename T>
+    struct ArgValueType<std::vector<T>>
+    {
+        using Type = ArgSpan<T>;
+    };
+
+    template <>
+    struct ArgValueType<std::vector<String>>
+    {
+        using Type = ArgSpan<ArgStringView>;
+    };
+
+    /**
+     * How many values a list argument takes every time one of its keys appears (same as the
+     *      `nargs` of the Python argparse).
+     */
+    enum ArgNargs
+    {
+        /**
+         * Exactly one value per key, the values of the repeated keys are appended
+         *      (`--input a --input b`).
+         */
+        NARGS_ONE,
+
+        /**
+         * All the following values until the next key, at least one (`--input a b c`, `+`).
+         */
+        NARGS_ONE_OR_MORE,
+
+        /**
+         * All the following values until the next key, possibly none (`*`).
+         */
+        NARGS_ZERO_OR_MORE,
+    };
+
+    /**
+     * The value which the visitor of a positional argument of type `T` receives, the `String`
+     *      values are passed as views so that they are never copied.
+     */
+    template <typename T>
+    struct ArgPositionalValue
+    {
+        using Type = T;
+    };
+
+    template <>
+    struct ArgPositionalValue<String>
+    {
+        using Type = ArgStringView;
+    };
+
+    /**
+     * Receives each value of a positional argument during the parse, see
+     *      `ArgParser::addPositional`. The view of a `String` value points into the `argv` (or
+     *      into the buffer of an `ArgTokenSource` where it is only valid during the call).
+     *
+     * @param index The index of the value among the values of its positional argument, always
+     *      `0` unless the argument is repeated.
+     */
+    template <typename T>
+    using ArgPositionalVisitor = std::function<void(u32 index, typename ArgPositionalValue<T>::Type value)>;
+
+    /**
+     * The value which a validator of an argument of type `T` checks: each element of a list on
+     *      its own, the `String` values as views.
+     */
+    template <typename T>
+    struct ArgValidatedValue
+    {
+        using Type = typename ArgPositionalValue<T>::Type;
+    };
+
+    template <typename T>
+    struct ArgValidatedValue<std::vector<T>>
+    {
+        using Type = typename ArgPositionalValue<T>::Type;
+    };
+
+    /**
+     * A validator of the user, see `ArgHandle::addValidator`.
+     *
+     * @retval true if the value is accepted.
+     */
+    template <typename T>
+    using ArgValidatorFunction = std::function<bool(typename ArgValidatedValue<T>::Type value)>;
+
+    /**
+     * Lightweight typed reference to an argument which is returned by `ArgParser::addArgument`.
+     *      Reading through the handle goes straight to the storage slot of the argument, there is
+     *      no key lookup and no type check (the type is fixed by the template at compile time),
+     *      so that it can be used inside the hot loops.
+     *
+     * The handle is only valid as long as the parser which created it, a default constructed
+     *      handle must not be read.
+     *
+     * @example
+     * ```c++
+     * ArgHandle<f32> radius = parser.addArgument<f32>({"-r", "--radius"}, "The radius", true);
+     * parser.parse(argc, argv);
+     *
+     * f32 value = radius.get(); // same as parser.getArgument<f32>("-r")
+     * ```
+     */
+    template <typename T>
+    class ArgHandle
+    {
+    public:
+        ArgHandle() = default;
+
+        /**
+         * @return The current value of the argument (the parsed value or the default value).
+         */
+        inline typename ArgValueType<T>::Type get() const;
+
+        /**
+         * Changes how many values the list argument takes per key, see `ArgNargs`. Throws
+         *      `std::invalid_argument` if the argument is not a list.
+         *
+         * @return The same handle so that it can be chained after `addArgument`.
+         *
+         * @example
+         * ```c++
+         * ArgHandle<std::vector<String>> inputs = parser.addArgument<std::vector<String>>({"--input"})
+         *                                              .setNargs(NARGS_ONE_OR_MORE);
+         * ```
+         */
+        inline ArgHandle<T> setNargs(ArgNargs nargs) const;
+
+        /**
+         * Reads the argument from the environment variable `name` when it is not given in the
+         *      command line, so that the value is taken from the command line, then from the
+         *      environment, then from the default value. The environment value goes through the
+         *      same conversion as a command line value (`true`/`1` and `false`/`0` for a `bool`).
+         *      Throws `std::invalid_argument` if the argument is a list, if it already has a
+         *      variable or if the variable is used by another argument.
+         *
+         * @return The same handle so that it can be chained after `addArgument`.
+         *
+         * @example
+         * ```c++
+         * parser.addArgument<i32>({"-j", "--jobs"}, "The number of jobs", false, 1)
+         *     .setEnvironmentVariable("APP_JOBS");
+         * ```
+         */
+        inline ArgHandle<T> setEnvironmentVariable(const String &name) const;
+
+        /**
+         * Attaches a built-in validator (see `ArgValidator`) which checks every provided value
+         *      of the argument during `parse`, a rejected value fails the parse with
+         *      `ARG_ERROR_VALIDATION_FAILED`. Throws `std::invalid_argument` if the validator does
+         *      not fit the type of the argument.
+         *
+         * @return The same handle so that it can be chained after `addArgument`.
+         */
+        inline ArgHandle<T> addValidator(const ArgValidator &validator) const;
+
+        /**
+         * Same as the other `addValidator` but the values are checked by `check`. The validators
+         *      run in the order of their registration and every value is checked in its order,
+         *      the parse reports the first rejected value of that order.
+         *
+         * @param requirement What the value must be, used by the message (`The value x of the
+         *      argument [--input] is not <requirement>`).
+         *
+         * @param isParallel If `true`, the checks are independent and can run on any thread (a
+         *      file system check, ...): once a parse has enough of them
+         *      (`NTT_ARG_VALIDATION_PARALLEL_MIN_CHECKS`) they fan out across the worker threads
+         *      (see `ArgParser::setValidationThreads`). The outcome is the same as the one of a
+         *      single thread, but the checks after the rejected value may run as well.
+         *
+         * @example
+         * ```c++
+         * parser.addArgument<std::vector<String>>({"--input"}, "The input files")
+         *     .addValidator([](ArgStringView path)
+         *                   { return access(path.toString().c_str(), R_OK) == 0; },
+         *                   "a readable file", true);
+         * ```
+         */
+        inline ArgHandle<T> addValidator(
+            const ArgValidatorFunction<T> &check,
+            const String &requirement,
+            bool isParallel = false) const;
+
+        /**
+         * @retval true if the handle is created by a parser.
+         * @retval false if the handle is default constructed.
+         */
+        inline bool isValid() const { return m_parser != nullptr; }
+
+    private:
+        friend class ArgParser;
+        friend class ArgParseResult;
+        friend class ArgSnapshot;
+
+        ArgHandle(ArgParser *parser, u32 index)
+            : m_parser(parser), m_index(index)
+        {
+        }
+
+        ArgParser *m_parser = nullptr;
+        u32 m_index = 0;
+    };
+
+    /**
+     * Defines the arguments of a subcommand into its own parser, see `ArgParser::addSubcommand`.
+     */
+    using ArgSubcommandBuilder = std::function<void(ArgParser &parser)>;
+
     /**
      * A comprehensive abstract utilities for handling the input arguments which the user
      *      passes from the command line to the program. This class is inspired by the the
      *      argparse library in Python with the similer simple user interface.ArgParser
-     * The option -h or --help will show the description of the parser.
+     * The option -h or --help will show the description of the parser (see `getHelp`).
      *
      * @example
      * ```c++
@@ -59,7 +562,9 @@ namespace NTT_NS
          *      you can type both `-v` or `--version` to trigger the argument, with the second example,
          *      you can only type `-v` to trigger the argument.
          *
-         * @tparam T only inside `String`, `F32`, `I32`, `bool`, other types are not supported.
+         * @tparam T only inside `String`, `F32`, `I32`, `bool`, other types are not supported. The
+         *      list of those types (`std::vector<String>`, ...) defines an argument which collects
+         *      every value (`--input a --input b`), see `ArgHandle::setNargs`.
          *
          * @param description The description which will be shown when user get helper from the the parser.
          *
@@ -68,16 +573,130 @@ namespace NTT_NS
          *
          * @param defaultValue The default value of the argument, this will be used if the argument is not
          *      provided from the command line.
+         *
+         * @return The typed handle which can be used to read the argument value without any lookup.
+         */
+        template <typename T>
+        ArgHandle<T> addArgument(
+            const std::vector<String> &triggerKeys,
+            const String &description = NTT_STRING_EMPTY,
+            bool isRequired = false,
+            const T defaultValue = T());
+
+        /**
+         * Same as the other `addArgument` but the value is written directly into the user storage
+         *      (a variable or a struct member) during `parse`, so that a whole configuration struct
+         *      is filled in one pass without any lookup afterwards. The default value is written
+         *      into the storage by this method and by every `reset()`.
+         *
+         * @param destination The storage of the value, it must outlive the parser.
+         *
+         * @example
+         * ```c++
+         * struct Config { f32 radius; bool useColor; } cfg;
+         *
+         * parser.addArgument({"-r", "--radius"}, &cfg.radius, "The radius", true, 1.0f);
+         * parser.addArgument({"--use-color"}, &cfg.useColor);
+         * parser.parse(argc, argv); // cfg is filled
+         * ```
          */
         template <typename T>
-        void addArgument(
+        ArgHandle<T> addArgument(
             const std::vector<String> &triggerKeys,
+            T *destination,
             const String &description = NTT_STRING_EMPTY,
             bool isRequired = false,
             const T defaultValue = T());
 
         /**
-         * Used in the main function for parsing the arguments from the command line.
+         * Defines a positional argument (`tool [options] <input>...`): the tokens which are not
+         *      keys go to the positional arguments in the order of their definition. The values are
+         *      not stored by the parser, each one is converted and passed to the visitor as soon as
+         *      its token is parsed, so that the processing of the first input can start while the
+         *      later ones are still read (see `parseStream`). A token which starts with `-` (except
+         *      `-` alone) is a key, the tokens after `--` are always positional (`tool -- -5`).
+         *
+         * The visitor runs inside `parse` (inside any thread which parses a frozen schema), an
+         *      exception thrown by it goes through `parse` and `tryParse`. The invalid `i32`,
+         *      `f32` and `bool` (`true` or `false`) values follow the conversion policy, the
+         *      lenient one passes the numeric prefix of the value (or `T()` without one) to the
+         *      visitor.
+         *
+         * Throws `std::invalid_argument` if the name is empty, starts with `-` or is already the
+         *      name of a positional argument, if the previous positional argument is repeated or
+         *      if a required positional argument follows an optional one.
+         *
+         * @tparam T only inside `String`, `F32`, `I32`, `bool`.
+         *
+         * @param name The name which is shown by the help and the error messages.
+         *
+         * @param isRequired If `true`, the parse fails if the argument receives no value.
+         *
+         * @param isRepeated If `true`, the argument takes every following positional token.
+         *
+         * @example
+         * ```c++
+         * parser.addPositional<String>("inputs", [&](u32 index, ArgStringView path)
+         *                              { queue.push(path.toString()); },
+         *                              "The input files", true, true);
+         * parser.parse(argc, argv); // tool -j 4 a.txt b.txt
+         * ```
+         */
+        template <typename T>
+        void addPositional(
+            const String &name,
+            const ArgPositionalVisitor<T> &visitor,
+            const String &description = NTT_STRING_EMPTY,
+            bool isRequired = false,
+            bool isRepeated = false);
+
+        /**
+         * Defines a subcommand (`tool <subcommand> [options]`): the first token of the command line
+         *      which is not an argument of this parser and is the name of a subcommand ends the
+         *      arguments of this parser, the following tokens are parsed by the parser of that
+         *      subcommand. Only the name and the description are stored here, the builder defines
+         *      the arguments of the subcommand and runs the first time the subcommand is selected
+         *      by `parse`, so that the cost of the startup does not depend on the number of
+         *      subcommands. The parser of the subcommand is kept for the following parses.
+         *
+         * Throws `std::invalid_argument` if the name is empty, starts with `-`, is already defined
+         *      or if this parser is itself a subcommand. A parser with subcommands cannot be frozen.
+         *
+         * @param builder Receives the parser of the subcommand, it may capture the handles of the
+         *      added arguments.
+         *
+         * @example
+         * ```c++
+         * ArgHandle<i32> jobs;
+         * parser.addSubcommand("build", "Build the project", [&jobs](ArgParser &build)
+         *                      { jobs = build.addArgument<i32>({"-j", "--jobs"}, "The jobs", false, 1); });
+         *
+         * parser.parse(argc, argv); // tool build -j 4
+         * if (parser.getSubcommandName() == "build")
+         * {
+         *     i32 value = jobs.get();
+         * }
+         * ```
+         */
+        void addSubcommand(const String &name, const String &description, const ArgSubcommandBuilder &builder);
+
+        /**
+         * @return The parser of the subcommand which is selected by the last parse, `nullptr` if
+         *      the command line has no subcommand.
+         */
+        ArgParser *getSubcommand() const;
+
+        /**
+         * @return The name of the subcommand which is selected by the last parse, empty if the
+         *      command line has no subcommand.
+         */
+        ArgStringView getSubcommandName() const;
+
+        /**
+         * Used in the main function for parsing the arguments from the command line. If the
+         *      command line contains `-h` or `--help` (and those keys are not defined by the user),
+         *      the help text is printed and the program exits with `EXIT_SUCCESS`, see `tryParse`
+         *      to handle that case differently.
          *
          * @param argc The number of arguments passed to the program.
          * @param argv The arguments passed to the program.
@@ -94,6 +713,75 @@ namespace NTT_NS
          */
         void parse(u32 argc, char **argv);
 
+        /**
+         * Same as `parse` but the failure is returned instead of thrown, nothing is formatted and
+         *      nothing is allocated on the failure path (once the internal buffers have grown), so
+         *      that rejecting many command lines stays cheap.
+         *
+         * @return The status of the parse, `isParsed()` is `true` only if it is ok. The request
+         *      of the help is returned as `ARG_ERROR_HELP_REQUESTED`, nothing is printed.
+         *
+         * @example
+         * ```c++
+         * ArgStatus status = parser.tryParse(argc, argv);
+         * if (!status.ok())
+         * {
+         *     std::cerr << parser.getErrorMessage(status).c_str() << std::endl;
+         * }
+         * ```
+         */
+        ArgStatus tryParse(u32 argc, char **argv);
+
+        /**
+         * Same as `parse` but the tokens are read from the source while they are parsed, there is
+         *      no program name. Only the values which are kept grow the memory: the scalar values
+         *      replace each other and the values of the list arguments are copied, so that a
+         *      stream of any length with repeated keys is parsed with a flat memory. The `String`
+         *      values are always copied (even in zero copy mode) and converted during the parse
+         *      (even with the lazy conversion). The `@file` tokens are not expanded and the
+         *      subcommands are not selected.
+         *
+         * The token index of a status is the position of the token inside the stream (from `1`),
+         *      an invalid list value has no token index (like the values of the config file). The
+         *      subject is a view into the buffer of the source until its next read.
+         */
+        void parseStream(ArgTokenSource &source);
+
+        /**
+         * Same as `parseStream` but the failure is returned instead of thrown, see `tryParse`.
+         */
+        ArgStatus tryParseStream(ArgTokenSource &source);
+
+        /**
+         * Loads the JSON config file which is applied by every following `parse`, the value of an
+         *      argument is taken from the command line, then from its environment variable, then
+         *      from the config file, then from its default value. The file is streamed through the
+         *      SAX parser of nlohmann/json without building a document, so that the memory does not
+         *      grow with the file size: each member is matched against the long keys (`"radius"`
+         *      or `"--radius"` for `--radius`, `{"output": {"path": ...}}` for `--output.path`),
+         *      only the values of the matched members are kept and the others are ignored. An
+         *      array fills a list argument and `null` is ignored. The values are converted by
+         *      `parse` like the command line values.
+         *
+         * The arguments must be added before, loading the file resets the parser and replaces
+         *      the previous config file. Throws `std::invalid_argument` if the file cannot be
+         *      opened or is not a valid JSON object.
+         *
+         * @example
+         * ```c++
+         * parser.addArgument<i32>({"-j", "--jobs"}, "The number of jobs", false, 1);
+         * parser.parseConfig("service.json"); // {"jobs": 8}
+         * parser.parse(argc, argv);           // --jobs 2 overrides the config file
+         * ```
+         */
+        void parseConfig(const String &path);
+
+        /**
+         * Same as `parseConfig` but the failure is returned instead of thrown. The subject of the
+         *      status is a view into `path`.
+         */
+        ArgStatus tryParseConfig(const String &path);
+
         /**
          * Obtain the argument value as the type which is specified. If the
          *      type @tparam T is not the same as the type in defined, the
@@ -102,18 +790,222 @@ namespace NTT_NS
          * @tparam T The type of the argument.
          * @param key The key of the argument. If the key is not found, the error will be thrown.
          *
-         * @return The value of the argument.
+         * @return The value of the argument, an `ArgSpan` for the list arguments.
          */
         template <typename T>
-        T getArgument(const String &key);
+        typename ArgValueType<T>::Type getArgument(const String &key);
+
+        /**
+         * Same as `getArgument` but the failure (`ARG_ERROR_KEY_NOT_FOUND`,
+         *      `ARG_ERROR_TYPE_MISMATCH`) is returned instead of thrown, without any allocation. The
+         *      subject of the status is a view into `key`, so that the message must be formatted
+         *      before a temporary key is destroyed.
+         *
+         * @param value Receives the value of the argument, not modified on failure.
+         */
+        template <typename T>
+        ArgStatus tryGetArgument(const String &key, typename ArgValueType<T>::Type &value) const;
+
+        /**
+         * Formats the message of the status, the same message which is thrown by `parse` and
+         *      `getArgument` for that failure, empty if the status is ok. A failure inside a
+         *      subcommand is formatted by the parser of that subcommand.
+         */
+        String getErrorMessage(const ArgStatus &status) const;
+
+        /**
+         * Converts every value which is still kept as a raw token by the lazy conversion, so that
+         *      an invalid value (`STRICT_CONVERSION`) is thrown here instead of by the first read.
+         *      Nothing is done if the lazy conversion is disabled.
+         */
+        void validateAll();
+
+        /**
+         * Same as `validateAll` but the first failure (`ARG_ERROR_INVALID_VALUE`) is returned
+         *      instead of thrown.
+         */
+        ArgStatus tryValidateAll();
+
+        /**
+         * The help text (the description, one line per argument with its keys, value type,
+         *      description and default value and one line per subcommand). The text is laid out
+         *      once into a single buffer and kept until an argument is added or changed, the view
+         *      is valid until then.
+         */
+        ArgStringView getHelp() const;
+
+        /**
+         * Writes `getHelp()` into the standard output with a single write.
+         */
+        void printHelp() const;
+
+        /**
+         * Obtain the value of a `String` argument without any copy. With `setZeroCopyStrings(true)`
+         *      the view points directly into the `argv` which is passed into `parse`, otherwise it
+         *      points to the string stored inside the parser (or the bound storage) and is valid
+         *      until the next `parse` or `reset`.
+         *
+         * @param key The key of the argument. If the key is not found or the argument is not a
+         *      `String`, the error will be thrown.
+         */
+        ArgStringView getArgumentView(const String &key);
+
+        /**
+         * Chooses how the invalid `i32` and `f32` values are handled by `parse`, see
+         *      `ArgConversionPolicy`.
+         *
+         * @param policy `LENIENT_CONVERSION` by default.
+         */
+        void setConversionPolicy(ArgConversionPolicy policy);
+
+        /**
+         * Enables the response files: every `@path` token of the command line is replaced by the
+         *      tokens inside the file at `path`, which is how a command line longer than the system
+         *      limit is passed. The file is memory mapped and tokenized in place (white space
+         *      separated, a token starting with `"` runs until the next `"`), the `String` values
+         *      from the file are views into the mapping whatever the zero copy mode is, and the
+         *      mapping is kept until the next `parse` or `reset`.
+         *
+         * @param enabled `false` by default so that the values starting with `@` are not affected.
+         */
+        void setResponseFiles(bool enabled);
+
+        /**
+         * Defers the conversion of the `i32` and `f32` values: `parse` only records the raw token
+         *      and marks the argument as provided, the value is converted by the first read
+         *      (`getArgument`, `ArgHandle::get`) and cached until the next `parse` or `reset`. The
+         *      arguments which are never read are never converted, so that the `argv` must outlive
+         *      the reads and an invalid value (`STRICT_CONVERSION`) is thrown by the read instead
+         *      of `parse`, see `validateAll`. The bound arguments and the lists are always
+         *      converted by `parse`, the results of `freeze()` as well since they can be read from
+         *      any thread. The reads of this parser may still come from several threads (the
+         *      handles of the worker loops): only the first read of a lazy value takes a lock of
+         *      the parser so that the value is converted once, the following reads take no lock.
+         *      `parse`, `reset`, `serialize` and `validateAll` must not run concurrently with the
+         *      reads.
+         *
+         * Changing the mode resets the parser.
+         *
+         * @param enabled `false` by default.
+         */
+        void setLazyConversion(bool enabled);
+
+        /**
+         * Accepts the unambiguous prefix of a long key (`--rad` for `--radius`) like `argparse`,
+         *      only for the `--` tokens which are not a key themselves. The prefix of the keys of
+         *      several arguments is rejected with `ARG_ERROR_AMBIGUOUS_KEY`, the exact lookup of the
+         *      keys is not affected.
+         *
+         * @param enabled `false` by default so that a new key never changes what an abbreviated
+         *      command line means.
+         */
+        void setPrefixMatching(bool enabled);
+
+        /**
+         * The number of threads which run the parallel validators (the calling thread included),
+         *      `1` checks every value on the parsing thread. The checks are handed to the worker
+         *      pool of the process, which is only grown by the first parse needing more workers:
+         *      the parses do not start any thread.
+         *
+         * @param threadCount `0` by default, which means the number of hardware threads.
+         */
+        void setValidationThreads(u32 threadCount);
+
+        /**
+         * Switches how the `String` values are stored by `parse`. When enabled, the parser keeps
+         *      non-owning views into `argv` instead of copying every value, so that the `argv` must
+         *      outlive the usage of the values (which is always true for the `argv` of `main`). The
+         *      arguments which are bound to a user storage are always copied into that storage.
+         *
+         * Changing the mode resets the parser.
+         *
+         * @param enabled `false` by default.
+         */
+        void setZeroCopyStrings(bool enabled);
 
         /**
          * Renew the states of the parser result, the isParsed() will return false after calling this
          *      function.
-         * All the argurment defintions will be kept.
+         * All the argurment defintions will be kept, every value (including the bound storages) is
+         *      restored to its default value.
          */
         void reset();
 
+        /**
+         * @return What the parses of this parser cost since its creation (or `resetCounters`),
+         *      the parses of a subcommand are counted by the parser of that subcommand. Every
+         *      counter stays `0` unless the library is built with `NTT_ARG_INSTRUMENTATION`.
+         */
+        const ArgParseCounters &getCounters() const;
+
+        void resetCounters();
+
+        /**
+         * Creates an immutable copy of the current argument definitions (and of the zero copy,
+         *      response file and conversion settings and the loaded config file). The schema can
+         *      be shared between threads and parses into separated `ArgParseResult`s, the handles
+         *      returned by `addArgument` can be used to read those results. Later changes of this
+         *      parser do not affect the schema.
+         */
+        std::shared_ptr<const ArgSchema> freeze() const;
+
+        /**
+         * Writes the current values (and whether each argument is provided) into a flat blob
+         *      which another process can read without parsing, see `attach`. The blob does not
+         *      contain any pointer, the strings and the list values are copied into it, and it
+         *      starts with a hash of the argument definitions. The lazily converted values are
+         *      converted first so that `STRICT_CONVERSION` throws `std::invalid_argument` here.
+         *
+         * @example
+         * ```c++
+         * parser.parse(argc, argv);
+         * std::vector<u8> blob = parser.serialize();
+         * write(memfd, blob.data(), blob.size()); // the workers map the memfd
+         * ```
+         */
+        std::vector<u8> serialize();
+
+        /**
+         * Same as `serialize` but the blob is written into an existing buffer and the failure is
+         *      returned instead of thrown.
+         */
+        ArgStatus trySerialize(std::vector<u8> &blob);
+
+        /**
+         * Attaches to a blob written by `serialize` in a parser with the same arguments (the
+         *      same keys, types and flags in the same order), nothing is copied: the blob must
+         *      outlive the snapshot and must be aligned to 8 bytes (a mapping or a heap buffer).
+         *      The header and the bounds of every value are checked once so that a corrupted blob
+         *      cannot be read out of bounds. The blob uses the byte order of the machine.
+         *      Throws `std::invalid_argument` if the blob is not valid or is written by other
+         *      arguments.
+         *
+         * @param size The size of the readable memory, it may be larger than the blob.
+         */
+        ArgSnapshot attach(const void *data, u64 size) const;
+
+        /**
+         * Same as `attach` but the failure (`ARG_ERROR_SNAPSHOT_INVALID`,
+         *      `ARG_ERROR_SNAPSHOT_SCHEMA_MISMATCH`) is returned instead of thrown.
+         */
+        ArgStatus tryAttach(const void *data, u64 size, ArgSnapshot &snapshot) const;
+
+        /**
+         * Builds the completion index of the arguments: every trigger key and subcommand name
+         *      in the sorted order with the description and the type of its argument and the
+         *      choices of its `ArgValidator::choice` validators. The index does not contain any
+         *      pointer and is queried by `ArgCompletionIndex` without building the parser (the
+         *      positional arguments and the arguments of the subcommands are not in it).
+         */
+        std::vector<u8> buildCompletionIndex() const;
+
+        /**
+         * Writes the completion index into the file (at build or install time, next to the
+         *      scripts of `ArgCompletionIndex::getScript`), throws `std::invalid_argument` if the
+         *      file cannot be written.
+         */
+        void writeCompletionIndex(const String &path) const;
+
     public:
         /**
          * @retval true if the arguments are parsed successfully.
@@ -121,7 +1013,73 @@ namespace NTT_NS
          */
         inline bool isParsed() const { return m_isParsed; }
 
+    private:
+        template <typename T>
+        friend class ArgHandle;
+
+        /**
+         * Unchecked access to the argument value at the given index, only used by `ArgHandle`
+         *      whose type and index are guaranteed by `addArgument`.
+         */
+        template <typename T>
+        typename ArgValueType<T>::Type getArgumentAt(u32 index) const;
+
+        /**
+         * Only used by `ArgHandle::setNargs`.
+         */
+        void setNargs(u32 index, ArgNargs nargs);
+
+        /**
+         * Only used by `ArgHandle::setEnvironmentVariable`.
+         */
+        void setEnvironmentVariable(u32 index, const String &name);
+
+        /**
+         * Only used by `ArgHandle::addValidator`.
+         */
+        void addValidator(u32 index, const ArgValidator &validator);
+
+        template <typename T>
+        void addValidator(u32 index, const ArgValidatorFunction<T> &check, const String &requirement, bool isParallel);
+
     private:
         bool m_isParsed = false;
     };
+
+    template <typename T>
+    inline typename ArgValueType<T>::Type ArgHandle<T>::get() const
+    {
+        return m_parser->getArgumentAt<T>(m_index);
+    }
+
+    template <typename T>
+    inline ArgHandle<T> ArgHandle<T>::setNargs(ArgNargs nargs) const
+    {
+        m_parser->setNargs(m_index, nargs);
+        return *this;
+    }
+
+    template <typename T>
+    inline ArgHandle<T> ArgHandle<T>::setEnvironmentVariable(const String &name) const
+    {
+        m_parser->setEnvironmentVariable(m_index, name);
+        return *this;
+    }
+
+    template <typename T>
+    inline ArgHandle<T> ArgHandle<T>::addValidator(const ArgValidator &validator) const
+    {
+        m_parser->addValidator(m_index, validator);
+        return *this;
+    }
+
+    template <typename T>
+    inline ArgHandle<T> ArgHandle<T>::addValidator(
+        const ArgValidatorFunction<T> &check,
+        const String &requirement,
+        bool isParallel) const
+    {
+        m_parser->template addValidator<T>(m_index, check, requirement, isParallel);
+        return *this;
+    }
 } // namespace NTT_NS
@@ -0,0 +1,169 @@
+#include "response_file.hpp"
+#include <cstring>
+
+#ifdef NTT_PLATFORM_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+namespace NTT_NS
+{
+#ifdef NTT_PLATFORM_UNIX
+    bool MappedFile::open(const char *path)
+    {
+        const int fileDescriptor = ::open(path, O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            return false;
+        }
+
+        struct stat fileStat;
+        if (fstat(fileDescriptor, &fileStat) != 0)
+        {
+            close(fileDescriptor);
+            return false;
+        }
+
+        m_size = static_cast<u64>(fileStat.st_size);
+        if (m_size == 0)
+        {
+            close(fileDescriptor);
+            return true;
+        }
+
+        void *mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        close(fileDescriptor);
+
+        if (mapped == MAP_FAILED)
+        {
+            m_size = 0;
+            return false;
+        }
+
+        // The response file is always read once from the beginning to the end.
+        madvise(mapped, m_size, MADV_SEQUENTIAL);
+
+        m_data = static_cast<const char *>(mapped);
+        return true;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data != nullptr)
+        {
+            munmap(const_cast<char *>(m_data), m_size);
+        }
+    }
+#else
+    bool MappedFile::open(const char *path)
+    {
+        HANDLE file = CreateFileA(
+            path,
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        m_size = static_cast<u64>(fileSize.QuadPart);
+        if (m_size == 0)
+        {
+            CloseHandle(file);
+            return true;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            m_size = 0;
+            return false;
+        }
+
+        const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            m_size = 0;
+            return false;
+        }
+
+        m_fileHandle = file;
+        m_mappingHandle = mapping;
+        m_data = static_cast<const char *>(view);
+        return true;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+            CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+            CloseHandle(static_cast<HANDLE>(m_fileHandle));
+        }
+    }
+#endif
+
+    static inline bool isWhiteSpace(char character)
+    {
+        return character == ' ' || character == '\t' || character == '\n' || character == '\r';
+    }
+
+    bool tokenizeResponseFile(const char *data, u64 size, u32 flags, std::vector<ArgToken> &tokens)
+    {
+        const char *current = data;
+        const char *end = data + size;
+
+        while (current != end)
+        {
+            if (isWhiteSpace(*current))
+            {
+                current++;
+                continue;
+            }
+
+            const char *begin = current;
+            if (*current == '"')
+            {
+                begin++;
+                const char *closing = static_cast<const char *>(
+                    memchr(begin, '"', static_cast<size_t>(end - begin)));
+                if (closing == nullptr)
+                {
+                    return false;
+                }
+
+                tokens.push_back(ArgToken{begin, static_cast<u32>(closing - begin), flags});
+                current = closing + 1;
+                continue;
+            }
+
+            while (current != end && !isWhiteSpace(*current))
+            {
+                current++;
+            }
+
+            tokens.push_back(ArgToken{begin, static_cast<u32>(current - begin), flags});
+        }
+
+        return true;
+    }
+} // namespace NTT_NS
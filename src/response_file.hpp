@@ -0,0 +1,49 @@
+#pragma once
+#include <NTTLib.hpp>
+#include <vector>
+#include "argument_data.hpp"
+
+namespace NTT_NS
+{
+    /**
+     * Read only memory mapping of a whole file, the content is never copied. The mapping is
+     *      released by the destructor.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        ~MappedFile();
+
+        /**
+         * @retval true if the file is mapped (an empty file is valid and has no data).
+         * @retval false if the file cannot be opened or mapped.
+         */
+        bool open(const char *path);
+
+        inline const char *data() const { return m_data; }
+        inline u64 size() const { return m_size; }
+
+    private:
+        const char *m_data = nullptr;
+        u64 m_size = 0;
+
+#ifndef NTT_PLATFORM_UNIX
+        void *m_fileHandle = nullptr;
+        void *m_mappingHandle = nullptr;
+#endif
+    };
+
+    /**
+     * Splits the content of a response file into tokens which point directly into the content.
+     *      The tokens are separated by white spaces (space, tab, new line), a token which starts
+     *      with `"` runs until the next `"` and may contain white spaces, the quotes are not part
+     *      of the token (the same rule as `String::split(" ", {"\"", "\""})`).
+     *
+     * @retval true if the whole content is tokenized.
+     * @retval false if a quote is not terminated.
+     */
+    bool tokenizeResponseFile(const char *data, u64 size, u32 flags, std::vector<ArgToken> &tokens);
+} // namespace NTT_NS
@@ -0,0 +1,211 @@
+#include "schema.hpp"
+#include <exception>
+#include <stdexcept>
+#include "memory.hpp"
+#include "argument_data.hpp"
+#include "parallel.hpp"
+#include "help.hpp"
+
+namespace NTT_NS
+{
+    class ArgSchema::ArgSchemaPrivate
+    {
+    public:
+        String description;
+        SchemaData data;
+        HelpText help;
+    };
+
+    class ArgParseResult::ArgParseResultPrivate
+    {
+    public:
+        std::shared_ptr<const ArgSchema> schema;
+        ResultData data;
+        bool isParsed = false;
+        ArgStatus status;
+
+        inline const SchemaData &schemaData() const
+        {
+            if (schema == nullptr)
+            {
+                throw std::invalid_argument("The result is not parsed by any schema");
+            }
+            return schema->impl->data;
+        }
+    };
+
+    ArgParseResult::ArgParseResult()
+    {
+        impl = CreateScope<ArgParseResultPrivate>();
+    }
+
+    ArgParseResult::ArgParseResult(ArgParseResult &&other)
+    {
+        impl = std::move(other.impl);
+        other.impl = CreateScope<ArgParseResultPrivate>();
+    }
+
+    ArgParseResult &ArgParseResult::operator=(ArgParseResult &&other)
+    {
+        if (this != &other)
+        {
+            impl = std::move(other.impl);
+            other.impl = CreateScope<ArgParseResultPrivate>();
+        }
+        return *this;
+    }
+
+    ArgParseResult::~ArgParseResult() {}
+
+    bool ArgParseResult::isParsed() const
+    {
+        return impl->isParsed;
+    }
+
+    const ArgStatus &ArgParseResult::getStatus() const
+    {
+        return impl->status;
+    }
+
+    const ArgParseCounters &ArgParseResult::getCounters() const
+    {
+        return impl->data.counters;
+    }
+
+    String ArgParseResult::getError() const
+    {
+        if (impl->status.ok() || impl->schema == nullptr)
+        {
+            return NTT_STRING_EMPTY;
+        }
+        return formatStatus(impl->schema->impl->data, impl->status);
+    }
+
+#define NTT_PARSE_RESULT_GET_VALUE_DEF(typeName, argParserType)                                 \
+    template <>                                                                                 \
+    ArgValueType<typeName>::Type ArgParseResult::getArgument<typeName>(const String &key) const \
+    {                                                                                           \
+        const SchemaData &schema = impl->schemaData();                                          \
+        u32 index = 0;                                                                          \
+        throwOnError(schema, schema.findTypedArgument(key, argParserType, #typeName, index));   \
+        return ArgumentReader<typeName>::read(schema, impl->data, index, false);                \
+    }                                                                                           \
+                                                                                                \
+    template <>                                                                                 \
+    ArgStatus ArgParseResult::tryGetArgument<typeName>(                                         \
+        const String &key,                                                                      \
+        ArgValueType<typeName>::Type &value) const                                              \
+    {                                                                                           \
+        if (impl->schema == nullptr)                                                            \
+        {                                                                                       \
+            return ArgStatus(ArgErrorCode::ARG_ERROR_NOT_PARSED,                                \
+                             NTT_ARG_NO_INDEX,                                                  \
+                             NTT_ARG_NO_INDEX);                                                 \
+        }                                                                                       \
+                                                                                                \
+        const SchemaData &schema = impl->schema->impl->data;                                    \
+        u32 index = 0;                                                                          \
+        const ArgStatus status =                                                                \
+            schema.findTypedArgument(key, argParserType, #typeName, index);                     \
+        if (status.ok())                                                                        \
+        {                                                                                       \
+            value = ArgumentReader<typeName>::read(schema, impl->data, index, false);           \
+        }                                                                                       \
+        return status;                                                                          \
+    }                                                                                           \
+                                                                                                \
+    template <>                                                                                 \
+    ArgValueType<typeName>::Type ArgParseResult::getArgumentAt<typeName>(u32 index) const       \
+    {                                                                                           \
+        const SchemaData &schema = impl->schema->impl->data;                                    \
+        return ArgumentReader<typeName>::read(schema, impl->data, index, false);                \
+    }
+
+    NTT_PARSE_RESULT_GET_VALUE_DEF(String, ArgParserType::STRING);
+    NTT_PARSE_RESULT_GET_VALUE_DEF(ArgStringView, ArgParserType::STRING);
+    NTT_PARSE_RESULT_GET_VALUE_DEF(i32, ArgParserType::I32);
+    NTT_PARSE_RESULT_GET_VALUE_DEF(f32, ArgParserType::F32);
+    NTT_PARSE_RESULT_GET_VALUE_DEF(bool, ArgParserType::BOOL);
+    NTT_PARSE_RESULT_GET_VALUE_DEF(std::vector<String>, ArgParserType::STRING_LIST);
+    NTT_PARSE_RESULT_GET_VALUE_DEF(std::vector<i32>, ArgParserType::I32_LIST);
+    NTT_PARSE_RESULT_GET_VALUE_DEF(std::vector<f32>, ArgParserType::F32_LIST);
+    NTT_PARSE_RESULT_GET_VALUE_DEF(std::vector<bool>, ArgParserType::BOOL_LIST);
+
+    ArgSchema::ArgSchema(const String &description, const SchemaData &data)
+    {
+        impl = CreateScope<ArgSchemaPrivate>();
+        impl->description = description;
+        impl->data = data;
+        impl->help.update(impl->description, impl->data);
+    }
+
+    ArgSchema::~ArgSchema() {}
+
+    const String &ArgSchema::getDescription() const
+    {
+        return impl->description;
+    }
+
+    bool ArgSchema::hasZeroCopyStrings() const
+    {
+        return impl->data.zeroCopyStrings;
+    }
+
+    ArgParseResult ArgSchema::parse(u32 argc, char **argv) const
+    {
+        ArgParseResult result;
+        parse(argc, argv, result);
+        return result;
+    }
+
+    void ArgSchema::parse(u32 argc, char **argv, ArgParseResult &result) const
+    {
+        throwOnError(impl->data, tryParse(argc, argv, result));
+    }
+
+    ArgStatus ArgSchema::tryParse(u32 argc, char **argv, ArgParseResult &result) const
+    {
+        ArgParseResult::ArgParseResultPrivate &resultImpl = *result.impl;
+        if (resultImpl.schema.get() != this)
+        {
+            resultImpl.schema = shared_from_this();
+            resultImpl.data = ResultData();
+        }
+
+        resultImpl.status = parseArguments(impl->data, resultImpl.data, argc, argv, false);
+        resultImpl.isParsed = resultImpl.status.ok();
+        return resultImpl.status;
+    }
+
+    String ArgSchema::getErrorMessage(const ArgStatus &status) const
+    {
+        return formatStatus(impl->data, status);
+    }
+
+    ArgStringView ArgSchema::getHelp() const
+    {
+        return impl->help.view();
+    }
+
+    void ArgSchema::printHelp() const
+    {
+        impl->help.write();
+    }
+
+    std::vector<ArgParseResult> ArgSchema::parseBatch(
+        const std::vector<ArgCommandLine> &commandLines,
+        u32 threadCount) const
+    {
+        std::vector<ArgParseResult> results(commandLines.size());
+
+        parallelFor(
+            static_cast<u32>(commandLines.size()),
+            threadCount,
+            [&](u32 index)
+            {
+                tryParse(commandLines[index].argc, commandLines[index].argv, results[index]);
+            });
+
+        return results;
+    }
+} // namespace NTT_NS
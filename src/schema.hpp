@@ -0,0 +1,180 @@
+#pragma once
+#include "parser.hpp"
+#include <memory>
+#include <vector>
+
+namespace NTT_NS
+{
+    struct SchemaData;
+    class ArgSchema;
+
+    /**
+     * One command line of a batch (see `ArgSchema::parseBatch`), the `argv` is not copied and must
+     *      be valid while the batch is parsed (and while the results are used if the zero copy mode
+     *      is enabled, or while the error messages are formatted).
+     */
+    struct ArgCommandLine
+    {
+        u32 argc;
+        char **argv;
+    };
+
+    /**
+     * The values of one parse against an `ArgSchema`. The result owns everything it needs (apart
+     *      from the `argv` in zero copy mode) so that it can be read from any thread without
+     *      locking. The bound storages of the original `ArgParser` are never touched, their values
+     *      are kept inside the result like the other arguments.
+     *
+     * @example
+     * ```c++
+     * std::shared_ptr<const ArgSchema> schema = parser.freeze();
+     * ArgParseResult result = schema->parse(argc, argv);
+     * f32 radius = result.getArgument<f32>("--radius");
+     * ```
+     */
+    class ArgParseResult
+    {
+        NTT_PRIVATE_DEF(ArgParseResult);
+
+    public:
+        ArgParseResult();
+        ArgParseResult(ArgParseResult &&other);
+        ArgParseResult &operator=(ArgParseResult &&other);
+        ~ArgParseResult();
+
+    public:
+        /**
+         * @retval true if the last parse into this result succeeded.
+         * @retval false if it is never parsed or the parse failed (see `getError`).
+         */
+        bool isParsed() const;
+
+        /**
+         * @return The status of the last parse into this result (`ArgSchema::tryParse` or
+         *      `ArgSchema::parseBatch`).
+         */
+        const ArgStatus &getStatus() const;
+
+        /**
+         * Formats the message of the error which stopped the last parse, empty if there is no
+         *      error. The `argv` of that parse must still be valid.
+         */
+        String getError() const;
+
+        /**
+         * Same as `ArgParser::getCounters`, for the parses into this result.
+         */
+        const ArgParseCounters &getCounters() const;
+
+        /**
+         * Same contract as `ArgParser::getArgument`.
+         */
+        template <typename T>
+        typename ArgValueType<T>::Type getArgument(const String &key) const;
+
+        /**
+         * Same contract as `ArgParser::tryGetArgument`, `ARG_ERROR_NOT_PARSED` if the result is
+         *      never parsed.
+         */
+        template <typename T>
+        ArgStatus tryGetArgument(const String &key, typename ArgValueType<T>::Type &value) const;
+
+        /**
+         * Reads the value through a handle returned by `ArgParser::addArgument` of the parser which
+         *      the schema is frozen from, there is no lookup and no check.
+         */
+        template <typename T>
+        inline typename ArgValueType<T>::Type get(const ArgHandle<T> &handle) const
+        {
+            return getArgumentAt<T>(handle.m_index);
+        }
+
+    private:
+        friend class ArgSchema;
+
+        template <typename T>
+        typename ArgValueType<T>::Type getArgumentAt(u32 index) const;
+    };
+
+    /**
+     * Immutable copy of the argument definitions of an `ArgParser` (see `ArgParser::freeze`). A
+     *      schema can be shared between threads, each parse writes into its own `ArgParseResult`
+     *      so that any number of command lines can be parsed concurrently.
+     */
+    class ArgSchema : public std::enable_shared_from_this<ArgSchema>
+    {
+        NTT_PRIVATE_DEF(ArgSchema);
+
+    public:
+        ~ArgSchema();
+
+    public:
+        /**
+         * @return The description of the parser which the schema is frozen from.
+         */
+        const String &getDescription() const;
+
+        /**
+         * @return `true` if the parser was in zero copy mode when it was frozen, the `String`
+         *      values of the results then point into the `argv` of their parse.
+         */
+        bool hasZeroCopyStrings() const;
+
+        /**
+         * Parses the command line into a new result, throws `std::invalid_argument` on error like
+         *      `ArgParser::parse`. The request of the help is thrown as well instead of exiting
+         *      the program, see `getHelp`.
+         */
+        ArgParseResult parse(u32 argc, char **argv) const;
+
+        /**
+         * Parses the command line into an existing result so that its buffers are reused, throws
+         *      `std::invalid_argument` on error like `ArgParser::parse`.
+         */
+        void parse(u32 argc, char **argv, ArgParseResult &result) const;
+
+        /**
+         * Same as `parse` but the failure is returned instead of thrown (see `ArgParser::tryParse`),
+         *      the status is also kept inside the result.
+         */
+        ArgStatus tryParse(u32 argc, char **argv, ArgParseResult &result) const;
+
+        /**
+         * Same as `ArgParser::getErrorMessage`.
+         */
+        String getErrorMessage(const ArgStatus &status) const;
+
+        /**
+         * Same as `ArgParser::getHelp`, the text is laid out when the schema is frozen.
+         */
+        ArgStringView getHelp() const;
+
+        /**
+         * Same as `ArgParser::printHelp`.
+         */
+        void printHelp() const;
+
+        /**
+         * Parses every command line on the worker pool of `parallelFor` (started by the first
+         *      parallel call and reused by the following ones), the parse errors do not throw but
+         *      are stored inside the corresponding result (`ArgParseResult::getStatus`), their
+         *      messages are only formatted by `ArgParseResult::getError`.
+         *
+         * An exception which escapes the parse of a command line is rethrown once every worker is
+         *      done with the batch, the one of the first command line which throws.
+         *
+         * @param threadCount The maximum number of threads, `0` means the number of hardware threads.
+         *
+         * @return The results in the same order as `commandLines`.
+         */
+        std::vector<ArgParseResult> parseBatch(
+            const std::vector<ArgCommandLine> &commandLines,
+            u32 threadCount = 0) const;
+
+    private:
+        friend class ArgParser;
+        friend class ArgParseResult;
+
+        ArgSchema(const String &description, const SchemaData &data);
+    };
+} // namespace NTT_NS
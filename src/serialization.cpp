@@ -0,0 +1,373 @@
+#include "serialization.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace NTT_NS
+{
+    static inline void hashBytes(u64 &hash, const void *data, u64 length)
+    {
+        const u8 *bytes = static_cast<const u8 *>(data);
+        for (u64 i = 0; i < length; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+
+    u64 hashSchema(const SchemaData &schema)
+    {
+        u64 hash = 14695981039346656037ull;
+        const u32 count = schema.count();
+        hashBytes(hash, &count, sizeof(count));
+
+        for (u32 index = 0; index < count; index++)
+        {
+            // The values of the positional arguments are never stored.
+            if (schema.isPositional(index))
+            {
+                continue;
+            }
+
+            const u8 type = schema.types[index];
+            const u8 flags = schema.flags[index] & ~ARGUMENT_FLAG_BOUND;
+            hashBytes(hash, &type, sizeof(type));
+            hashBytes(hash, &flags, sizeof(flags));
+
+            const ArgumentInfo &info = schema.infos[index];
+            hashBytes(hash, &info.keyCount, sizeof(info.keyCount));
+            for (u32 key = 0; key < info.keyCount; key++)
+            {
+                const StringRef &ref = schema.keys[info.firstKey + key];
+                hashBytes(hash, &ref.length, sizeof(ref.length));
+                hashBytes(hash, schema.stringPool.data() + ref.offset, ref.length);
+            }
+        }
+        return hash;
+    }
+
+    static inline u64 alignOffset(u64 offset)
+    {
+        return (offset + NTT_SNAPSHOT_ALIGNMENT - 1) & ~static_cast<u64>(NTT_SNAPSHOT_ALIGNMENT - 1);
+    }
+
+    /**
+     * Places a section of `count` elements at the current offset and moves the offset after it.
+     */
+    static inline u64 placeSection(u64 &offset, u64 count, u64 elementSize)
+    {
+        const u64 sectionOffset = alignOffset(offset);
+        offset = sectionOffset + count * elementSize;
+        return sectionOffset;
+    }
+
+    template <typename T>
+    static inline T *sectionAt(std::vector<u8> &blob, u64 offset)
+    {
+        return reinterpret_cast<T *>(blob.data() + offset);
+    }
+
+    template <typename T>
+    static inline void storeBits(SnapshotValue &value, T bits)
+    {
+        memcpy(&value.first, &bits, sizeof(T));
+    }
+
+    /**
+     * Copies the strings (with a terminating null character) into the character section.
+     */
+    class SnapshotChars
+    {
+    public:
+        explicit SnapshotChars(char *chars)
+            : m_chars(chars)
+        {
+        }
+
+        inline StringRef append(ArgStringView text)
+        {
+            const StringRef ref{m_size, text.length()};
+            memcpy(m_chars + m_size, text.data(), text.length());
+            m_size += text.length() + 1;
+            return ref;
+        }
+
+    private:
+        char *m_chars;
+        u32 m_size = 0;
+    };
+
+    void serializeResult(const SchemaData &schema, u64 schemaHash, const ResultData &result, std::vector<u8> &blob)
+    {
+        const u32 count = schema.count();
+        const u64 wordCount = result.providedBits.size();
+
+        SnapshotHeader header = {};
+        header.magic = NTT_SNAPSHOT_MAGIC;
+        header.version = NTT_SNAPSHOT_VERSION;
+        header.schemaHash = schemaHash;
+        header.argumentCount = count;
+
+        // The first pass only measures the sections, the positional slots (never stored) are
+        //      left zero filled.
+        for (u32 index = 0; index < count; index++)
+        {
+            if (schema.isPositional(index))
+            {
+                continue;
+            }
+
+            switch (schema.types[index])
+            {
+            case ArgParserType::STRING:
+                header.charCount += ArgumentReader<ArgStringView>::read(schema, result, index, true).length() + 1;
+                break;
+            case ArgParserType::STRING_LIST:
+            {
+                const ArgSpan<ArgStringView> items = ArgumentReader<std::vector<String>>::read(schema, result, index, true);
+                header.stringItemCount += items.size();
+                for (const ArgStringView &item : items)
+                {
+                    header.charCount += item.length() + 1;
+                }
+                break;
+            }
+            case ArgParserType::I32_LIST:
+                header.i32ItemCount += result.values[index].listValue.count;
+                break;
+            case ArgParserType::F32_LIST:
+                header.f32ItemCount += result.values[index].listValue.count;
+                break;
+            case ArgParserType::BOOL_LIST:
+                header.boolItemCount += result.values[index].listValue.count;
+                break;
+            case ArgParserType::I32:
+            case ArgParserType::F32:
+            case ArgParserType::BOOL:
+            default:
+                break;
+            }
+        }
+
+        u64 offset = sizeof(SnapshotHeader);
+        header.typesOffset = placeSection(offset, count, sizeof(ArgParserType));
+        header.providedOffset = placeSection(offset, wordCount, sizeof(u64));
+        header.valuesOffset = placeSection(offset, count, sizeof(SnapshotValue));
+        header.stringItemsOffset = placeSection(offset, header.stringItemCount, sizeof(StringRef));
+        header.i32ItemsOffset = placeSection(offset, header.i32ItemCount, sizeof(i32));
+        header.f32ItemsOffset = placeSection(offset, header.f32ItemCount, sizeof(f32));
+        header.boolItemsOffset = placeSection(offset, header.boolItemCount, sizeof(u8));
+        header.charsOffset = placeSection(offset, header.charCount, sizeof(char));
+        header.size = alignOffset(offset);
+
+        // Zero filled so that the padding is always the same for the same values.
+        blob.assign(header.size, 0);
+        memcpy(blob.data(), &header, sizeof(header));
+        if (count != 0)
+        {
+            memcpy(blob.data() + header.typesOffset, schema.types.data(), count * sizeof(ArgParserType));
+        }
+        if (wordCount != 0)
+        {
+            memcpy(blob.data() + header.providedOffset, result.providedBits.data(), wordCount * sizeof(u64));
+        }
+
+        SnapshotValue *values = sectionAt<SnapshotValue>(blob, header.valuesOffset);
+        StringRef *stringItems = sectionAt<StringRef>(blob, header.stringItemsOffset);
+        i32 *i32Items = sectionAt<i32>(blob, header.i32ItemsOffset);
+        f32 *f32Items = sectionAt<f32>(blob, header.f32ItemsOffset);
+        u8 *boolItems = sectionAt<u8>(blob, header.boolItemsOffset);
+        SnapshotChars chars(sectionAt<char>(blob, header.charsOffset));
+        u32 itemCounts[NTT_ARGUMENT_LIST_KIND_COUNT] = {};
+
+        for (u32 index = 0; index < count; index++)
+        {
+            if (schema.isPositional(index))
+            {
+                continue;
+            }
+
+            const ArgParserType type = schema.types[index];
+            SnapshotValue &value = values[index];
+            u32 *itemCount = type >= ArgParserType::STRING_LIST ? &itemCounts[type - ArgParserType::STRING_LIST] : nullptr;
+
+            switch (type)
+            {
+            case ArgParserType::STRING:
+            {
+                const StringRef ref = chars.append(ArgumentReader<ArgStringView>::read(schema, result, index, true));
+                value = SnapshotValue{ref.offset, ref.length};
+                break;
+            }
+            case ArgParserType::I32:
+                storeBits(value, ArgumentReader<i32>::read(schema, result, index, true));
+                break;
+            case ArgParserType::F32:
+                storeBits(value, ArgumentReader<f32>::read(schema, result, index, true));
+                break;
+            case ArgParserType::BOOL:
+                value.first = ArgumentReader<bool>::read(schema, result, index, true) ? 1 : 0;
+                break;
+            case ArgParserType::STRING_LIST:
+            {
+                const ArgSpan<ArgStringView> items = ArgumentReader<std::vector<String>>::read(schema, result, index, true);
+                value = SnapshotValue{*itemCount, items.size()};
+                for (const ArgStringView &item : items)
+                {
+                    stringItems[(*itemCount)++] = chars.append(item);
+                }
+                break;
+            }
+            case ArgParserType::I32_LIST:
+            {
+                const ListRange &range = result.values[index].listValue;
+                value = SnapshotValue{*itemCount, range.count};
+                std::copy(result.i32Items.begin() + range.offset, result.i32Items.begin() + range.offset + range.count, i32Items + *itemCount);
+                *itemCount += range.count;
+                break;
+            }
+            case ArgParserType::F32_LIST:
+            {
+                const ListRange &range = result.values[index].listValue;
+                value = SnapshotValue{*itemCount, range.count};
+                std::copy(result.f32Items.begin() + range.offset, result.f32Items.begin() + range.offset + range.count, f32Items + *itemCount);
+                *itemCount += range.count;
+                break;
+            }
+            case ArgParserType::BOOL_LIST:
+            {
+                const ListRange &range = result.values[index].listValue;
+                value = SnapshotValue{*itemCount, range.count};
+                std::copy(result.boolItems.begin() + range.offset, result.boolItems.begin() + range.offset + range.count, boolItems + *itemCount);
+                *itemCount += range.count;
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+
+    static inline bool fitsSection(const SnapshotHeader &header, u64 offset, u64 count, u64 elementSize)
+    {
+        return offset % NTT_SNAPSHOT_ALIGNMENT == 0 &&
+               offset >= sizeof(SnapshotHeader) &&
+               offset <= header.size &&
+               count <= (header.size - offset) / elementSize;
+    }
+
+    static inline bool fitsRange(u32 offset, u32 count, u32 total)
+    {
+        return static_cast<u64>(offset) + count <= total;
+    }
+
+    /**
+     * The string and its terminating null character must be inside the character section.
+     */
+    static inline bool fitsString(const SnapshotLayout &layout, StringRef ref)
+    {
+        return static_cast<u64>(ref.offset) + ref.length < layout.header->charCount &&
+               layout.chars[ref.offset + ref.length] == '\0';
+    }
+
+    static bool checkValue(const SnapshotLayout &layout, u32 index)
+    {
+        const SnapshotHeader &header = *layout.header;
+        const SnapshotValue &value = layout.values[index];
+
+        switch (layout.types[index])
+        {
+        case ArgParserType::STRING:
+            return fitsString(layout, StringRef{value.first, value.second});
+        case ArgParserType::STRING_LIST:
+            if (!fitsRange(value.first, value.second, header.stringItemCount))
+            {
+                return false;
+            }
+            for (u32 item = value.first; item < value.first + value.second; item++)
+            {
+                if (!fitsString(layout, layout.stringItems[item]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        case ArgParserType::I32_LIST:
+            return fitsRange(value.first, value.second, header.i32ItemCount);
+        case ArgParserType::F32_LIST:
+            return fitsRange(value.first, value.second, header.f32ItemCount);
+        case ArgParserType::BOOL_LIST:
+            return fitsRange(value.first, value.second, header.boolItemCount);
+        case ArgParserType::I32:
+        case ArgParserType::F32:
+        case ArgParserType::BOOL:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    ArgStatus attachSnapshot(const SchemaData &schema, u64 schemaHash, const void *data, u64 size, SnapshotLayout &layout)
+    {
+        const ArgStatus invalid(ArgErrorCode::ARG_ERROR_SNAPSHOT_INVALID, NTT_ARG_NO_INDEX, NTT_ARG_NO_INDEX);
+        if (data == nullptr ||
+            size < sizeof(SnapshotHeader) ||
+            reinterpret_cast<uintptr_t>(data) % NTT_SNAPSHOT_ALIGNMENT != 0)
+        {
+            return invalid;
+        }
+
+        const u8 *bytes = static_cast<const u8 *>(data);
+        const SnapshotHeader &header = *reinterpret_cast<const SnapshotHeader *>(bytes);
+
+        // The mapping of a shared memory segment may be longer than the blob.
+        if (header.magic != NTT_SNAPSHOT_MAGIC ||
+            header.version != NTT_SNAPSHOT_VERSION ||
+            header.size > size)
+        {
+            return invalid;
+        }
+
+        if (header.schemaHash != schemaHash || header.argumentCount != schema.count())
+        {
+            return ArgStatus(ArgErrorCode::ARG_ERROR_SNAPSHOT_SCHEMA_MISMATCH, NTT_ARG_NO_INDEX, NTT_ARG_NO_INDEX);
+        }
+
+        const u64 wordCount = (static_cast<u64>(header.argumentCount) + NTT_ARGUMENT_PROVIDED_WORD_BITS - 1) /
+                              NTT_ARGUMENT_PROVIDED_WORD_BITS;
+        if (!fitsSection(header, header.typesOffset, header.argumentCount, sizeof(ArgParserType)) ||
+            !fitsSection(header, header.providedOffset, wordCount, sizeof(u64)) ||
+            !fitsSection(header, header.valuesOffset, header.argumentCount, sizeof(SnapshotValue)) ||
+            !fitsSection(header, header.stringItemsOffset, header.stringItemCount, sizeof(StringRef)) ||
+            !fitsSection(header, header.i32ItemsOffset, header.i32ItemCount, sizeof(i32)) ||
+            !fitsSection(header, header.f32ItemsOffset, header.f32ItemCount, sizeof(f32)) ||
+            !fitsSection(header, header.boolItemsOffset, header.boolItemCount, sizeof(u8)) ||
+            !fitsSection(header, header.charsOffset, header.charCount, sizeof(char)))
+        {
+            return invalid;
+        }
+
+        SnapshotLayout attached;
+        attached.header = &header;
+        attached.types = reinterpret_cast<const ArgParserType *>(bytes + header.typesOffset);
+        attached.providedBits = reinterpret_cast<const u64 *>(bytes + header.providedOffset);
+        attached.values = reinterpret_cast<const SnapshotValue *>(bytes + header.valuesOffset);
+        attached.stringItems = reinterpret_cast<const StringRef *>(bytes + header.stringItemsOffset);
+        attached.i32Items = reinterpret_cast<const i32 *>(bytes + header.i32ItemsOffset);
+        attached.f32Items = reinterpret_cast<const f32 *>(bytes + header.f32ItemsOffset);
+        attached.boolItems = bytes + header.boolItemsOffset;
+        attached.chars = reinterpret_cast<const char *>(bytes + header.charsOffset);
+
+        for (u32 index = 0; index < header.argumentCount; index++)
+        {
+            if (attached.types[index] != schema.types[index] ||
+                (!schema.isPositional(index) && !checkValue(attached, index)))
+            {
+                return invalid;
+            }
+        }
+
+        layout = attached;
+        return ArgStatus();
+    }
+} // namespace NTT_NS
@@ -0,0 +1,105 @@
+#pragma once
+#include "argument_data.hpp"
+
+// The flat layout of a serialized result (`ArgParser::serialize`), every section is addressed by
+//      its offset from the start of the blob so that the blob can be mapped at any address.
+
+#define NTT_SNAPSHOT_MAGIC 0x53475241u // "ARGS"
+#define NTT_SNAPSHOT_VERSION 1u
+
+/**
+ * Every section starts at a multiple of the alignment, the attached blob must be aligned the same
+ *      (which is always true for a mapping or a heap allocation).
+ */
+#define NTT_SNAPSHOT_ALIGNMENT 8
+
+namespace NTT_NS
+{
+    /**
+     * The first bytes of the blob. The sections follow in the order of the fields: type tags,
+     *      provided bits, values, list items (per element type) and the characters of the strings.
+     */
+    struct SnapshotHeader
+    {
+        u32 magic;
+        u32 version;
+        u64 schemaHash;
+        u64 size;
+        u32 argumentCount;
+        u32 stringItemCount;
+        u32 i32ItemCount;
+        u32 f32ItemCount;
+        u32 boolItemCount;
+        u32 charCount;
+
+        u64 typesOffset;
+        u64 providedOffset;
+        u64 valuesOffset;
+        u64 stringItemsOffset;
+        u64 i32ItemsOffset;
+        u64 f32ItemsOffset;
+        u64 boolItemsOffset;
+        u64 charsOffset;
+    };
+
+    /**
+     * The value of one argument: the bits of an `i32`, `f32` or `bool` in `first`, the range of
+     *      the characters (`StringRef`) of a `STRING` or the range of the items (`ListRange`) of
+     *      a list.
+     */
+    struct SnapshotValue
+    {
+        u32 first;
+        u32 second;
+    };
+
+    /**
+     * The sections of an attached blob, they are checked once by `attachSnapshot` so that every
+     *      read stays inside the blob.
+     */
+    struct SnapshotLayout
+    {
+        const SnapshotHeader *header = nullptr;
+        const ArgParserType *types = nullptr;
+        const u64 *providedBits = nullptr;
+        const SnapshotValue *values = nullptr;
+        const StringRef *stringItems = nullptr;
+        const i32 *i32Items = nullptr;
+        const f32 *f32Items = nullptr;
+        const u8 *boolItems = nullptr;
+        const char *chars = nullptr;
+
+        inline bool isProvided(u32 index) const
+        {
+            return (providedBits[index / NTT_ARGUMENT_PROVIDED_WORD_BITS] >>
+                    (index % NTT_ARGUMENT_PROVIDED_WORD_BITS)) &
+                   1u;
+        }
+
+        inline ArgStringView stringAt(StringRef ref) const
+        {
+            return ArgStringView(chars + ref.offset, ref.length);
+        }
+    };
+
+    /**
+     * FNV-1a hash of what the blob depends on: the number of arguments and the type, the flags
+     *      (except the binding which is local to the process) and the keys of each one, so that
+     *      the same definitions give the same hash in every process. The cost grows with the
+     *      length of every key, the parser keeps it until an argument is added or changed.
+     */
+    u64 hashSchema(const SchemaData &schema);
+
+    /**
+     * Writes the current values (the bound storages for the bound arguments) into the blob, the
+     *      pending values must be resolved before.
+     */
+    void serializeResult(const SchemaData &schema, u64 schemaHash, const ResultData &result, std::vector<u8> &blob);
+
+    /**
+     * Checks the header and the bounds of every section and value without copying anything.
+     *
+     * @return `ARG_ERROR_SNAPSHOT_INVALID` or `ARG_ERROR_SNAPSHOT_SCHEMA_MISMATCH` on failure.
+     */
+    ArgStatus attachSnapshot(const SchemaData &schema, u64 schemaHash, const void *data, u64 size, SnapshotLayout &layout);
+} // namespace NTT_NS
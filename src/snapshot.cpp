@@ -0,0 +1,169 @@
+#include "snapshot.hpp"
+#include <cstring>
+#include <stdexcept>
+#include "memory.hpp"
+#include "argument_data.hpp"
+#include "serialization.hpp"
+
+namespace NTT_NS
+{
+    class ArgSnapshot::ArgSnapshotPrivate
+    {
+    public:
+        const SchemaData *schema = nullptr;
+        SnapshotLayout layout;
+
+        /**
+         * The views of the `String` list items, `ArgSpan` needs them contiguous and the blob
+         *      only holds their offsets. They are built once by the attach.
+         */
+        std::vector<ArgStringView> stringItems;
+
+        inline const SchemaData &schemaData() const
+        {
+            if (schema == nullptr)
+            {
+                throw std::invalid_argument("The snapshot is not attached to any serialized result");
+            }
+            return *schema;
+        }
+
+        inline ArgStringView stringAt(const SnapshotValue &value) const
+        {
+            return layout.stringAt(StringRef{value.first, value.second});
+        }
+
+        template <typename T>
+        inline T bitsOf(const SnapshotValue &value) const
+        {
+            T bits;
+            memcpy(&bits, &value.first, sizeof(T));
+            return bits;
+        }
+    };
+
+    ArgSnapshot::ArgSnapshot()
+    {
+        impl = CreateScope<ArgSnapshotPrivate>();
+    }
+
+    ArgSnapshot::ArgSnapshot(ArgSnapshot &&other)
+    {
+        impl = std::move(other.impl);
+        other.impl = CreateScope<ArgSnapshotPrivate>();
+    }
+
+    ArgSnapshot &ArgSnapshot::operator=(ArgSnapshot &&other)
+    {
+        if (this != &other)
+        {
+            impl = std::move(other.impl);
+            other.impl = CreateScope<ArgSnapshotPrivate>();
+        }
+        return *this;
+    }
+
+    ArgSnapshot::~ArgSnapshot() {}
+
+    bool ArgSnapshot::isAttached() const
+    {
+        return impl->schema != nullptr;
+    }
+
+    bool ArgSnapshot::isProvided(const String &key) const
+    {
+        const SchemaData &schema = impl->schemaData();
+        const i64 index = schema.searchByKey(key);
+        if (index == NTT_ARGUMENT_INVALID_INDEX)
+        {
+            throwOnError(schema, ArgStatus(ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND,
+                                           NTT_ARG_NO_INDEX,
+                                           NTT_ARG_NO_INDEX,
+                                           ArgStringView(key.c_str(), key.length())));
+        }
+        return isProvidedAt(static_cast<u32>(index));
+    }
+
+    bool ArgSnapshot::isProvidedAt(u32 index) const
+    {
+        return impl->layout.isProvided(index);
+    }
+
+    ArgStatus ArgSnapshot::attach(const SchemaData &schema, u64 schemaHash, const void *data, u64 size)
+    {
+        impl->schema = nullptr;
+        impl->stringItems.clear();
+
+        const ArgStatus status = attachSnapshot(schema, schemaHash, data, size, impl->layout);
+        if (!status.ok())
+        {
+            return status;
+        }
+
+        const SnapshotLayout &layout = impl->layout;
+        impl->stringItems.resize(layout.header->stringItemCount);
+        for (u32 item = 0; item < layout.header->stringItemCount; item++)
+        {
+            impl->stringItems[item] = layout.stringAt(layout.stringItems[item]);
+        }
+
+        impl->schema = &schema;
+        return status;
+    }
+
+#define NTT_SNAPSHOT_GET_VALUE_DEF(typeName, argParserType, readValue)                                \
+    template <>                                                                                       \
+    ArgValueType<typeName>::Type ArgSnapshot::getArgumentAt<typeName>(u32 index) const                \
+    {                                                                                                 \
+        const SnapshotValue &value = impl->layout.values[index];                                      \
+        return readValue;                                                                             \
+    }                                                                                                 \
+                                                                                                      \
+    template <>                                                                                       \
+    ArgValueType<typeName>::Type ArgSnapshot::getArgument<typeName>(const String &key) const          \
+    {                                                                                                 \
+        const SchemaData &schema = impl->schemaData();                                                \
+        u32 index = 0;                                                                                \
+        throwOnError(schema, schema.findTypedArgument(key, argParserType, #typeName, index));         \
+        return getArgumentAt<typeName>(index);                                                        \
+    }                                                                                                 \
+                                                                                                      \
+    template <>                                                                                       \
+    ArgStatus ArgSnapshot::tryGetArgument<typeName>(                                                  \
+        const String &key,                                                                            \
+        ArgValueType<typeName>::Type &value) const                                                    \
+    {                                                                                                 \
+        if (impl->schema == nullptr)                                                                  \
+        {                                                                                             \
+            return ArgStatus(ArgErrorCode::ARG_ERROR_NOT_PARSED, NTT_ARG_NO_INDEX, NTT_ARG_NO_INDEX); \
+        }                                                                                             \
+                                                                                                      \
+        u32 index = 0;                                                                                \
+        const ArgStatus status =                                                                      \
+            impl->schema->findTypedArgument(key, argParserType, #typeName, index);                    \
+        if (status.ok())                                                                              \
+        {                                                                                             \
+            value = getArgumentAt<typeName>(index);                                                   \
+        }                                                                                             \
+        return status;                                                                                \
+    }
+
+    NTT_SNAPSHOT_GET_VALUE_DEF(String, ArgParserType::STRING,
+                               impl->stringAt(value).toString());
+    NTT_SNAPSHOT_GET_VALUE_DEF(ArgStringView, ArgParserType::STRING,
+                               impl->stringAt(value));
+    NTT_SNAPSHOT_GET_VALUE_DEF(i32, ArgParserType::I32,
+                               impl->bitsOf<i32>(value));
+    NTT_SNAPSHOT_GET_VALUE_DEF(f32, ArgParserType::F32,
+                               impl->bitsOf<f32>(value));
+    NTT_SNAPSHOT_GET_VALUE_DEF(bool, ArgParserType::BOOL,
+                               value.first != 0);
+    NTT_SNAPSHOT_GET_VALUE_DEF(std::vector<String>, ArgParserType::STRING_LIST,
+                               ArgSpan<ArgStringView>(impl->stringItems.data() + value.first, value.second));
+    NTT_SNAPSHOT_GET_VALUE_DEF(std::vector<i32>, ArgParserType::I32_LIST,
+                               ArgSpan<i32>(impl->layout.i32Items + value.first, value.second));
+    NTT_SNAPSHOT_GET_VALUE_DEF(std::vector<f32>, ArgParserType::F32_LIST,
+                               ArgSpan<f32>(impl->layout.f32Items + value.first, value.second));
+    NTT_SNAPSHOT_GET_VALUE_DEF(std::vector<bool>, ArgParserType::BOOL_LIST,
+                               ArgSpan<bool>(impl->layout.boolItems + value.first, value.second));
+} // namespace NTT_NS
@@ -0,0 +1,93 @@
+#pragma once
+#include "parser.hpp"
+
+namespace NTT_NS
+{
+    struct SchemaData;
+
+    /**
+     * Read only view over a serialized result (see `ArgParser::serialize`), obtained by
+     *      `ArgParser::attach` in another process which defines the same arguments. Nothing is
+     *      parsed or converted: every read goes straight into the blob, the `String` values are
+     *      views into it and the lists are spans over it. The snapshot is valid as long as the
+     *      blob and the parser which attached it (until another argument is added).
+     *
+     * @example
+     * ```c++
+     * // launcher
+     * parser.parse(argc, argv);
+     * std::vector<u8> blob = parser.serialize(); // written into a memfd passed to the workers
+     *
+     * // worker, the same `addArgument` calls
+     * ArgSnapshot snapshot = parser.attach(mapping, mappingSize);
+     * f32 radius = snapshot.get(radiusHandle);
+     * ```
+     */
+    class ArgSnapshot
+    {
+        NTT_PRIVATE_DEF(ArgSnapshot);
+
+    public:
+        ArgSnapshot();
+        ArgSnapshot(ArgSnapshot &&other);
+        ArgSnapshot &operator=(ArgSnapshot &&other);
+        ~ArgSnapshot();
+
+    public:
+        /**
+         * @retval true if the snapshot is attached to a blob.
+         * @retval false if it is default constructed or the last attach failed.
+         */
+        bool isAttached() const;
+
+        /**
+         * Same contract as `ArgParser::getArgument`.
+         */
+        template <typename T>
+        typename ArgValueType<T>::Type getArgument(const String &key) const;
+
+        /**
+         * Same contract as `ArgParser::tryGetArgument`, `ARG_ERROR_NOT_PARSED` if the snapshot is
+         *      not attached.
+         */
+        template <typename T>
+        ArgStatus tryGetArgument(const String &key, typename ArgValueType<T>::Type &value) const;
+
+        /**
+         * Reads the value through a handle returned by `addArgument` of the attaching parser,
+         *      there is no lookup and no check.
+         */
+        template <typename T>
+        inline typename ArgValueType<T>::Type get(const ArgHandle<T> &handle) const
+        {
+            return getArgumentAt<T>(handle.m_index);
+        }
+
+        /**
+         * @retval true if the argument is given by the serialized parse (command line,
+         *      environment or config file).
+         * @retval false if it has its default value. Throws `std::invalid_argument` if the key
+         *      is not found.
+         */
+        bool isProvided(const String &key) const;
+
+        template <typename T>
+        inline bool isProvided(const ArgHandle<T> &handle) const
+        {
+            return isProvidedAt(handle.m_index);
+        }
+
+    private:
+        friend class ArgParser;
+
+        template <typename T>
+        typename ArgValueType<T>::Type getArgumentAt(u32 index) const;
+
+        bool isProvidedAt(u32 index) const;
+
+        /**
+         * Only used by `ArgParser::tryAttach`, the snapshot is detached on failure.
+         */
+        ArgStatus attach(const SchemaData &schema, u64 schemaHash, const void *data, u64 size);
+    };
+} // namespace NTT_NS
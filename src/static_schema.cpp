@@ -0,0 +1,191 @@
+#include "static_schema.hpp"
+#include "argument_data.hpp"
+#include "conversion.hpp"
+#include "help.hpp"
+
+namespace NTT_NS
+{
+    static inline void markStaticProvided(u64 *providedBits, u32 index)
+    {
+        providedBits[index / NTT_ARG_STATIC_PROVIDED_WORD_BITS] |=
+            u64(1) << (index % NTT_ARG_STATIC_PROVIDED_WORD_BITS);
+    }
+
+    static inline bool isStaticProvided(const u64 *providedBits, u32 index)
+    {
+        return (providedBits[index / NTT_ARG_STATIC_PROVIDED_WORD_BITS] >>
+                (index % NTT_ARG_STATIC_PROVIDED_WORD_BITS)) &
+               1u;
+    }
+
+    static inline ArgStatus staticMissingValue(u32 tokenIndex, u32 index, const ArgToken &key, const char *typeName)
+    {
+        return ArgStatus(ArgErrorCode::ARG_ERROR_MISSING_VALUE, tokenIndex + 1, index, key.view(), typeName);
+    }
+
+    ArgStatus parseStaticArguments(
+        const ArgStaticSchemaView &schema,
+        ArgStaticValue *values,
+        u64 *providedBits,
+        u32 argc,
+        char **argv)
+    {
+        for (u32 index = 0; index < schema.count; index++)
+        {
+            values[index] = schema.arguments[index].defaultValue;
+        }
+        memset(providedBits,
+               0,
+               (schema.count + NTT_ARG_STATIC_PROVIDED_WORD_BITS - 1) / NTT_ARG_STATIC_PROVIDED_WORD_BITS * sizeof(u64));
+
+        const bool rejectsInvalidValue = schema.conversionPolicy == ArgConversionPolicy::STRICT_CONVERSION;
+
+        // The program name is skipped, the token indexes are the same as inside `argv`.
+        for (u32 i = 1; i < argc; i++)
+        {
+            const ArgToken token{argv[i], static_cast<u32>(strlen(argv[i])), 0};
+            const u32 index = schema.find(token.data, token.length);
+
+            if (index == NTT_ARG_NO_INDEX)
+            {
+                const ArgErrorCode code = isHelpKey(token) ? ArgErrorCode::ARG_ERROR_HELP_REQUESTED
+                                                           : ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND;
+                return ArgStatus(code, i, NTT_ARG_NO_INDEX, token.view());
+            }
+
+            switch (schema.arguments[index].type)
+            {
+            case ArgStaticType::ARG_STATIC_STRING:
+                if (i + 1 >= argc)
+                {
+                    return staticMissingValue(i, index, token, "string");
+                }
+
+                values[index].stringValue = ArgStaticString{argv[i + 1], static_cast<u32>(strlen(argv[i + 1]))};
+                i++;
+                break;
+            case ArgStaticType::ARG_STATIC_I32:
+            {
+                if (i + 1 >= argc)
+                {
+                    return staticMissingValue(i, index, token, "i32");
+                }
+
+                const char *value = argv[i + 1];
+                const u32 length = static_cast<u32>(strlen(value));
+                if (!parseI32(value, value + length, values[index].i32Value))
+                {
+                    if (rejectsInvalidValue)
+                    {
+                        return ArgStatus(ArgErrorCode::ARG_ERROR_INVALID_VALUE, i + 1, index, ArgStringView(value, length), "i32");
+                    }
+                    parseI32Prefix(value, value + length, values[index].i32Value);
+                }
+                i++;
+                break;
+            }
+            case ArgStaticType::ARG_STATIC_F32:
+            {
+                if (i + 1 >= argc)
+                {
+                    return staticMissingValue(i, index, token, "f32");
+                }
+
+                const char *value = argv[i + 1];
+                const u32 length = static_cast<u32>(strlen(value));
+                if (!parseF32(value, value + length, values[index].f32Value))
+                {
+                    if (rejectsInvalidValue)
+                    {
+                        return ArgStatus(ArgErrorCode::ARG_ERROR_INVALID_VALUE, i + 1, index, ArgStringView(value, length), "f32");
+                    }
+                    parseF32Prefix(value, value + length, values[index].f32Value);
+                }
+                i++;
+                break;
+            }
+            case ArgStaticType::ARG_STATIC_BOOL:
+                // The explicit value is optional, the flag alone means `true`.
+                if (i + 1 < argc && (strcmp(argv[i + 1], "true") == 0 || strcmp(argv[i + 1], "false") == 0))
+                {
+                    values[index].boolValue = strcmp(argv[i + 1], "true") == 0;
+                    i++;
+                }
+                else
+                {
+                    values[index].boolValue = true;
+                }
+                break;
+            default:
+                throw std::invalid_argument("The type is not supported");
+            }
+
+            markStaticProvided(providedBits, index);
+        }
+
+        for (u32 required = 0; required < schema.requiredCount; required++)
+        {
+            const u32 index = schema.requiredIndexes[required];
+            if (!isStaticProvided(providedBits, index))
+            {
+                return ArgStatus(ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED, NTT_ARG_NO_INDEX, index);
+            }
+        }
+
+        return ArgStatus();
+    }
+
+    static std::vector<String> staticTriggerKeysOf(const ArgStaticSchemaView &schema, u32 index)
+    {
+        const ArgStaticKeys &keys = schema.arguments[index].keys;
+        std::vector<String> triggerKeys;
+        triggerKeys.reserve(keys.count);
+        for (u32 key = 0; key < keys.count; key++)
+        {
+            triggerKeys.push_back(ArgStringView(keys.keys[key], keys.lengths[key]).toString());
+        }
+        return triggerKeys;
+    }
+
+    String formatStaticStatus(const ArgStaticSchemaView &schema, const ArgStatus &status)
+    {
+        switch (status.code())
+        {
+        case ArgErrorCode::ARG_ERROR_NONE:
+            return NTT_STRING_EMPTY;
+        case ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND:
+            return format("The key {} is not found", status.subject().toString());
+        case ArgErrorCode::ARG_ERROR_MISSING_VALUE:
+            return format("The {} argument {} is not followed by a value",
+                          String(status.typeName()),
+                          staticTriggerKeysOf(schema, status.argumentIndex()));
+        case ArgErrorCode::ARG_ERROR_INVALID_VALUE:
+            return format("The value {} of the argument {} is not a valid {}",
+                          status.subject().toString(),
+                          staticTriggerKeysOf(schema, status.argumentIndex()),
+                          String(status.typeName()));
+        case ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED:
+            return format("The required argument {} is not provided",
+                          staticTriggerKeysOf(schema, status.argumentIndex()));
+        case ArgErrorCode::ARG_ERROR_HELP_REQUESTED:
+            return "The help is requested";
+
+        // Never returned by the parse of a static schema.
+        case ArgErrorCode::ARG_ERROR_TYPE_MISMATCH:
+        case ArgErrorCode::ARG_ERROR_RESPONSE_FILE_NOT_OPENED:
+        case ArgErrorCode::ARG_ERROR_RESPONSE_FILE_UNTERMINATED_QUOTE:
+        case ArgErrorCode::ARG_ERROR_NOT_PARSED:
+        case ArgErrorCode::ARG_ERROR_CONFIG_FILE_NOT_OPENED:
+        case ArgErrorCode::ARG_ERROR_CONFIG_FILE_INVALID:
+        case ArgErrorCode::ARG_ERROR_SNAPSHOT_INVALID:
+        case ArgErrorCode::ARG_ERROR_SNAPSHOT_SCHEMA_MISMATCH:
+        case ArgErrorCode::ARG_ERROR_AMBIGUOUS_KEY:
+        case ArgErrorCode::ARG_ERROR_STREAM_READ_FAILED:
+        case ArgErrorCode::ARG_ERROR_STREAM_TOKEN_TOO_LONG:
+        case ArgErrorCode::ARG_ERROR_UNEXPECTED_POSITIONAL:
+        case ArgErrorCode::ARG_ERROR_VALIDATION_FAILED:
+        default:
+            return "Unknown error";
+        }
+    }
+} // namespace NTT_NS
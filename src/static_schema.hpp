@@ -0,0 +1,547 @@
+#pragma once
+#include "parser.hpp"
+#include <cstring>
+#include <stdexcept>
+
+// The maximum number of keys of one argument of a static schema, the constructor of
+//      `ArgStaticKeys` takes as many.
+#define NTT_ARG_STATIC_MAX_KEYS 4
+
+// The seeds tried by the compile time search of the perfect hash, a schema whose keys need more
+//      does not compile.
+#define NTT_ARG_STATIC_MAX_SEEDS 1024
+
+#define NTT_ARG_STATIC_PROVIDED_WORD_BITS 64
+
+namespace NTT_NS
+{
+    /**
+     * The types of the arguments of a static schema, only the single value types are supported
+     *      since the default values must be constant data.
+     */
+    enum ArgStaticType : u8
+    {
+        ARG_STATIC_STRING,
+        ARG_STATIC_I32,
+        ARG_STATIC_F32,
+        ARG_STATIC_BOOL,
+    };
+
+    constexpr u32 argStaticLength(const char *text)
+    {
+        u32 length = 0;
+        while (text != nullptr && text[length] != '\0')
+        {
+            length++;
+        }
+        return length;
+    }
+
+    constexpr bool argStaticEquals(const char *first, u32 firstLength, const char *second, u32 secondLength)
+    {
+        if (firstLength != secondLength)
+        {
+            return false;
+        }
+        for (u32 i = 0; i < firstLength; i++)
+        {
+            if (first[i] != second[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * FNV-1a of the key whose offset basis depends on the seed, followed by a final mix so that
+     *      the seed also changes the low bits which select the slot. The same function is
+     *      evaluated by the compiler (search of the seed) and by the parse.
+     */
+    constexpr u32 argStaticHash(const char *key, u32 length, u32 seed)
+    {
+        u32 hash = 2166136261u ^ (seed * 2654435761u);
+        for (u32 i = 0; i < length; i++)
+        {
+            hash ^= static_cast<unsigned char>(key[i]);
+            hash *= 16777619u;
+        }
+        hash ^= hash >> 15;
+        hash *= 2246822519u;
+        hash ^= hash >> 13;
+        return hash;
+    }
+
+    /**
+     * The number of slots of the perfect hash, a power of 2 which is at least twice the maximum
+     *      number of keys so that a seed is found after a few tries.
+     */
+    constexpr u32 argStaticSlotCount(u32 argumentCount)
+    {
+        u32 slotCount = 1;
+        while (slotCount < argumentCount * NTT_ARG_STATIC_MAX_KEYS * 2)
+        {
+            slotCount *= 2;
+        }
+        return slotCount;
+    }
+
+    struct ArgStaticString
+    {
+        const char *data;
+        u32 length;
+    };
+
+    /**
+     * The default value of an argument (constant data) or its parsed value, the `STRING` values
+     *      are either the literal of the definition or a view into the `argv`.
+     */
+    union ArgStaticValue
+    {
+        ArgStaticString stringValue;
+        i32 i32Value;
+        f32 f32Value;
+        bool boolValue;
+
+        constexpr ArgStaticValue() : i32Value(0) {}
+        constexpr ArgStaticValue(const char *value) : stringValue{value, argStaticLength(value)} {}
+        constexpr ArgStaticValue(i32 value) : i32Value(value) {}
+        constexpr ArgStaticValue(f32 value) : f32Value(value) {}
+        constexpr ArgStaticValue(bool value) : boolValue(value) {}
+    };
+
+    /**
+     * The trigger keys of an argument, built from the braced list of the definition
+     *      (`{"-r", "--radius"}`).
+     */
+    struct ArgStaticKeys
+    {
+        const char *keys[NTT_ARG_STATIC_MAX_KEYS];
+        u32 lengths[NTT_ARG_STATIC_MAX_KEYS];
+        u32 count;
+
+        constexpr ArgStaticKeys(
+            const char *first,
+            const char *second = nullptr,
+            const char *third = nullptr,
+            const char *fourth = nullptr)
+            : keys{first, second, third, fourth},
+              lengths{argStaticLength(first), argStaticLength(second), argStaticLength(third), argStaticLength(fourth)},
+              count(fourth != nullptr ? 4 : third != nullptr ? 3 : second != nullptr ? 2 : 1)
+        {
+        }
+    };
+
+    /**
+     * One argument of a static schema, see `staticArgument`.
+     */
+    struct ArgStaticArgument
+    {
+        ArgStaticKeys keys;
+        const char *description;
+        ArgStaticType type;
+        bool isRequired;
+        ArgStaticValue defaultValue;
+    };
+
+    /**
+     * The type tag, the default value and the read of each supported type.
+     */
+    template <typename T>
+    struct ArgStaticTraits;
+
+    template <>
+    struct ArgStaticTraits<String>
+    {
+        using Default = const char *;
+        static constexpr ArgStaticType type() { return ArgStaticType::ARG_STATIC_STRING; }
+        static constexpr Default defaultValue() { return ""; }
+        static inline String read(const ArgStaticValue &value)
+        {
+            return ArgStringView(value.stringValue.data, value.stringValue.length).toString();
+        }
+    };
+
+    template <>
+    struct ArgStaticTraits<ArgStringView>
+    {
+        using Default = const char *;
+        static constexpr ArgStaticType type() { return ArgStaticType::ARG_STATIC_STRING; }
+        static constexpr Default defaultValue() { return ""; }
+        static inline ArgStringView read(const ArgStaticValue &value)
+        {
+            return ArgStringView(value.stringValue.data, value.stringValue.length);
+        }
+    };
+
+    template <>
+    struct ArgStaticTraits<i32>
+    {
+        using Default = i32;
+        static constexpr ArgStaticType type() { return ArgStaticType::ARG_STATIC_I32; }
+        static constexpr Default defaultValue() { return 0; }
+        static inline i32 read(const ArgStaticValue &value) { return value.i32Value; }
+    };
+
+    template <>
+    struct ArgStaticTraits<f32>
+    {
+        using Default = f32;
+        static constexpr ArgStaticType type() { return ArgStaticType::ARG_STATIC_F32; }
+        static constexpr Default defaultValue() { return 0.0f; }
+        static inline f32 read(const ArgStaticValue &value) { return value.f32Value; }
+    };
+
+    template <>
+    struct ArgStaticTraits<bool>
+    {
+        using Default = bool;
+        static constexpr ArgStaticType type() { return ArgStaticType::ARG_STATIC_BOOL; }
+        static constexpr Default defaultValue() { return false; }
+        static inline bool read(const ArgStaticValue &value) { return value.boolValue; }
+    };
+
+    /**
+     * Defines one argument of a static schema, the parameters are the same as
+     *      `ArgParser::addArgument`.
+     *
+     * @tparam T `String`, `i32`, `f32` or `bool` (`ArgStringView` is the same as `String`).
+     */
+    template <typename T>
+    constexpr ArgStaticArgument staticArgument(
+        ArgStaticKeys triggerKeys,
+        const char *description = "",
+        bool isRequired = false,
+        typename ArgStaticTraits<T>::Default defaultValue = ArgStaticTraits<T>::defaultValue())
+    {
+        return ArgStaticArgument{triggerKeys, description, ArgStaticTraits<T>::type(), isRequired, ArgStaticValue(defaultValue)};
+    }
+
+    /**
+     * Typed reference to an argument of a static schema, obtained at compile time by
+     *      `ArgStaticSchema::handle` so that the type is checked by the compiler.
+     */
+    template <typename T>
+    class ArgStaticHandle
+    {
+    public:
+        constexpr ArgStaticHandle() : m_index(NTT_ARG_NO_INDEX) {}
+
+        constexpr u32 index() const { return m_index; }
+
+    private:
+        template <u32 N>
+        friend class ArgStaticSchema;
+
+        constexpr explicit ArgStaticHandle(u32 index) : m_index(index) {}
+
+        u32 m_index;
+    };
+
+    /**
+     * One slot of the perfect hash, `argument` is `NTT_ARG_NO_INDEX` for an empty slot.
+     */
+    struct ArgStaticSlot
+    {
+        u32 argument;
+        u32 key;
+    };
+
+    /**
+     * The constant tables of an `ArgStaticSchema` without its size, so that the parse is not
+     *      instantiated per schema.
+     */
+    struct ArgStaticSchemaView
+    {
+        const ArgStaticArgument *arguments;
+        u32 count;
+        const ArgStaticSlot *slots;
+        u32 slotMask;
+        u32 seed;
+        const u32 *requiredIndexes;
+        u32 requiredCount;
+        ArgConversionPolicy conversionPolicy;
+
+        /**
+         * One hash and one comparison whatever the number of keys is.
+         *
+         * @return The index of the argument, `NTT_ARG_NO_INDEX` if the key is not defined.
+         */
+        inline u32 find(const char *key, u32 length) const
+        {
+            const ArgStaticSlot &slot = slots[argStaticHash(key, length, seed) & slotMask];
+            if (slot.argument == NTT_ARG_NO_INDEX)
+            {
+                return NTT_ARG_NO_INDEX;
+            }
+
+            const ArgStaticKeys &keys = arguments[slot.argument].keys;
+            return keys.lengths[slot.key] == length && memcmp(keys.keys[slot.key], key, length) == 0
+                       ? slot.argument
+                       : NTT_ARG_NO_INDEX;
+        }
+    };
+
+    /**
+     * The parse shared by every static schema: the values receive the default values, then the
+     *      tokens are read like `ArgParser::parse` does. The `STRING` values are views into the
+     *      `argv`.
+     */
+    ArgStatus parseStaticArguments(
+        const ArgStaticSchemaView &schema,
+        ArgStaticValue *values,
+        u64 *providedBits,
+        u32 argc,
+        char **argv);
+
+    /**
+     * Same messages as `ArgParser::getErrorMessage`.
+     */
+    String formatStaticStatus(const ArgStaticSchemaView &schema, const ArgStatus &status);
+
+    template <u32 N>
+    class ArgStaticSchema;
+
+    /**
+     * The values of one parse against an `ArgStaticSchema`, a fixed size object without any
+     *      allocation. The values are only valid after a successful parse and as long as the
+     *      `argv` of that parse (the `String` values are views into it).
+     */
+    template <u32 N>
+    class ArgStaticResult
+    {
+    public:
+        inline bool isParsed() const { return m_isParsed; }
+
+        template <typename T>
+        inline typename ArgValueType<T>::Type get(const ArgStaticHandle<T> &handle) const
+        {
+            return ArgStaticTraits<T>::read(m_values[handle.index()]);
+        }
+
+        /**
+         * @retval true if the argument is given by the command line.
+         * @retval false if it has its default value.
+         */
+        template <typename T>
+        inline bool isProvided(const ArgStaticHandle<T> &handle) const
+        {
+            return (m_providedBits[handle.index() / NTT_ARG_STATIC_PROVIDED_WORD_BITS] >>
+                    (handle.index() % NTT_ARG_STATIC_PROVIDED_WORD_BITS)) &
+                   1u;
+        }
+
+    private:
+        friend class ArgStaticSchema<N>;
+
+        ArgStaticValue m_values[N];
+        u64 m_providedBits[(N + NTT_ARG_STATIC_PROVIDED_WORD_BITS - 1) / NTT_ARG_STATIC_PROVIDED_WORD_BITS] = {};
+        bool m_isParsed = false;
+    };
+
+    /**
+     * Declarative alternative to `ArgParser` for the tools whose arguments never change: the
+     *      definitions are a `constexpr` table and the schema (a perfect hash of every key, the
+     *      required argument list) is computed by the compiler, so that nothing is built at
+     *      startup and the lookup of a token is one hash and one comparison. A duplicated key or
+     *      a handle of the wrong type is a compile error.
+     *
+     * @example
+     * ```c++
+     * constexpr ArgStaticArgument kArguments[] = {
+     *     staticArgument<String>({"-v", "--version"}, "The version", false, "1.0.0"),
+     *     staticArgument<f32>({"-r", "--radius"}, "The radius", true, 1.0f),
+     * };
+     * constexpr ArgStaticSchema<2> kSchema(kArguments);
+     * constexpr ArgStaticHandle<f32> kRadius = kSchema.handle<f32>("--radius");
+     *
+     * ArgStaticResult<2> result;
+     * kSchema.parse(argc, argv, result);
+     * f32 radius = result.get(kRadius);
+     * ```
+     */
+    template <u32 N>
+    class ArgStaticSchema
+    {
+        static_assert(N > 0, "The static schema needs at least one argument");
+
+    public:
+        static constexpr u32 SLOT_COUNT = argStaticSlotCount(N);
+
+        /**
+         * @param arguments A `constexpr` table which must outlive the schema (a global).
+         * @param policy See `ArgParser::setConversionPolicy`.
+         */
+        constexpr explicit ArgStaticSchema(
+            const ArgStaticArgument (&arguments)[N],
+            ArgConversionPolicy policy = ArgConversionPolicy::LENIENT_CONVERSION)
+            : m_arguments(arguments),
+              m_policy(policy),
+              m_seed(0),
+              m_slots{},
+              m_requiredIndexes{},
+              m_requiredCount(0)
+        {
+            checkKeys();
+            m_seed = findSeed();
+
+            for (u32 slot = 0; slot < SLOT_COUNT; slot++)
+            {
+                m_slots[slot] = ArgStaticSlot{NTT_ARG_NO_INDEX, 0};
+            }
+            for (u32 argument = 0; argument < N; argument++)
+            {
+                const ArgStaticKeys &keys = m_arguments[argument].keys;
+                for (u32 key = 0; key < keys.count; key++)
+                {
+                    m_slots[argStaticHash(keys.keys[key], keys.lengths[key], m_seed) & (SLOT_COUNT - 1)] =
+                        ArgStaticSlot{argument, key};
+                }
+
+                if (m_arguments[argument].isRequired)
+                {
+                    m_requiredIndexes[m_requiredCount++] = argument;
+                }
+            }
+        }
+
+        constexpr u32 count() const { return N; }
+
+        /**
+         * @return The index of the argument of the key, evaluated at compile time the key which is
+         *      not defined does not compile.
+         */
+        constexpr u32 indexOf(const char *key) const
+        {
+            const u32 length = argStaticLength(key);
+            const ArgStaticSlot slot = m_slots[argStaticHash(key, length, m_seed) & (SLOT_COUNT - 1)];
+            if (slot.argument == NTT_ARG_NO_INDEX ||
+                !argStaticEquals(m_arguments[slot.argument].keys.keys[slot.key],
+                                 m_arguments[slot.argument].keys.lengths[slot.key],
+                                 key,
+                                 length))
+            {
+                throw std::invalid_argument("The key is not defined by the static schema");
+            }
+            return slot.argument;
+        }
+
+        template <typename T>
+        constexpr ArgStaticHandle<T> handle(const char *key) const
+        {
+            const u32 index = indexOf(key);
+            if (m_arguments[index].type != ArgStaticTraits<T>::type())
+            {
+                throw std::invalid_argument("The type of the handle does not match the argument");
+            }
+            return ArgStaticHandle<T>(index);
+        }
+
+        /**
+         * Same as `ArgParser::tryParse`, the help request (`-h`, `--help`) is returned as
+         *      `ARG_ERROR_HELP_REQUESTED`.
+         */
+        inline ArgStatus tryParse(u32 argc, char **argv, ArgStaticResult<N> &result) const
+        {
+            const ArgStatus status = parseStaticArguments(view(), result.m_values, result.m_providedBits, argc, argv);
+            result.m_isParsed = status.ok();
+            return status;
+        }
+
+        /**
+         * Same as `tryParse` but the failure is thrown as `std::invalid_argument`, the help
+         *      request as well (like `ArgSchema::parse`).
+         */
+        inline void parse(u32 argc, char **argv, ArgStaticResult<N> &result) const
+        {
+            const ArgStatus status = tryParse(argc, argv, result);
+            if (!status.ok())
+            {
+                throw std::invalid_argument(getErrorMessage(status).c_str());
+            }
+        }
+
+        inline String getErrorMessage(const ArgStatus &status) const
+        {
+            return formatStaticStatus(view(), status);
+        }
+
+        inline ArgStaticSchemaView view() const
+        {
+            return ArgStaticSchemaView{m_arguments, N, m_slots, SLOT_COUNT - 1, m_seed, m_requiredIndexes, m_requiredCount, m_policy};
+        }
+
+    private:
+        constexpr void checkKeys() const
+        {
+            for (u32 argument = 0; argument < N; argument++)
+            {
+                const ArgStaticKeys &keys = m_arguments[argument].keys;
+                for (u32 key = 0; key < keys.count; key++)
+                {
+                    if (keys.lengths[key] == 0)
+                    {
+                        throw std::invalid_argument("The key of the static schema is empty");
+                    }
+
+                    for (u32 other = 0; other < argument; other++)
+                    {
+                        const ArgStaticKeys &otherKeys = m_arguments[other].keys;
+                        for (u32 otherKey = 0; otherKey < otherKeys.count; otherKey++)
+                        {
+                            if (argStaticEquals(keys.keys[key], keys.lengths[key], otherKeys.keys[otherKey], otherKeys.lengths[otherKey]))
+                            {
+                                throw std::invalid_argument("The key is already defined by the static schema");
+                            }
+                        }
+                    }
+                    for (u32 otherKey = 0; otherKey < key; otherKey++)
+                    {
+                        if (argStaticEquals(keys.keys[key], keys.lengths[key], keys.keys[otherKey], keys.lengths[otherKey]))
+                        {
+                            throw std::invalid_argument("The key is already defined by the static schema");
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * @return The first seed which places every key into its own slot.
+         */
+        constexpr u32 findSeed() const
+        {
+            for (u32 seed = 0; seed < NTT_ARG_STATIC_MAX_SEEDS; seed++)
+            {
+                bool used[SLOT_COUNT] = {};
+                bool isPerfect = true;
+                for (u32 argument = 0; argument < N && isPerfect; argument++)
+                {
+                    const ArgStaticKeys &keys = m_arguments[argument].keys;
+                    for (u32 key = 0; key < keys.count && isPerfect; key++)
+                    {
+                        const u32 slot = argStaticHash(keys.keys[key], keys.lengths[key], seed) & (SLOT_COUNT - 1);
+                        isPerfect = !used[slot];
+                        used[slot] = true;
+                    }
+                }
+
+                if (isPerfect)
+                {
+                    return seed;
+                }
+            }
+            throw std::invalid_argument("No perfect hash is found for the keys of the static schema");
+        }
+
+        const ArgStaticArgument *m_arguments;
+        ArgConversionPolicy m_policy;
+        u32 m_seed;
+        ArgStaticSlot m_slots[SLOT_COUNT];
+        u32 m_requiredIndexes[N];
+        u32 m_requiredCount;
+    };
+
+    template <u32 N>
+    constexpr u32 ArgStaticSchema<N>::SLOT_COUNT;
+} // namespace NTT_NS
@@ -0,0 +1,161 @@
+#include "token_source.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "memory.hpp"
+
+#ifdef NTT_PLATFORM_UNIX
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+namespace NTT_NS
+{
+    class ArgTokenSource::ArgTokenSourcePrivate
+    {
+    public:
+        ArgChunkReader reader;
+        char delimiter = '\0';
+        std::vector<char> buffer;
+
+        /**
+         * The start of the next token and the end of the bytes which are read.
+         */
+        u32 position = 0;
+        u32 end = 0;
+
+        bool isEnded = false;
+        ArgErrorCode error = ArgErrorCode::ARG_ERROR_NONE;
+        u64 tokenCount = 0;
+
+        /**
+         * Moves the partial token to the front of the buffer and reads after it.
+         *
+         * @retval false if nothing more can be read (end of the input or failure).
+         */
+        bool refill()
+        {
+            if (position != 0)
+            {
+                memmove(buffer.data(), buffer.data() + position, end - position);
+                end -= position;
+                position = 0;
+            }
+
+            if (end == buffer.size())
+            {
+                error = ArgErrorCode::ARG_ERROR_STREAM_TOKEN_TOO_LONG;
+                return false;
+            }
+
+            const i64 count = reader(buffer.data() + end, static_cast<u32>(buffer.size()) - end);
+            if (count < 0)
+            {
+                error = ArgErrorCode::ARG_ERROR_STREAM_READ_FAILED;
+                return false;
+            }
+            if (count == 0)
+            {
+                isEnded = true;
+                return false;
+            }
+
+            end += static_cast<u32>(count);
+            return true;
+        }
+    };
+
+    static i64 readDescriptor(i32 fileDescriptor, char *buffer, u32 capacity)
+    {
+        for (;;)
+        {
+#ifdef NTT_PLATFORM_UNIX
+            const ssize_t count = ::read(fileDescriptor, buffer, capacity);
+#else
+            const int count = _read(fileDescriptor, buffer, capacity);
+#endif
+            if (count >= 0 || errno != EINTR)
+            {
+                return static_cast<i64>(count);
+            }
+        }
+    }
+
+    ArgTokenSource::ArgTokenSource(i32 fileDescriptor, ArgTokenDelimiter delimiter, u32 bufferSize)
+        : ArgTokenSource(
+              [fileDescriptor](char *buffer, u32 capacity)
+              { return readDescriptor(fileDescriptor, buffer, capacity); },
+              delimiter,
+              bufferSize)
+    {
+    }
+
+    ArgTokenSource::ArgTokenSource(ArgChunkReader reader, ArgTokenDelimiter delimiter, u32 bufferSize)
+    {
+        if (bufferSize == 0)
+        {
+            throw std::invalid_argument("The buffer of the token source cannot be empty");
+        }
+
+        impl = CreateScope<ArgTokenSourcePrivate>();
+        impl->reader = std::move(reader);
+        impl->delimiter = delimiter == ArgTokenDelimiter::ARG_TOKEN_DELIMITER_NEWLINE ? '\n' : '\0';
+        impl->buffer.resize(bufferSize);
+    }
+
+    ArgTokenSource::~ArgTokenSource() {}
+
+    bool ArgTokenSource::next(ArgStringView &token)
+    {
+        ArgTokenSourcePrivate &source = *impl;
+        u32 searched = source.position;
+
+        for (;;)
+        {
+            const char *start = source.buffer.data() + source.position;
+            const char *found = static_cast<const char *>(
+                memchr(source.buffer.data() + searched, source.delimiter, source.end - searched));
+            if (found != nullptr)
+            {
+                const u32 length = static_cast<u32>(found - start);
+                token = ArgStringView(start, length);
+                source.position += length + 1;
+                source.tokenCount++;
+                return true;
+            }
+
+            if (source.isEnded || source.error != ArgErrorCode::ARG_ERROR_NONE)
+            {
+                return false;
+            }
+
+            // Only the part after the partial token is searched again.
+            searched = source.end - source.position;
+            if (!source.refill())
+            {
+                if (source.error != ArgErrorCode::ARG_ERROR_NONE || source.position == source.end)
+                {
+                    return false;
+                }
+
+                // The last token has no delimiter.
+                token = ArgStringView(source.buffer.data(), source.end);
+                source.position = source.end;
+                source.tokenCount++;
+                return true;
+            }
+        }
+    }
+
+    ArgErrorCode ArgTokenSource::getError() const
+    {
+        return impl->error;
+    }
+
+    u64 ArgTokenSource::getTokenCount() const
+    {
+        return impl->tokenCount;
+    }
+} // namespace NTT_NS
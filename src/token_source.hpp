@@ -0,0 +1,82 @@
+#pragma once
+#include "parser.hpp"
+
+/**
+ * The default size of the buffer of an `ArgTokenSource`, the longest token (with its delimiter)
+ *      must fit into it.
+ */
+#define NTT_ARG_TOKEN_SOURCE_BUFFER_SIZE (64 * 1024)
+
+namespace NTT_NS
+{
+    enum ArgTokenDelimiter : u8
+    {
+        /**
+         * `find -print0`, `xargs -0`, ...
+         */
+        ARG_TOKEN_DELIMITER_NUL,
+        ARG_TOKEN_DELIMITER_NEWLINE,
+    };
+
+    /**
+     * Fills `buffer` with the next bytes of the input.
+     *
+     * @return The number of bytes written (at most `capacity`), `0` at the end of the input and a
+     *      negative number on failure.
+     */
+    using ArgChunkReader = std::function<i64(char *buffer, u32 capacity)>;
+
+    /**
+     * Delimited tokens read from a file descriptor (a pipe, the standard input, ...) or from any
+     *      chunked reader through a fixed size buffer, the memory does not depend on the input
+     *      length. The tokens are not copied: each one is a view into the buffer which is only
+     *      valid until the next call of `next`. The last token does not need a delimiter.
+     *
+     * @example
+     * ```c++
+     * // find . -print0 | tool --jobs 4
+     * ArgTokenSource source(0); // standard input, NUL delimited
+     * parser.parseStream(source);
+     * ```
+     */
+    class ArgTokenSource
+    {
+        NTT_PRIVATE_DEF(ArgTokenSource);
+
+    public:
+        /**
+         * The descriptor is not closed by the source.
+         */
+        explicit ArgTokenSource(
+            i32 fileDescriptor,
+            ArgTokenDelimiter delimiter = ArgTokenDelimiter::ARG_TOKEN_DELIMITER_NUL,
+            u32 bufferSize = NTT_ARG_TOKEN_SOURCE_BUFFER_SIZE);
+
+        explicit ArgTokenSource(
+            ArgChunkReader reader,
+            ArgTokenDelimiter delimiter = ArgTokenDelimiter::ARG_TOKEN_DELIMITER_NUL,
+            u32 bufferSize = NTT_ARG_TOKEN_SOURCE_BUFFER_SIZE);
+
+        ~ArgTokenSource();
+
+    public:
+        /**
+         * @retval true if `token` receives the next token.
+         * @retval false at the end of the input or on failure (see `getError`), every following
+         *      call returns `false` as well.
+         */
+        bool next(ArgStringView &token);
+
+        /**
+         * @return `ARG_ERROR_STREAM_READ_FAILED` if the reader fails,
+         *      `ARG_ERROR_STREAM_TOKEN_TOO_LONG` if a token does not fit into the buffer,
+         *      `ARG_ERROR_NONE` otherwise (including the end of the input).
+         */
+        ArgErrorCode getError() const;
+
+        /**
+         * @return The number of tokens returned by `next`.
+         */
+        u64 getTokenCount() const;
+    };
+} // namespace NTT_NS
@@ -0,0 +1,407 @@
+#include "validator.hpp"
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include "argument_data.hpp"
+#include "conversion.hpp"
+#include "parallel.hpp"
+
+namespace NTT_NS
+{
+    ArgValidator ArgValidator::range(f64 minimum, f64 maximum)
+    {
+        ArgValidator validator(Kind::RANGE);
+        validator.m_minimum = minimum;
+        validator.m_maximum = maximum;
+        return validator;
+    }
+
+    ArgValidator ArgValidator::choice(const std::vector<String> &choices)
+    {
+        ArgValidator validator(Kind::CHOICE);
+        validator.m_choices = choices;
+        return validator;
+    }
+
+    ArgValidator ArgValidator::regex(const String &pattern)
+    {
+        ArgValidator validator(Kind::REGEX);
+        validator.m_pattern = pattern;
+        return validator;
+    }
+
+    static std::string formatNumber(f64 value)
+    {
+        char text[NTT_CONVERSION_FORMAT_CAPACITY];
+        return std::string(text, formatF64(value, text));
+    }
+
+    void SchemaData::addValidator(u32 index, const ArgValidator &validator)
+    {
+        const ArgParserType elementType = isList(index)
+                                              ? static_cast<ArgParserType>(types[index] - ArgParserType::STRING_LIST)
+                                              : types[index];
+
+        ValidatorInfo info;
+        info.argument = index;
+        info.isParallel = false;
+        info.minimum = 0.0;
+        info.maximum = 0.0;
+
+        std::string requirement;
+        switch (validator.m_kind)
+        {
+        case ArgValidator::Kind::RANGE:
+            if (elementType != ArgParserType::I32 && elementType != ArgParserType::F32)
+            {
+                throw std::invalid_argument(
+                    format("The range validator needs an i32 or f32 argument, {} is not", triggerKeysOf(index)).c_str());
+            }
+            if (!(validator.m_minimum <= validator.m_maximum))
+            {
+                throw std::invalid_argument(format("The range of the argument {} is empty", triggerKeysOf(index)).c_str());
+            }
+
+            info.kind = ValidatorKind::VALIDATOR_RANGE;
+            info.minimum = validator.m_minimum;
+            info.maximum = validator.m_maximum;
+            requirement = "inside [" + formatNumber(info.minimum) + ", " + formatNumber(info.maximum) + "]";
+            break;
+        case ArgValidator::Kind::CHOICE:
+            if (elementType != ArgParserType::STRING)
+            {
+                throw std::invalid_argument(
+                    format("The choice validator needs a string argument, {} is not", triggerKeysOf(index)).c_str());
+            }
+
+            info.kind = ValidatorKind::VALIDATOR_CHOICE;
+            requirement = "one of [";
+            for (const String &choice : validator.m_choices)
+            {
+                if (info.choices.find(stringPool.data(), choice.c_str(), choice.length()) != NTT_ARGUMENT_INVALID_INDEX)
+                {
+                    continue;
+                }
+
+                info.choices.insert(choice.c_str(), intern(choice.c_str(), choice.length()), 0);
+                requirement.append(info.choices.count == 1 ? "" : ", ");
+                requirement.append(choice.c_str(), choice.length());
+            }
+            requirement.append("]");
+            break;
+        case ArgValidator::Kind::REGEX:
+            if (elementType != ArgParserType::STRING)
+            {
+                throw std::invalid_argument(
+                    format("The regex validator needs a string argument, {} is not", triggerKeysOf(index)).c_str());
+            }
+
+            try
+            {
+                info.pattern = std::make_shared<const std::regex>(validator.m_pattern.c_str(), std::regex::ECMAScript);
+            }
+            catch (const std::regex_error &)
+            {
+                throw std::invalid_argument(
+                    format("The pattern {} is not a valid regular expression", validator.m_pattern).c_str());
+            }
+
+            info.kind = ValidatorKind::VALIDATOR_REGEX;
+            info.isParallel = true;
+            requirement = "matching " + std::string(validator.m_pattern.c_str(), validator.m_pattern.length());
+            break;
+        default:
+            throw std::invalid_argument("The validator is not supported");
+        }
+
+        info.requirement = std::make_shared<const std::string>(std::move(requirement));
+        validators.push_back(std::move(info));
+        flags[index] |= ARGUMENT_FLAG_VALIDATED;
+    }
+
+    void SchemaData::addValidator(u32 index, const ValidatorFunction &check, const String &requirement, bool isParallel)
+    {
+        ValidatorInfo info;
+        info.argument = index;
+        info.kind = ValidatorKind::VALIDATOR_FUNCTION;
+        info.isParallel = isParallel;
+        info.minimum = 0.0;
+        info.maximum = 0.0;
+        info.check = check;
+        info.requirement = std::make_shared<const std::string>(requirement.c_str(), requirement.length());
+        validators.push_back(std::move(info));
+        flags[index] |= ARGUMENT_FLAG_VALIDATED;
+    }
+
+    /**
+     * @return The number of values of the argument which are checked, the values which are not
+     *      provided (the default values) are not.
+     */
+    static inline u32 checkedValueCount(const SchemaData &schema, const ResultData &result, u32 index)
+    {
+        if (!result.isProvided(index))
+        {
+            return 0;
+        }
+        return schema.isList(index) ? result.values[index].listValue.count : 1;
+    }
+
+    /**
+     * The value (or the list element) as a scalar, read from the bound storage if there is one.
+     */
+    static ArgumentValue checkedValue(
+        const SchemaData &schema,
+        const ResultData &result,
+        u32 index,
+        u32 valueIndex,
+        bool applyBindings)
+    {
+        ArgumentValue value;
+        switch (schema.types[index])
+        {
+        case ArgParserType::STRING:
+            value.stringValue = ArgumentReader<ArgStringView>::read(schema, result, index, applyBindings);
+            break;
+        case ArgParserType::I32:
+            value.i32Value = ArgumentReader<i32>::read(schema, result, index, applyBindings);
+            break;
+        case ArgParserType::F32:
+            value.f32Value = ArgumentReader<f32>::read(schema, result, index, applyBindings);
+            break;
+        case ArgParserType::BOOL:
+            value.boolValue = ArgumentReader<bool>::read(schema, result, index, applyBindings);
+            break;
+        case ArgParserType::STRING_LIST:
+            value.stringValue = result.stringItems[result.values[index].listValue.offset + valueIndex];
+            break;
+        case ArgParserType::I32_LIST:
+            value.i32Value = result.i32Items[result.values[index].listValue.offset + valueIndex];
+            break;
+        case ArgParserType::F32_LIST:
+            value.f32Value = result.f32Items[result.values[index].listValue.offset + valueIndex];
+            break;
+        case ArgParserType::BOOL_LIST:
+            value.boolValue = result.boolItems[result.values[index].listValue.offset + valueIndex] != 0;
+            break;
+        default:
+            break;
+        }
+        return value;
+    }
+
+    /**
+     * @retval true if the validator accepts the value.
+     */
+    static bool accepts(const SchemaData &schema, const ValidatorInfo &validator, const ArgumentValue &value)
+    {
+        switch (validator.kind)
+        {
+        case ValidatorKind::VALIDATOR_RANGE:
+        {
+            const ArgParserType type = schema.types[validator.argument];
+            const f64 number = type == ArgParserType::I32 || type == ArgParserType::I32_LIST
+                                   ? static_cast<f64>(value.i32Value)
+                                   : static_cast<f64>(value.f32Value);
+            return number >= validator.minimum && number <= validator.maximum;
+        }
+        case ValidatorKind::VALIDATOR_CHOICE:
+            return validator.choices.find(schema.stringPool.data(),
+                                          value.stringValue.data(),
+                                          value.stringValue.length()) != NTT_ARGUMENT_INVALID_INDEX;
+        case ValidatorKind::VALIDATOR_REGEX:
+            return std::regex_match(value.stringValue.data(),
+                                    value.stringValue.data() + value.stringValue.length(),
+                                    *validator.pattern);
+        case ValidatorKind::VALIDATOR_FUNCTION:
+            return validator.check(value);
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * The token of the `f32` value (or list element) as given by the user, the formatted value
+     *      if the token is not known.
+     */
+    static std::string f32Text(const SchemaData &schema, const ResultData &result, u32 index, u32 valueIndex, f32 value)
+    {
+        if (!schema.isList(index))
+        {
+            return result.f32Texts[index].empty() ? formatNumber(value) : result.f32Texts[index];
+        }
+
+        // The items of an argument are stored in the order of its tokens.
+        u32 item = 0;
+        for (const ListItem &listItem : result.listItems)
+        {
+            if (listItem.argument == index && item++ == valueIndex)
+            {
+                return std::string(result.tokens[listItem.token].data, result.tokens[listItem.token].length);
+            }
+        }
+        return formatNumber(value);
+    }
+
+    static ArgStatus rejected(
+        const SchemaData &schema,
+        ResultData &result,
+        const ValidationCheck &check,
+        bool applyBindings)
+    {
+        const ValidatorInfo &validator = schema.validators[check.validator];
+        const u32 index = validator.argument;
+        const ArgumentValue value = checkedValue(schema, result, index, check.value, applyBindings);
+
+        ArgStringView subject;
+        switch (schema.types[index])
+        {
+        case ArgParserType::STRING:
+        case ArgParserType::STRING_LIST:
+            subject = value.stringValue;
+            break;
+        case ArgParserType::I32:
+        case ArgParserType::I32_LIST:
+            result.rejectedValue = std::to_string(value.i32Value);
+            subject = ArgStringView(result.rejectedValue.c_str(), static_cast<u32>(result.rejectedValue.length()));
+            break;
+        case ArgParserType::F32:
+        case ArgParserType::F32_LIST:
+            result.rejectedValue = f32Text(schema, result, index, check.value, value.f32Value);
+            subject = ArgStringView(result.rejectedValue.c_str(), static_cast<u32>(result.rejectedValue.length()));
+            break;
+        case ArgParserType::BOOL:
+        case ArgParserType::BOOL_LIST:
+        default:
+            subject = value.boolValue ? ArgStringView("true", 4) : ArgStringView("false", 5);
+            break;
+        }
+
+        return ArgStatus(ArgErrorCode::ARG_ERROR_VALIDATION_FAILED,
+                         NTT_ARG_NO_INDEX,
+                         index,
+                         subject,
+                         validator.requirement->c_str());
+    }
+
+    ArgStatus validateArguments(const SchemaData &schema, ResultData &result, bool applyBindings)
+    {
+        std::vector<ValidationCheck> &checks = result.validationChecks;
+        std::vector<u32> &parallelChecks = result.parallelChecks;
+        checks.clear();
+        parallelChecks.clear();
+
+        for (u32 validatorIndex = 0; validatorIndex < schema.validators.size(); validatorIndex++)
+        {
+            const ValidatorInfo &validator = schema.validators[validatorIndex];
+            const u32 valueCount = checkedValueCount(schema, result, validator.argument);
+            if (valueCount != 0)
+            {
+                // The lazily kept values are checked once they are converted.
+                const ArgStatus status = resolvePending(schema, result, validator.argument);
+                if (!status.ok())
+                {
+                    return status;
+                }
+            }
+
+            for (u32 value = 0; value < valueCount; value++)
+            {
+                if (validator.isParallel)
+                {
+                    parallelChecks.push_back(static_cast<u32>(checks.size()));
+                }
+                checks.push_back(ValidationCheck{validatorIndex, value});
+            }
+        }
+
+        NTT_ARG_INSTRUMENT(result.counters.validations += checks.size();)
+
+        // A validator which throws stops the checks like a rejection, the first of them in the
+        //      order of the checks is reported.
+        std::mutex exceptionMutex;
+        std::exception_ptr exception;
+        u32 exceptionCheck = static_cast<u32>(checks.size());
+
+        // The other checks run first on this thread, the parallel checks after the first
+        //      rejection are not needed anymore.
+        u32 firstRejection = static_cast<u32>(checks.size());
+        for (u32 checkIndex = 0; checkIndex < checks.size(); checkIndex++)
+        {
+            const ValidationCheck &check = checks[checkIndex];
+            const ValidatorInfo &validator = schema.validators[check.validator];
+            if (validator.isParallel)
+            {
+                continue;
+            }
+
+            try
+            {
+                if (!accepts(schema, validator, checkedValue(schema, result, validator.argument, check.value, applyBindings)))
+                {
+                    firstRejection = checkIndex;
+                    break;
+                }
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+                exceptionCheck = checkIndex;
+                break;
+            }
+        }
+
+        const u32 lastNeeded = std::min(firstRejection, exceptionCheck);
+        while (!parallelChecks.empty() && parallelChecks.back() > lastNeeded)
+        {
+            parallelChecks.pop_back();
+        }
+
+        std::vector<u8> &rejections = result.validationRejections;
+        rejections.assign(checks.size(), 0);
+
+        const u32 threadCount = parallelChecks.size() < NTT_ARG_VALIDATION_PARALLEL_MIN_CHECKS ? 1 : schema.validationThreads;
+        parallelFor(
+            static_cast<u32>(parallelChecks.size()),
+            threadCount,
+            [&](u32 parallelIndex)
+            {
+                const u32 checkIndex = parallelChecks[parallelIndex];
+                const ValidationCheck &check = checks[checkIndex];
+                const ValidatorInfo &validator = schema.validators[check.validator];
+                try
+                {
+                    const ArgumentValue value = checkedValue(schema, result, validator.argument, check.value, applyBindings);
+                    rejections[checkIndex] = accepts(schema, validator, value) ? 0 : 1;
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if (checkIndex < exceptionCheck)
+                    {
+                        exception = std::current_exception();
+                        exceptionCheck = checkIndex;
+                    }
+                }
+            });
+
+        for (u32 checkIndex : parallelChecks)
+        {
+            if (rejections[checkIndex] != 0)
+            {
+                firstRejection = std::min(firstRejection, checkIndex);
+                break;
+            }
+        }
+
+        if (exceptionCheck < firstRejection)
+        {
+            std::rethrow_exception(exception);
+        }
+        if (firstRejection < checks.size())
+        {
+            return rejected(schema, result, checks[firstRejection], applyBindings);
+        }
+        return ArgStatus();
+    }
+} // namespace NTT_NS
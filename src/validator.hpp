@@ -0,0 +1,67 @@
+#pragma once
+#include "parser.hpp"
+
+/**
+ * The parallel validators only fan out across the worker threads from this number of checks, a
+ *      smaller batch is cheaper to check on the parsing thread than to hand out.
+ */
+#define NTT_ARG_VALIDATION_PARALLEL_MIN_CHECKS 64
+
+namespace NTT_NS
+{
+    /**
+     * A built-in check of the values of an argument, attached by `ArgHandle::addValidator` and
+     *      run by every parse once the values are known (from the command line, the environment
+     *      or the config file, the default values are not checked). Each value of a list is
+     *      checked on its own.
+     *
+     * @example
+     * ```c++
+     * parser.addArgument<i32>({"-j", "--jobs"}, "The number of jobs", false, 1)
+     *     .addValidator(ArgValidator::range(1, 64));
+     * parser.addArgument<String>({"--mode"}, "The mode", false, "fast")
+     *     .addValidator(ArgValidator::choice({"fast", "safe"}));
+     * ```
+     */
+    class ArgValidator
+    {
+    public:
+        /**
+         * Only for the `i32` and `f32` arguments (and their lists), both bounds are included.
+         */
+        static ArgValidator range(f64 minimum, f64 maximum);
+
+        /**
+         * Only for the `String` arguments (and their lists), the value must be one of the
+         *      choices (looked up by a hash).
+         */
+        static ArgValidator choice(const std::vector<String> &choices);
+
+        /**
+         * Only for the `String` arguments (and their lists), the whole value must match the
+         *      ECMAScript regular expression. The matches of a long list are checked in parallel.
+         */
+        static ArgValidator regex(const String &pattern);
+
+    private:
+        friend struct SchemaData;
+
+        enum Kind : u8
+        {
+            RANGE,
+            CHOICE,
+            REGEX,
+        };
+
+        explicit ArgValidator(Kind kind)
+            : m_kind(kind)
+        {
+        }
+
+        Kind m_kind;
+        f64 m_minimum = 0.0;
+        f64 m_maximum = 0.0;
+        std::vector<String> m_choices;
+        String m_pattern;
+    };
+} // namespace NTT_NS
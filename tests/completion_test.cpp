@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <NTTArgParser.hpp>
+#include <cstdio>
+#include <string>
+
+using namespace NTT_NS;
+
+static ArgStringView View(const char *text)
+{
+    return ArgStringView(text, static_cast<u32>(strlen(text)));
+}
+
+/**
+ * The texts of the candidates, with their description after a `:` if they have one.
+ */
+static std::vector<std::string> Complete(const ArgCompletionIndex &index, const char *word, const char *previous = "")
+{
+    std::vector<ArgCompletionCandidate> candidates;
+    index.complete(View(word), View(previous), candidates);
+
+    std::vector<std::string> texts;
+    for (const ArgCompletionCandidate &candidate : candidates)
+    {
+        std::string text(candidate.text.data(), candidate.text.length());
+        if (!candidate.description.empty())
+        {
+            text += ":" + std::string(candidate.description.data(), candidate.description.length());
+        }
+        texts.push_back(text);
+    }
+    return texts;
+}
+
+class ArgCompletionTest : public ::testing::Test
+{
+protected:
+    ArgParser parser{"This is the description of the parser"};
+
+    void SetUp() override
+    {
+        parser.addArgument<String>({"-v", "--version"}, "The version", false, "1.0.0");
+        parser.addArgument<i32>({"-c", "--col"}, "The column");
+        parser.addArgument<bool>({"--use-color"}, "Use the colors");
+        parser.addArgument<String>({"--mode"}, "The mode", false, "fast")
+            .addValidator(ArgValidator::choice({"safe", "fast", "slow"}));
+        parser.addArgument<std::vector<String>>({"--modes"}, "The modes")
+            .addValidator(ArgValidator::choice({"safe", "fast", "slow"}))
+            .addValidator(ArgValidator::choice({"fast", "slow", "other"}));
+        parser.addPositional<String>("input", [](u32, ArgStringView) {}, "The input");
+        parser.addSubcommand("build", "Build the project", [](ArgParser &) {});
+    }
+};
+
+TEST_F(ArgCompletionTest, CompleteThePrefixes)
+{
+    const std::vector<u8> blob = parser.buildCompletionIndex();
+    ArgCompletionIndex index;
+    ASSERT_TRUE(index.attach(blob.data(), blob.size()));
+    EXPECT_EQ(index.getKeyCount(), 8);
+
+    EXPECT_THAT(Complete(index, "--m"), ::testing::ElementsAre("--mode:The mode", "--modes:The modes"));
+    EXPECT_THAT(Complete(index, "--co"), ::testing::ElementsAre("--col:The column"));
+    EXPECT_THAT(Complete(index, "-"), ::testing::SizeIs(7));
+    EXPECT_THAT(Complete(index, "b"), ::testing::ElementsAre("build:Build the project"));
+    EXPECT_THAT(Complete(index, "--unknown"), ::testing::IsEmpty());
+
+    // The values: the choices, nothing (a file name) or the keys again after a flag.
+    EXPECT_THAT(Complete(index, "", "--mode"), ::testing::ElementsAre("fast", "safe", "slow"));
+    EXPECT_THAT(Complete(index, "s", "--mode"), ::testing::ElementsAre("safe", "slow"));
+    EXPECT_THAT(Complete(index, "", "--modes"), ::testing::ElementsAre("fast", "slow"));
+    EXPECT_THAT(Complete(index, "", "-c"), ::testing::IsEmpty());
+    EXPECT_THAT(Complete(index, "--v", "-c"), ::testing::ElementsAre("--version:The version"));
+    EXPECT_THAT(Complete(index, "--v", "--use-color"), ::testing::ElementsAre("--version:The version"));
+    EXPECT_THAT(Complete(index, "bu", "--use-color"), ::testing::ElementsAre("build:Build the project"));
+
+    // The same definitions always give the same bytes.
+    EXPECT_EQ(parser.buildCompletionIndex(), blob);
+}
+
+TEST_F(ArgCompletionTest, InvalidCompletionIndex)
+{
+    const std::vector<u8> blob = parser.buildCompletionIndex();
+    ArgCompletionIndex index;
+    EXPECT_FALSE(index.isAttached());
+    EXPECT_THAT(Complete(index, "-"), ::testing::IsEmpty());
+
+    EXPECT_FALSE(index.attach(blob.data(), 16));
+    EXPECT_FALSE(index.attach(blob.data(), blob.size() - 1));
+    EXPECT_FALSE(index.isAttached());
+
+    std::vector<u8> corrupted = blob;
+    corrupted[0] ^= 0xFF;
+    EXPECT_FALSE(index.attach(corrupted.data(), corrupted.size()));
+
+    // Everything after the header: the strings and the options of the keys are checked when
+    // they are read.
+    corrupted = blob;
+    for (u64 offset = 64; offset < corrupted.size(); offset++)
+    {
+        corrupted[offset] = 0xFF;
+    }
+    ASSERT_TRUE(index.attach(corrupted.data(), corrupted.size()));
+    Complete(index, "-");
+    Complete(index, "", "--mode");
+
+    EXPECT_FALSE(index.open("missing_completion_index.bin"));
+    EXPECT_THROW(parser.writeCompletionIndex("missing_directory/index.bin"), std::invalid_argument);
+}
+
+TEST_F(ArgCompletionTest, RunTheCompletionQuery)
+{
+    const String path = "ntt_completion_test_index.bin";
+    parser.writeCompletionIndex(path);
+
+    ArgCompletionIndex index;
+    ASSERT_TRUE(index.open(path));
+    EXPECT_THAT(Complete(index, "--use"), ::testing::ElementsAre("--use-color:Use the colors"));
+
+    const char *query[] = {"program", "--complete", "--m", "--col"};
+    ::testing::internal::CaptureStdout();
+    EXPECT_TRUE(ArgCompletionIndex::run(4, const_cast<char **>(query), path));
+    EXPECT_EQ(::testing::internal::GetCapturedStdout(), "--mode\tThe mode\n--modes\tThe modes\n");
+
+    const char *values[] = {"program", "--complete", "", "--mode"};
+    ::testing::internal::CaptureStdout();
+    EXPECT_TRUE(ArgCompletionIndex::run(4, const_cast<char **>(values), path));
+    EXPECT_EQ(::testing::internal::GetCapturedStdout(), "fast\nsafe\nslow\n");
+
+    const char *normal[] = {"program", "--mode", "safe"};
+    EXPECT_FALSE(ArgCompletionIndex::run(3, const_cast<char **>(normal), path));
+    std::remove(path.c_str());
+
+    EXPECT_THAT(ArgCompletionIndex::getScript(ArgCompletionShell::ARG_COMPLETION_SHELL_BASH, "my-tool").c_str(),
+                ::testing::HasSubstr("complete -o default -F _ntt_complete_my_tool my-tool\n"));
+    EXPECT_THAT(ArgCompletionIndex::getScript(ArgCompletionShell::ARG_COMPLETION_SHELL_ZSH, "my-tool").c_str(),
+                ::testing::StartsWith("#compdef my-tool\n_my_tool()\n"));
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <conversion.hpp>
+
+using namespace NTT_NS;
+
+static bool ParseI32(const char *text, i32 &out)
+{
+    return parseI32(text, text + strlen(text), out);
+}
+
+static bool ParseF32(const char *text, f32 &out)
+{
+    return parseF32(text, text + strlen(text), out);
+}
+
+TEST(ConversionTest, ParseValidI32)
+{
+    i32 value = 0;
+
+    EXPECT_TRUE(ParseI32("0", value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ParseI32("42", value));
+    EXPECT_EQ(value, 42);
+    EXPECT_TRUE(ParseI32("-3", value));
+    EXPECT_EQ(value, -3);
+    EXPECT_TRUE(ParseI32("+17", value));
+    EXPECT_EQ(value, 17);
+    EXPECT_TRUE(ParseI32("2147483647", value));
+    EXPECT_EQ(value, std::numeric_limits<i32>::max());
+    EXPECT_TRUE(ParseI32("-2147483648", value));
+    EXPECT_EQ(value, std::numeric_limits<i32>::min());
+}
+
+TEST(ConversionTest, ParseInvalidI32)
+{
+    i32 value = 123;
+
+    EXPECT_FALSE(ParseI32("", value));
+    EXPECT_FALSE(ParseI32("-", value));
+    EXPECT_FALSE(ParseI32("Testing", value));
+    EXPECT_FALSE(ParseI32("12abc", value));
+    EXPECT_FALSE(ParseI32(" 12", value));
+    EXPECT_FALSE(ParseI32("1.5", value));
+    EXPECT_FALSE(ParseI32("2147483648", value));
+    EXPECT_FALSE(ParseI32("-2147483649", value));
+    EXPECT_FALSE(ParseI32("99999999999999999999999", value));
+    EXPECT_EQ(value, 123);
+}
+
+TEST(ConversionTest, ParseValidF32)
+{
+    f32 value = 0.0f;
+
+    EXPECT_TRUE(ParseF32("9.5", value));
+    EXPECT_EQ(value, 9.5f);
+    EXPECT_TRUE(ParseF32("2.12", value));
+    EXPECT_EQ(value, 2.12f);
+    EXPECT_TRUE(ParseF32("-3", value));
+    EXPECT_EQ(value, -3.0f);
+    EXPECT_TRUE(ParseF32(".5", value));
+    EXPECT_EQ(value, 0.5f);
+    EXPECT_TRUE(ParseF32("5.", value));
+    EXPECT_EQ(value, 5.0f);
+    EXPECT_TRUE(ParseF32("-2.5e-3", value));
+    EXPECT_EQ(value, -2.5e-3f);
+    EXPECT_TRUE(ParseF32("1E3", value));
+    EXPECT_EQ(value, 1000.0f);
+    EXPECT_TRUE(ParseF32("0.1", value));
+    EXPECT_EQ(value, 0.1f);
+    EXPECT_TRUE(ParseF32("3.4028234e38", value));
+    EXPECT_EQ(value, std::numeric_limits<f32>::max());
+    EXPECT_TRUE(ParseF32("3.4028235e38", value));
+    EXPECT_EQ(value, std::numeric_limits<f32>::max());
+    EXPECT_TRUE(ParseF32("-3.40282356e38", value));
+    EXPECT_EQ(value, -std::numeric_limits<f32>::max());
+    EXPECT_TRUE(ParseF32("0.000000000000000000000000000000000000000000001", value));
+    EXPECT_EQ(value, 1e-45f);
+    EXPECT_TRUE(ParseF32("1e-99999", value));
+    EXPECT_EQ(value, 0.0f);
+    EXPECT_TRUE(ParseF32("123456789012345678901234567890", value));
+    EXPECT_EQ(value, 123456789012345678901234567890.0f);
+    EXPECT_TRUE(ParseF32("-Infinity", value));
+    EXPECT_EQ(value, -std::numeric_limits<f32>::infinity());
+    EXPECT_TRUE(ParseF32("nan", value));
+    EXPECT_TRUE(std::isnan(value));
+}
+
+TEST(ConversionTest, ParseInvalidF32)
+{
+    f32 value = 1.0f;
+
+    EXPECT_FALSE(ParseF32("", value));
+    EXPECT_FALSE(ParseF32("+", value));
+    EXPECT_FALSE(ParseF32(".", value));
+    EXPECT_FALSE(ParseF32("Hello World", value));
+    EXPECT_FALSE(ParseF32("1.5f", value));
+    EXPECT_FALSE(ParseF32("1e", value));
+    EXPECT_FALSE(ParseF32("1e+", value));
+    EXPECT_FALSE(ParseF32("1.2.3", value));
+    EXPECT_FALSE(ParseF32("infinite", value));
+    EXPECT_FALSE(ParseF32("3.4028236e38", value));
+    EXPECT_FALSE(ParseF32("1e39", value));
+    EXPECT_FALSE(ParseF32("-1e400", value));
+    EXPECT_EQ(value, 1.0f);
+}
+
+TEST(ConversionTest, ParsePrefixLikeTheStandardConversions)
+{
+    i32 integer = 123;
+    const char *text = " 12abc";
+    EXPECT_TRUE(parseI32Prefix(text, text + strlen(text), integer));
+    EXPECT_EQ(integer, 12);
+    text = "-7.9";
+    EXPECT_TRUE(parseI32Prefix(text, text + strlen(text), integer));
+    EXPECT_EQ(integer, -7);
+    text = "abc";
+    EXPECT_FALSE(parseI32Prefix(text, text + strlen(text), integer));
+    text = "2147483648x";
+    EXPECT_FALSE(parseI32Prefix(text, text + strlen(text), integer));
+    EXPECT_EQ(integer, -7);
+
+    f32 number = 1.0f;
+    text = "2.5x";
+    EXPECT_TRUE(parseF32Prefix(text, text + strlen(text), number));
+    EXPECT_EQ(number, 2.5f);
+    text = "1e";
+    EXPECT_TRUE(parseF32Prefix(text, text + strlen(text), number));
+    EXPECT_EQ(number, 1.0f);
+    text = "\t-3e2.5";
+    EXPECT_TRUE(parseF32Prefix(text, text + strlen(text), number));
+    EXPECT_EQ(number, -300.0f);
+    text = "infinite";
+    EXPECT_TRUE(parseF32Prefix(text, text + strlen(text), number));
+    EXPECT_TRUE(std::isinf(number));
+    text = ".e5";
+    EXPECT_FALSE(parseF32Prefix(text, text + strlen(text), number));
+    text = "1e39x";
+    EXPECT_FALSE(parseF32Prefix(text, text + strlen(text), number));
+    EXPECT_TRUE(std::isinf(number));
+}
+
+static std::string FormatF64(f64 value)
+{
+    char text[NTT_CONVERSION_FORMAT_CAPACITY];
+    const u32 length = formatF64(value, text);
+    EXPECT_EQ(length, strlen(text));
+    return std::string(text, length);
+}
+
+TEST(ConversionTest, FormatLikePrintfInTheCLocale)
+{
+    const f64 values[] = {0.0, -0.0, 1.0, -2.5, 0.1, 9.5f, 2.12f, 100000.0, 999999.0, 999999.5, 1000000.0,
+                          1e-4, 1.5e-5, 0.000123456789, 123456789.0, 3.4028234e38, -1e-300, 4.9e-324,
+                          1e100, 0.30000000000000004};
+    for (f64 value : values)
+    {
+        char expected[32];
+        snprintf(expected, sizeof(expected), "%g", value);
+        EXPECT_EQ(FormatF64(value), expected) << expected;
+    }
+
+    EXPECT_EQ(FormatF64(std::numeric_limits<f64>::infinity()), "inf");
+    EXPECT_EQ(FormatF64(-std::numeric_limits<f64>::infinity()), "-inf");
+    EXPECT_EQ(FormatF64(std::numeric_limits<f64>::quiet_NaN()), "nan");
+}
+
+TEST(ConversionTest, FormatIgnoresTheLocale)
+{
+    const char *previous = setlocale(LC_NUMERIC, nullptr);
+    const std::string saved = previous != nullptr ? previous : "C";
+    if (setlocale(LC_NUMERIC, "de_DE.UTF-8") == nullptr && setlocale(LC_NUMERIC, "fr_FR.UTF-8") == nullptr)
+    {
+        GTEST_SKIP() << "No locale with a decimal comma is installed";
+    }
+
+    const std::string formatted = FormatF64(2.5);
+    const std::string small = FormatF64(1.25e-7);
+    setlocale(LC_NUMERIC, saved.c_str());
+    EXPECT_EQ(formatted, "2.5");
+    EXPECT_EQ(small, "1.25e-07");
+}
@@ -1,9 +1,35 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <NTTArgParser.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
 
 using namespace NTT_NS;
 
+/**
+ * Sets (or removes with `nullptr`) a variable of the process environment.
+ */
+static void SetEnvironment(const char *name, const char *value)
+{
+#ifdef NTT_PLATFORM_UNIX
+    if (value == nullptr)
+    {
+        unsetenv(name);
+    }
+    else
+    {
+        setenv(name, value, 1);
+    }
+#else
+    _putenv_s(name, value == nullptr ? "" : value);
+#endif
+}
+
 class ArgParserTest : public ::testing::Test
 {
 protected:
@@ -178,3 +204,1449 @@ TEST_F(ArgParserTest, InputInvalidArgumentType)
     EXPECT_EQ(parser.getArgument<f32>("-r"), 1.0f);
     EXPECT_EQ(parser.getArgument<i32>("-c"), 0);
 }
+
+TEST_F(ArgParserTest, AddArgumentWithDuplicatedKey)
+{
+    DefineArgument();
+
+    EXPECT_THROW(
+        parser.addArgument<i32>({"-n", "--radius"}, "Duplicated with the radius"),
+        std::invalid_argument);
+    EXPECT_THROW(
+        parser.addArgument<i32>({"-n", "-n"}, "Duplicated inside the definition"),
+        std::invalid_argument);
+
+    // The rejected definitions must not leave any of their keys behind.
+    EXPECT_NO_THROW(parser.addArgument<i32>({"-n"}, "The count of the program"));
+}
+
+TEST_F(ArgParserTest, ParseWithManyArguments)
+{
+    const u32 argumentCount = 1000;
+    for (u32 i = 0; i < argumentCount; i++)
+    {
+        parser.addArgument<i32>(
+            {format("-k{}", i), format("--key-{}", i)},
+            "Generated argument",
+            false, static_cast<i32>(i));
+    }
+
+    LoadArgument("program -k10 100 --key-999 -5 --key-0 7");
+    parser.parse(argCount, argValues);
+
+    EXPECT_EQ(parser.getArgument<i32>("--key-10"), 100);
+    EXPECT_EQ(parser.getArgument<i32>("-k999"), -5);
+    EXPECT_EQ(parser.getArgument<i32>("-k0"), 7);
+    EXPECT_EQ(parser.getArgument<i32>("-k500"), 500);
+    EXPECT_THROW(parser.getArgument<i32>("-k1000"), std::invalid_argument);
+}
+
+TEST_F(ArgParserTest, ReadArgumentsThroughHandles)
+{
+    ArgHandle<String> version = parser.addArgument<String>({"-v", "--version"}, "", false, "0.0.1");
+    ArgHandle<i32> col = parser.addArgument<i32>({"-c", "--col"});
+    ArgHandle<f32> radius = parser.addArgument<f32>({"-r", "--radius"}, "", true, 1.0f);
+    ArgHandle<bool> useColor = parser.addArgument<bool>({"--use-color"});
+    ArgHandle<i32> invalid;
+
+    EXPECT_TRUE(radius.isValid());
+    EXPECT_FALSE(invalid.isValid());
+    EXPECT_EQ(version.get(), "0.0.1");
+
+    parser.parse(argCount, argValues);
+
+    EXPECT_EQ(version.get(), "1.0.0");
+    EXPECT_EQ(col.get(), 8);
+    EXPECT_EQ(radius.get(), 9.5f);
+    EXPECT_EQ(useColor.get(), true);
+
+    LoadArgument(test2);
+    parser.parse(argCount, argValues);
+
+    EXPECT_EQ(col.get(), -3);
+    EXPECT_EQ(radius.get(), 2.12f);
+    EXPECT_EQ(useColor.get(), false);
+    EXPECT_EQ(col.get(), parser.getArgument<i32>("--col"));
+}
+
+TEST_F(ArgParserTest, ParseIntoBoundStorage)
+{
+    struct Config
+    {
+        String version;
+        i32 col;
+        f32 radius;
+        bool useColor;
+    } config;
+
+    parser.addArgument({"-v", "--version"}, &config.version, "", false, String("0.0.1"));
+    parser.addArgument({"-c", "--col"}, &config.col, "", false, 4);
+    ArgHandle<f32> radius = parser.addArgument({"-r", "--radius"}, &config.radius, "", true, 1.0f);
+    parser.addArgument({"--use-color"}, &config.useColor);
+
+    EXPECT_EQ(config.version, "0.0.1");
+    EXPECT_EQ(config.col, 4);
+    EXPECT_EQ(config.radius, 1.0f);
+    EXPECT_EQ(config.useColor, false);
+
+    parser.parse(argCount, argValues);
+
+    EXPECT_EQ(config.version, "1.0.0");
+    EXPECT_EQ(config.col, 8);
+    EXPECT_EQ(config.radius, 9.5f);
+    EXPECT_EQ(config.useColor, true);
+    EXPECT_EQ(radius.get(), 9.5f);
+    EXPECT_EQ(parser.getArgument<i32>("--col"), 8);
+
+    parser.reset();
+
+    EXPECT_EQ(parser.isParsed(), false);
+    EXPECT_EQ(config.version, "0.0.1");
+    EXPECT_EQ(config.col, 4);
+    EXPECT_EQ(config.radius, 1.0f);
+    EXPECT_EQ(config.useColor, false);
+}
+
+TEST_F(ArgParserTest, RequiredArgumentIsCheckedAgainAfterReparse)
+{
+    DefineArgument();
+    parser.parse(argCount, argValues);
+
+    LoadArgument("program -v 1.0.0");
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+}
+
+TEST_F(ArgParserTest, ZeroCopyStringsPointIntoArgv)
+{
+    DefineArgument();
+    parser.setZeroCopyStrings(true);
+
+    EXPECT_EQ(parser.getArgumentView("-v"), "1.0.0");
+
+    parser.parse(argCount, argValues);
+
+    ArgStringView version = parser.getArgumentView("--version");
+    EXPECT_EQ(version.data(), argValues[2]);
+    EXPECT_EQ(version.length(), 5u);
+    EXPECT_EQ(parser.getArgument<String>("-v"), "1.0.0");
+    EXPECT_THROW(parser.getArgumentView("-c"), std::invalid_argument);
+    EXPECT_THROW(parser.getArgumentView("-t"), std::invalid_argument);
+
+    parser.reset();
+    EXPECT_EQ(parser.getArgumentView("-v"), "1.0.0");
+    EXPECT_NE(parser.getArgumentView("-v").data(), argValues[2]);
+}
+
+TEST_F(ArgParserTest, StringViewWithoutZeroCopy)
+{
+    DefineArgument();
+    parser.parse(argCount, argValues);
+
+    ArgStringView version = parser.getArgumentView("-v");
+    EXPECT_EQ(version, "1.0.0");
+    EXPECT_NE(version.data(), argValues[2]);
+    EXPECT_EQ(version.toString(), parser.getArgument<String>("-v"));
+}
+
+TEST_F(ArgParserTest, BoolFlagFollowedByAnotherKey)
+{
+    DefineArgument();
+
+    LoadArgument("program --use-color -r 2.5");
+    parser.parse(argCount, argValues);
+
+    EXPECT_EQ(parser.getArgument<bool>("--use-color"), true);
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 2.5f);
+}
+
+TEST_F(ArgParserTest, AddArgumentsAfterParseKeepsTheValues)
+{
+    DefineArgument();
+    parser.addArgument<String>({"--name"}, "The name", false, "default-name");
+    parser.parse(argCount, argValues);
+
+    for (u32 i = 0; i < 200; i++)
+    {
+        parser.addArgument<String>({format("--generated-{}", i)}, "Generated argument", false, "generated");
+    }
+
+    EXPECT_EQ(parser.getArgument<String>("-v"), "1.0.0");
+    EXPECT_EQ(parser.getArgument<String>("--name"), "default-name");
+    EXPECT_EQ(parser.getArgument<String>("--generated-199"), "generated");
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 9.5f);
+}
+
+TEST_F(ArgParserTest, StrictConversionRejectsInvalidValues)
+{
+    DefineArgument();
+    parser.setConversionPolicy(ArgConversionPolicy::STRICT_CONVERSION);
+
+    LoadArgument("program -c 12abc -r 1.0");
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+    EXPECT_EQ(parser.isParsed(), false);
+
+    LoadArgument("program -c 3 -r 1e40");
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+
+    LoadArgument("program -c -2147483648 -r -1.5e2");
+    EXPECT_NO_THROW(parser.parse(argCount, argValues));
+    EXPECT_EQ(parser.getArgument<i32>("-c"), -2147483648);
+    EXPECT_EQ(parser.getArgument<f32>("-r"), -150.0f);
+}
+
+TEST_F(ArgParserTest, LenientConversionKeepsTheNumericPrefix)
+{
+    DefineArgument();
+
+    LoadArgument("program -c 12abc -r 2.5x");
+    EXPECT_NO_THROW(parser.parse(argCount, argValues));
+    EXPECT_EQ(parser.getArgument<i32>("-c"), 12);
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 2.5f);
+
+    LoadArgument("program -c x12 -r e5");
+    EXPECT_NO_THROW(parser.parse(argCount, argValues));
+    EXPECT_EQ(parser.getArgument<i32>("-c"), 0);
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 1.0f);
+}
+
+TEST_F(ArgParserTest, ExpandResponseFile)
+{
+    DefineArgument();
+    parser.addArgument<String>({"--name"}, "The name", false, "default-name");
+    parser.setResponseFiles(true);
+
+    const char *path = "parser_test_response_file.txt";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "-v 2.0.0\n\t--col 12\n--name \"first  second\" -r 0.5";
+    }
+
+    LoadArgument(format("program @{} --use-color", String(path)));
+    parser.parse(argCount, argValues);
+    std::remove(path);
+
+    EXPECT_EQ(parser.getArgument<String>("-v"), "2.0.0");
+    EXPECT_EQ(parser.getArgument<i32>("--col"), 12);
+    EXPECT_EQ(parser.getArgument<String>("--name"), "first  second");
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 0.5f);
+    EXPECT_EQ(parser.getArgument<bool>("--use-color"), true);
+
+    for (u32 i = 0; i < 100; i++)
+    {
+        parser.addArgument<String>({format("--generated-{}", i)}, "Generated argument", false, "generated");
+    }
+    EXPECT_EQ(parser.getArgument<String>("--name"), "first  second");
+}
+
+TEST_F(ArgParserTest, InvalidResponseFile)
+{
+    DefineArgument();
+
+    LoadArgument("program @parser_test_missing_file.txt");
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+
+    parser.setResponseFiles(true);
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+
+    const char *path = "parser_test_unterminated_file.txt";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "-v \"1.0.0";
+    }
+
+    LoadArgument(format("program @{}", String(path)));
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+    std::remove(path);
+}
+
+TEST_F(ArgParserTest, RepeatedKeysAreCollectedIntoList)
+{
+    DefineArgument();
+    ArgHandle<std::vector<String>> inputs =
+        parser.addArgument<std::vector<String>>({"-i", "--input"}, "The input files");
+    parser.addArgument<std::vector<i32>>({"--level"}, "The levels", false, {1, 2});
+
+    LoadArgument("program -i first.txt -r 1.5 --input second.txt -i third.txt");
+    parser.parse(argCount, argValues);
+
+    ArgSpan<ArgStringView> values = parser.getArgument<std::vector<String>>("--input");
+    ASSERT_EQ(values.size(), 3);
+    EXPECT_EQ(values[0], "first.txt");
+    EXPECT_EQ(values[1], "second.txt");
+    EXPECT_EQ(values[2], "third.txt");
+    EXPECT_EQ(inputs.get().data(), values.data());
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 1.5f);
+
+    ArgSpan<i32> levels = parser.getArgument<std::vector<i32>>("--level");
+    ASSERT_EQ(levels.size(), 2);
+    EXPECT_EQ(levels[0], 1);
+    EXPECT_EQ(levels[1], 2);
+
+    EXPECT_THROW(parser.getArgument<String>("--input"), std::invalid_argument);
+    EXPECT_THROW(parser.getArgument<std::vector<f32>>("--level"), std::invalid_argument);
+}
+
+TEST_F(ArgParserTest, ListWithNargsTakesValuesUntilNextKey)
+{
+    DefineArgument();
+    parser.addArgument<std::vector<i32>>({"--ids"}).setNargs(NARGS_ONE_OR_MORE);
+    parser.addArgument<std::vector<f32>>({"--weights"}).setNargs(NARGS_ONE_OR_MORE);
+    parser.addArgument<std::vector<bool>>({"--masks"}, "The masks", false, {true}).setNargs(NARGS_ZERO_OR_MORE);
+
+    LoadArgument("program --ids 1 -2 3 -r 2.5 --weights 0.5 1e2 --ids 4 --masks");
+    parser.parse(argCount, argValues);
+
+    ArgSpan<i32> ids = parser.getArgument<std::vector<i32>>("--ids");
+    EXPECT_EQ(std::vector<i32>(ids.begin(), ids.end()), std::vector<i32>({1, -2, 3, 4}));
+
+    ArgSpan<f32> weights = parser.getArgument<std::vector<f32>>("--weights");
+    EXPECT_EQ(std::vector<f32>(weights.begin(), weights.end()), std::vector<f32>({0.5f, 100.0f}));
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 2.5f);
+    EXPECT_EQ(parser.getArgument<std::vector<bool>>("--masks").size(), 0);
+
+    LoadArgument("program --masks true false true -r 1.0");
+    parser.parse(argCount, argValues);
+
+    ArgSpan<bool> masks = parser.getArgument<std::vector<bool>>("--masks");
+    ASSERT_EQ(masks.size(), 3);
+    EXPECT_EQ(masks[0], true);
+    EXPECT_EQ(masks[1], false);
+    EXPECT_EQ(masks[2], true);
+    EXPECT_EQ(parser.getArgument<std::vector<i32>>("--ids").size(), 0);
+
+    LoadArgument("program --ids -r 2.5");
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+
+    EXPECT_THROW(parser.addArgument<i32>({"--single"}).setNargs(NARGS_ONE_OR_MORE), std::invalid_argument);
+}
+
+TEST_F(ArgParserTest, ListBoundToUserStorage)
+{
+    std::vector<String> inputs;
+    std::vector<i32> sizes;
+    parser.addArgument<std::vector<String>>({"--input"}, &inputs, "The inputs", true);
+    parser.addArgument<std::vector<i32>>({"--size"}, &sizes, "The sizes", false, {8}).setNargs(NARGS_ONE_OR_MORE);
+    EXPECT_EQ(sizes, std::vector<i32>({8}));
+
+    LoadArgument("program --size 1 2 3");
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+
+    LoadArgument("program --input a.txt --size 16 32 --input b.txt");
+    parser.parse(argCount, argValues);
+
+    EXPECT_EQ(inputs, std::vector<String>({"a.txt", "b.txt"}));
+    EXPECT_EQ(sizes, std::vector<i32>({16, 32}));
+
+    parser.reset();
+    EXPECT_EQ(inputs.size(), 0);
+    EXPECT_EQ(sizes, std::vector<i32>({8}));
+}
+
+TEST_F(ArgParserTest, ListKeepsValuesWhenArgumentsAreAdded)
+{
+    parser.addArgument<std::vector<String>>({"--input"}, "The inputs", false, {"default.txt"});
+    parser.addArgument<std::vector<String>>({"--tag"}).setNargs(NARGS_ONE_OR_MORE);
+
+    LoadArgument("program --tag x y");
+    parser.parse(argCount, argValues);
+    DeleteArgument();
+
+    for (u32 i = 0; i < 200; i++)
+    {
+        parser.addArgument<std::vector<String>>({format("--generated-{}", i)}, "Generated", false, {"generated"});
+    }
+
+    ArgSpan<ArgStringView> tags = parser.getArgument<std::vector<String>>("--tag");
+    ASSERT_EQ(tags.size(), 2);
+    EXPECT_EQ(tags[0], "x");
+    EXPECT_EQ(tags[1], "y");
+    EXPECT_EQ(parser.getArgument<std::vector<String>>("--input")[0], "default.txt");
+    EXPECT_EQ(parser.getArgument<std::vector<String>>("--generated-199")[0], "generated");
+}
+
+TEST_F(ArgParserTest, ParseLargeList)
+{
+    const u32 valueCount = 100000;
+    parser.addArgument<std::vector<i32>>({"--values"}).setNargs(NARGS_ONE_OR_MORE);
+
+    std::vector<String> storage;
+    storage.reserve(valueCount + 2);
+    storage.push_back("program");
+    storage.push_back("--values");
+    for (u32 i = 0; i < valueCount; i++)
+    {
+        storage.push_back(format("{}", i));
+    }
+
+    std::vector<char *> args;
+    for (String &arg : storage)
+    {
+        args.push_back(const_cast<char *>(arg.c_str()));
+    }
+
+    parser.parse(static_cast<u32>(args.size()), args.data());
+
+    ArgSpan<i32> values = parser.getArgument<std::vector<i32>>("--values");
+    ASSERT_EQ(values.size(), valueCount);
+    for (u32 i = 0; i < valueCount; i++)
+    {
+        ASSERT_EQ(values[i], static_cast<i32>(i));
+    }
+}
+
+TEST_F(ArgParserTest, TryParseReturnsTheErrorWithoutThrowing)
+{
+    DefineArgument();
+    parser.setConversionPolicy(ArgConversionPolicy::STRICT_CONVERSION);
+
+    struct Case
+    {
+        const char *commandLine;
+        ArgErrorCode code;
+        u32 tokenIndex;
+        u32 argumentIndex;
+        const char *subject;
+    };
+
+    const Case cases[] = {
+        {"program -v 1.0.0 --unknown 3 -r 1.0", ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND, 3, NTT_ARG_NO_INDEX, "--unknown"},
+        {"program -r 1.0 -v", ArgErrorCode::ARG_ERROR_MISSING_VALUE, 3, 0, "-v"},
+        {"program -r 1.0 --col 12abc", ArgErrorCode::ARG_ERROR_INVALID_VALUE, 4, 1, "12abc"},
+        {"program -v 1.0.0", ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED, NTT_ARG_NO_INDEX, 2, ""},
+    };
+
+    for (const Case &testCase : cases)
+    {
+        LoadArgument(testCase.commandLine);
+
+        const ArgStatus status = parser.tryParse(argCount, argValues);
+        EXPECT_EQ(status.code(), testCase.code) << testCase.commandLine;
+        EXPECT_EQ(status.tokenIndex(), testCase.tokenIndex) << testCase.commandLine;
+        EXPECT_EQ(status.argumentIndex(), testCase.argumentIndex) << testCase.commandLine;
+        EXPECT_EQ(status.subject(), testCase.subject) << testCase.commandLine;
+        EXPECT_EQ(parser.isParsed(), false);
+
+        try
+        {
+            parser.parse(argCount, argValues);
+            ADD_FAILURE() << testCase.commandLine;
+        }
+        catch (const std::invalid_argument &e)
+        {
+            EXPECT_EQ(parser.getErrorMessage(status), e.what());
+        }
+    }
+
+    LoadArgument("program -r 1.0 --col 12");
+    EXPECT_TRUE(parser.tryParse(argCount, argValues).ok());
+    EXPECT_EQ(parser.isParsed(), true);
+    EXPECT_EQ(parser.getErrorMessage(ArgStatus()), "");
+}
+
+TEST_F(ArgParserTest, TryGetArgument)
+{
+    DefineArgument();
+    parser.parse(argCount, argValues);
+
+    f32 radius = 0.0f;
+    EXPECT_TRUE(parser.tryGetArgument<f32>("-r", radius).ok());
+    EXPECT_EQ(radius, 9.5f);
+
+    // The subject of the status is a view into the key, which must outlive the message.
+    const String missingKey = "--missing";
+    i32 count = -1;
+    ArgStatus status = parser.tryGetArgument<i32>(missingKey, count);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND);
+    EXPECT_EQ(parser.getErrorMessage(status), "The key --missing is not found");
+    EXPECT_EQ(count, -1);
+
+    status = parser.tryGetArgument<i32>("-r", count);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_TYPE_MISMATCH);
+    EXPECT_EQ(status.argumentIndex(), 2);
+    EXPECT_EQ(parser.getErrorMessage(status), "The key [-r, --radius] is not a i32");
+    EXPECT_EQ(count, -1);
+}
+
+TEST_F(ArgParserTest, LazyConversionConvertsOnFirstRead)
+{
+    DefineArgument();
+    parser.setLazyConversion(true);
+
+    LoadArgument("program -c 12 -r -1.5e2");
+    EXPECT_NO_THROW(parser.parse(argCount, argValues));
+    EXPECT_EQ(parser.getArgument<i32>("-c"), 12);
+    EXPECT_EQ(parser.getArgument<f32>("-r"), -150.0f);
+    EXPECT_EQ(parser.getArgument<f32>("--radius"), -150.0f);
+
+    LoadArgument("program -c 12abc -r 2.5x");
+    EXPECT_NO_THROW(parser.parse(argCount, argValues));
+    EXPECT_EQ(parser.getArgument<i32>("-c"), 12);
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 2.5f);
+
+    parser.reset();
+    EXPECT_TRUE(parser.tryValidateAll().ok());
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 1.0f);
+}
+
+TEST_F(ArgParserTest, LazyConversionReportsInvalidValuesOnRead)
+{
+    DefineArgument();
+    parser.setLazyConversion(true);
+    parser.setConversionPolicy(ArgConversionPolicy::STRICT_CONVERSION);
+
+    LoadArgument("program -c 12abc -r 1.0");
+    EXPECT_NO_THROW(parser.parse(argCount, argValues));
+    EXPECT_EQ(parser.isParsed(), true);
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 1.0f);
+
+    i32 count = -1;
+    const ArgStatus status = parser.tryGetArgument<i32>("-c", count);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_INVALID_VALUE);
+    EXPECT_EQ(status.argumentIndex(), 1);
+    EXPECT_EQ(status.subject(), "12abc");
+    EXPECT_EQ(count, -1);
+
+    // The argument stays pending, every read reports the same error.
+    EXPECT_THROW(parser.getArgument<i32>("-c"), std::invalid_argument);
+    EXPECT_EQ(parser.tryValidateAll().code(), ArgErrorCode::ARG_ERROR_INVALID_VALUE);
+    EXPECT_THROW(parser.validateAll(), std::invalid_argument);
+
+    LoadArgument("program -c 3 -r 2.0");
+    parser.parse(argCount, argValues);
+    EXPECT_NO_THROW(parser.validateAll());
+    EXPECT_EQ(parser.getArgument<i32>("-c"), 3);
+}
+
+TEST_F(ArgParserTest, LazyConversionKeepsBoundAndHandleValues)
+{
+    i32 level = 0;
+    parser.setLazyConversion(true);
+    parser.addArgument<i32>({"-l", "--level"}, &level, "The level", false, 1);
+    const ArgHandle<f32> scale = parser.addArgument<f32>({"-s", "--scale"}, "The scale", false, 1.0f);
+
+    LoadArgument("program -l 4 -s 0.25");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(level, 4);
+    EXPECT_EQ(scale.get(), 0.25f);
+    EXPECT_EQ(parser.getArgument<i32>("-l"), 4);
+
+    // The schema results are converted during the parse whatever the mode is.
+    std::shared_ptr<const ArgSchema> schema = parser.freeze();
+    ArgParseResult result;
+    schema->parse(argCount, argValues, result);
+    EXPECT_EQ(result.getArgument<f32>("-s"), 0.25f);
+}
+
+TEST_F(ArgParserTest, LazyConversionReadFromSeveralThreads)
+{
+    parser.setLazyConversion(true);
+    std::vector<ArgHandle<i32>> handles;
+    std::string commandLine = "program";
+    for (u32 i = 0; i < 200; i++)
+    {
+        handles.push_back(parser.addArgument<i32>({String(("--value-" + std::to_string(i)).c_str())}));
+        commandLine += " --value-" + std::to_string(i) + " " + std::to_string(i * 3);
+    }
+
+    LoadArgument(String(commandLine.c_str()));
+    parser.parse(argCount, argValues);
+
+    // Every thread converts some of the pending values on its first read, the others read them.
+    std::atomic<u32> mismatches(0);
+    std::vector<std::thread> readers;
+    for (u32 thread = 0; thread < 4; thread++)
+    {
+        readers.emplace_back([&handles, &mismatches, thread]()
+                             {
+                                 for (u32 i = 0; i < handles.size(); i++)
+                                 {
+                                     const u32 index = (i + thread * 50) % handles.size();
+                                     if (handles[index].get() != static_cast<i32>(index * 3))
+                                     {
+                                         mismatches++;
+                                     }
+                                 }
+                             });
+    }
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+TEST_F(ArgParserTest, HelpText)
+{
+    DefineArgument();
+    parser.addArgument<std::vector<i32>>({"--sizes"}, "The sizes", false, {1, 2}).setNargs(NARGS_ONE_OR_MORE);
+
+    EXPECT_EQ(parser.getHelp(),
+              "This is the description of the parser\n"
+              "\n"
+              "Options:\n"
+              "  -h, --help              Show this help message and exit\n"
+              "  -v, --version <string>  Show the version of the program (default: 1.0.0)\n"
+              "  -c, --col <i32>         Show the color of the program (default: 0)\n"
+              "  -r, --radius <f32>      Show the radius of the program (required)\n"
+              "  --use-color             Show the color of the program\n"
+              "  --sizes <i32>...        The sizes (default: [1, 2])\n");
+
+    // The text is laid out again once an argument is added.
+    parser.addArgument<String>({"--a-very-long-option-name-for-the-output"}, "The output");
+    const String help = parser.getHelp().toString();
+    EXPECT_NE(help.find("  --a-very-long-option-name-for-the-output <string>\n"
+                        "                          The output\n"),
+              std::string::npos);
+}
+
+TEST_F(ArgParserTest, HelpRequest)
+{
+    DefineArgument();
+
+    LoadArgument("program -v 2.0.0 --help");
+    const ArgStatus status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_HELP_REQUESTED);
+    EXPECT_EQ(status.tokenIndex(), 3);
+    EXPECT_EQ(parser.isParsed(), false);
+
+    LoadArgument("program -h");
+    EXPECT_EXIT(parser.parse(argCount, argValues), ::testing::ExitedWithCode(EXIT_SUCCESS), "");
+
+    // The keys defined by the user are not the help.
+    i32 height = 0;
+    parser.addArgument<i32>({"-h", "--height"}, &height, "The height");
+    LoadArgument("program -h 3 -r 1.0");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(height, 3);
+    EXPECT_NE(parser.getHelp().toString().find("  --help  "), std::string::npos);
+}
+
+TEST_F(ArgParserTest, EnvironmentVariableFallback)
+{
+    DefineArgument();
+    f32 scale = 0.0f;
+    const ArgHandle<i32> jobs = parser.addArgument<i32>({"-j", "--jobs"}, "The jobs", false, 1)
+                                    .setEnvironmentVariable("NTT_TEST_JOBS");
+    parser.addArgument<f32>({"--scale"}, &scale, "The scale", false, 1.0f).setEnvironmentVariable("NTT_TEST_SCALE");
+    parser.addArgument<String>({"--name"}, "The name", false, "default").setEnvironmentVariable("NTT_TEST_NAME");
+    parser.addArgument<bool>({"--fast"}).setEnvironmentVariable("NTT_TEST_FAST");
+
+    SetEnvironment("NTT_TEST_JOBS", "8");
+    SetEnvironment("NTT_TEST_SCALE", "0.5");
+    SetEnvironment("NTT_TEST_NAME", "from-env");
+    SetEnvironment("NTT_TEST_FAST", "1");
+
+    // The command line wins over the environment, the environment over the default value.
+    LoadArgument("program -r 1.0 --jobs 3");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(jobs.get(), 3);
+    EXPECT_EQ(scale, 0.5f);
+    EXPECT_EQ(parser.getArgument<String>("--name"), "from-env");
+    EXPECT_EQ(parser.getArgument<bool>("--fast"), true);
+
+    SetEnvironment("NTT_TEST_JOBS", nullptr);
+    SetEnvironment("NTT_TEST_SCALE", nullptr);
+    SetEnvironment("NTT_TEST_NAME", nullptr);
+    SetEnvironment("NTT_TEST_FAST", nullptr);
+
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(scale, 1.0f);
+    EXPECT_EQ(parser.getArgument<String>("--name"), "default");
+    EXPECT_EQ(parser.getArgument<bool>("--fast"), false);
+    EXPECT_NE(parser.getHelp().toString().find("The jobs (default: 1) [env: NTT_TEST_JOBS]\n"), std::string::npos);
+}
+
+TEST_F(ArgParserTest, EnvironmentValuesOutliveTheEnvironment)
+{
+    DefineArgument();
+    parser.setZeroCopyStrings(true);
+    parser.setLazyConversion(true);
+    parser.addArgument<i32>({"-j", "--jobs"}).setEnvironmentVariable("NTT_TEST_JOBS");
+    parser.addArgument<String>({"--name"}).setEnvironmentVariable("NTT_TEST_NAME");
+
+    SetEnvironment("NTT_TEST_JOBS", "8");
+    SetEnvironment("NTT_TEST_NAME", "from-env");
+
+    LoadArgument("program -r 1.0");
+    parser.parse(argCount, argValues);
+
+    // Neither the zero copy mode nor the lazy mode keeps a view into the environment.
+    EXPECT_NE(parser.getArgumentView("--name").data(), getenv("NTT_TEST_NAME"));
+    SetEnvironment("NTT_TEST_JOBS", "1234567");
+    SetEnvironment("NTT_TEST_NAME", nullptr);
+    EXPECT_EQ(parser.getArgument<i32>("--jobs"), 8);
+    EXPECT_EQ(parser.getArgument<String>("--name"), "from-env");
+
+    SetEnvironment("NTT_TEST_JOBS", nullptr);
+}
+
+TEST_F(ArgParserTest, EnvironmentVariableErrors)
+{
+    DefineArgument();
+    parser.addArgument<i32>({"-j", "--jobs"}).setEnvironmentVariable("NTT_TEST_JOBS");
+
+    EXPECT_THROW(parser.addArgument<i32>({"--other"}).setEnvironmentVariable("NTT_TEST_JOBS"), std::invalid_argument);
+    EXPECT_THROW(parser.addArgument<i32>({"--empty"}).setEnvironmentVariable(""), std::invalid_argument);
+    EXPECT_THROW(parser.addArgument<std::vector<i32>>({"--values"}).setEnvironmentVariable("NTT_TEST_VALUES"),
+                 std::invalid_argument);
+
+    parser.setConversionPolicy(ArgConversionPolicy::STRICT_CONVERSION);
+    SetEnvironment("NTT_TEST_JOBS", "many");
+
+    LoadArgument("program -r 1.0");
+    const ArgStatus status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_INVALID_VALUE);
+    EXPECT_EQ(status.tokenIndex(), NTT_ARG_NO_INDEX);
+    EXPECT_EQ(parser.getErrorMessage(status), "The value many of the argument [-j, --jobs] is not a valid i32");
+
+    // The required argument can be given by the environment.
+    SetEnvironment("NTT_TEST_JOBS", "2");
+    parser.addArgument<String>({"--token"}, "The token", true).setEnvironmentVariable("NTT_TEST_TOKEN");
+    EXPECT_EQ(parser.tryParse(argCount, argValues).code(), ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED);
+    SetEnvironment("NTT_TEST_TOKEN", "secret");
+    EXPECT_TRUE(parser.tryParse(argCount, argValues).ok());
+    EXPECT_EQ(parser.getArgument<String>("--token"), "secret");
+
+    SetEnvironment("NTT_TEST_JOBS", nullptr);
+    SetEnvironment("NTT_TEST_TOKEN", nullptr);
+}
+
+TEST_F(ArgParserTest, ConfigFileIsOverriddenByCommandLine)
+{
+    DefineArgument();
+    parser.addArgument<String>({"--output.path"}, "The output path", false, "out");
+    parser.addArgument<std::vector<i32>>({"--sizes"}, "The sizes", false, {1, 2});
+    parser.addArgument<std::vector<String>>({"--tags"}, "The tags", false, {"default"});
+    parser.addArgument<i32>({"-j", "--jobs"}, "The jobs", false, 1).setEnvironmentVariable("NTT_TEST_CONFIG_JOBS");
+
+    const char *path = "parser_test_config.json";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "{\n"
+                "  \"version\": \"2.\\u00e9\\\"\",\n"
+                "  \"--col\": 12,\n"
+                "  \"radius\": 0.5,\n"
+                "  \"use-color\": true,\n"
+                "  \"jobs\": 4,\n"
+                "  \"unknown\": {\"nested\": [1, {\"col\": 3}, null]},\n"
+                "  \"output\": {\"path\": \"/tmp/result\"},\n"
+                "  \"sizes\": [3, 4, 5],\n"
+                "  \"tags\": []\n"
+                "}\n";
+    }
+    parser.parseConfig(path);
+    std::remove(path);
+
+    SetEnvironment("NTT_TEST_CONFIG_JOBS", "6");
+    LoadArgument("program --col 7");
+    parser.parse(argCount, argValues);
+    SetEnvironment("NTT_TEST_CONFIG_JOBS", nullptr);
+
+    EXPECT_EQ(parser.getArgument<String>("-v"), "2.\xc3\xa9\"");
+    EXPECT_EQ(parser.getArgument<i32>("--col"), 7);
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 0.5f);
+    EXPECT_EQ(parser.getArgument<bool>("--use-color"), true);
+    EXPECT_EQ(parser.getArgument<i32>("--jobs"), 6);
+    EXPECT_EQ(parser.getArgument<String>("--output.path"), "/tmp/result");
+    EXPECT_EQ(parser.getArgument<std::vector<i32>>("--sizes").size(), 3u);
+    EXPECT_EQ(parser.getArgument<std::vector<i32>>("--sizes")[2], 5);
+    EXPECT_TRUE(parser.getArgument<std::vector<String>>("--tags").empty());
+
+    // The config values are kept when the parser grows.
+    for (u32 i = 0; i < 100; i++)
+    {
+        parser.addArgument<String>({format("--generated-{}", i)}, "Generated argument", false, "generated");
+    }
+    EXPECT_EQ(parser.getArgument<String>("--output.path"), "/tmp/result");
+
+    LoadArgument("program --sizes 9 --jobs 2");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(parser.getArgument<std::vector<i32>>("--sizes").size(), 1u);
+    EXPECT_EQ(parser.getArgument<i32>("--jobs"), 2);
+    EXPECT_EQ(parser.getArgument<i32>("--col"), 12);
+}
+
+TEST_F(ArgParserTest, InvalidConfigFile)
+{
+    DefineArgument();
+
+    const String missingPath = "parser_test_missing_config.json";
+    ArgStatus status = parser.tryParseConfig(missingPath);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_CONFIG_FILE_NOT_OPENED);
+    EXPECT_EQ(parser.getErrorMessage(status), "The config file parser_test_missing_config.json cannot be opened");
+
+    const String path = "parser_test_invalid_config.json";
+    const char *contents[] = {
+        "{\n\"radius\": 1.0,\n\"col\": }",
+        "{\"radius\": [1.0]}",
+        "{\"radius\": {\"value\": 1.0}}",
+        "[1, 2]",
+        "{\"radius\": 1.0} trailing",
+        "{\"col\": 1.2.3}",
+        "{\"col\": 01}",
+        "{\"col\": -}",
+        "{\"version\": \"\\udc00\"}",
+    };
+    for (const char *content : contents)
+    {
+        {
+            std::ofstream file(path.c_str(), std::ios::binary);
+            file << content;
+        }
+        EXPECT_EQ(parser.tryParseConfig(path).code(), ArgErrorCode::ARG_ERROR_CONFIG_FILE_INVALID) << content;
+    }
+
+    {
+        std::ofstream file(path.c_str(), std::ios::binary);
+        file << "{\n\"radius\": 1.0,\n\"col\": }";
+    }
+    EXPECT_THROW(parser.parseConfig(path), std::invalid_argument);
+    status = parser.tryParseConfig(path);
+    EXPECT_EQ(status.tokenIndex(), 3);
+    EXPECT_EQ(parser.getErrorMessage(status), "The config file parser_test_invalid_config.json is not valid at line 3");
+
+    // A value which the argument cannot take is reported at its line as well.
+    {
+        std::ofstream file(path.c_str(), std::ios::binary);
+        file << "{\n\"col\": 1,\n\n\"radius\":\n  {\"value\": 1.0}\n}";
+    }
+    EXPECT_EQ(parser.tryParseConfig(path).tokenIndex(), 5);
+
+    // The conversion errors are reported by the parse.
+    {
+        std::ofstream file(path.c_str(), std::ios::binary);
+        file << "{\"radius\": 1.0, \"col\": \"many\"}";
+    }
+    parser.parseConfig(path);
+    std::remove(path.c_str());
+
+    parser.setConversionPolicy(ArgConversionPolicy::STRICT_CONVERSION);
+    LoadArgument("program");
+    status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_INVALID_VALUE);
+    EXPECT_EQ(status.tokenIndex(), NTT_ARG_NO_INDEX);
+    EXPECT_EQ(parser.getErrorMessage(status), "The value many of the argument [-c, --col] is not a valid i32");
+}
+
+TEST_F(ArgParserTest, SerializedResultIsReadWithoutParsing)
+{
+    DefineArgument();
+    i32 jobs = 0;
+    parser.addArgument<i32>({"-j", "--jobs"}, &jobs, "The jobs", false, 1);
+    parser.addArgument<std::vector<String>>({"--tags"}, "The tags", false, {"default"});
+    parser.addArgument<std::vector<f32>>({"--scales"}, "The scales").setNargs(NARGS_ONE_OR_MORE);
+    parser.setLazyConversion(true);
+
+    LoadArgument("program -v 2.0.0 --col 8 -r 9.5 -j 4 --scales 0.5 1.5");
+    parser.parse(argCount, argValues);
+
+    // The blob is copied into a separated 8 bytes aligned buffer as if it was mapped.
+    const std::vector<u8> blob = parser.serialize();
+    std::vector<u64> mapping((blob.size() + sizeof(u64) - 1) / sizeof(u64));
+    memcpy(mapping.data(), blob.data(), blob.size());
+
+    ArgParser worker("The worker parser");
+    worker.addArgument<String>({"-v", "--version"});
+    ArgHandle<i32> col = worker.addArgument<i32>({"-c", "--col"});
+    worker.addArgument<f32>({"-r", "--radius"}, "", true);
+    worker.addArgument<bool>({"--use-color"});
+    ArgHandle<i32> workerJobs = worker.addArgument<i32>({"-j", "--jobs"});
+    ArgHandle<std::vector<String>> tags = worker.addArgument<std::vector<String>>({"--tags"});
+    worker.addArgument<std::vector<f32>>({"--scales"}).setNargs(NARGS_ONE_OR_MORE);
+
+    const ArgSnapshot snapshot = worker.attach(mapping.data(), mapping.size() * sizeof(u64));
+    EXPECT_TRUE(snapshot.isAttached());
+    EXPECT_FALSE(worker.isParsed());
+
+    const ArgStringView version = snapshot.getArgument<ArgStringView>("--version");
+    EXPECT_EQ(version, "2.0.0");
+    EXPECT_GE(reinterpret_cast<const u8 *>(version.data()), reinterpret_cast<const u8 *>(mapping.data()));
+    EXPECT_LT(reinterpret_cast<const u8 *>(version.data()), reinterpret_cast<const u8 *>(mapping.data() + mapping.size()));
+
+    EXPECT_EQ(snapshot.get(col), 8);
+    EXPECT_EQ(snapshot.getArgument<f32>("-r"), 9.5f);
+    EXPECT_EQ(snapshot.getArgument<bool>("--use-color"), false);
+    EXPECT_EQ(snapshot.get(workerJobs), 4);
+    EXPECT_TRUE(snapshot.isProvided(workerJobs));
+    EXPECT_FALSE(snapshot.isProvided("--use-color"));
+    EXPECT_THROW(snapshot.isProvided("--unknown"), std::invalid_argument);
+
+    EXPECT_EQ(snapshot.get(tags).size(), 1u);
+    EXPECT_EQ(snapshot.get(tags)[0], "default");
+    const ArgSpan<f32> scales = snapshot.getArgument<std::vector<f32>>("--scales");
+    EXPECT_EQ(scales.size(), 2u);
+    EXPECT_EQ(scales[1], 1.5f);
+
+    // The snapshot does not depend on the serializing parser.
+    LoadArgument("program -r 1.0");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(snapshot.get(col), 8);
+
+    // The same definitions give the same blob.
+    LoadArgument("program -v 2.0.0 --col 8 -r 9.5 -j 4 --scales 0.5 1.5");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(parser.serialize(), blob);
+}
+
+TEST_F(ArgParserTest, InvalidSerializedResult)
+{
+    DefineArgument();
+    parser.parse(argCount, argValues);
+    const std::vector<u8> blob = parser.serialize();
+    std::vector<u64> mapping((blob.size() + sizeof(u64) - 1) / sizeof(u64) + 1);
+    memcpy(mapping.data(), blob.data(), blob.size());
+
+    ArgSnapshot snapshot;
+    EXPECT_FALSE(snapshot.isAttached());
+    i32 value = 0;
+    EXPECT_EQ(snapshot.tryGetArgument<i32>("--col", value).code(), ArgErrorCode::ARG_ERROR_NOT_PARSED);
+    EXPECT_THROW(snapshot.getArgument<i32>("--col"), std::invalid_argument);
+
+    EXPECT_EQ(parser.tryAttach(mapping.data(), blob.size() - 1, snapshot).code(), ArgErrorCode::ARG_ERROR_SNAPSHOT_INVALID);
+    EXPECT_EQ(parser.tryAttach(reinterpret_cast<u8 *>(mapping.data()) + 1, blob.size(), snapshot).code(),
+              ArgErrorCode::ARG_ERROR_SNAPSHOT_INVALID);
+    EXPECT_EQ(parser.tryAttach(nullptr, 0, snapshot).code(), ArgErrorCode::ARG_ERROR_SNAPSHOT_INVALID);
+
+    u8 *bytes = reinterpret_cast<u8 *>(mapping.data());
+    bytes[0] ^= 0xFF;
+    const ArgStatus status = parser.tryAttach(mapping.data(), blob.size(), snapshot);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_SNAPSHOT_INVALID);
+    EXPECT_EQ(parser.getErrorMessage(status), "The serialized result is not valid");
+    bytes[0] ^= 0xFF;
+
+    // A string which runs past its end.
+    std::vector<u8> corrupted = blob;
+    const char version[] = "1.0.0";
+    std::vector<u8>::iterator found = std::search(corrupted.begin(), corrupted.end(), version, version + sizeof(version));
+    ASSERT_NE(found, corrupted.end());
+    found[sizeof(version) - 1] = 'x';
+    std::vector<u64> corruptedMapping(mapping.size());
+    memcpy(corruptedMapping.data(), corrupted.data(), corrupted.size());
+    EXPECT_EQ(parser.tryAttach(corruptedMapping.data(), corrupted.size(), snapshot).code(),
+              ArgErrorCode::ARG_ERROR_SNAPSHOT_INVALID);
+
+    ArgParser other("The other parser");
+    other.addArgument<String>({"-v", "--version"});
+    other.addArgument<i32>({"-c", "--color"});
+    EXPECT_THROW(other.attach(mapping.data(), blob.size()), std::invalid_argument);
+    EXPECT_EQ(other.getErrorMessage(other.tryAttach(mapping.data(), blob.size(), snapshot)),
+              "The serialized result does not match the arguments of the parser");
+    EXPECT_FALSE(snapshot.isAttached());
+
+    EXPECT_TRUE(parser.tryAttach(mapping.data(), blob.size(), snapshot).ok());
+    EXPECT_EQ(snapshot.getArgument<i32>("--col"), 8);
+    EXPECT_EQ(snapshot.tryGetArgument<i32>("-r", value).code(), ArgErrorCode::ARG_ERROR_TYPE_MISMATCH);
+}
+
+TEST_F(ArgParserTest, SubcommandIsBuiltWhenSelected)
+{
+    DefineArgument();
+
+    u32 buildCount = 0;
+    u32 testCount = 0;
+    ArgHandle<i32> jobs;
+    ArgHandle<std::vector<String>> targets;
+    parser.addSubcommand("build", "Build the project", [&](ArgParser &build)
+                         {
+                             buildCount++;
+                             jobs = build.addArgument<i32>({"-j", "--jobs"}, "The jobs", false, 1);
+                             targets = build.addArgument<std::vector<String>>({"--targets"}, "The targets")
+                                           .setNargs(NARGS_ONE_OR_MORE); });
+    parser.addSubcommand("test", "Run the tests", [&](ArgParser &test)
+                         {
+                             testCount++;
+                             test.addArgument<String>({"--filter"}, "The filter", true); });
+    parser.addArgument<std::vector<String>>({"--inputs"}, "The inputs").setNargs(NARGS_ONE_OR_MORE);
+
+    EXPECT_EQ(buildCount, 0u);
+    EXPECT_NE(parser.getHelp().toString().find("Commands:\n"
+                                                "  build                   Build the project\n"
+                                                "  test                    Run the tests\n"),
+              std::string::npos);
+
+    LoadArgument("program -r 2.5 --inputs a b build -j 4 --targets lib app");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(buildCount, 1u);
+    EXPECT_EQ(testCount, 0u);
+    EXPECT_EQ(parser.getSubcommandName(), "build");
+    ASSERT_NE(parser.getSubcommand(), nullptr);
+    EXPECT_TRUE(parser.getSubcommand()->isParsed());
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 2.5f);
+    EXPECT_EQ(parser.getArgument<std::vector<String>>("--inputs").size(), 2u);
+    EXPECT_EQ(jobs.get(), 4);
+    EXPECT_EQ(targets.get().size(), 2u);
+    EXPECT_EQ(parser.getSubcommand()->getArgument<i32>("--jobs"), 4);
+
+    // The arguments of the parser are not arguments of the subcommand.
+    LoadArgument("program -r 1.0 build -v 2.0.0");
+    ArgStatus status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND);
+    EXPECT_EQ(status.subcommandIndex(), 0u);
+    EXPECT_EQ(status.tokenIndex(), 4u);
+    EXPECT_EQ(parser.getErrorMessage(status), "The key -v is not found");
+
+    // The parser of the subcommand is kept.
+    LoadArgument("program -r 1.0 build");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(buildCount, 1u);
+    EXPECT_EQ(jobs.get(), 1);
+
+    LoadArgument("program -r 1.0");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(parser.getSubcommand(), nullptr);
+    EXPECT_TRUE(parser.getSubcommandName().empty());
+
+    // The failures inside the subcommand are formatted by the subcommand.
+    LoadArgument("program -r 1.0 test --filter");
+    status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(testCount, 1u);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_MISSING_VALUE);
+    EXPECT_EQ(status.subcommandIndex(), 1u);
+    EXPECT_EQ(status.tokenIndex(), 4u);
+    EXPECT_EQ(parser.getErrorMessage(status), "The string argument [--filter] is not followed by a value");
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+
+    LoadArgument("program -r 1.0 test");
+    status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED);
+    EXPECT_EQ(parser.getErrorMessage(status), "The required argument [--filter] is not provided");
+
+    LoadArgument("program -r 1.0 test --help");
+    EXPECT_EQ(parser.tryParse(argCount, argValues).code(), ArgErrorCode::ARG_ERROR_HELP_REQUESTED);
+    EXPECT_EXIT(parser.parse(argCount, argValues), ::testing::ExitedWithCode(EXIT_SUCCESS), "");
+}
+
+TEST_F(ArgParserTest, InvalidSubcommand)
+{
+    DefineArgument();
+    const ArgSubcommandBuilder builder = [](ArgParser &subcommand)
+    {
+        subcommand.addSubcommand("nested", "The nested subcommand", [](ArgParser &) {});
+    };
+    parser.addSubcommand("build", "Build the project", builder);
+
+    EXPECT_THROW(parser.addSubcommand("build", "Again", builder), std::invalid_argument);
+    EXPECT_THROW(parser.addSubcommand("--col", "A key", builder), std::invalid_argument);
+    EXPECT_THROW(parser.addSubcommand("", "Empty", builder), std::invalid_argument);
+    EXPECT_THROW(parser.addArgument<i32>({"build"}), std::invalid_argument);
+    EXPECT_THROW(parser.freeze(), std::invalid_argument);
+
+    LoadArgument("program -r 1.0 deploy");
+    EXPECT_EQ(parser.tryParse(argCount, argValues).code(), ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND);
+
+    // The builder throws, the subcommand is not selected.
+    LoadArgument("program -r 1.0 build");
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+    EXPECT_EQ(parser.getSubcommand(), nullptr);
+}
+
+TEST_F(ArgParserTest, UnambiguousPrefixSelectsTheLongKey)
+{
+    DefineArgument();
+    parser.addArgument<std::vector<i32>>({"--range"}, "The range").setNargs(NARGS_ONE_OR_MORE);
+
+    // Disabled by default.
+    LoadArgument("program --rad 2.5");
+    EXPECT_EQ(parser.tryParse(argCount, argValues).code(), ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND);
+
+    parser.setPrefixMatching(true);
+    LoadArgument("program --rad 2.5 --ran 1 2 --use");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 2.5f);
+    EXPECT_EQ(parser.getArgument<std::vector<i32>>("--range").size(), 2);
+    EXPECT_EQ(parser.getArgument<bool>("--use-color"), true);
+
+    // The values of a list stop at a prefix, the exact keys always win.
+    LoadArgument("program --range 3 --r 1.0");
+    ArgStatus status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_AMBIGUOUS_KEY);
+    EXPECT_EQ(status.tokenIndex(), 3);
+    EXPECT_EQ(parser.getErrorMessage(status), "The key --r is ambiguous, it matches --radius, --range");
+
+    LoadArgument("program --radius 1.0 --range 3 --col 4");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(parser.getArgument<std::vector<i32>>("--range").size(), 1);
+    EXPECT_EQ(parser.getArgument<i32>("--col"), 4);
+
+    // The single dash keys are never abbreviated.
+    LoadArgument("program -r 1.0 -ver 2.0.0");
+    EXPECT_EQ(parser.tryParse(argCount, argValues).code(), ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND);
+}
+
+TEST_F(ArgParserTest, MissingKeySuggestsTheClosestKeys)
+{
+    DefineArgument();
+    parser.addArgument<i32>({"--color"}, "The color");
+
+    LoadArgument("program -r 1.0 --raduis 2.0");
+    ArgStatus status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND);
+    EXPECT_EQ(parser.getErrorMessage(status), "The key --raduis is not found, did you mean --radius?");
+
+    LoadArgument("program -r 1.0 --use-colour");
+    status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(parser.getErrorMessage(status), "The key --use-colour is not found, did you mean --use-color?");
+
+    // The closest first.
+    LoadArgument("program -r 1.0 --coler 8");
+    status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(parser.getErrorMessage(status), "The key --coler is not found, did you mean --color, --col?");
+
+    // A short key is never matched with an unrelated one.
+    LoadArgument("program -r 1.0 -x");
+    status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(parser.getErrorMessage(status), "The key -x is not found");
+
+    LoadArgument("program -r 1.0 --versoin 2.0.0");
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+}
+
+TEST_F(ArgParserTest, SerializedResultSkipsThePositionals)
+{
+    const auto definePositionals = [](ArgParser &target)
+    {
+        target.addPositional<String>("mode", [](u32, ArgStringView) {}, "The mode", true);
+        target.addArgument<i32>({"-j", "--jobs"}, "The jobs", false, 1);
+        target.addPositional<String>("inputs", [](u32, ArgStringView) {}, "The inputs", false, true);
+    };
+    definePositionals(parser);
+
+    LoadArgument("program fast -j 4 a.txt b.txt");
+    parser.parse(argCount, argValues);
+    const std::vector<u8> blob = parser.serialize();
+    std::vector<u64> mapping((blob.size() + sizeof(u64) - 1) / sizeof(u64));
+    memcpy(mapping.data(), blob.data(), blob.size());
+
+    // The positional values are not part of the blob, it does not depend on them.
+    LoadArgument("program slow -j 4 c.txt");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(parser.serialize(), blob);
+
+    ArgParser worker("The worker parser");
+    definePositionals(worker);
+    const ArgSnapshot snapshot = worker.attach(mapping.data(), mapping.size() * sizeof(u64));
+    EXPECT_EQ(snapshot.getArgument<i32>("--jobs"), 4);
+}
+
+TEST_F(ArgParserTest, PositionalArgumentsAreVisited)
+{
+    DefineArgument();
+    std::vector<std::string> visited;
+    i32 level = 0;
+    parser.addPositional<i32>("level", [&level](u32 index, i32 value)
+                              { level = value + static_cast<i32>(index); },
+                              "The level", true);
+    parser.addPositional<String>("inputs", [&visited](u32 index, ArgStringView value)
+                                 { visited.push_back(std::to_string(index) + ":" + value.toString()); },
+                                 "The inputs", false, true);
+
+    // The values are visited in the order of the tokens, between the keys.
+    LoadArgument("program 3 a.txt -r 1.0 b.txt --use-color - -- -c.txt --col");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(level, 3);
+    EXPECT_THAT(visited, ::testing::ElementsAre("0:a.txt", "1:b.txt", "2:-", "3:-c.txt", "4:--col"));
+    EXPECT_EQ(parser.getArgument<f32>("-r"), 1.0f);
+    EXPECT_EQ(parser.getArgument<bool>("--use-color"), true);
+    EXPECT_EQ(parser.getArgument<i32>("--col"), 0);
+
+    // The negative numbers are keys unless they follow `--`.
+    visited.clear();
+    LoadArgument("program -r 1.0 -- -5");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(level, -5);
+    EXPECT_TRUE(visited.empty());
+
+    // The frozen schema visits the same way.
+    visited.clear();
+    std::shared_ptr<const ArgSchema> schema = parser.freeze();
+    ArgParseResult result;
+    LoadArgument("program 7 c.txt -r 2.0");
+    EXPECT_TRUE(schema->tryParse(argCount, argValues, result).ok());
+    EXPECT_EQ(level, 7);
+    EXPECT_THAT(visited, ::testing::ElementsAre("0:c.txt"));
+
+    EXPECT_EQ(parser.getHelp(),
+              "This is the description of the parser\n"
+              "\n"
+              "Arguments:\n"
+              "  level                   The level (required)\n"
+              "  inputs...               The inputs\n"
+              "\n"
+              "Options:\n"
+              "  -h, --help              Show this help message and exit\n"
+              "  -v, --version <string>  Show the version of the program (default: 1.0.0)\n"
+              "  -c, --col <i32>         Show the color of the program (default: 0)\n"
+              "  -r, --radius <f32>      Show the radius of the program (required)\n"
+              "  --use-color             Show the color of the program\n");
+}
+
+TEST_F(ArgParserTest, InvalidPositionalArgument)
+{
+    DefineArgument();
+    const ArgPositionalVisitor<f32> ignore = [](u32, f32) {};
+
+    // Without any positional argument the tokens are still unknown keys.
+    LoadArgument("program -r 1.0 input");
+    EXPECT_EQ(parser.tryParse(argCount, argValues).code(), ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND);
+
+    EXPECT_THROW(parser.addPositional<f32>("", ignore), std::invalid_argument);
+    EXPECT_THROW(parser.addPositional<f32>("--scale", ignore), std::invalid_argument);
+    parser.addPositional<f32>("scale", ignore, "The scale");
+    EXPECT_THROW(parser.addPositional<f32>("scale", ignore), std::invalid_argument);
+    EXPECT_THROW(parser.addPositional<f32>("offset", ignore, "The offset", true), std::invalid_argument);
+    parser.addPositional<f32>("offset", ignore, "The offset", false, true);
+    EXPECT_THROW(parser.addPositional<f32>("extra", ignore), std::invalid_argument);
+
+    LoadArgument("program -r 1.0 1.5 2.5 abc");
+    parser.setConversionPolicy(ArgConversionPolicy::STRICT_CONVERSION);
+    ArgStatus status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_INVALID_VALUE);
+    EXPECT_EQ(status.tokenIndex(), 5);
+    EXPECT_EQ(parser.getErrorMessage(status), "The value abc of the argument [offset] is not a valid f32");
+
+    ArgParser single("Single positional");
+    u32 visits = 0;
+    single.addPositional<bool>("enabled", [&visits](u32, bool) { visits++; }, "Enabled", true);
+
+    LoadArgument("program true false");
+    status = single.tryParse(argCount, argValues);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_UNEXPECTED_POSITIONAL);
+    EXPECT_EQ(status.tokenIndex(), 2);
+    EXPECT_EQ(single.getErrorMessage(status), "The positional value false is not expected");
+    EXPECT_EQ(visits, 1);
+
+    // A required positional argument goes through the same check as the required keys.
+    LoadArgument("program");
+    status = single.tryParse(argCount, argValues);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED);
+    EXPECT_EQ(single.getErrorMessage(status), "The required argument [enabled] is not provided");
+}
+
+TEST_F(ArgParserTest, ValidatorsRejectTheValues)
+{
+    DefineArgument();
+    parser.addArgument<String>({"--mode"}, "The mode", false, "unchecked")
+        .addValidator(ArgValidator::choice({"fast", "safe", "fast"}));
+    parser.addArgument<std::vector<String>>({"--names"}, "The names")
+        .setNargs(NARGS_ONE_OR_MORE)
+        .addValidator(ArgValidator::regex("[a-z]+_[0-9]+"));
+    ArgHandle<i32> jobs = parser.addArgument<i32>({"-j", "--jobs"}, "The jobs", false, 0)
+                              .addValidator(ArgValidator::range(1, 64))
+                              .addValidator([](i32 value)
+                                            { return value % 2 == 0; },
+                                            "even");
+
+    EXPECT_THROW(parser.addArgument<i32>({"--level"}).addValidator(ArgValidator::choice({"1"})), std::invalid_argument);
+    EXPECT_THROW(parser.addArgument<String>({"--tag"}).addValidator(ArgValidator::range(0, 1)), std::invalid_argument);
+    EXPECT_THROW(parser.addArgument<String>({"--id"}).addValidator(ArgValidator::regex("([a-z")), std::invalid_argument);
+    EXPECT_THROW(parser.addArgument<f32>({"--ratio"}).addValidator(ArgValidator::range(1, 0)), std::invalid_argument);
+
+    // The default values are not checked.
+    LoadArgument("program -r 1.0 --mode safe --names a_1 bc_23 -j 8");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(jobs.get(), 8);
+
+    LoadArgument("program -r 1.0");
+    parser.parse(argCount, argValues);
+    EXPECT_EQ(parser.getArgument<String>("--mode"), "unchecked");
+
+    LoadArgument("program -r 1.0 --mode slow");
+    ArgStatus status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_VALIDATION_FAILED);
+    EXPECT_EQ(status.argumentIndex(), 4);
+    EXPECT_EQ(parser.getErrorMessage(status), "The value slow of the argument [--mode] is not one of [fast, safe]");
+    EXPECT_FALSE(parser.isParsed());
+
+    LoadArgument("program -r 1.0 --names a_1 b_2 c3 D_4");
+    status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(parser.getErrorMessage(status), "The value c3 of the argument [--names] is not matching [a-z]+_[0-9]+");
+
+    // The validators run in their order.
+    LoadArgument("program -r 1.0 -j 65");
+    status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(parser.getErrorMessage(status), "The value 65 of the argument [-j, --jobs] is not inside [1, 64]");
+
+    LoadArgument("program -r 1.0 -j 7");
+    EXPECT_THROW(parser.parse(argCount, argValues), std::invalid_argument);
+    status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(parser.getErrorMessage(status), "The value 7 of the argument [-j, --jobs] is not even");
+
+    // The environment values are checked like the command line ones, the lazy ones once converted.
+    jobs.setEnvironmentVariable("NTT_TEST_VALIDATED_JOBS");
+    SetEnvironment("NTT_TEST_VALIDATED_JOBS", "0");
+    parser.setLazyConversion(true);
+    LoadArgument("program -r 1.0");
+    EXPECT_EQ(parser.tryParse(argCount, argValues).code(), ArgErrorCode::ARG_ERROR_VALIDATION_FAILED);
+    SetEnvironment("NTT_TEST_VALIDATED_JOBS", nullptr);
+}
+
+TEST_F(ArgParserTest, RejectedFloatIsReportedAsGiven)
+{
+    parser.addArgument<f32>({"--ratio"})
+        .addValidator(ArgValidator::range(0.0, 0.5))
+        .setEnvironmentVariable("NTT_TEST_VALIDATED_RATIO");
+    parser.addArgument<std::vector<f32>>({"--weights"})
+        .setNargs(NARGS_ONE_OR_MORE)
+        .addValidator(ArgValidator::range(-1.0, 1.0));
+
+    // The message shows the token, not the float it is converted into.
+    LoadArgument("program --ratio 0.50000001e1");
+    ArgStatus status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(parser.getErrorMessage(status),
+              "The value 0.50000001e1 of the argument [--ratio] is not inside [0, 0.5]");
+
+    LoadArgument("program --weights 0.25 0.75 1.0000001 0.5");
+    status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(parser.getErrorMessage(status),
+              "The value 1.0000001 of the argument [--weights] is not inside [-1, 1]");
+
+    SetEnvironment("NTT_TEST_VALIDATED_RATIO", "7.25");
+    parser.setLazyConversion(true);
+    parser.setZeroCopyStrings(true);
+    LoadArgument("program --weights 0.25");
+    status = parser.tryParse(argCount, argValues);
+    EXPECT_EQ(parser.getErrorMessage(status), "The value 7.25 of the argument [--ratio] is not inside [0, 0.5]");
+    SetEnvironment("NTT_TEST_VALIDATED_RATIO", nullptr);
+}
+
+TEST_F(ArgParserTest, ParallelValidatorsMatchASingleThread)
+{
+    std::atomic<u32> checks(0);
+    parser.addArgument<std::vector<i32>>({"--ids"}, "The ids")
+        .setNargs(NARGS_ONE_OR_MORE)
+        .addValidator([&checks](i32 value)
+                      {
+                          checks++;
+                          if (value < 0)
+                          {
+                              throw std::runtime_error("negative id");
+                          }
+                          return value % 1000 != 999;
+                      },
+                      "an id not ending with 999", true);
+
+    std::string line = "program --ids";
+    for (u32 i = 0; i < 5000; i++)
+    {
+        line += " " + std::to_string(i == 4500 ? 1999 : i % 999);
+    }
+
+    for (u32 threadCount : {1u, 4u, 0u})
+    {
+        parser.setValidationThreads(threadCount);
+
+        LoadArgument(String(line + " 2999"));
+        checks = 0;
+        ArgStatus status = parser.tryParse(argCount, argValues);
+        EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_VALIDATION_FAILED);
+        EXPECT_EQ(parser.getErrorMessage(status),
+                  "The value 1999 of the argument [--ids] is not an id not ending with 999");
+        EXPECT_GE(checks.load(), 4501u);
+
+        LoadArgument(String(line.substr(0, line.find(" 1999")) + " 7"));
+        EXPECT_TRUE(parser.tryParse(argCount, argValues).ok());
+
+        // The first exception in the order of the checks goes through, after the rejected value.
+        LoadArgument(String(line + " -1"));
+        EXPECT_EQ(parser.tryParse(argCount, argValues).code(), ArgErrorCode::ARG_ERROR_VALIDATION_FAILED);
+        LoadArgument("program --ids 3 -1 999 -2");
+        EXPECT_THROW(parser.tryParse(argCount, argValues), std::runtime_error);
+    }
+
+    // The parses of a batch check on their own thread.
+    std::shared_ptr<const ArgSchema> schema = parser.freeze();
+    LoadArgument(String(line.substr(0, line.find(" 1999"))));
+    std::vector<ArgCommandLine> lines(8, ArgCommandLine{argCount, argValues});
+    for (const ArgParseResult &result : schema->parseBatch(lines, 4))
+    {
+        EXPECT_TRUE(result.isParsed());
+    }
+}
+
+TEST_F(ArgParserTest, ParallelValidatorsReuseTheWorkers)
+{
+    // Counts the threads which check a value for the first time.
+    static std::atomic<u32> newThreads(0);
+    parser.addArgument<std::vector<i32>>({"--ids"}, "The ids")
+        .setNargs(NARGS_ONE_OR_MORE)
+        .addValidator([](i32 value)
+                      {
+                          thread_local bool isKnown = false;
+                          if (!isKnown)
+                          {
+                              isKnown = true;
+                              newThreads++;
+                          }
+                          std::this_thread::sleep_for(std::chrono::microseconds(50));
+                          return value >= 0;
+                      },
+                      "a positive id", true);
+    parser.setValidationThreads(4);
+
+    std::string line = "program --ids";
+    for (u32 i = 0; i < 2 * NTT_ARG_VALIDATION_PARALLEL_MIN_CHECKS; i++)
+    {
+        line += " " + std::to_string(i);
+    }
+    LoadArgument(String(line));
+    parser.parse(argCount, argValues);
+
+    // The following parses hand their checks to the same workers, they start no thread.
+    newThreads = 0;
+    for (u32 i = 0; i < 10; i++)
+    {
+        EXPECT_TRUE(parser.tryParse(argCount, argValues).ok());
+    }
+    EXPECT_EQ(newThreads.load(), 0u);
+}
+
+static u64 s_fakeAllocations = 0;
+
+static u64 CountFakeAllocations()
+{
+    // Every sample is one allocation later, so that each parse counts exactly 1.
+    return s_fakeAllocations++;
+}
+
+TEST_F(ArgParserTest, CountersOfTheParses)
+{
+    DefineArgument();
+
+    setArgAllocationCounter(CountFakeAllocations);
+    parser.parse(argCount, argValues);
+
+    LoadArgument("program -c 1x -r 2.0");
+    parser.parse(argCount, argValues);
+
+    LoadArgument("program -c 3");
+    EXPECT_FALSE(parser.tryParse(argCount, argValues).ok());
+    setArgAllocationCounter(nullptr);
+
+    const ArgParseCounters &counters = parser.getCounters();
+    if (!isArgInstrumentationEnabled())
+    {
+        EXPECT_EQ(counters.parses, 0);
+        EXPECT_EQ(counters.tokens, 0);
+        EXPECT_EQ(counters.parseNanoseconds, 0);
+        EXPECT_THAT(counters.toJson(), ::testing::StartsWith("{\"enabled\": false, \"parses\": 0,"));
+        return;
+    }
+
+    EXPECT_EQ(counters.parses, 3);
+    EXPECT_EQ(counters.failedParses, 1);
+    EXPECT_EQ(counters.tokens, 7 + 4 + 2);
+    EXPECT_EQ(counters.keyLookups, 4 + 2 + 1);
+    EXPECT_GE(counters.keyComparisons, counters.keyLookups);
+    EXPECT_EQ(counters.conversions, 2 + 2 + 1);
+    EXPECT_EQ(counters.conversionFailures, 1);
+    EXPECT_EQ(counters.allocations, 3);
+    EXPECT_GE(counters.parseNanoseconds, counters.lookupNanoseconds + counters.conversionNanoseconds);
+    EXPECT_THAT(counters.toJson(), ::testing::StartsWith("{\"enabled\": true, \"parses\": 3, \"failed_parses\": 1,"));
+
+    // Nothing is counted by the reset of the values.
+    parser.reset();
+    EXPECT_EQ(parser.getCounters().parses, 3);
+    parser.resetCounters();
+    EXPECT_EQ(parser.getCounters().parses, 0);
+    EXPECT_EQ(parser.getCounters().conversions, 0);
+}
@@ -0,0 +1,462 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <NTTArgParser.hpp>
+#include <parallel.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace NTT_NS;
+
+/**
+ * Owns the `argv` of many command lines for the schema tests.
+ */
+class CommandLines
+{
+public:
+    void Add(const std::vector<std::string> &tokens)
+    {
+        m_storages.emplace_back(tokens);
+        std::vector<std::string> &storage = m_storages.back();
+
+        m_argvs.emplace_back();
+        for (std::string &token : storage)
+        {
+            m_argvs.back().push_back(&token[0]);
+        }
+    }
+
+    std::vector<ArgCommandLine> Get()
+    {
+        std::vector<ArgCommandLine> commandLines;
+        for (std::vector<char *> &argv : m_argvs)
+        {
+            commandLines.push_back(ArgCommandLine{static_cast<u32>(argv.size()), argv.data()});
+        }
+        return commandLines;
+    }
+
+private:
+    std::deque<std::vector<std::string>> m_storages;
+    std::deque<std::vector<char *>> m_argvs;
+};
+
+class ArgSchemaTest : public ::testing::Test
+{
+protected:
+    ArgParser parser{"This is the description of the parser"};
+    f32 boundRadius = 0.0f;
+    ArgHandle<i32> col;
+
+    void SetUp() override
+    {
+        parser.addArgument<String>({"-v", "--version"}, "The version", false, "1.0.0");
+        col = parser.addArgument<i32>({"-c", "--col"}, "The column");
+        parser.addArgument({"-r", "--radius"}, &boundRadius, "The radius", true, 1.0f);
+    }
+};
+
+TEST_F(ArgSchemaTest, ParseIntoSeparatedResults)
+{
+    std::shared_ptr<const ArgSchema> schema = parser.freeze();
+    EXPECT_EQ(schema->getDescription(), "This is the description of the parser");
+
+    CommandLines commandLines;
+    commandLines.Add({"program", "-v", "2.0.0", "-c", "3", "-r", "2.5"});
+    commandLines.Add({"program", "-c", "-7", "--radius", "4"});
+    std::vector<ArgCommandLine> lines = commandLines.Get();
+
+    ArgParseResult first = schema->parse(lines[0].argc, lines[0].argv);
+    ArgParseResult second = schema->parse(lines[1].argc, lines[1].argv);
+
+    EXPECT_TRUE(first.isParsed());
+    EXPECT_EQ(first.getArgument<String>("-v"), "2.0.0");
+    EXPECT_EQ(first.get(col), 3);
+    EXPECT_EQ(first.getArgument<f32>("-r"), 2.5f);
+
+    EXPECT_EQ(second.getArgument<String>("--version"), "1.0.0");
+    EXPECT_EQ(second.get(col), -7);
+    EXPECT_EQ(second.getArgument<f32>("--radius"), 4.0f);
+
+    // The bound storage of the parser is not touched by the schema.
+    EXPECT_EQ(boundRadius, 1.0f);
+
+    EXPECT_THROW(first.getArgument<f32>("-c"), std::invalid_argument);
+    EXPECT_THROW(first.getArgument<f32>("-t"), std::invalid_argument);
+}
+
+TEST_F(ArgSchemaTest, SchemaIsNotChangedByTheParser)
+{
+    std::shared_ptr<const ArgSchema> schema = parser.freeze();
+    parser.addArgument<bool>({"--use-color"});
+
+    CommandLines commandLines;
+    commandLines.Add({"program", "-r", "1", "--use-color"});
+    std::vector<ArgCommandLine> lines = commandLines.Get();
+
+    EXPECT_THROW(schema->parse(lines[0].argc, lines[0].argv), std::invalid_argument);
+    EXPECT_NO_THROW(parser.parse(lines[0].argc, lines[0].argv));
+}
+
+TEST_F(ArgSchemaTest, ReuseResultBetweenParses)
+{
+    std::shared_ptr<const ArgSchema> schema = parser.freeze();
+
+    CommandLines commandLines;
+    commandLines.Add({"program", "-c", "5", "-r", "1"});
+    commandLines.Add({"program", "-v", "3.0.0"});
+    std::vector<ArgCommandLine> lines = commandLines.Get();
+
+    ArgParseResult result;
+    EXPECT_FALSE(result.isParsed());
+
+    schema->parse(lines[0].argc, lines[0].argv, result);
+    EXPECT_EQ(result.get(col), 5);
+
+    EXPECT_THROW(schema->parse(lines[1].argc, lines[1].argv, result), std::invalid_argument);
+    EXPECT_FALSE(result.isParsed());
+}
+
+TEST_F(ArgSchemaTest, ParseBatchMatchesSequentialParse)
+{
+    std::shared_ptr<const ArgSchema> schema = parser.freeze();
+
+    const u32 commandLineCount = 2000;
+    CommandLines commandLines;
+    for (u32 i = 0; i < commandLineCount; i++)
+    {
+        if (i % 10 == 9)
+        {
+            commandLines.Add({"program", "-c", std::to_string(i)});
+        }
+        else
+        {
+            commandLines.Add({"program",
+                              "-v", "v" + std::to_string(i),
+                              "-c", std::to_string(i),
+                              "-r", std::to_string(i) + ".5"});
+        }
+    }
+
+    std::vector<ArgCommandLine> lines = commandLines.Get();
+    std::vector<ArgParseResult> results = schema->parseBatch(lines, 4);
+
+    ASSERT_EQ(results.size(), commandLineCount);
+    for (u32 i = 0; i < commandLineCount; i++)
+    {
+        const ArgParseResult &result = results[i];
+        if (i % 10 == 9)
+        {
+            EXPECT_FALSE(result.isParsed());
+            EXPECT_EQ(result.getStatus().code(), ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED);
+            EXPECT_THAT(result.getError().c_str(), ::testing::HasSubstr("--radius"));
+            continue;
+        }
+
+        ASSERT_TRUE(result.isParsed()) << result.getError();
+        EXPECT_EQ(result.getArgument<String>("-v"), "v" + std::to_string(i));
+        EXPECT_EQ(result.get(col), static_cast<i32>(i));
+        EXPECT_EQ(result.getArgument<f32>("-r"), static_cast<f32>(i) + 0.5f);
+    }
+}
+
+TEST_F(ArgSchemaTest, ParseBatchRethrowsTheVisitorException)
+{
+    ArgParser inputParser("The inputs");
+    inputParser.addPositional<String>("input", [](u32, ArgStringView input)
+                                      {
+                                          if (input.length() > 4 && strncmp(input.data(), "bad-", 4) == 0)
+                                          {
+                                              throw std::runtime_error(input.toString().c_str());
+                                          }
+                                      });
+    std::shared_ptr<const ArgSchema> schema = inputParser.freeze();
+
+    CommandLines commandLines;
+    for (u32 i = 0; i < 1000; i++)
+    {
+        commandLines.Add({"program", (i == 300 || i == 700 ? "bad-" : "good-") + std::to_string(i)});
+    }
+    std::vector<ArgCommandLine> lines = commandLines.Get();
+
+    // The exception of the first failed command line, whatever the number of threads is.
+    for (u32 threadCount : {1u, 4u, 0u})
+    {
+        try
+        {
+            schema->parseBatch(lines, threadCount);
+            ADD_FAILURE() << "The exception of the visitor is not rethrown";
+        }
+        catch (const std::runtime_error &e)
+        {
+            EXPECT_STREQ(e.what(), "bad-300");
+        }
+    }
+
+    // The workers are released: the next batch runs normally.
+    lines.erase(lines.begin() + 300);
+    lines.erase(lines.begin() + 699);
+    for (const ArgParseResult &result : schema->parseBatch(lines, 4))
+    {
+        EXPECT_TRUE(result.isParsed());
+    }
+}
+
+
+TEST_F(ArgSchemaTest, TryParseAndTryGetArgument)
+{
+    std::shared_ptr<const ArgSchema> schema = parser.freeze();
+
+    CommandLines commandLines;
+    commandLines.Add({"program", "-v", "1.0.0", "--unknown", "-r", "2.5"});
+    commandLines.Add({"program", "-v", "1.0.0", "-r", "2.5"});
+    std::vector<ArgCommandLine> lines = commandLines.Get();
+
+    ArgParseResult result;
+    i32 count = 0;
+    EXPECT_EQ(result.tryGetArgument<i32>("-c", count).code(), ArgErrorCode::ARG_ERROR_NOT_PARSED);
+
+    ArgStatus status = schema->tryParse(lines[0].argc, lines[0].argv, result);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND);
+    EXPECT_EQ(status.tokenIndex(), 3);
+    EXPECT_FALSE(result.isParsed());
+    EXPECT_EQ(schema->getErrorMessage(status), "The key --unknown is not found");
+    EXPECT_EQ(result.getError(), "The key --unknown is not found");
+
+    status = schema->tryParse(lines[1].argc, lines[1].argv, result);
+    ASSERT_TRUE(status.ok());
+    EXPECT_TRUE(result.isParsed());
+    EXPECT_EQ(result.getError(), "");
+
+    f32 radius = 0.0f;
+    EXPECT_TRUE(result.tryGetArgument<f32>("--radius", radius).ok());
+    EXPECT_EQ(radius, 2.5f);
+    EXPECT_EQ(result.tryGetArgument<i32>("--radius", count).code(), ArgErrorCode::ARG_ERROR_TYPE_MISMATCH);
+    EXPECT_EQ(count, 0);
+}
+
+TEST_F(ArgSchemaTest, HelpIsLaidOutWhenFrozen)
+{
+    std::shared_ptr<const ArgSchema> schema = parser.freeze();
+    const String help = schema->getHelp().toString();
+
+    // Later changes of the parser do not affect the help of the schema.
+    parser.addArgument<i32>({"--later"}, "Added after the freeze");
+    EXPECT_EQ(schema->getHelp(), help.c_str());
+    EXPECT_NE(help.find("  -r, --radius <f32>      The radius (required)\n"), std::string::npos);
+    EXPECT_EQ(help.find("--later"), std::string::npos);
+
+    CommandLines commandLines;
+    commandLines.Add({"program", "--help"});
+    std::vector<ArgCommandLine> lines = commandLines.Get();
+
+    ArgParseResult result;
+    EXPECT_EQ(schema->tryParse(lines[0].argc, lines[0].argv, result).code(), ArgErrorCode::ARG_ERROR_HELP_REQUESTED);
+    EXPECT_THROW(schema->parse(lines[0].argc, lines[0].argv, result), std::invalid_argument);
+}
+
+TEST_F(ArgSchemaTest, LiveResultRejectsAZeroCopySchema)
+{
+    EXPECT_THROW(ArgLiveResult(nullptr), std::invalid_argument);
+
+    // The snapshots would point into the `argv` of the reloads.
+    parser.setZeroCopyStrings(true);
+    std::shared_ptr<const ArgSchema> schema = parser.freeze();
+    EXPECT_TRUE(schema->hasZeroCopyStrings());
+    EXPECT_THROW(ArgLiveResult live(schema), std::invalid_argument);
+
+    parser.setZeroCopyStrings(false);
+    EXPECT_FALSE(parser.freeze()->hasZeroCopyStrings());
+    EXPECT_NO_THROW(ArgLiveResult live(parser.freeze()));
+}
+
+TEST_F(ArgSchemaTest, LiveResultKeepsTheViewsConsistent)
+{
+    ArgLiveResult live(parser.freeze());
+    EXPECT_EQ(live.getGeneration(), 0);
+    EXPECT_FALSE(live.read().getResult().isParsed());
+
+    {
+        // The values are copied, the command line of a reload can be released.
+        CommandLines commandLines;
+        commandLines.Add({"program", "-v", "2.0.0", "-c", "3", "-r", "2.5"});
+        std::vector<ArgCommandLine> lines = commandLines.Get();
+        live.reload(lines[0].argc, lines[0].argv);
+    }
+
+    CommandLines commandLines;
+    commandLines.Add({"program", "-v", "3.0.0", "-c", "4", "-r", "3.5"});
+    commandLines.Add({"program", "-c", "5"});
+    std::vector<ArgCommandLine> lines = commandLines.Get();
+
+    ArgLiveView view = live.read();
+    EXPECT_EQ(view.getGeneration(), 1);
+    EXPECT_EQ(view.getArgument<String>("-v"), "2.0.0");
+
+    // The view keeps its snapshot alive across the reload.
+    live.reload(lines[0].argc, lines[0].argv);
+    EXPECT_EQ(live.getGeneration(), 2);
+    EXPECT_EQ(view.get(col), 3);
+    EXPECT_EQ(view.getArgument<f32>("-r"), 2.5f);
+    EXPECT_EQ(live.read().get(col), 4);
+    EXPECT_EQ(live.getRetiredCount(), 1);
+
+    // A failed reload is never published.
+    EXPECT_EQ(live.tryReload(lines[1].argc, lines[1].argv).code(), ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED);
+    EXPECT_THROW(live.reload(lines[1].argc, lines[1].argv), std::invalid_argument);
+    EXPECT_EQ(live.getGeneration(), 2);
+    EXPECT_EQ(live.read().getArgument<String>("--version"), "3.0.0");
+
+    // The snapshot is reclaimed by the first reload after its last view.
+    {
+        ArgLiveView released = std::move(view);
+    }
+    live.reload(lines[0].argc, lines[0].argv);
+    EXPECT_EQ(live.getRetiredCount(), 0);
+}
+
+TEST_F(ArgSchemaTest, LiveResultHasNoTornReadsUnderReloads)
+{
+    ArgLiveResult live(parser.freeze());
+
+    // Every command line gives the same number to each argument.
+    const u32 commandLineCount = 64;
+    CommandLines commandLines;
+    for (u32 i = 1; i <= commandLineCount; i++)
+    {
+        commandLines.Add({"program",
+                          "-v", "v" + std::to_string(i),
+                          "-c", std::to_string(i),
+                          "-r", std::to_string(i)});
+    }
+    std::vector<ArgCommandLine> lines = commandLines.Get();
+    live.reload(lines[0].argc, lines[0].argv);
+
+    const u32 readerCount = 4;
+    const u32 reloadCount = 5000;
+    std::atomic<bool> isReloading(true);
+    std::atomic<u32> startedReaders(0);
+    std::atomic<u32> tornReads(0);
+    std::atomic<u32> reads(0);
+
+    std::vector<std::thread> readers;
+    for (u32 reader = 0; reader < readerCount; reader++)
+    {
+        readers.emplace_back(
+            [&]()
+            {
+                u64 lastGeneration = 0;
+                startedReaders++;
+                do
+                {
+                    ArgLiveView view = live.read();
+                    const i32 number = view.get(col);
+                    const bool consistent =
+                        view.getArgument<String>("-v") == "v" + std::to_string(number) &&
+                        view.getArgument<f32>("-r") == static_cast<f32>(number) &&
+                        view.getGeneration() >= lastGeneration;
+                    lastGeneration = view.getGeneration();
+
+                    tornReads += consistent ? 0 : 1;
+                    reads++;
+                } while (isReloading.load());
+            });
+    }
+
+    // The reloads only start once every reader runs.
+    while (startedReaders.load() < readerCount)
+    {
+        std::this_thread::yield();
+    }
+
+    for (u32 reload = 1; reload <= reloadCount; reload++)
+    {
+        const ArgCommandLine &line = lines[reload % commandLineCount];
+        EXPECT_TRUE(live.tryReload(line.argc, line.argv).ok());
+    }
+    isReloading = false;
+
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(tornReads.load(), 0);
+    EXPECT_GE(reads.load(), readerCount);
+    EXPECT_EQ(live.getGeneration(), reloadCount + 1);
+
+    live.reload(lines[0].argc, lines[0].argv);
+    EXPECT_EQ(live.getRetiredCount(), 0);
+}
+
+TEST(ParallelForTest, RethrowsTheExceptionOfTheLowestTask)
+{
+    // The exception of the first failed task, whatever the number of threads is.
+    for (u32 threadCount : {1u, 4u, 0u})
+    {
+        try
+        {
+            parallelFor(1000, threadCount, [](u32 index)
+                        {
+                            if (index == 300 || index == 700)
+                            {
+                                throw std::runtime_error("bad-" + std::to_string(index));
+                            }
+                        });
+            ADD_FAILURE() << "The exception of the task is not rethrown";
+        }
+        catch (const std::runtime_error &e)
+        {
+            EXPECT_STREQ(e.what(), "bad-300");
+        }
+    }
+
+    // The workers are released: the next call runs every task.
+    std::atomic<u32> doneCount(0);
+    parallelFor(1000, 4, [&](u32)
+                { doneCount.fetch_add(1, std::memory_order_relaxed); });
+    EXPECT_EQ(doneCount.load(), 1000u);
+}
+
+/**
+ * Counts the threads which run a task for the first time.
+ */
+static std::atomic<u32> s_newTaskThreads(0);
+
+static void markTaskThread()
+{
+    thread_local bool isKnown = false;
+    if (!isKnown)
+    {
+        isKnown = true;
+        s_newTaskThreads.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+TEST(ParallelForTest, ReusesTheWorkerThreads)
+{
+    const auto slowTask = [](u32)
+    {
+        markTaskThread();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    };
+
+    parallelFor(64, 4, slowTask);
+    s_newTaskThreads.store(0);
+
+    // The following calls run on the same workers, no thread is started anymore.
+    std::atomic<u32> doneCount(0);
+    for (u32 call = 0; call < 20; call++)
+    {
+        parallelFor(64, 4, [&](u32 index)
+                    {
+                        slowTask(index);
+                        doneCount.fetch_add(1, std::memory_order_relaxed);
+                    });
+    }
+    EXPECT_EQ(s_newTaskThreads.load(), 0u);
+    EXPECT_EQ(doneCount.load(), 20u * 64u);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <NTTArgParser.hpp>
+#include <string>
+
+using namespace NTT_NS;
+
+namespace
+{
+    constexpr ArgStaticArgument kArguments[] = {
+        staticArgument<String>({"-v", "--version"}, "Show the version of the program", false, "1.0.0"),
+        staticArgument<i32>({"-c", "--col"}, "Show the color of the program"),
+        staticArgument<f32>({"-r", "--radius"}, "Show the radius of the program", true, 1.0f),
+        staticArgument<bool>({"--use-color"}, "Show the color of the program"),
+    };
+
+    constexpr ArgStaticSchema<4> kSchema(kArguments);
+    constexpr ArgStaticSchema<4> kStrictSchema(kArguments, ArgConversionPolicy::STRICT_CONVERSION);
+
+    constexpr ArgStaticHandle<String> kVersion = kSchema.handle<String>("--version");
+    constexpr ArgStaticHandle<ArgStringView> kVersionView = kSchema.handle<ArgStringView>("-v");
+    constexpr ArgStaticHandle<i32> kCol = kSchema.handle<i32>("-c");
+    constexpr ArgStaticHandle<f32> kRadius = kSchema.handle<f32>("--radius");
+    constexpr ArgStaticHandle<bool> kUseColor = kSchema.handle<bool>("--use-color");
+
+    // Everything above is evaluated by the compiler.
+    static_assert(kSchema.count() == 4, "The schema has 4 arguments");
+    static_assert(kSchema.indexOf("--radius") == 2, "The lookup is done at compile time");
+    static_assert(kUseColor.index() == 3, "The handle is built at compile time");
+} // namespace
+
+class ArgStaticSchemaTest : public ::testing::Test
+{
+protected:
+    std::vector<std::string> storage;
+    std::vector<char *> argv;
+
+    void LoadArgument(const std::vector<std::string> &tokens)
+    {
+        storage = tokens;
+        argv.clear();
+        for (std::string &token : storage)
+        {
+            argv.push_back(&token[0]);
+        }
+    }
+
+    u32 argc() const { return static_cast<u32>(argv.size()); }
+};
+
+TEST_F(ArgStaticSchemaTest, ParseWithoutBuildingAnything)
+{
+    ArgStaticResult<4> result;
+    EXPECT_FALSE(result.isParsed());
+
+    LoadArgument({"program", "-r", "2.5", "--col", "12", "--use-color"});
+    kSchema.parse(argc(), argv.data(), result);
+    EXPECT_TRUE(result.isParsed());
+    EXPECT_EQ(result.get(kVersion), "1.0.0");
+    EXPECT_EQ(result.get(kVersionView), "1.0.0");
+    EXPECT_EQ(result.get(kCol), 12);
+    EXPECT_EQ(result.get(kRadius), 2.5f);
+    EXPECT_EQ(result.get(kUseColor), true);
+    EXPECT_FALSE(result.isProvided(kVersion));
+    EXPECT_TRUE(result.isProvided(kRadius));
+
+    // The same result is reused, every value is restored first.
+    LoadArgument({"program", "--radius", "3.0", "-v", "2.0.0", "--use-color", "false"});
+    EXPECT_TRUE(kSchema.tryParse(argc(), argv.data(), result).ok());
+    EXPECT_EQ(result.get(kVersion), "2.0.0");
+    EXPECT_EQ(result.get(kCol), 0);
+    EXPECT_EQ(result.get(kRadius), 3.0f);
+    EXPECT_EQ(result.get(kUseColor), false);
+    EXPECT_FALSE(result.isProvided(kCol));
+}
+
+TEST_F(ArgStaticSchemaTest, ParseFailure)
+{
+    ArgStaticResult<4> result;
+
+    LoadArgument({"program", "-r", "1.0", "--missing"});
+    ArgStatus status = kSchema.tryParse(argc(), argv.data(), result);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND);
+    EXPECT_EQ(status.tokenIndex(), 3);
+    EXPECT_EQ(kSchema.getErrorMessage(status), "The key --missing is not found");
+    EXPECT_FALSE(result.isParsed());
+
+    LoadArgument({"program", "-c", "12"});
+    status = kSchema.tryParse(argc(), argv.data(), result);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED);
+    EXPECT_EQ(kSchema.getErrorMessage(status), "The required argument [-r, --radius] is not provided");
+    EXPECT_THROW(kSchema.parse(argc(), argv.data(), result), std::invalid_argument);
+
+    LoadArgument({"program", "-r"});
+    status = kSchema.tryParse(argc(), argv.data(), result);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_MISSING_VALUE);
+    EXPECT_EQ(kSchema.getErrorMessage(status), "The f32 argument [-r, --radius] is not followed by a value");
+
+    LoadArgument({"program", "-r", "1.0", "--help"});
+    EXPECT_EQ(kSchema.tryParse(argc(), argv.data(), result).code(), ArgErrorCode::ARG_ERROR_HELP_REQUESTED);
+
+    // The invalid value keeps its numeric prefix unless the conversion is strict.
+    LoadArgument({"program", "-r", "1.0", "-c", "12abc"});
+    EXPECT_TRUE(kSchema.tryParse(argc(), argv.data(), result).ok());
+    EXPECT_EQ(result.get(kCol), 12);
+
+    status = kStrictSchema.tryParse(argc(), argv.data(), result);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_INVALID_VALUE);
+    EXPECT_EQ(status.tokenIndex(), 4);
+    EXPECT_EQ(kStrictSchema.getErrorMessage(status), "The value 12abc of the argument [-c, --col] is not a valid i32");
+}
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <NTTArgParser.hpp>
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#ifdef NTT_PLATFORM_UNIX
+#include <unistd.h>
+#endif
+
+using namespace NTT_NS;
+
+/**
+ * Hands out the input in chunks of at most `chunkSize` bytes, `-1` once `failAt` bytes are read.
+ */
+static ArgChunkReader MemoryReader(const std::string &input, u32 chunkSize, u64 failAt = UINT64_MAX)
+{
+    std::shared_ptr<u64> offset = std::make_shared<u64>(0);
+    return [input, chunkSize, failAt, offset](char *buffer, u32 capacity) -> i64
+    {
+        if (*offset >= failAt)
+        {
+            return -1;
+        }
+
+        const u64 count = std::min<u64>({static_cast<u64>(capacity), chunkSize, input.size() - *offset, failAt - *offset});
+        memcpy(buffer, input.data() + *offset, count);
+        *offset += count;
+        return static_cast<i64>(count);
+    };
+}
+
+/**
+ * The tokens separated by the delimiter, without a delimiter after the last one.
+ */
+static std::string Joined(const std::vector<std::string> &tokens, char delimiter = '\0')
+{
+    std::string joined;
+    for (const std::string &token : tokens)
+    {
+        if (&token != &tokens.front())
+        {
+            joined.push_back(delimiter);
+        }
+        joined += token;
+    }
+    return joined;
+}
+
+static std::vector<std::string> ReadAll(ArgTokenSource &source)
+{
+    std::vector<std::string> tokens;
+    ArgStringView token;
+    while (source.next(token))
+    {
+        tokens.emplace_back(token.data(), token.length());
+    }
+    return tokens;
+}
+
+class ArgTokenSourceTest : public ::testing::Test
+{
+protected:
+    ArgParser parser{"This is the description of the parser"};
+
+    void SetUp() override
+    {
+        parser.addArgument<String>({"-v", "--version"}, "The version", false, "1.0.0");
+        parser.addArgument<i32>({"-c", "--col"}, "The column");
+        parser.addArgument<bool>({"--use-color"}, "Use the colors");
+        parser.addArgument<std::vector<String>>({"-f", "--files"}, "The files").setNargs(NARGS_ONE_OR_MORE);
+    }
+};
+
+TEST_F(ArgTokenSourceTest, TokensAcrossTheChunks)
+{
+    const std::string input = Joined({"first", "second", "", "a-much-longer-token", "last"});
+
+    // The tokens straddle the chunks and the buffer is compacted many times.
+    ArgTokenSource source(MemoryReader(input, 3), ArgTokenDelimiter::ARG_TOKEN_DELIMITER_NUL, 24);
+    EXPECT_THAT(ReadAll(source), ::testing::ElementsAre("first", "second", "", "a-much-longer-token", "last"));
+    EXPECT_EQ(source.getError(), ArgErrorCode::ARG_ERROR_NONE);
+    EXPECT_EQ(source.getTokenCount(), 5);
+
+    ArgStringView token;
+    EXPECT_FALSE(source.next(token));
+
+    ArgTokenSource lines(MemoryReader("one\ntwo\n", 100), ArgTokenDelimiter::ARG_TOKEN_DELIMITER_NEWLINE);
+    EXPECT_THAT(ReadAll(lines), ::testing::ElementsAre("one", "two"));
+}
+
+TEST_F(ArgTokenSourceTest, TokenSourceFailures)
+{
+    ArgTokenSource tooLong(MemoryReader(Joined({"short", "far-too-long-token", ""}), 4), ArgTokenDelimiter::ARG_TOKEN_DELIMITER_NUL, 8);
+    EXPECT_THAT(ReadAll(tooLong), ::testing::ElementsAre("short"));
+    EXPECT_EQ(tooLong.getError(), ArgErrorCode::ARG_ERROR_STREAM_TOKEN_TOO_LONG);
+
+    ArgTokenSource failing(MemoryReader(Joined({"-c", "12", "-v"}), 2, 5));
+    EXPECT_THAT(ReadAll(failing), ::testing::ElementsAre("-c"));
+    EXPECT_EQ(failing.getError(), ArgErrorCode::ARG_ERROR_STREAM_READ_FAILED);
+
+    ArgTokenSource parsed(MemoryReader(Joined({"-c", "12", "-v"}), 2, 5));
+    ArgStatus status = parser.tryParseStream(parsed);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_STREAM_READ_FAILED);
+    EXPECT_EQ(status.tokenIndex(), 2);
+    EXPECT_EQ(parser.getErrorMessage(status), "The token source cannot be read at the token 2");
+    EXPECT_FALSE(parser.isParsed());
+}
+
+TEST_F(ArgTokenSourceTest, ParseStreamLikeTheCommandLine)
+{
+    std::string input;
+    for (u32 i = 0; i < 1000; i++)
+    {
+        input += "--col";
+        input.push_back('\0');
+        input += std::to_string(i);
+        input.push_back('\0');
+    }
+    input += Joined({"--use-color", "-f", "a.txt", "b.txt", "-v", "2.0.0"});
+
+    // A small buffer: the values are copied out of it before it is reused.
+    ArgTokenSource source(MemoryReader(input, 7), ArgTokenDelimiter::ARG_TOKEN_DELIMITER_NUL, 16);
+    parser.parseStream(source);
+    EXPECT_TRUE(parser.isParsed());
+    EXPECT_EQ(parser.getArgument<i32>("--col"), 999);
+    EXPECT_EQ(parser.getArgument<bool>("--use-color"), true);
+    ArgSpan<ArgStringView> files = parser.getArgument<std::vector<String>>("--files");
+    ASSERT_EQ(files.size(), 2);
+    EXPECT_EQ(files[0], "a.txt");
+    EXPECT_EQ(files[1], "b.txt");
+    EXPECT_EQ(parser.getArgument<String>("--version"), "2.0.0");
+
+    ArgTokenSource invalid(MemoryReader(Joined({"--col", "1", "--unknown"}), 64));
+    ArgStatus status = parser.tryParseStream(invalid);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_KEY_NOT_FOUND);
+    EXPECT_EQ(status.tokenIndex(), 3);
+    EXPECT_EQ(parser.getErrorMessage(status), "The key --unknown is not found");
+
+    ArgTokenSource missing(MemoryReader(Joined({"--use-color", "-v"}), 64));
+    status = parser.tryParseStream(missing);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_MISSING_VALUE);
+    EXPECT_EQ(status.tokenIndex(), 2);
+    EXPECT_EQ(parser.getErrorMessage(status), "The string argument [-v, --version] is not followed by a value");
+}
+
+TEST_F(ArgTokenSourceTest, ParseStreamVisitsThePositionalTokens)
+{
+    u64 sum = 0;
+    u32 count = 0;
+    parser.addPositional<i32>("numbers", [&sum, &count](u32 index, i32 value)
+                              {
+                                  EXPECT_EQ(index, count);
+                                  sum += static_cast<u64>(value);
+                                  count++;
+                              },
+                              "The numbers", true, true);
+
+    std::string input;
+    for (u32 i = 1; i <= 10000; i++)
+    {
+        input += std::to_string(i);
+        input.push_back('\0');
+    }
+    input += Joined({"--col", "5", "--", "-1"});
+
+    // The values are visited while the small buffer is reused, nothing is kept.
+    ArgTokenSource source(MemoryReader(input, 5), ArgTokenDelimiter::ARG_TOKEN_DELIMITER_NUL, 16);
+    parser.parseStream(source);
+    EXPECT_EQ(count, 10001);
+    EXPECT_EQ(sum, 10000ull * 10001 / 2 - 1);
+    EXPECT_EQ(parser.getArgument<i32>("--col"), 5);
+
+    ArgTokenSource missing(MemoryReader(Joined({"--col", "1"}), 64));
+    ArgStatus status = parser.tryParseStream(missing);
+    EXPECT_EQ(status.code(), ArgErrorCode::ARG_ERROR_REQUIRED_NOT_PROVIDED);
+    EXPECT_EQ(parser.getErrorMessage(status), "The required argument [numbers] is not provided");
+}
+
+#ifdef NTT_PLATFORM_UNIX
+TEST_F(ArgTokenSourceTest, ParseStreamFromPipe)
+{
+    int descriptors[2];
+    ASSERT_EQ(pipe(descriptors), 0);
+
+    const std::string input = Joined({"-v", "3.1.4", "--col", "42", ""}, '\n');
+    ASSERT_EQ(write(descriptors[1], input.data(), input.size()), static_cast<ssize_t>(input.size()));
+    close(descriptors[1]);
+
+    ArgTokenSource source(descriptors[0], ArgTokenDelimiter::ARG_TOKEN_DELIMITER_NEWLINE);
+    EXPECT_EQ(parser.tryParseStream(source).code(), ArgErrorCode::ARG_ERROR_NONE);
+    EXPECT_EQ(parser.getArgument<String>("-v"), "3.1.4");
+    EXPECT_EQ(parser.getArgument<i32>("-c"), 42);
+    close(descriptors[0]);
+}
+#endif